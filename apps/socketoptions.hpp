@@ -219,6 +219,13 @@ const SocketOption srt_options [] {
     { "fc", 0, SRTO_FC, SocketOption::PRE, SocketOption::INT, nullptr},
     { "sndbuf", 0, SRTO_SNDBUF, SocketOption::PRE, SocketOption::INT, nullptr},
     { "rcvbuf", 0, SRTO_RCVBUF, SocketOption::PRE, SocketOption::INT, nullptr},
+    { "udpsndbatch", 0, SRTO_UDP_SNDBATCH, SocketOption::PRE, SocketOption::INT, nullptr},
+    { "udprcvbatch", 0, SRTO_UDP_RCVBATCH, SocketOption::PRE, SocketOption::INT, nullptr},
+    { "udpgso", 0, SRTO_UDP_GSO, SocketOption::PRE, SocketOption::BOOL, nullptr},
+    { "udpgro", 0, SRTO_UDP_GRO, SocketOption::PRE, SocketOption::BOOL, nullptr},
+    { "sndworkers", 0, SRTO_SNDWORKERS, SocketOption::PRE, SocketOption::INT, nullptr},
+    { "cryptoworkers", 0, SRTO_CRYPTOWORKERS, SocketOption::PRE, SocketOption::INT, nullptr},
+    { "listenshards", 0, SRTO_LISTENSHARDS, SocketOption::PRE, SocketOption::INT, nullptr},
     // linger option is handled outside of the common loop, therefore commented out.
     //{ "linger", 0, SRTO_LINGER, SocketOption::PRE, SocketOption::INT, nullptr},
     { "ipttl", 0, SRTO_IPTTL, SocketOption::PRE, SocketOption::INT, nullptr},
@@ -228,6 +235,7 @@ const SocketOption srt_options [] {
     { "oheadbw", 0, SRTO_OHEADBW, SocketOption::POST, SocketOption::INT, nullptr},
     { "latency", 0, SRTO_LATENCY, SocketOption::PRE, SocketOption::INT, nullptr},
     { "tsbpdmode", 0, SRTO_TSBPDMODE, SocketOption::PRE, SocketOption::BOOL, nullptr},
+    { "tsbpdshared", 0, SRTO_TSBPDSHARED, SocketOption::PRE, SocketOption::BOOL, nullptr},
     { "tlpktdrop", 0, SRTO_TLPKTDROP, SocketOption::PRE, SocketOption::BOOL, nullptr},
     { "snddropdelay", 0, SRTO_SNDDROPDELAY, SocketOption::POST, SocketOption::INT, nullptr},
     { "nakreport", 0, SRTO_NAKREPORT, SocketOption::PRE, SocketOption::BOOL, nullptr},
@@ -243,6 +251,7 @@ const SocketOption srt_options [] {
     { "payloadsize", 0, SRTO_PAYLOADSIZE, SocketOption::PRE, SocketOption::INT, nullptr},
     { "kmrefreshrate", 0, SRTO_KMREFRESHRATE, SocketOption::PRE, SocketOption::INT, nullptr },
     { "kmpreannounce", 0, SRTO_KMPREANNOUNCE, SocketOption::PRE, SocketOption::INT, nullptr },
+    { "cryptoprecomp", 0, SRTO_CRYPTOPRECOMP, SocketOption::PRE, SocketOption::INT, nullptr },
     { "enforcedencryption", 0, SRTO_ENFORCEDENCRYPTION, SocketOption::PRE, SocketOption::BOOL, nullptr },
     { "ipv6only", 0, SRTO_IPV6ONLY, SocketOption::PRE, SocketOption::INT, nullptr },
     { "peeridletimeo", 0, SRTO_PEERIDLETIMEO, SocketOption::PRE, SocketOption::INT, nullptr },
@@ -409,6 +409,37 @@ static int _crysprFallback_AES_SetCtrStream(CRYSPR_cb *cryspr_cb, hcrypt_Ctx *ct
 }
 #endif
 
+/*
+ * Compute the AES-CTR keystream of the packet with index pki (host order),
+ * which is the encryption of len bytes of zeros with the packet's IV.
+ * XORing it with the payload gives the same result as ms_encrypt().
+ * out must have room for len rounded up to the AES block size.
+ */
+int crysprHelper_CtrKeystream(CRYSPR_cb *cryspr_cb, hcrypt_Ctx *ctx, hcrypt_Pki pki, size_t len, unsigned char *out)
+{
+	CRYSPR_AESCTX *aes_key = CRYSPR_GETSEK(cryspr_cb, hcryptCtx_GetKeyIndex(ctx));
+	unsigned char iv[CRYSPR_AESBLKSZ];
+	hcrypt_Pki nwk_pki = htonl(pki);
+
+	ASSERT(ctx->mode == HCRYPT_CTX_MODE_AESCTR);
+
+	hcrypt_SetCtrIV((unsigned char *)&nwk_pki, ctx->salt, iv);
+#if CRYSPR_HAS_AESCTR
+	memset(out, 0, len);
+	return(cryspr_cb->cryspr->aes_ctr_cipher(true, aes_key, iv, out, len, out));
+#else /*CRYSPR_HAS_AESCTR*/
+	{
+		size_t out_len = 0;
+		int iret = _crysprFallback_AES_SetCtrStream(cryspr_cb, ctx, len, iv);
+		if (iret) {
+			return(iret);
+		}
+		return(cryspr_cb->cryspr->aes_ecb_cipher(true, aes_key,
+				cryspr_cb->ctr_stream, cryspr_cb->ctr_stream_len, out, &out_len));
+	}
+#endif/*CRYSPR_HAS_AESCTR*/
+}
+
 static int crysprFallback_MsEncrypt(
 	CRYSPR_cb *cryspr_cb,
 	hcrypt_Ctx *ctx,
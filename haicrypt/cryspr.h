@@ -217,6 +217,7 @@ typedef struct tag_CRYSPR_methods {
 
 CRYSPR_cb  *crysprHelper_Open(CRYSPR_methods *cryspr, size_t cb_len, size_t max_len);
 int         crysprHelper_Close(CRYSPR_cb *cryspr_cb);
+int         crysprHelper_CtrKeystream(CRYSPR_cb *cryspr_cb, hcrypt_Ctx *ctx, hcrypt_Pki pki, size_t len, unsigned char *out);
 
 CRYSPR_methods *crysprInit(CRYSPR_methods *cryspr);
 
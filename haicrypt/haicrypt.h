@@ -57,6 +57,15 @@ typedef struct {
         unsigned char   str[HAICRYPT_SECRET_MAX_SZ];
 }HaiCrypt_Secret;
 
+/* Optional cache of passphrase derived KEKs, shared by sessions.
+ * lookup returns 0 and fills kek when found. Both may be called concurrently. */
+typedef struct {
+        int     (*lookup)(const char *pwd, size_t pwd_len, const unsigned char *salt, size_t salt_len,
+                          unsigned char *kek, size_t kek_len);
+        void    (*store)(const char *pwd, size_t pwd_len, const unsigned char *salt, size_t salt_len,
+                         const unsigned char *kek, size_t kek_len);
+}HaiCrypt_KekCache;
+
 typedef struct {
 #define HAICRYPT_CFG_F_TX       0x01        /* !TX -> RX */
 #define HAICRYPT_CFG_F_CRYPTO   0x02        /* Perform crypto Tx:Encrypt Rx:Decrypt */
@@ -82,6 +91,7 @@ typedef struct {
         unsigned int    km_refresh_rate_pkt;    /* Keying Material Refresh Rate (pkts) */
 #define HAICRYPT_DEF_KM_PRE_ANNOUNCE 0x1000     /* Keying Material Default Pre/Post Announce (pkts) */
         unsigned int    km_pre_announce_pkt;    /* Keying Material Pre/Post Announce (pkts) */
+        const HaiCrypt_KekCache *kek_cache;     /* NULL: derive the KEK each time */
 }HaiCrypt_Cfg;
 
 typedef enum HaiCrypt_CryptoDir { HAICRYPT_CRYPTO_DIR_RX, HAICRYPT_CRYPTO_DIR_TX } HaiCrypt_CryptoDir;
@@ -111,6 +121,17 @@ int  HaiCrypt_Tx_ManageKeys(HaiCrypt_Handle hhc, void *out_p[], size_t out_len_p
 int  HaiCrypt_Tx_Data(HaiCrypt_Handle hhc, unsigned char *pfx, unsigned char *data, size_t data_len);
 int  HaiCrypt_Rx_Data(HaiCrypt_Handle hhc, unsigned char *pfx, unsigned char *data, size_t data_len);
 
+/* Precomputed AES-CTR keystream (sender)
+ * SetKeystreamCache: keep the keystream of up to npkts packets, 0 to disable.
+ * PrecomputeKeystream: compute len bytes of keystream for the packets with index
+ * pki to pki+npkts-1 with the current key, unless already done; returns the
+ * number of keystreams computed. HaiCrypt_Tx_Data XORs a matching keystream
+ * with the payload instead of calling the cipher. Must not be called
+ * concurrently with HaiCrypt_Tx_Data. */
+int  HaiCrypt_Tx_SetKeystreamCache(HaiCrypt_Handle hhc, int npkts);
+int  HaiCrypt_Tx_PrecomputeKeystream(HaiCrypt_Handle hhc, uint32_t pki, int npkts, size_t len);
+int  HaiCrypt_Tx_GetKeystreamStats(HaiCrypt_Handle hhc, unsigned *hits, unsigned *misses);
+
 /// @brief Check if the crypto service provider supports AES GCM.
 /// @return returns 1 if AES GCM is supported, 0 otherwise.
 int  HaiCrypt_IsAESGCM_Supported(void);
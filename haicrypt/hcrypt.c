@@ -71,6 +71,7 @@ static hcrypt_Session* sHaiCrypt_PrepareHandle(const HaiCrypt_Cfg* cfg, HaiCrypt
 
     crypto->cryspr = cfg->cryspr;
     crypto->cfg.data_max_len = cfg->data_max_len;
+    crypto->cfg.kek_cache = cfg->kek_cache;
 
     /* Setup transport packet info */
     switch (cfg->xport) {
@@ -221,6 +222,7 @@ int HaiCrypt_ExtractConfig(HaiCrypt_Handle hhcSrc, HaiCrypt_Cfg* pcfg)
         pcfg->key_len = ctx->sek_len;
     }
     pcfg->data_max_len = crypto->cfg.data_max_len;
+    pcfg->kek_cache = crypto->cfg.kek_cache;
     pcfg->km_tx_period_ms = 0;//No HaiCrypt KM inject period, handled in SRT;
 
     pcfg->km_refresh_rate_pkt = crypto->km.refresh_rate;
@@ -305,6 +307,7 @@ int HaiCrypt_Clone(HaiCrypt_Handle hhcSrc, HaiCrypt_CryptoDir tx, HaiCrypt_Handl
             mem_buf += inbuf_siz;
         }
         timerclear(&cryptoClone->km.tx_last);
+        memset(&cryptoClone->ks, 0, sizeof(cryptoClone->ks));
 
         /* Adjust pointers  pointing into cryproSrc after copy
            msg_info and crysprs are extern statics so this is ok*/
@@ -346,6 +349,8 @@ int HaiCrypt_Close(HaiCrypt_Handle hhc)
 
     if (crypto) {
         if (crypto->cryspr && crypto->cryspr->close) crypto->cryspr->close(crypto->cryspr_cb);
+        free(crypto->ks.slot);
+        free(crypto->ks.stream);
         free(crypto);
         rc = 0;
     }
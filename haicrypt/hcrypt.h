@@ -55,6 +55,13 @@ written by
 #include "crypto_api.h"
 #endif /* HAICRYPT_SUPPORT_CRYPTO_API */
 
+/* Precomputed AES-CTR keystream of one packet (sender) */
+typedef struct {
+        hcrypt_Pki          pki;            /* Packet index (host order) */
+        unsigned            kk;             /* Key index (0:even, 1:odd) */
+        size_t              len;            /* Keystream length, 0: free slot */
+} hcrypt_KsSlot;
+
 typedef struct hcrypt_Session_str {
 #ifdef HAICRYPT_SUPPORT_CRYPTO_API
         /* 
@@ -81,6 +88,7 @@ typedef struct hcrypt_Session_str {
 
         struct {
             size_t          data_max_len;
+            const HaiCrypt_KekCache * kek_cache;
         }cfg;
 
         struct {
@@ -89,6 +97,15 @@ typedef struct hcrypt_Session_str {
             unsigned int    refresh_rate;   /* SEK use period */
             unsigned int    pre_announce;   /* Pre/Post next/old SEK announce */
         }km;
+
+        struct {
+            hcrypt_KsSlot * slot;           /* Slot of pki is slot[pki % nslots], NULL: disabled */
+            unsigned char * stream;         /* Keystreams, slot_siz bytes per slot */
+            size_t          slot_siz;
+            unsigned        nslots;
+            unsigned        hits;           /* Packets encrypted with a precomputed keystream */
+            unsigned        misses;         /* Packets encrypted by the cipher */
+        }ks;
 } hcrypt_Session;
 
 #if ENABLE_HAICRYPT_LOGGING
@@ -177,6 +194,7 @@ int hcryptCtx_Tx_PostSwitch(hcrypt_Session *crypto);
 int hcryptCtx_Tx_AsmKM(hcrypt_Session *crypto, hcrypt_Ctx *ctx, unsigned char *alt_sek);
 int hcryptCtx_Tx_ManageKM(hcrypt_Session *crypto);
 int hcryptCtx_Tx_InjectKM(hcrypt_Session *crypto, void *out_p[], size_t out_len_p[], int maxout);
+void hcryptCtx_Tx_DropKeystream(hcrypt_Session *crypto, hcrypt_Ctx *ctx);
 
 /// @brief Initialize receiving crypto context.
 /// @param crypto library instance handle.
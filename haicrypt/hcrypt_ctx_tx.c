@@ -69,6 +69,7 @@ int hcryptCtx_Tx_Rekey(hcrypt_Session *crypto, hcrypt_Ctx *ctx)
 		HCRYPT_LOG(LOG_ERR, "cryspr setkey(sek[%zd]) failed\n", ctx->sek_len);
 		return(-1);
 	}
+	hcryptCtx_Tx_DropKeystream(crypto, ctx);
 
 	HCRYPT_LOG(LOG_NOTICE, "rekeyed crypto context[%d]\n", (ctx->flags & HCRYPT_CTX_F_xSEK)/2);
 	HCRYPT_PRINTKEY(ctx->sek, ctx->sek_len, "sek");
@@ -129,6 +130,7 @@ int hcryptCtx_Tx_CloneKey(hcrypt_Session *crypto, hcrypt_Ctx *ctx, const hcrypt_
 		HCRYPT_LOG(LOG_ERR, "cryspr setkey(sek[%zd]) failed\n", ctx->sek_len);
 		return(-1);
 	}
+	hcryptCtx_Tx_DropKeystream(crypto, ctx);
 
 	HCRYPT_LOG(LOG_NOTICE, "clone-keyed crypto context[%d]\n", (ctx->flags & HCRYPT_CTX_F_xSEK)/2);
 	HCRYPT_PRINTKEY(ctx->sek, ctx->sek_len, "sek");
@@ -203,6 +205,7 @@ int hcryptCtx_Tx_Refresh(hcrypt_Session *crypto)
 		HCRYPT_LOG(LOG_ERR, "refresh cryspr setkey(sek[%d]) failed\n", new_ctx->sek_len);
 		return(-1);
 	}
+	hcryptCtx_Tx_DropKeystream(crypto, new_ctx);
 
 	HCRYPT_PRINTKEY(new_ctx->sek, new_ctx->sek_len, "sek");
 
@@ -419,3 +422,18 @@ int hcryptCtx_Tx_InjectKM(hcrypt_Session *crypto,
 }
 
 
+
+/*
+ * Forget the keystreams precomputed with the previous key of ctx
+ * when the key changes.
+ */
+void hcryptCtx_Tx_DropKeystream(hcrypt_Session *crypto, hcrypt_Ctx *ctx)
+{
+	unsigned kk = hcryptCtx_GetKeyIndex(ctx);
+	unsigned i;
+
+	for (i = 0; i < crypto->ks.nslots; i++) {
+		if (crypto->ks.slot[i].kk == kk)
+			crypto->ks.slot[i].len = 0;
+	}
+}
@@ -72,16 +72,23 @@ int hcryptCtx_GenSecret(hcrypt_Session *crypto, hcrypt_Ctx *ctx)
 	size_t pbkdf_salt_len = (ctx->salt_len >= HAICRYPT_PBKDF2_SALT_LEN
 		? HAICRYPT_PBKDF2_SALT_LEN 
 		: ctx->salt_len);
+	const unsigned char *pbkdf_salt = &ctx->salt[ctx->salt_len - pbkdf_salt_len];
+	const HaiCrypt_KekCache *cache = crypto->cfg.kek_cache;
 	int iret = 0;
-	(void)crypto;
 
-	iret = crypto->cryspr->km_pbkdf2(crypto->cryspr_cb, ctx->cfg.pwd, ctx->cfg.pwd_len,
-		&ctx->salt[ctx->salt_len - pbkdf_salt_len], pbkdf_salt_len, 
-		HAICRYPT_PBKDF2_ITER_CNT, kek_len, kek);
+	/* Same passphrase, salt and length: same KEK */
+	if ((NULL == cache)
+	||  (0 != cache->lookup(ctx->cfg.pwd, ctx->cfg.pwd_len, pbkdf_salt, pbkdf_salt_len, kek, kek_len))) {
+		iret = crypto->cryspr->km_pbkdf2(crypto->cryspr_cb, ctx->cfg.pwd, ctx->cfg.pwd_len,
+			(unsigned char *)pbkdf_salt, pbkdf_salt_len,
+			HAICRYPT_PBKDF2_ITER_CNT, kek_len, kek);
 
-	if(iret) {
-		HCRYPT_LOG(LOG_ERR, "km_pbkdf2() failed (rc=%d)\n", iret);
-		return(-1);
+		if(iret) {
+			HCRYPT_LOG(LOG_ERR, "km_pbkdf2() failed (rc=%d)\n", iret);
+			return(-1);
+		}
+		if (NULL != cache)
+			cache->store(ctx->cfg.pwd, ctx->cfg.pwd_len, pbkdf_salt, pbkdf_salt_len, kek, kek_len);
 	}
 	HCRYPT_PRINTKEY(ctx->cfg.pwd, ctx->cfg.pwd_len, "pwd");
 	HCRYPT_PRINTKEY(kek, kek_len, "kek");
@@ -92,6 +92,26 @@ int HaiCrypt_Tx_GetKeyFlags(HaiCrypt_Handle hhc)
 	return(hcryptCtx_GetKeyFlags(crypto->ctx));
 }
 
+/*
+ * XOR a word at a time; the compiler turns this into vector instructions
+ * where the target has them.
+ */
+static void hcrypt_XorKeystream(unsigned char *data, const unsigned char *strm, size_t len)
+{
+	size_t i = 0;
+
+	for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+		uint64_t d, k;
+		memcpy(&d, &data[i], sizeof(d));
+		memcpy(&k, &strm[i], sizeof(k));
+		d ^= k;
+		memcpy(&data[i], &d, sizeof(d));
+	}
+	for (; i < len; i++) {
+		data[i] ^= strm[i];
+	}
+}
+
 int HaiCrypt_Tx_Data(HaiCrypt_Handle hhc,
 	unsigned char *in_pfx, unsigned char *in_data, size_t in_len)
 {
@@ -112,6 +132,20 @@ int HaiCrypt_Tx_Data(HaiCrypt_Handle hhc,
 		HCRYPT_LOG(LOG_ERR, "Tx_Data: Key mismatch!");
 	}
 
+	/* Use the keystream precomputed for this packet, if any */
+	if (NULL != crypto->ks.slot && HCRYPT_CTX_MODE_AESCTR == ctx->mode) {
+		hcrypt_Pki pki = hcryptMsg_GetPki(ctx->msg_info, in_pfx, 0);
+		hcrypt_KsSlot *slot = &crypto->ks.slot[pki % crypto->ks.nslots];
+
+		if (slot->pki == pki && slot->kk == hcryptCtx_GetKeyIndex(ctx) && slot->len >= in_len) {
+			hcrypt_XorKeystream(in_data, &crypto->ks.stream[(slot - crypto->ks.slot) * crypto->ks.slot_siz], in_len);
+			crypto->ks.hits++;
+			ctx->pkt_cnt++;
+			return(0);
+		}
+		crypto->ks.misses++;
+	}
+
 	/* Encrypt */
 	{
 		hcrypt_DataDesc indata;
@@ -173,3 +207,97 @@ int HaiCrypt_Tx_Process(HaiCrypt_Handle hhc,
 
 	return(nbout);
 }
+
+int HaiCrypt_Tx_SetKeystreamCache(HaiCrypt_Handle hhc, int npkts)
+{
+	hcrypt_Session *crypto = (hcrypt_Session *)hhc;
+	hcrypt_KsSlot *slot = NULL;
+	unsigned char *stream = NULL;
+	size_t slot_siz;
+
+	if ((NULL == crypto)
+	||  (NULL == crypto->ctx)
+	||  (0 > npkts)) {
+		HCRYPT_LOG(LOG_ERR, "SetKeystreamCache: invalid params: crypto=%p npkts=%d\n", crypto, npkts);
+		return(-1);
+	}
+	if ((0 < npkts) && (HCRYPT_CTX_MODE_AESCTR != crypto->ctx->mode)) {
+		HCRYPT_LOG(LOG_ERR, "SetKeystreamCache: not supported in cipher mode %u\n", crypto->ctx->mode);
+		return(-1);
+	}
+
+	slot_siz = hcryptMsg_PaddedLen(crypto->cfg.data_max_len, CRYSPR_AESBLKSZ);
+	if (0 < npkts) {
+		slot = calloc(npkts, sizeof(*slot));
+		stream = malloc(npkts * slot_siz);
+		if ((NULL == slot) || (NULL == stream)) {
+			HCRYPT_LOG(LOG_ERR, "%s\n", "malloc failed");
+			free(slot);
+			free(stream);
+			return(-1);
+		}
+	}
+
+	free(crypto->ks.slot);
+	free(crypto->ks.stream);
+	crypto->ks.slot = slot;
+	crypto->ks.stream = stream;
+	crypto->ks.slot_siz = slot_siz;
+	crypto->ks.nslots = npkts;
+	return(0);
+}
+
+int HaiCrypt_Tx_PrecomputeKeystream(HaiCrypt_Handle hhc, uint32_t pki, int npkts, size_t len)
+{
+	hcrypt_Session *crypto = (hcrypt_Session *)hhc;
+	hcrypt_Ctx *ctx = NULL;
+	unsigned kk;
+	int i, nbout = 0;
+
+	if ((NULL == crypto)
+	||  (NULL == (ctx = crypto->ctx))) {
+		HCRYPT_LOG(LOG_ERR, "PrecomputeKeystream: invalid params: crypto=%p crypto->ctx=%p\n", crypto, ctx);
+		return(-1);
+	}
+	if (NULL == crypto->ks.slot) {
+		return(0);
+	}
+
+	/* More packets than slots would overwrite the first ones */
+	if (npkts > (int)crypto->ks.nslots)
+		npkts = (int)crypto->ks.nslots;
+	if (len > crypto->cfg.data_max_len)
+		len = crypto->cfg.data_max_len;
+
+	kk = hcryptCtx_GetKeyIndex(ctx);
+	for (i = 0; i < npkts; i++, pki++) {
+		hcrypt_KsSlot *slot = &crypto->ks.slot[pki % crypto->ks.nslots];
+
+		if (slot->pki == pki && slot->kk == kk && slot->len >= len)
+			continue;
+
+		slot->len = 0;
+		if (crysprHelper_CtrKeystream(crypto->cryspr_cb, ctx, pki, len,
+				&crypto->ks.stream[(slot - crypto->ks.slot) * crypto->ks.slot_siz])) {
+			HCRYPT_LOG(LOG_ERR, "%s\n", "keystream computation failed");
+			return(-1);
+		}
+		slot->pki = pki;
+		slot->kk = kk;
+		slot->len = len;
+		nbout++;
+	}
+	return(nbout);
+}
+
+int HaiCrypt_Tx_GetKeystreamStats(HaiCrypt_Handle hhc, unsigned *hits, unsigned *misses)
+{
+	hcrypt_Session *crypto = (hcrypt_Session *)hhc;
+
+	if (NULL == crypto) {
+		return(-1);
+	}
+	*hits = crypto->ks.hits;
+	*misses = crypto->ks.misses;
+	return(0);
+}
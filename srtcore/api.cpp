@@ -63,6 +63,7 @@ modified by
 #include "netinet_any.h"
 #include "api.h"
 #include "core.h"
+#include "crypto.h"
 #include "epoll.h"
 #include "logging.h"
 #include "threadname.h"
@@ -180,6 +181,7 @@ srt::CUDTUnited::CUDTUnited()
     , m_GlobControlLock()
     , m_IDLock()
     , m_mMultiplexer()
+    , m_iShardMuxID(-1)
     , m_pCache(new CCache<CInfoBlock>)
     , m_bClosing(false)
     , m_GCStopCond()
@@ -425,6 +427,7 @@ int srt::CUDTUnited::cleanupAtFork()
 {
     cleanupAllSockets();
     resetThread(&m_GCThread);
+    m_TsbpdPool.resetAtFork();
     resetCond(m_GCStopCond);
     m_GCStopLock.unlock();
     setupCond(m_GCStopCond, "GCStop");
@@ -450,6 +453,10 @@ int srt::CUDTUnited::cleanup()
 
     stopGarbageCollector();
     closeAllSockets();
+    m_TsbpdPool.stop();
+
+    // Don't keep the passphrases and their KEKs past the last srt_cleanup().
+    CKekCache::instance().clear();
     return 0;
 }
 
@@ -619,6 +626,7 @@ SRTSOCKET srt::CUDTUnited::newSocket(CUDTSocket** pps)
 int srt::CUDTUnited::newConnection(const SRTSOCKET     listen,
                                    const sockaddr_any& peer,
                                    const CPacket&      hspkt,
+                                   const CRcvQueue*    rcvq,
                                    CHandShake&         w_hs,
                                    int&                w_error,
                                    CUDT*&              w_acpu)
@@ -772,7 +780,7 @@ int srt::CUDTUnited::newConnection(const SRTSOCKET     listen,
 
         // bind to the same addr of listening socket
         ns->core().open();
-        if (!updateListenerMux(ns, ls))
+        if (!updateListenerMux(ns, ls, rcvq))
         {
             // This is highly unlikely if not impossible, but there's
             // a theoretical runtime chance of failure so it should be
@@ -1164,6 +1172,31 @@ int srt::CUDTUnited::listen(const SRTSOCKET u, int backlog)
 
     s->core().setListenState(); // propagates CUDTException,
                                 // if thrown, remains in OPENED state if so.
+
+    // Connection requests may come through any of the shards.
+    vector<CRcvQueue*> shards;
+    try
+    {
+        ExclusiveLock glock(m_GlobControlLock);
+        // Only a listener opens the other shards: the system hashes the
+        // incoming packets to any of them, and only the listener's
+        // connections are dispatched between the shards.
+        CMultiplexer* mux = map_getp(m_mMultiplexer, s->m_iMuxID);
+        if (mux && mux->m_iShardGroup == mux->m_iID && shardRcvQueues(s).empty())
+            openShardMuxers(*mux, s);
+        shards = shardRcvQueues(s);
+    }
+    catch (...)
+    {
+        s->core().notListening();
+        throw;
+    }
+    if (!setShardListener(shards, &s->core(), true))
+    {
+        setShardListener(shards, &s->core(), false);
+        s->core().notListening();
+        throw CUDTException(MJ_NOTSUP, MN_BUSY, 0);
+    }
     s->m_Status = SRTS_LISTENING;
 
     return 0;
@@ -1996,6 +2029,14 @@ int srt::CUDTUnited::groupConnect(CUDTGroup* pg, SRT_SOCKGROUPCONFIG* targets, i
 int srt::CUDTUnited::connectIn(CUDTSocket* s, const sockaddr_any& target_addr, int32_t forced_isn)
 {
     ScopedLock cg(s->m_ControlLock);
+
+    // The replies to a caller or rendezvous socket would be spread by the
+    // system among all shards, while only the listener dispatches them.
+    if (s->core().m_config.iListenShards > 1)
+    {
+        LOGC(cnlog.Error, log << "srt_connect: @" << s->m_SocketID << " has SRTO_LISTENSHARDS set; only a listener can use it");
+        throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+    }
     // a socket can "connect" only if it is in the following states:
     // - OPENED: assume the socket binding parameters are configured
     // - INIT: configure binding parameters here
@@ -2171,6 +2212,12 @@ int srt::CUDTUnited::close(CUDTSocket* s)
 
         HLOGC(smlog.Debug, log << s->core().CONID() << "CLOSING (removing listener immediately)");
         s->core().notListening();
+        vector<CRcvQueue*> shards;
+        {
+            SharedLock glock(m_GlobControlLock);
+            shards = shardRcvQueues(s);
+        }
+        setShardListener(shards, &s->core(), false);
         s->m_Status = SRTS_CLOSING;
 
         // broadcast all "accept" waiting
@@ -2184,7 +2231,11 @@ int srt::CUDTUnited::close(CUDTSocket* s)
         // may block INDEFINITELY. As long as it's acceptable to block the
         // call to srt_close(), and all functions in all threads where this
         // very socket is used, this shall not block the central database.
-        s->core().closeInternal();
+        if (s->core().closeInternal())
+        {
+            // The zero-copy user data are released before srt_close() returns.
+            s->core().waitSndBatchOut();
+        }
 
         // synchronize with garbage collection.
         HLOGC(smlog.Debug,
@@ -2563,10 +2614,23 @@ int srt::CUDTUnited::epoll_add_usock(const int eid, const SRTSOCKET u, const int
 // NOTE: WILL LOCK (serially):
 // - CEPoll::m_EPollLock
 // - CUDT::m_RecvLock
+// - CUDTSocket::m_AcceptLock (listener only)
 int srt::CUDTUnited::epoll_add_usock_INTERNAL(const int eid, CUDTSocket* s, const int* events)
 {
     int ret = m_EPoll.update_usock(eid, s->m_SocketID, events);
     s->core().addEPoll(eid);
+
+    // Connections queued before the EID was subscribed have already
+    // reported SRT_EPOLL_ACCEPT to the EIDs known at that time.
+    if (s->m_Status == SRTS_LISTENING)
+    {
+        enterCS(s->m_AcceptLock);
+        const bool pending = !s->m_QueuedSockets.empty();
+        leaveCS(s->m_AcceptLock);
+
+        if (pending)
+            m_EPoll.update_events(s->m_SocketID, s->core().m_sPollID, SRT_EPOLL_ACCEPT, true);
+    }
     return ret;
 }
 
@@ -3041,8 +3105,13 @@ void srt::CUDTUnited::removeSocket(const SRTSOCKET u)
    //
    // Report: P04-1.28, P04-2.27, P04-2.50, P04-2.55
 
+    // The shards must not pass any more requests to the deleted listener.
+    // They stay alive until this socket releases its multiplexer below.
+    const vector<CRcvQueue*> shards = shardRcvQueues(s);
+
     HLOGC(smlog.Debug, log << "GC/removeSocket: closing associated UDT @" << u);
     leaveCS(m_GlobControlLock);
+    setShardListener(shards, &s->core(), false);
     s->core().closeInternal();
     enterCS(m_GlobControlLock);
     HLOGC(smlog.Debug, log << "GC/removeSocket: DELETING SOCKET @" << u);
@@ -3067,7 +3136,11 @@ void srt::CUDTUnited::removeSocket(const SRTSOCKET u)
 
     mx.m_iRefCount--;
     HLOGC(smlog.Debug, log << "unrefing underlying muxer " << mid << " for @" << u << ", ref=" << mx.m_iRefCount);
-    if (0 == mx.m_iRefCount)
+    if (0 == mx.m_iRefCount && mx.m_iShardGroup != -1)
+    {
+        releaseShardMuxers(mx.m_iShardGroup);
+    }
+    else if (0 == mx.m_iRefCount)
     {
         HLOGC(smlog.Debug,
               log << "MUXER id=" << mid << " lost last socket @" << u << " - deleting muxer bound to port "
@@ -3103,6 +3176,121 @@ uint16_t srt::CUDTUnited::installMuxer(CUDTSocket* w_s, CMultiplexer& fw_sm)
     return sa.hport();
 }
 
+void srt::CUDTUnited::openShardMuxers(const CMultiplexer& first, const CUDTSocket* s)
+{
+    sockaddr_any sa;
+    first.m_pChannel->getSockAddr((sa));
+
+    vector<int> opened;
+    try
+    {
+        for (int i = 1; i < first.m_mcfg.iListenShards; ++i)
+        {
+            const int id = --m_iShardMuxID;
+            opened.push_back(id);
+
+            CMultiplexer& m = m_mMultiplexer[id];
+            m.m_mcfg        = first.m_mcfg;
+            m.m_iIPversion  = first.m_iIPversion;
+            m.m_iPort       = first.m_iPort;
+            m.m_iID         = id;
+            m.m_iShardGroup = first.m_iID;
+            // Shards are used by the accepted sockets only.
+            m.m_iRefCount = 0;
+
+            m.m_pChannel = new CChannel();
+            m.m_pChannel->setConfig(m.m_mcfg);
+            m.m_pChannel->open(sa);
+
+            m.m_pTimer = new CTimer;
+            if (m.m_mcfg.iCryptoWorkers > 0)
+            {
+                m.m_pCryptoPool = new CCryptoPool;
+                m.m_pCryptoPool->init(m.m_mcfg.iCryptoWorkers);
+            }
+            m.m_pSndQueue = new CSndQueue;
+            m.m_pSndQueue->init(m.m_pChannel, m.m_pTimer, m.m_mcfg.iUDPSndBatch, m.m_mcfg.iSndWorkers, m.m_pCryptoPool);
+            m.m_pRcvQueue = new CRcvQueue;
+            m.m_pRcvQueue->init(128, s->core().maxPayloadSize(), m.m_iIPversion, 1024, m.m_pChannel, m.m_pTimer,
+                                m.m_mcfg.iUDPRcvBatch, m.m_pCryptoPool);
+
+            HLOGC(smlog.Debug, log << "listen: opened shard " << i << " id=" << id << " of multiplexer " << first.m_iID);
+        }
+    }
+    catch (...)
+    {
+        for (size_t i = 0; i < opened.size(); ++i)
+        {
+            m_mMultiplexer[opened[i]].destroy();
+            m_mMultiplexer.erase(opened[i]);
+        }
+        throw;
+    }
+}
+
+void srt::CUDTUnited::releaseShardMuxers(int group)
+{
+    // The system spreads the incoming traffic among all UDP sockets
+    // bound to the address, so removing one of them would redirect
+    // packets of the connections served by the others.
+    for (map<int, CMultiplexer>::iterator i = m_mMultiplexer.begin(); i != m_mMultiplexer.end(); ++i)
+    {
+        if (i->second.m_iShardGroup == group && i->second.m_iRefCount > 0)
+            return;
+    }
+
+    for (map<int, CMultiplexer>::iterator i = m_mMultiplexer.begin(); i != m_mMultiplexer.end();)
+    {
+        CMultiplexer& mx = i->second;
+        if (mx.m_iShardGroup != group)
+        {
+            ++i;
+            continue;
+        }
+
+        HLOGC(smlog.Debug, log << "MUXER id=" << mx.m_iID << " of shard group " << group << " - deleting");
+        mx.m_pSndQueue->setClosing();
+        mx.m_pRcvQueue->setClosing();
+        mx.destroy();
+        m_mMultiplexer.erase(i++);
+    }
+}
+
+vector<srt::CRcvQueue*> srt::CUDTUnited::shardRcvQueues(const CUDTSocket* s)
+{
+    vector<CRcvQueue*> shards;
+
+    const CMultiplexer* mux = map_getp(m_mMultiplexer, s->m_iMuxID);
+    if (!mux || mux->m_iShardGroup == -1)
+        return shards;
+
+    for (map<int, CMultiplexer>::iterator i = m_mMultiplexer.begin(); i != m_mMultiplexer.end(); ++i)
+    {
+        const CMultiplexer& m = i->second;
+        if (m.m_iShardGroup == mux->m_iShardGroup && m.m_iID != mux->m_iID)
+            shards.push_back(m.m_pRcvQueue);
+    }
+    return shards;
+}
+
+bool srt::CUDTUnited::setShardListener(const vector<CRcvQueue*>& shards, CUDT* u, bool listen)
+{
+    bool ok = true;
+    for (size_t i = 0; i < shards.size(); ++i)
+    {
+        if (listen)
+        {
+            if (!shards[i]->setListener(u))
+                ok = false;
+        }
+        else
+        {
+            shards[i]->removeListener(u);
+        }
+    }
+    return ok;
+}
+
 bool srt::CUDTUnited::inet6SettingsCompat(const sockaddr_any& muxaddr, const CSrtMuxerConfig& cfgMuxer,
         const sockaddr_any& reqaddr, const CSrtMuxerConfig& cfgSocket)
 {
@@ -3416,15 +3604,27 @@ void srt::CUDTUnited::updateMux(CUDTSocket* s, const sockaddr_any& reqaddr, cons
             m.m_mcfg.iIpV6Only = m.m_pChannel->sockopt(IPPROTO_IPV6, IPV6_V6ONLY, -1);
         }
 
-        m.m_pTimer    = new CTimer;
+        m.m_pTimer = new CTimer;
+        if (m.m_mcfg.iCryptoWorkers > 0)
+        {
+            m.m_pCryptoPool = new CCryptoPool;
+            m.m_pCryptoPool->init(m.m_mcfg.iCryptoWorkers);
+        }
         m.m_pSndQueue = new CSndQueue;
-        m.m_pSndQueue->init(m.m_pChannel, m.m_pTimer);
+        m.m_pSndQueue->init(m.m_pChannel, m.m_pTimer, m.m_mcfg.iUDPSndBatch, m.m_mcfg.iSndWorkers, m.m_pCryptoPool);
         m.m_pRcvQueue = new CRcvQueue;
-        m.m_pRcvQueue->init(128, s->core().maxPayloadSize(), m.m_iIPversion, 1024, m.m_pChannel, m.m_pTimer);
+        m.m_pRcvQueue->init(128, s->core().maxPayloadSize(), m.m_iIPversion, 1024, m.m_pChannel, m.m_pTimer,
+                            m.m_mcfg.iUDPRcvBatch, m.m_pCryptoPool);
 
         // Rewrite the port here, as it might be only known upon return
         // from CChannel::open.
         m.m_iPort               = installMuxer((s), m);
+
+        // The channel is bound with SO_REUSEPORT, but the other shards
+        // are only opened by listen(). A given UDP socket can't be shared
+        // this way.
+        if (m.m_mcfg.iListenShards > 1 && !udpsock)
+            m.m_iShardGroup = m.m_iID;
         swap(m_mMultiplexer[m.m_iID],m);
     }
     catch (const CUDTException&)
@@ -3446,7 +3646,7 @@ void srt::CUDTUnited::updateMux(CUDTSocket* s, const sockaddr_any& reqaddr, cons
 // exists, otherwise the dispatching procedure wouldn't even call this
 // function. By historical reasons there's also a fallback for a case when the
 // multiplexer wasn't found by id, the search by port number continues.
-bool srt::CUDTUnited::updateListenerMux(CUDTSocket* s, const CUDTSocket* ls)
+bool srt::CUDTUnited::updateListenerMux(CUDTSocket* s, const CUDTSocket* ls, const CRcvQueue* rcvq)
 {
     ExclusiveLock cg(m_GlobControlLock);
     const int  port = ls->m_SelfAddr.hport();
@@ -3461,6 +3661,22 @@ bool srt::CUDTUnited::updateListenerMux(CUDTSocket* s, const CUDTSocket* ls)
 
     CMultiplexer* mux = map_getp(m_mMultiplexer, ls->m_iMuxID);
 
+    // The request might have come through another shard of the listener's
+    // multiplexer. The system sends there all packets from this peer, so
+    // the new socket must stay with that shard.
+    if (mux && mux->m_iShardGroup != -1 && mux->m_pRcvQueue != rcvq)
+    {
+        for (map<int, CMultiplexer>::iterator i = m_mMultiplexer.begin(); i != m_mMultiplexer.end(); ++i)
+        {
+            if (i->second.m_iShardGroup == mux->m_iShardGroup && i->second.m_pRcvQueue == rcvq)
+            {
+                HLOGC(smlog.Debug, log << "updateListenerMux: using shard muxer id=" << i->second.m_iID);
+                mux = &i->second;
+                break;
+            }
+        }
+    }
+
     // NOTE:
     // THIS BELOW CODE is only for a highly unlikely situation when the listener
     // socket has been closed in the meantime when the accepted socket is being
@@ -4081,6 +4297,36 @@ int srt::CUDT::sendmsg2(SRTSOCKET u, const char* buf, int len, SRT_MSGCTRL& w_m)
     }
 }
 
+int srt::CUDT::sendmsgZeroCopy(SRTSOCKET u, const char* buf, int len, SRT_MSGCTRL& w_m, srt_sendbuf_release_fn* release_fn, void* opaque)
+{
+    try
+    {
+        if (!release_fn)
+            throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+
+#if ENABLE_BONDING
+        // The members keep their own copies of the payload.
+        if (u & SRTGROUP_MASK)
+            throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+#endif
+
+        return uglobal().locateSocket(u, CUDTUnited::ERH_THROW)->core().sendmsg2(buf, len, (w_m), release_fn, opaque);
+    }
+    catch (const CUDTException& e)
+    {
+        return APIError(e);
+    }
+    catch (bad_alloc&)
+    {
+        return APIError(MJ_SYSTEMRES, MN_MEMORY, 0);
+    }
+    catch (const std::exception& ee)
+    {
+        LOGC(aclog.Fatal, log << "sendmsg: UNEXPECTED EXCEPTION: " << typeid(ee).name() << ": " << ee.what());
+        return APIError(MJ_UNKNOWN, MN_NONE, 0);
+    }
+}
+
 int srt::CUDT::recv(SRTSOCKET u, char* buf, int len, int)
 {
     SRT_MSGCTRL mctrl = srt_msgctrl_default;
@@ -4121,6 +4367,57 @@ int srt::CUDT::recvmsg2(SRTSOCKET u, char* buf, int len, SRT_MSGCTRL& w_m)
     }
 }
 
+int srt::CUDT::recvmsgZeroCopy(SRTSOCKET u, SRT_RCVLOAN* loan, SRT_MSGCTRL& w_m)
+{
+    try
+    {
+        if (!loan)
+            throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+
+#if ENABLE_BONDING
+        // The group reads the members' packets into its own buffer.
+        if (u & SRTGROUP_MASK)
+            throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+#endif
+
+        return uglobal().locateSocket(u, CUDTUnited::ERH_THROW)->core().recvmsgZeroCopy((*loan), (w_m));
+    }
+    catch (const CUDTException& e)
+    {
+        return APIError(e);
+    }
+    catch (bad_alloc&)
+    {
+        return APIError(MJ_SYSTEMRES, MN_MEMORY, 0);
+    }
+    catch (const std::exception& ee)
+    {
+        LOGC(aclog.Fatal, log << "recvmsg: UNEXPECTED EXCEPTION: " << typeid(ee).name() << ": " << ee.what());
+        return APIError(MJ_UNKNOWN, MN_NONE, 0);
+    }
+}
+
+int srt::CUDT::releaseRecvLoan(SRTSOCKET u, const SRT_RCVLOAN* loan)
+{
+    try
+    {
+        if (!loan)
+            throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+
+        uglobal().locateSocket(u, CUDTUnited::ERH_THROW)->core().releaseRecvLoan(*loan);
+        return 0;
+    }
+    catch (const CUDTException& e)
+    {
+        return APIError(e);
+    }
+    catch (const std::exception& ee)
+    {
+        LOGC(aclog.Fatal, log << "recvmsg_release: UNEXPECTED EXCEPTION: " << typeid(ee).name() << ": " << ee.what());
+        return APIError(MJ_UNKNOWN, MN_NONE, 0);
+    }
+}
+
 int64_t srt::CUDT::sendfile(SRTSOCKET u, fstream& ifs, int64_t& offset, int64_t size, int block)
 {
     try
@@ -4896,8 +5193,25 @@ void setloghandler(void* opaque, SRT_LOG_HANDLER_FN* handler)
 
 void setlogflags(int flags)
 {
-    ScopedLock gg(srt_logger_config.mutex);
-    srt_logger_config.flags = flags;
+    {
+        ScopedLock gg(srt_logger_config.mutex);
+        srt_logger_config.flags = flags;
+    }
+
+#if ENABLE_LOGGING
+    // Write out the queued records before the ones written synchronously.
+    if ((flags & SRT_LOGF_ASYNC) == 0)
+        srt_logging::LogQueue::instance().flush();
+#endif
+}
+
+int64_t getlogoverflow()
+{
+#if ENABLE_LOGGING
+    return int64_t(srt_logging::LogQueue::instance().overflow());
+#else
+    return 0;
+#endif
 }
 
 SRT_API bool setstreamid(SRTSOCKET u, const std::string& sid)
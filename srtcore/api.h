@@ -239,6 +239,8 @@ class CUDTUnited
     friend class CUDT;
     friend class CUDTGroup;
     friend class CRendezvousQueue;
+    friend class CSndQueue;
+    friend class CRcvQueue;
     friend class CCryptoControl;
 
 public:
@@ -274,6 +276,8 @@ public:
     /// Create (listener-side) a new socket associated with the incoming connection request.
     /// @param [in] listen the listening socket ID.
     /// @param [in] peer peer address.
+    /// @param [in] hspkt the handshake packet.
+    /// @param [in] rcvq the receiving queue that got the request; the new socket uses its multiplexer.
     /// @param [in,out] hs handshake information from peer side (in), negotiated value (out);
     /// @param [out] w_error error code in case of failure.
     /// @param [out] w_acpu reference to the existing associated socket if already exists.
@@ -284,6 +288,7 @@ public:
     int newConnection(const SRTSOCKET     listen,
                       const sockaddr_any& peer,
                       const CPacket&      hspkt,
+                      const CRcvQueue*    rcvq,
                       CHandShake&         w_hs,
                       int&                w_error,
                       CUDT*&              w_acpu);
@@ -374,6 +379,7 @@ public:
 #endif
 
     CEPoll& epoll_ref() { return m_EPoll; }
+    CTsbpdPool& tsbpdPool() { return m_TsbpdPool; }
 
 private:
     /// Generates a new socket ID. This function starts from a randomly
@@ -515,12 +521,30 @@ public:
 private:
 
     void updateMux(CUDTSocket* s, const sockaddr_any& addr, const UDPSOCKET* = NULL);
-    bool updateListenerMux(CUDTSocket* s, const CUDTSocket* ls);
+    bool updateListenerMux(CUDTSocket* s, const CUDTSocket* ls, const CRcvQueue* rcvq);
 
     // Utility functions for updateMux
     void     configureMuxer(CMultiplexer& w_m, const CUDTSocket* s, int af);
     uint16_t installMuxer(CUDTSocket* w_s, CMultiplexer& sm);
 
+    /// Open the multiplexers bound with SO_REUSEPORT to the address of
+    /// @a first, which completes the group of SRTO_LISTENSHARDS shards.
+    void openShardMuxers(const CMultiplexer& first, const CUDTSocket* s);
+
+    /// Delete the multiplexers of the shard group @a group if none
+    /// of them is used by any socket.
+    void releaseShardMuxers(int group);
+
+    /// Get the receiving queues of the other multiplexers in the shard
+    /// group of the multiplexer of @a s. Requires m_GlobControlLock.
+    std::vector<CRcvQueue*> shardRcvQueues(const CUDTSocket* s);
+
+    /// Set or remove the listener @a u on the receiving queues @a shards.
+    /// Must not be called with m_GlobControlLock held, as the listener
+    /// slot is locked by the receiving threads before m_GlobControlLock.
+    /// @return false if some other listener occupies any of them
+    static bool setShardListener(const std::vector<CRcvQueue*>& shards, CUDT* u, bool listen);
+
     /// @brief Checks if channel configuration matches the socket configuration.
     /// @param cfgMuxer multiplexer configuration.
     /// @param cfgSocket socket configuration.
@@ -533,6 +557,9 @@ private:
     SRT_ATTR_GUARDED_BY(m_GlobControlLock)
     std::map<int, CMultiplexer> m_mMultiplexer; // UDP multiplexer
 
+    SRT_ATTR_GUARDED_BY(m_GlobControlLock)
+    int m_iShardMuxID; // The last ID given to a shard multiplexer, negative not to collide with socket IDs
+
     /// UDT network information cache.
     /// Existence is guarded by m_GlobControlLock, but the cache itself is thread-safe.
     SRT_ATTR_GUARDED_BY(m_GlobControlLock)
@@ -566,6 +593,8 @@ private:
 
     CEPoll m_EPoll; // handling epoll data structures and events
 
+    CTsbpdPool m_TsbpdPool; // shared TSBPD threads for sockets with SRTO_TSBPDSHARED
+
 private:
     CUDTUnited(const CUDTUnited&);
     CUDTUnited& operator=(const CUDTUnited&);
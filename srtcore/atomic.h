@@ -175,6 +175,31 @@ public:
 #endif
   }
 
+  /// @brief Adds @a val to the atomic object, with no ordering constraint
+  /// on the surrounding memory accesses. Suitable for counters that are
+  /// only read as values on their own, such as statistics.
+  /// @returns The old value of the atomic object.
+  T fetch_add_relaxed(const T val) {
+#if defined(ATOMIC_USE_SRT_SYNC_MUTEX) && (ATOMIC_USE_SRT_SYNC_MUTEX == 1)
+    ScopedLock lg_(mutex_);
+    const T t = value_;
+    value_ += val;
+    return t;
+#elif defined(ATOMIC_USE_GCC_INTRINSICS)
+    return __atomic_fetch_add(&value_, val, __ATOMIC_RELAXED);
+#elif defined(ATOMIC_USE_MSVC_INTRINSICS)
+    T old_val;
+    do {
+      old_val = value_;
+    } while (msvc::interlocked<T>::compare_exchange(&value_, static_cast<T>(old_val + val), old_val) != old_val);
+    return old_val;
+#elif defined(ATOMIC_USE_CPP11_ATOMIC)
+    return value_.fetch_add(val, std::memory_order_relaxed);
+#else
+    #error "Implement Me."
+#endif
+  }
+
   T operator|=(T i) {
 #if defined(ATOMIC_USE_SRT_SYNC_MUTEX) && (ATOMIC_USE_SRT_SYNC_MUTEX == 1)
     ScopedLock lg_(mutex_);
@@ -146,6 +146,15 @@ CRcvBuffer::~CRcvBuffer()
         m_pUnitQueue->makeUnitFree(it->pUnit);
         it->pUnit = NULL;
     }
+
+    // The application can't use the lent payloads any longer.
+    while (!m_Loans.empty())
+    {
+        SRT_RCVLOAN loan;
+        loan.segs  = m_Loans.begin()->first;
+        loan.nsegs = 0;
+        releaseLoan(loan);
+    }
 }
 
 int CRcvBuffer::insert(CUnit* unit)
@@ -206,6 +215,35 @@ int CRcvBuffer::insert(CUnit* unit)
     return 0;
 }
 
+int CRcvBuffer::probe(int32_t seqno) const
+{
+    const int offset = CSeqNo::seqoff(m_iStartSeqNo, seqno);
+    if (offset < 0)
+        return -2;
+
+    if (offset >= (int)capacity())
+        return -3;
+
+    const int pos = (m_iStartPos + offset) % m_szSize;
+    if (m_entries[pos].status != EntryState_Empty)
+        return -1;
+
+    return 0;
+}
+
+int32_t CRcvBuffer::getMsgNoAt(int32_t seqno) const
+{
+    const int offset = CSeqNo::seqoff(m_iStartSeqNo, seqno);
+    if (offset < 0 || offset >= m_iMaxPosOff)
+        return SRT_MSGNO_NONE;
+
+    const int pos = (m_iStartPos + offset) % m_szSize;
+    if (m_entries[pos].status != EntryState_Avail)
+        return SRT_MSGNO_NONE;
+
+    return packetAt(pos).getMsgSeq(m_bPeerRexmitFlag);
+}
+
 std::pair<int, int> CRcvBuffer::dropUpTo(int32_t seqno)
 {
     IF_RCVBUF_DEBUG(ScopedLog scoped_log);
@@ -391,6 +429,44 @@ int CRcvBuffer::dropMessage(int32_t seqnolo, int32_t seqnohi, int32_t msgno, Dro
 }
 
 int CRcvBuffer::readMessage(char* data, size_t len, SRT_MSGCTRL* msgctrl)
+{
+    return extractMessage(data, len, msgctrl, NULL);
+}
+
+int CRcvBuffer::lendMessage(SRT_RCVLOAN& w_loan, SRT_MSGCTRL* msgctrl)
+{
+    std::vector<CUnit*> units;
+    const int bytes = extractMessage(NULL, 0, msgctrl, &units);
+    if (units.empty())
+        return bytes;
+
+    SRT_RCVSEG* segs = new SRT_RCVSEG[units.size()];
+    for (size_t i = 0; i < units.size(); ++i)
+    {
+        segs[i].data = units[i]->m_Packet.m_pcData;
+        segs[i].len  = (int) units[i]->m_Packet.getLength();
+    }
+    m_Loans[segs].swap(units);
+
+    w_loan.segs  = segs;
+    w_loan.nsegs = (int) m_Loans[segs].size();
+    return bytes;
+}
+
+bool CRcvBuffer::releaseLoan(const SRT_RCVLOAN& loan)
+{
+    loans_t::iterator it = m_Loans.find(loan.segs);
+    if (it == m_Loans.end())
+        return false;
+
+    for (size_t i = 0; i < it->second.size(); ++i)
+        m_pUnitQueue->makeUnitFree(it->second[i]);
+    delete[] it->first;
+    m_Loans.erase(it);
+    return true;
+}
+
+int CRcvBuffer::extractMessage(char* data, size_t len, SRT_MSGCTRL* msgctrl, std::vector<CUnit*>* w_units)
 {
     const bool canReadInOrder = hasReadableInorderPkts();
     if (!canReadInOrder && m_iFirstReadableOutOfOrder < 0)
@@ -422,11 +498,14 @@ int CRcvBuffer::readMessage(char* data, size_t len, SRT_MSGCTRL* msgctrl)
         const size_t   pktsize = packet.getLength();
         const int32_t pktseqno = packet.getSeqNo();
 
-        // unitsize can be zero
-        const size_t unitsize = std::min(remain, pktsize);
-        memcpy(dst, packet.m_pcData, unitsize);
-        remain -= unitsize;
-        dst += unitsize;
+        if (!w_units)
+        {
+            // unitsize can be zero
+            const size_t unitsize = std::min(remain, pktsize);
+            memcpy(dst, packet.m_pcData, unitsize);
+            remain -= unitsize;
+            dst += unitsize;
+        }
 
         ++pkts_read;
         bytes_extracted += (int) pktsize;
@@ -449,7 +528,16 @@ int CRcvBuffer::readMessage(char* data, size_t len, SRT_MSGCTRL* msgctrl)
         if (msgctrl)
             msgctrl->pktseq = pktseqno;
 
-        releaseUnitInPos(i);
+        if (w_units)
+        {
+            // The unit stays taken until the loan is released.
+            w_units->push_back(m_entries[i].pUnit);
+            m_entries[i] = Entry();
+        }
+        else
+        {
+            releaseUnitInPos(i);
+        }
         if (updateStartPos)
         {
             m_iStartPos = incPos(i);
@@ -486,6 +574,9 @@ int CRcvBuffer::readMessage(char* data, size_t len, SRT_MSGCTRL* msgctrl)
         // incase readable inorder packets are all read out.
         updateFirstReadableOutOfOrder();
 
+    if (w_units)
+        return bytes_extracted;
+
     const int bytes_read = int(dst - data);
     if (bytes_read < bytes_extracted)
     {
@@ -11,6 +11,8 @@
 #ifndef INC_SRT_BUFFER_RCV_H
 #define INC_SRT_BUFFER_RCV_H
 
+#include <map>
+#include <vector>
 #include "buffer_tools.h" // AvgBufSize
 #include "common.h"
 #include "queue.h"
@@ -64,6 +66,10 @@ public:
     // TODO: Previously '-2' also meant 'already acknowledged'. Check usage of this value.
     int insert(CUnit* unit);
 
+    /// Check if a packet with the given sequence number could be inserted.
+    /// @return the same values as insert()
+    int probe(int32_t seqno) const;
+
     /// Drop packets in the receiver buffer from the current position up to the seqno (excluding seqno).
     /// @param [in] seqno drop units up to this sequence number
     /// @return number of dropped (missing) and discarded (available) packets as a pair(dropped, discarded).
@@ -109,6 +115,24 @@ public:
     ///         -1 on failure.
     int readMessage(char* data, size_t len, SRT_MSGCTRL* msgctrl = NULL);
 
+    /// Read the whole message without copying it. The units of the message
+    /// are taken out of the buffer, but not freed until releaseLoan() is
+    /// called or the buffer is destroyed.
+    ///
+    /// @param [out] w_loan the payloads of the packets of the message.
+    /// @param [in,out] message control data
+    ///
+    /// @return the number of bytes of the message, 0 if nothing to read.
+    int lendMessage(SRT_RCVLOAN& w_loan, SRT_MSGCTRL* msgctrl = NULL);
+
+    /// Free the units of a message read by lendMessage().
+    /// @param [in] loan the loan as returned by lendMessage().
+    /// @return false if the loan wasn't made by this buffer or is already released.
+    bool releaseLoan(const SRT_RCVLOAN& loan);
+
+    /// The number of messages read by lendMessage() and not yet released.
+    size_t numLoans() const { return m_Loans.size(); }
+
     /// Read acknowledged data into a user buffer.
     /// @param [in, out] dst pointer to the target user buffer.
     /// @param [in] len length of user buffer.
@@ -187,6 +211,10 @@ public:
 
     PacketInfo getFirstReadablePacketInfo(time_point time_now) const;
 
+    /// Get the message number of the packet with the given sequence number.
+    /// @return the message number or SRT_MSGNO_NONE if the packet is not available.
+    int32_t getMsgNoAt(int32_t seqno) const;
+
     /// @brief Get the sequence number of the first packet that can't be read
     /// (either because it is missing, or because it is a part of a bigger message
     /// that is not fully available yet).
@@ -282,6 +310,11 @@ private:
     void updateNonreadPos();
     void releaseUnitInPos(int pos);
 
+    /// Read the message at the reading position, see readMessage().
+    /// If @a w_units is not NULL, the units are moved there instead
+    /// of copying their payload to @a data.
+    int extractMessage(char* data, size_t len, SRT_MSGCTRL* msgctrl, std::vector<CUnit*>* w_units);
+
     /// @brief Drop a unit from the buffer.
     /// @param pos position in the m_entries of the unit to drop.
     /// @return false if nothing to drop, true if the unit was dropped successfully.
@@ -370,6 +403,10 @@ private:
     bool m_bPeerRexmitFlag;         // Needed to read message number correctly
     const bool m_bMessageAPI;       // Operation mode flag: message or stream.
 
+    // The units lent by lendMessage(), by the array of segments handed out.
+    typedef std::map<const SRT_RCVSEG*, std::vector<CUnit*> > loans_t;
+    loans_t m_Loans;
+
 public: // TSBPD public functions
     /// Set TimeStamp-Based Packet Delivery Rx Mode
     /// @param [in] timebase localtime base (uSec) of packet time stamps including buffering delay
@@ -64,61 +64,58 @@ using namespace std;
 using namespace srt_logging;
 using namespace sync;
 
+namespace {
+int roundUpToPowerOf2(int size)
+{
+    int n = 1;
+    while (n < size)
+        n <<= 1;
+    return n;
+}
+}
+
 CSndBuffer::CSndBuffer(int ip_family, int size, int maxpld, int authtag)
     : m_BufLock()
-    , m_pBlock(NULL)
-    , m_pFirstBlock(NULL)
-    , m_pCurrBlock(NULL)
-    , m_pLastBlock(NULL)
+    , m_pBlocks(NULL)
+    , m_iMask(0)
+    , m_iStartPos(0)
+    , m_iCurrOff(0)
     , m_pBuffer(NULL)
     , m_iNextMsgNo(1)
-    , m_iSize(size)
+    , m_iSize(roundUpToPowerOf2(size))
+    , m_iUnitSize(size)
     , m_iBlockLen(maxpld)
     , m_iAuthTagSize(authtag)
     , m_iCount(0)
     , m_iBytesCount(0)
     , m_rateEstimator(ip_family)
+    , m_bReleased(false)
 {
-    // initial physical buffer of "size"
-    m_pBuffer           = new Buffer;
-    m_pBuffer->m_pcData = new char[m_iSize * m_iBlockLen];
-    m_pBuffer->m_iSize  = m_iSize;
-    m_pBuffer->m_pNext  = NULL;
-
-    // circular linked list for out bound packets
-    m_pBlock  = new Block;
-    Block* pb = m_pBlock;
-    char* pc  = m_pBuffer->m_pcData;
+    // circular buffer for out bound packets
+    m_pBlocks = new Block[m_iSize];
+    m_iMask   = m_iSize - 1;
 
     for (int i = 0; i < m_iSize; ++i)
     {
-        pb->m_iMsgNoBitset = 0;
-        pb->m_pcData       = pc;
-        pc                += m_iBlockLen;
-
-        if (i < m_iSize - 1)
-        {
-            pb->m_pNext        = new Block;
-            pb                 = pb->m_pNext;
-        }
+        m_pBlocks[i].m_iMsgNoBitset = 0;
+        m_pBlocks[i].m_pcData       = NULL;
+        m_pBlocks[i].m_pcOwnData    = NULL;
+        m_pBlocks[i].m_fnRelease    = NULL;
     }
-    pb->m_pNext = m_pBlock;
 
-    m_pFirstBlock = m_pCurrBlock = m_pLastBlock = m_pBlock;
+    // initial physical buffer of "size"
+    allocateData();
 
     setupMutex(m_BufLock, "Buf");
 }
 
 CSndBuffer::~CSndBuffer()
 {
-    Block* pb = m_pBlock->m_pNext;
-    while (pb != m_pBlock)
-    {
-        Block* temp = pb;
-        pb          = pb->m_pNext;
-        delete temp;
-    }
-    delete m_pBlock;
+    // The user data still referred to are no longer needed either.
+    collectReleased(m_iCount);
+    releaseAcked();
+
+    delete[] m_pBlocks;
 
     while (m_pBuffer != NULL)
     {
@@ -131,7 +128,8 @@ CSndBuffer::~CSndBuffer()
     releaseMutex(m_BufLock);
 }
 
-void CSndBuffer::addBuffer(const char* data, int len, SRT_MSGCTRL& w_mctrl)
+void CSndBuffer::addBuffer(const char* data, int len, SRT_MSGCTRL& w_mctrl,
+                           srt_sendbuf_release_fn* release_fn, void* opaque)
 {
     int32_t& w_msgno     = w_mctrl.msgno;
     int32_t& w_seqno     = w_mctrl.pktseq;
@@ -169,8 +167,6 @@ void CSndBuffer::addBuffer(const char* data, int len, SRT_MSGCTRL& w_mctrl)
     // If there's more than one packet, this function must increase it by itself
     // and then return the accordingly modified sequence number in the reference.
 
-    Block* s = m_pLastBlock;
-
     if (w_msgno == SRT_MSGNO_NONE) // DEFAULT-UNCHANGED msgno supplied
     {
         HLOGC(bslog.Debug, log << "addBuffer: using internally managed msgno=" << m_iNextMsgNo);
@@ -184,6 +180,7 @@ void CSndBuffer::addBuffer(const char* data, int len, SRT_MSGCTRL& w_mctrl)
 
     for (int i = 0; i < iNumBlocks; ++i)
     {
+        Block* s = &blockAt(m_iCount + i);
         int pktlen = len - i * iPktLen;
         if (pktlen > iPktLen)
             pktlen = iPktLen;
@@ -191,8 +188,20 @@ void CSndBuffer::addBuffer(const char* data, int len, SRT_MSGCTRL& w_mctrl)
         HLOGC(bslog.Debug,
               log << "addBuffer: %" << w_seqno << " #" << w_msgno << " offset=" << (i * iPktLen)
                   << " size=" << pktlen << " TO BUFFER:" << (void*)s->m_pcData);
-        memcpy((s->m_pcData), data + i * iPktLen, pktlen);
+        if (release_fn)
+        {
+            // The user data stay unchanged, so they can be sent as they are.
+            s->m_pcData = const_cast<char*>(data + i * iPktLen);
+        }
+        else
+        {
+            if (!s->m_pcOwnData)
+                s->m_pcOwnData = takeData();
+            s->m_pcData = s->m_pcOwnData;
+            memcpy((s->m_pcData), data + i * iPktLen, pktlen);
+        }
         s->m_iLength = pktlen;
+        s->m_fnRelease = NULL;
 
         s->m_iSeqNo = w_seqno;
         w_seqno     = CSeqNo::incseq(w_seqno);
@@ -212,12 +221,14 @@ void CSndBuffer::addBuffer(const char* data, int len, SRT_MSGCTRL& w_mctrl)
         s->m_iTTL = ttl;
         s->m_tsRexmitTime = time_point();
         s->m_tsOriginTime = m_tsLastOriginTime;
-        
-        // Should never happen, as the call to increase() should ensure enough buffers.
-        SRT_ASSERT(s->m_pNext);
-        s = s->m_pNext;
     }
-    m_pLastBlock = s;
+
+    if (release_fn)
+    {
+        Block& last           = blockAt(m_iCount + iNumBlocks - 1);
+        last.m_fnRelease      = release_fn;
+        last.m_pReleaseOpaque = opaque;
+    }
 
     m_iCount = m_iCount + iNumBlocks;
     m_iBytesCount += len;
@@ -245,25 +256,44 @@ int CSndBuffer::addBufferFromFile(fstream& ifs, int len)
           log << "addBufferFromFile: size=" << m_iCount << " reserved=" << m_iSize << " needs=" << iPktLen
               << " buffers for " << len << " bytes");
 
-    // dynamically increase sender buffer
-    while (iNumBlocks + m_iCount >= m_iSize)
+    // The blocks past m_iCount are not used by the sending thread,
+    // so they are filled without the lock and only published under it.
+    // Resizing moves the ring, so it must be done under the lock.
+    int first_free;
     {
-        HLOGC(bslog.Debug,
-              log << "addBufferFromFile: ... still lacking " << (iNumBlocks + m_iCount - m_iSize) << " buffers...");
-        increase();
+        ScopedLock bufferguard(m_BufLock);
+        // dynamically increase sender buffer
+        while (iNumBlocks + m_iCount >= m_iSize)
+        {
+            HLOGC(bslog.Debug,
+                  log << "addBufferFromFile: ... still lacking " << (iNumBlocks + m_iCount - m_iSize) << " buffers...");
+            increase();
+        }
+        first_free = (m_iStartPos + m_iCount) & m_iMask;
+
+        for (int i = 0; i < iNumBlocks; ++i)
+        {
+            Block& b = m_pBlocks[(first_free + i) & m_iMask];
+            if (!b.m_pcOwnData)
+                b.m_pcOwnData = takeData();
+        }
     }
 
     HLOGC(bslog.Debug,
           log << CONID() << "addBufferFromFile: adding " << iPktLen << " packets (" << len
               << " bytes) to send, msgno=" << m_iNextMsgNo);
 
-    Block* s     = m_pLastBlock;
-    int    total = 0;
+    int total   = 0;
+    int nblocks = 0;
     for (int i = 0; i < iNumBlocks; ++i)
     {
         if (ifs.bad() || ifs.fail() || ifs.eof())
             break;
 
+        Block* s = &m_pBlocks[(first_free + i) & m_iMask];
+        s->m_pcData    = s->m_pcOwnData;
+        s->m_fnRelease = NULL;
+
         int pktlen = len - i * iPktLen;
         if (pktlen > iPktLen)
             pktlen = iPktLen;
@@ -286,14 +316,13 @@ int CSndBuffer::addBufferFromFile(fstream& ifs, int len)
 
         s->m_iLength = pktlen;
         s->m_iTTL    = SRT_MSGTTL_INF;
-        s            = s->m_pNext;
 
         total += pktlen;
+        ++nblocks;
     }
-    m_pLastBlock = s;
 
     enterCS(m_BufLock);
-    m_iCount = m_iCount + iNumBlocks;
+    m_iCount = m_iCount + nblocks;
     m_iBytesCount += total;
 
     leaveCS(m_BufLock);
@@ -311,13 +340,15 @@ int CSndBuffer::readData(CPacket& w_packet, steady_clock::time_point& w_srctime,
     w_seqnoinc = 0;
 
     ScopedLock bufferguard(m_BufLock);
-    while (m_pCurrBlock != m_pLastBlock)
+    while (m_iCurrOff < m_iCount)
     {
+        Block* p = &blockAt(m_iCurrOff);
+
         // Make the packet REFLECT the data stored in the buffer.
-        w_packet.m_pcData = m_pCurrBlock->m_pcData;
-        readlen = m_pCurrBlock->m_iLength;
+        w_packet.m_pcData = p->m_pcData;
+        readlen = p->m_iLength;
         w_packet.setLength(readlen, m_iBlockLen);
-        w_packet.set_seqno(m_pCurrBlock->m_iSeqNo);
+        w_packet.set_seqno(p->m_iSeqNo);
 
         // 1. On submission (addBuffer), the KK flag is set to EK_NOENC (0).
         // 2. The readData() is called to get the original (unique) payload not ever sent yet.
@@ -339,13 +370,12 @@ int CSndBuffer::readData(CPacket& w_packet, steady_clock::time_point& w_srctime,
         }
         else
         {
-            m_pCurrBlock->m_iMsgNoBitset |= MSGNO_ENCKEYSPEC::wrap(kflgs);
+            p->m_iMsgNoBitset |= MSGNO_ENCKEYSPEC::wrap(kflgs);
         }
 
-        Block* p = m_pCurrBlock;
-        w_packet.set_msgflags(m_pCurrBlock->m_iMsgNoBitset);
-        w_srctime = m_pCurrBlock->m_tsOriginTime;
-        m_pCurrBlock = m_pCurrBlock->m_pNext;
+        w_packet.set_msgflags(p->m_iMsgNoBitset);
+        w_srctime = p->m_tsOriginTime;
+        ++m_iCurrOff;
 
         if ((p->m_iTTL >= 0) && (count_milliseconds(steady_clock::now() - w_srctime) > p->m_iTTL))
         {
@@ -370,56 +400,30 @@ int CSndBuffer::readData(CPacket& w_packet, steady_clock::time_point& w_srctime,
 CSndBuffer::time_point CSndBuffer::peekNextOriginal() const
 {
     ScopedLock bufferguard(m_BufLock);
-    if (m_pCurrBlock == m_pLastBlock)
+    if (m_iCurrOff == m_iCount)
         return time_point();
 
-    return m_pCurrBlock->m_tsOriginTime;
+    return blockAt(m_iCurrOff).m_tsOriginTime;
 }
 
 int32_t CSndBuffer::getMsgNoAt(const int offset)
 {
     ScopedLock bufferguard(m_BufLock);
 
-    Block* p = m_pFirstBlock;
-
-    if (p)
+    if (offset < 0 || offset >= m_iCount)
     {
-        HLOGC(bslog.Debug,
-              log << "CSndBuffer::getMsgNoAt: FIRST MSG: size=" << p->m_iLength << " %" << p->m_iSeqNo << " #"
-                  << p->getMsgSeq() << " !" << BufferStamp(p->m_pcData, p->m_iLength));
-    }
-
-    if (offset >= m_iCount)
-    {
-        // Prevent accessing the last "marker" block
+        // Prevent accessing the blocks not in use
         LOGC(bslog.Error,
              log << "CSndBuffer::getMsgNoAt: IPE: offset=" << offset << " not found, max offset=" << m_iCount);
         return SRT_MSGNO_CONTROL;
     }
 
-    // XXX Suboptimal procedure to keep the blocks identifiable
-    // by sequence number. Consider using some circular buffer.
-    int       i;
-    Block* ee SRT_ATR_UNUSED = 0;
-    for (i = 0; i < offset && p; ++i)
-    {
-        ee = p;
-        p  = p->m_pNext;
-    }
-
-    if (!p)
-    {
-        LOGC(bslog.Error,
-             log << "CSndBuffer::getMsgNoAt: IPE: offset=" << offset << " not found, stopped at " << i << " with #"
-                 << (ee ? ee->getMsgSeq() : SRT_MSGNO_NONE));
-        return SRT_MSGNO_CONTROL;
-    }
-
+    const Block& b = blockAt(offset);
     HLOGC(bslog.Debug,
-          log << "CSndBuffer::getMsgNoAt: offset=" << offset << " found, size=" << p->m_iLength << " %" << p->m_iSeqNo
-              << " #" << p->getMsgSeq() << " !" << BufferStamp(p->m_pcData, p->m_iLength));
+          log << "CSndBuffer::getMsgNoAt: offset=" << offset << " found, size=" << b.m_iLength << " %" << b.m_iSeqNo
+              << " #" << b.getMsgSeq() << " !" << BufferStamp(b.m_pcData, b.m_iLength));
 
-    return p->getMsgSeq();
+    return b.getMsgSeq();
 }
 
 int CSndBuffer::readData(const int offset, CPacket& w_packet, steady_clock::time_point& w_srctime, DropRange& w_drop)
@@ -429,19 +433,12 @@ int CSndBuffer::readData(const int offset, CPacket& w_packet, steady_clock::time
 
     ScopedLock bufferguard(m_BufLock);
 
-    Block* p = m_pFirstBlock;
-
-    // XXX Suboptimal procedure to keep the blocks identifiable
-    // by sequence number. Consider using some circular buffer.
-    for (int i = 0; i < offset && p != m_pLastBlock; ++i)
-    {
-        p = p->m_pNext;
-    }
-    if (p == m_pLastBlock)
+    if (offset < 0 || offset >= m_iCount)
     {
         LOGC(qslog.Error, log << "CSndBuffer::readData: offset " << offset << " too large!");
         return READ_NONE;
     }
+    Block* p = &blockAt(offset);
 #if ENABLE_HEAVY_LOGGING
     const int32_t first_seq = p->m_iSeqNo;
     int32_t last_seq = p->m_iSeqNo;
@@ -451,10 +448,10 @@ int CSndBuffer::readData(const int offset, CPacket& w_packet, steady_clock::time
     // already set when it was once sent uniquely.
     SRT_ASSERT(p->m_iSeqNo == w_packet.seqno());
 
-    // Check if the block that is the next candidate to send (m_pCurrBlock pointing) is stale.
+    // Check if the block at the requested offset is stale.
 
     // If so, then inform the caller that it should first take care of the whole
-    // message (all blocks with that message id). Shift the m_pCurrBlock pointer
+    // message (all blocks with that message id). Shift the m_iCurrOff offset
     // to the position past the last of them. Then return -1 and set the
     // msgno bitset packet field to the message id that should be dropped as
     // a whole.
@@ -469,21 +466,19 @@ int CSndBuffer::readData(const int offset, CPacket& w_packet, steady_clock::time
     if ((p->m_iTTL >= 0) && (count_milliseconds(steady_clock::now() - p->m_tsOriginTime) > p->m_iTTL))
     {
         w_drop.msgno = p->getMsgSeq();
-        int msglen   = 1;
-        p            = p->m_pNext;
-        bool move    = false;
-        while (p != m_pLastBlock && w_drop.msgno == p->getMsgSeq())
+        int end      = offset + 1;
+        while (end < m_iCount && w_drop.msgno == blockAt(end).getMsgSeq())
         {
 #if ENABLE_HEAVY_LOGGING
-            last_seq = p->m_iSeqNo;
+            last_seq = blockAt(end).m_iSeqNo;
 #endif
-            if (p == m_pCurrBlock)
-                move = true;
-            p = p->m_pNext;
-            if (move)
-                m_pCurrBlock = p;
-            msglen++;
+            ++end;
         }
+        const int msglen = end - offset;
+
+        // Don't send originally the rest of the dropped message.
+        if (m_iCurrOff > offset && m_iCurrOff < end)
+            m_iCurrOff = end;
 
         HLOGC(qslog.Debug,
               log << "CSndBuffer::readData: due to TTL exceeded, %(" << first_seq << " - " << last_seq << "), "
@@ -496,12 +491,12 @@ int CSndBuffer::readData(const int offset, CPacket& w_packet, steady_clock::time
         w_drop.seqno[DropRange::BEGIN] = w_packet.seqno();
         w_drop.seqno[DropRange::END] = CSeqNo::incseq(w_packet.seqno(), msglen - 1);
 
-        // Note the rules: here `p` is pointing to the first block AFTER the
+        // Note the rules: here `end` is the offset of the first block AFTER the
         // message to be dropped, so the end sequence should be one behind
-        // the one for p. Note that the loop rolls until hitting the first
-        // packet that doesn't belong to the message or m_pLastBlock, which
-        // is past-the-end for the occupied range in the sender buffer.
-        SRT_ASSERT(w_drop.seqno[DropRange::END] == CSeqNo::decseq(p->m_iSeqNo));
+        // the one at `end`. Note that the loop rolls until hitting the first
+        // packet that doesn't belong to the message or the past-the-end offset
+        // for the occupied range in the sender buffer.
+        SRT_ASSERT(end == m_iCount || w_drop.seqno[DropRange::END] == CSeqNo::decseq(blockAt(end).m_iSeqNo));
         return READ_DROP;
     }
 
@@ -532,36 +527,21 @@ int CSndBuffer::readData(const int offset, CPacket& w_packet, steady_clock::time
 sync::steady_clock::time_point CSndBuffer::getPacketRexmitTime(const int offset)
 {
     ScopedLock bufferguard(m_BufLock);
-    const Block* p = m_pFirstBlock;
-
-    // XXX Suboptimal procedure to keep the blocks identifiable
-    // by sequence number. Consider using some circular buffer.
-    for (int i = 0; i < offset; ++i)
-    {
-        SRT_ASSERT(p);
-        p = p->m_pNext;
-    }
-
-    SRT_ASSERT(p);
-    return p->m_tsRexmitTime;
+    SRT_ASSERT(offset >= 0 && offset < m_iSize);
+    return blockAt(offset).m_tsRexmitTime;
 }
 
 void CSndBuffer::ackData(int offset)
 {
     ScopedLock bufferguard(m_BufLock);
 
-    bool move = false;
     for (int i = 0; i < offset; ++i)
-    {
-        m_iBytesCount -= m_pFirstBlock->m_iLength;
-        if (m_pFirstBlock == m_pCurrBlock)
-            move = true;
-        m_pFirstBlock = m_pFirstBlock->m_pNext;
-    }
-    if (move)
-        m_pCurrBlock = m_pFirstBlock;
+        m_iBytesCount -= blockAt(i).m_iLength;
+    collectReleased(offset);
 
-    m_iCount = m_iCount - offset;
+    m_iStartPos = (m_iStartPos + offset) & m_iMask;
+    m_iCurrOff  = m_iCurrOff > offset ? m_iCurrOff - offset : 0;
+    m_iCount    = m_iCount - offset;
 
     updAvgBufSize(steady_clock::now());
 }
@@ -629,7 +609,7 @@ int CSndBuffer::getCurrBufSize(int& w_bytes, int& w_timespan) const
      * Also, if there is only one pkt in buffer, the time difference will be 0.
      * Therefore, always add 1 ms if not empty.
      */
-    w_timespan = 0 < m_iCount ? (int) count_milliseconds(m_tsLastOriginTime - m_pFirstBlock->m_tsOriginTime) + 1 : 0;
+    w_timespan = 0 < m_iCount ? (int) count_milliseconds(m_tsLastOriginTime - blockAt(0).m_tsOriginTime) + 1 : 0;
 
     return m_iCount;
 }
@@ -637,36 +617,28 @@ int CSndBuffer::getCurrBufSize(int& w_bytes, int& w_timespan) const
 CSndBuffer::duration CSndBuffer::getBufferingDelay(const time_point& tnow) const
 {
     ScopedLock lck(m_BufLock);
-    SRT_ASSERT(m_pFirstBlock);
     if (m_iCount == 0)
         return duration(0);
 
-    return tnow - m_pFirstBlock->m_tsOriginTime;
+    return tnow - blockAt(0).m_tsOriginTime;
 }
 
 int CSndBuffer::dropLateData(int& w_bytes, int32_t& w_first_msgno, const steady_clock::time_point& too_late_time)
 {
     int     dpkts  = 0;
     int     dbytes = 0;
-    bool    move   = false;
     int32_t msgno  = 0;
 
     ScopedLock bufferguard(m_BufLock);
-    for (int i = 0; i < m_iCount && m_pFirstBlock->m_tsOriginTime < too_late_time; ++i)
+    for (; dpkts < m_iCount && blockAt(dpkts).m_tsOriginTime < too_late_time; ++dpkts)
     {
-        dpkts++;
-        dbytes += m_pFirstBlock->m_iLength;
-        msgno = m_pFirstBlock->getMsgSeq();
-
-        if (m_pFirstBlock == m_pCurrBlock)
-            move = true;
-        m_pFirstBlock = m_pFirstBlock->m_pNext;
+        dbytes += blockAt(dpkts).m_iLength;
+        msgno = blockAt(dpkts).getMsgSeq();
     }
+    collectReleased(dpkts);
 
-    if (move)
-    {
-        m_pCurrBlock = m_pFirstBlock;
-    }
+    m_iStartPos = (m_iStartPos + dpkts) & m_iMask;
+    m_iCurrOff  = m_iCurrOff > dpkts ? m_iCurrOff - dpkts : 0;
     m_iCount = m_iCount - dpkts;
 
     m_iBytesCount -= dbytes;
@@ -684,66 +656,113 @@ int CSndBuffer::dropLateData(int& w_bytes, int32_t& w_first_msgno, const steady_
 
 void CSndBuffer::increase()
 {
-    int unitsize = m_pBuffer->m_iSize;
+    const int unitsize = m_iSize;
 
-    // new physical buffer
-    Buffer* nbuf = NULL;
+    Block* nblk = NULL;
     try
     {
-        nbuf           = new Buffer;
-        nbuf->m_pcData = new char[unitsize * m_iBlockLen];
+        nblk = new Block[2 * unitsize];
     }
     catch (...)
     {
-        delete nbuf;
         throw CUDTException(MJ_SYSTEMRES, MN_MEMORY, 0);
     }
-    nbuf->m_iSize = unitsize;
-    nbuf->m_pNext = NULL;
 
-    // insert the buffer at the end of the buffer list
-    Buffer* p = m_pBuffer;
-    while (p->m_pNext != NULL)
-        p = p->m_pNext;
-    p->m_pNext = nbuf;
+    // Unroll the ring so that the first block lands at position 0,
+    // then append the new blocks. They get their storage when filled.
+    for (int i = 0; i < unitsize; ++i)
+        nblk[i] = blockAt(i);
 
-    // new packet blocks
-    Block* nblk = NULL;
+    for (int i = unitsize; i < 2 * unitsize; ++i)
+    {
+        nblk[i].m_iMsgNoBitset = 0;
+        nblk[i].m_pcData       = NULL;
+        nblk[i].m_pcOwnData    = NULL;
+        nblk[i].m_fnRelease    = NULL;
+    }
+
+    delete[] m_pBlocks;
+    m_pBlocks   = nblk;
+    m_iStartPos = 0;
+    m_iSize     = 2 * unitsize;
+    m_iMask     = m_iSize - 1;
+
+    HLOGC(bslog.Debug, log << "CSndBuffer: BUFFER FULL - total size: " << m_iSize << " blocks");
+}
+
+void CSndBuffer::allocateData()
+{
+    Buffer* nbuf = NULL;
     try
     {
-        nblk = new Block;
+        nbuf           = new Buffer;
+        nbuf->m_pcData = new char[m_iUnitSize * m_iBlockLen];
+        m_vFreeData.reserve(m_vFreeData.size() + m_iUnitSize);
     }
     catch (...)
     {
-        delete nblk;
+        if (nbuf)
+            delete[] nbuf->m_pcData;
+        delete nbuf;
         throw CUDTException(MJ_SYSTEMRES, MN_MEMORY, 0);
     }
-    Block* pb = nblk;
-    for (int i = 1; i < unitsize; ++i)
+    nbuf->m_iSize = m_iUnitSize;
+    nbuf->m_pNext = m_pBuffer;
+    m_pBuffer     = nbuf;
+
+    // Taken from the end, so the blocks are used in the order of the memory.
+    for (int i = m_iUnitSize - 1; i >= 0; --i)
+        m_vFreeData.push_back(nbuf->m_pcData + i * m_iBlockLen);
+
+    HLOGC(bslog.Debug, log << "CSndBuffer: adding " << (m_iUnitSize * m_iBlockLen) << " bytes spread to " << m_iUnitSize << " blocks");
+}
+
+char* CSndBuffer::takeData()
+{
+    if (m_vFreeData.empty())
+        allocateData();
+
+    char* data = m_vFreeData.back();
+    m_vFreeData.pop_back();
+    return data;
+}
+
+void CSndBuffer::collectReleased(int count)
+{
+    for (int i = 0; i < count; ++i)
     {
-        pb->m_pNext = new Block;
-        pb          = pb->m_pNext;
+        Block& b = blockAt(i);
+        if (b.m_pcOwnData)
+        {
+            m_vFreeData.push_back(b.m_pcOwnData);
+            b.m_pcOwnData = NULL;
+        }
+        if (!b.m_fnRelease)
+            continue;
+
+        const Release r = {b.m_fnRelease, b.m_pReleaseOpaque};
+        m_vReleased.push_back(r);
+        b.m_fnRelease = NULL;
     }
 
-    // insert the new blocks onto the existing one
-    pb->m_pNext           = m_pLastBlock->m_pNext;
-    m_pLastBlock->m_pNext = nblk;
+    if (!m_vReleased.empty())
+        m_bReleased = true;
+}
+
+void CSndBuffer::releaseAcked()
+{
+    if (!m_bReleased)
+        return;
 
-    pb       = nblk;
-    char* pc = nbuf->m_pcData;
-    for (int i = 0; i < unitsize; ++i)
+    vector<Release> released;
     {
-        pb->m_pcData = pc;
-        pb           = pb->m_pNext;
-        pc += m_iBlockLen;
+        ScopedLock bufferguard(m_BufLock);
+        released.swap(m_vReleased);
+        m_bReleased = false;
     }
 
-    m_iSize += unitsize;
-
-    HLOGC(bslog.Debug,
-          log << "CSndBuffer: BUFFER FULL - adding " << (unitsize * m_iBlockLen) << " bytes spread to " << unitsize
-              << " blocks"
-              << " (total size: " << m_iSize << " bytes)");
+    for (size_t i = 0; i < released.size(); ++i)
+        released[i].fn(released[i].opaque);
 }
 
 } // namespace srt
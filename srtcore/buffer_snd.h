@@ -106,8 +106,13 @@ public:
     /// @param [in] data pointer to the user data block.
     /// @param [in] len size of the block.
     /// @param [inout] w_mctrl Message control data
+    /// @param [in] release_fn if not NULL, @a data is not copied, but referred
+    ///        to until the whole message is acknowledged or dropped, and then
+    ///        release_fn(opaque) is scheduled to be called by releaseAcked().
+    /// @param [in] opaque the argument for @a release_fn
     SRT_ATTR_EXCLUDES(m_BufLock)
-    void addBuffer(const char* data, int len, SRT_MSGCTRL& w_mctrl);
+    void addBuffer(const char* data, int len, SRT_MSGCTRL& w_mctrl,
+                   srt_sendbuf_release_fn* release_fn = NULL, void* opaque = NULL);
 
     /// Read a block of data from file and insert it into the sending list.
     /// @param [in] ifs input file stream.
@@ -178,6 +183,12 @@ public:
     SRT_ATTR_EXCLUDES(m_BufLock)
     int dropLateData(int& bytes, int32_t& w_first_msgno, const time_point& too_late_time);
 
+    /// Call the release functions of the zero-copy messages that were
+    /// acknowledged or dropped since the last call. The functions are
+    /// called outside the buffer lock.
+    SRT_ATTR_EXCLUDES(m_BufLock)
+    void releaseAcked();
+
     void updAvgBufSize(const time_point& time);
     int  getAvgBufSize(int& bytes, int& timespan);
     int  getCurrBufSize(int& bytes, int& timespan) const;
@@ -214,15 +225,33 @@ public:
     void setRateEstimator(const CRateEstimator& other) { m_rateEstimator = other; }
 
 private:
+    /// Double the number of blocks. The payload of the blocks in use stays
+    /// where it is, only the block records are moved to the new ring.
     void increase();
 
+    /// Allocate the storage for m_iUnitSize more blocks.
+    void allocateData();
+
+    /// Get the storage for a block, allocating more if none is free.
+    SRT_ATTR_REQUIRES(m_BufLock)
+    char* takeData();
+
+    /// Give back the storage and schedule the release of the user data
+    /// of the blocks from the beginning of the buffer to @a count (exclusive).
+    SRT_ATTR_REQUIRES(m_BufLock)
+    void collectReleased(int count);
+
 private:
     mutable sync::Mutex m_BufLock; // used to synchronize buffer operation
 
     struct Block
     {
-        char* m_pcData;  // pointer to the data block
-        int   m_iLength; // payload length of the block (excluding auth tag).
+        char* m_pcData;    // pointer to the data block
+        char* m_pcOwnData; // the block's own storage while in use, m_pcData unless the data is the user's
+        int   m_iLength;   // payload length of the block (excluding auth tag).
+
+        srt_sendbuf_release_fn* m_fnRelease; // set in the last block of a zero-copy message
+        void*                   m_pReleaseOpaque;
 
         int32_t    m_iMsgNoBitset; // message number
         int32_t    m_iSeqNo;       // sequence number for scheduling
@@ -230,9 +259,7 @@ private:
         time_point m_tsRexmitTime; // packet retransmission time
         int        m_iTTL; // time to live (milliseconds)
 
-        Block* m_pNext; // next block
-
-        int32_t getMsgSeq()
+        int32_t getMsgSeq() const
         {
             // NOTE: this extracts message ID with regard to REXMIT flag.
             // This is valid only for message ID that IS GENERATED in this instance,
@@ -240,13 +267,24 @@ private:
             // for the peer that it uses LESS bits to represent the message.
             return m_iMsgNoBitset & MSGNO_SEQ::mask;
         }
+    };
 
-    } * m_pBlock, *m_pFirstBlock, *m_pCurrBlock, *m_pLastBlock;
-
-    // m_pBlock:         The head pointer
-    // m_pFirstBlock:    The first block
-    // m_pCurrBlock:	 The current block
-    // m_pLastBlock:     The last block (if first == last, buffer is empty)
+    /// The block at the given offset from the first (oldest) block.
+    Block& blockAt(int offset) { return m_pBlocks[(m_iStartPos + offset) & m_iMask]; }
+    const Block& blockAt(int offset) const { return m_pBlocks[(m_iStartPos + offset) & m_iMask]; }
+
+    // The blocks form a ring of m_iSize records, where m_iSize is a power of 2,
+    // so a packet is found by its offset from the last ACK point in constant time.
+    // Only the records are rounded up: the payload storage is allocated by
+    // m_iUnitSize blocks and given to a block only while it holds a packet,
+    // so the memory follows the configured size and the packets in flight.
+    // Offsets from the first block:
+    // [0, m_iCurrOff):         sent at least once, waiting for ACK
+    // [m_iCurrOff, m_iCount):  not sent yet
+    Block* m_pBlocks;   // the ring of blocks
+    int    m_iMask;     // m_iSize - 1
+    int    m_iStartPos; // position of the first block in the ring
+    int    m_iCurrOff;  // offset of the next block to send for the first time
 
     struct Buffer
     {
@@ -255,9 +293,12 @@ private:
         Buffer* m_pNext;  // next buffer
     } * m_pBuffer;        // physical buffer
 
+    std::vector<char*> m_vFreeData; // storage of the physical buffers not given to any block
+
     int32_t m_iNextMsgNo; // next message number
 
-    int m_iSize; // buffer size (number of packets)
+    int m_iSize; // buffer size (number of packets), a power of 2
+    const int m_iUnitSize;  // number of blocks of storage allocated at a time
     const int m_iBlockLen;  // maximum length of a block holding packet payload and AUTH tag (excluding packet header).
     const int m_iAuthTagSize; // Authentication tag size (if GCM is enabled).
 
@@ -272,6 +313,14 @@ private:
     AvgBufSize m_mavg;
     CRateEstimator m_rateEstimator;
 
+    struct Release
+    {
+        srt_sendbuf_release_fn* fn;
+        void*                   opaque;
+    };
+    std::vector<Release> m_vReleased; // zero-copy messages no longer in the buffer
+    sync::atomic<bool>   m_bReleased; // m_vReleased is not empty
+
 private:
     CSndBuffer(const CSndBuffer&);
     CSndBuffer& operator=(const CSndBuffer&);
@@ -63,6 +63,10 @@ modified by
 #include "netinet_any.h"
 #include "utilities.h"
 
+#if defined(SRT_ENABLE_GSO) || defined(SRT_ENABLE_GRO)
+#include <netinet/udp.h> // UDP_SEGMENT, UDP_GRO
+#endif
+
 #ifdef _WIN32
 typedef int socklen_t;
 #endif
@@ -138,6 +142,14 @@ static int set_cloexec(int fd, int set)
 
 srt::CChannel::CChannel()
     : m_iSocket(INVALID_SOCKET)
+    , m_bGSO(false)
+    , m_bGRO(false)
+    , m_pGROBuffer(NULL)
+    , m_iGROLen(0)
+    , m_iGROPos(0)
+    , m_iGROSegSize(0)
+    , m_iGROReads(0)
+    , m_iGROSegments(0)
 #ifdef SRT_ENABLE_PKTINFO
     , m_bBindMasked(true)
 #endif
@@ -157,7 +169,10 @@ srt::CChannel::CChannel()
 #endif
 }
 
-srt::CChannel::~CChannel() {}
+srt::CChannel::~CChannel()
+{
+    delete[] m_pGROBuffer;
+}
 
 void srt::CChannel::createSocket(int family)
 {
@@ -213,6 +228,18 @@ void srt::CChannel::createSocket(int family)
         }
 #endif // ENABLE_LOGGING
     }
+
+#if defined(__linux__) && defined(SO_REUSEPORT)
+    if (m_mcfg.iListenShards > 1)
+    {
+        // All shards bind the same address and the system spreads the
+        // incoming datagrams among them by the sender's address. Sockets
+        // with this option can only listen (see CUDTUnited::connectIn).
+        const int yes = 1;
+        if (::setsockopt(m_iSocket, SOL_SOCKET, SO_REUSEPORT, (const char*)&yes, sizeof yes) == -1)
+            throw CUDTException(MJ_SETUP, MN_NORES, NET_ERROR);
+    }
+#endif
 }
 
 void srt::CChannel::open(const sockaddr_any& addr)
@@ -578,6 +605,50 @@ void srt::CChannel::setUDPSockOpt()
         //::setsockopt(m_iSocket, IPPROTO_IPV6, IPV6_V6ONLY, &off, sizeof(off));
     }
 #endif
+
+    m_bGSO = false;
+    if (m_mcfg.bUDPGSO)
+    {
+#if defined(SRT_ENABLE_GSO) && !defined(SRT_TEST_FAKE_LOSS)
+        // Kernels without UDP_SEGMENT support reject this option. Whether the
+        // network device can do it too is only known after the first send.
+        int       gso_size = 0;
+        socklen_t optlen   = sizeof gso_size;
+        if (-1 == ::getsockopt(m_iSocket, IPPROTO_UDP, UDP_SEGMENT, (char*)&gso_size, &optlen))
+        {
+            LOGC(kmlog.Warn, log << "SRTO_UDP_GSO: segmentation offload not supported: " << SysStrError(NET_ERROR)
+                    << " - packets will be sent one by one");
+        }
+        else
+        {
+            m_bGSO = true;
+        }
+#else
+        LOGC(kmlog.Warn, log << "SRTO_UDP_GSO: segmentation offload not available on this platform");
+#endif
+    }
+
+    m_bGRO = false;
+    if (m_mcfg.bUDPGRO)
+    {
+#if defined(SRT_ENABLE_GRO) && !defined(SRT_TEST_FAKE_LOSS)
+        const int on = 1;
+        if (-1 == ::setsockopt(m_iSocket, IPPROTO_UDP, UDP_GRO, (const char*)&on, sizeof on))
+        {
+            LOGC(kmlog.Warn, log << "SRTO_UDP_GRO: receive coalescing not supported: " << SysStrError(NET_ERROR)
+                    << " - packets will be received one by one");
+        }
+        else
+        {
+            if (!m_pGROBuffer)
+                m_pGROBuffer = new char[MAX_GRO_BYTES];
+            m_iGROLen = m_iGROPos = 0;
+            m_bGRO = true;
+        }
+#else
+        LOGC(kmlog.Warn, log << "SRTO_UDP_GRO: receive coalescing not available on this platform");
+#endif
+    }
 }
 
 void srt::CChannel::close() const
@@ -896,6 +967,184 @@ int srt::CChannel::sendto(const sockaddr_any& addr, CPacket& packet, const socka
     return res;
 }
 
+int srt::CChannel::sendBatch(CBatchPacket* batch, int size) const
+{
+    SRT_ASSERT(size <= CSrtMuxerConfig::MAX_UDP_SNDBATCH);
+
+#if defined(SRT_ENABLE_SENDMMSG) && !defined(SRT_TEST_FAKE_LOSS)
+    mmsghdr mm[CSrtMuxerConfig::MAX_UDP_SNDBATCH];
+#ifdef SRT_ENABLE_PKTINFO
+    char mh_crtl_buf[CSrtMuxerConfig::MAX_UDP_SNDBATCH][sizeof(CMSGNodeIPv4) + sizeof(CMSGNodeIPv6)];
+#endif
+
+    for (int i = 0; i < size; ++i)
+    {
+        CPacket&            packet = batch[i].packet;
+        const sockaddr_any& addr   = batch[i].target;
+
+        HLOGC(kslog.Debug,
+              log << "CChannel::sendBatch: SENDING NOW [" << i << "/" << size << "] DST=" << addr.str()
+                  << " target=@" << packet.id() << " size=" << packet.getLength() << " pkt.ts=" << packet.timestamp()
+                  << " " << packet.Info());
+
+        // convert control information into network order
+        packet.toNetworkByteOrder();
+
+        msghdr& mh        = mm[i].msg_hdr;
+        mh.msg_name       = (sockaddr*)&addr;
+        mh.msg_namelen    = addr.size();
+        mh.msg_iov        = (iovec*)packet.m_PacketVector;
+        mh.msg_iovlen     = 2;
+        mh.msg_control    = NULL;
+        mh.msg_controllen = 0;
+        mh.msg_flags      = 0;
+        mm[i].msg_len     = 0;
+
+#ifdef SRT_ENABLE_PKTINFO
+        const sockaddr_any& source_addr = batch[i].source;
+        if (m_bBindMasked && source_addr.family() != AF_UNSPEC && !source_addr.isany())
+        {
+            if (!setSourceAddress(mh, mh_crtl_buf[i], source_addr))
+            {
+                LOGC(kslog.Error, log << "CChannel::setSourceAddress: source address invalid family #" << source_addr.family() << ", NOT setting.");
+                mh.msg_control    = NULL;
+                mh.msg_controllen = 0;
+            }
+        }
+#endif
+    }
+
+    int nsent = 0;
+    for (int done = 0; done < size;)
+    {
+        const int res = ::sendmmsg(m_iSocket, mm + done, unsigned(size - done), 0);
+        if (res <= 0)
+        {
+            // The first of the remaining packets could not be sent. As with
+            // sendto(), the packet is simply lost; continue with the next one.
+            HLOGC(kslog.Debug, log << "CChannel::sendBatch: sendmmsg failed: " << SysStrError(NET_ERROR)
+                    << " - skipping packet [" << done << "/" << size << "]");
+            ++done;
+            continue;
+        }
+
+        done  += res;
+        nsent += res;
+    }
+
+    for (int i = 0; i < size; ++i)
+        batch[i].packet.toHostByteOrder();
+
+    return nsent;
+#else
+    int nsent = 0;
+    for (int i = 0; i < size; ++i)
+    {
+        if (sendto(batch[i].target, batch[i].packet, batch[i].source) >= 0)
+            ++nsent;
+    }
+    return nsent;
+#endif
+}
+
+int srt::CChannel::sendSegmented(CBatchPacket* batch, int size) const
+{
+    SRT_ASSERT(size <= MAX_GSO_SEGMENTS);
+
+#if defined(SRT_ENABLE_GSO) && !defined(SRT_TEST_FAKE_LOSS)
+    const sockaddr_any& addr    = batch[0].target;
+    const uint16_t      segsize = uint16_t(CPacket::HDR_SIZE + batch[0].packet.getLength());
+
+    // Every packet is a pair of [header, payload] buffers, and the system
+    // cuts the whole sequence into datagrams of segsize bytes.
+    iovec vec[2 * MAX_GSO_SEGMENTS];
+    for (int i = 0; i < size; ++i)
+    {
+        CPacket& packet = batch[i].packet;
+
+        HLOGC(kslog.Debug,
+              log << "CChannel::sendSegmented: SENDING NOW [" << i << "/" << size << "] DST=" << addr.str()
+                  << " target=@" << packet.id() << " size=" << packet.getLength() << " pkt.ts=" << packet.timestamp()
+                  << " " << packet.Info());
+
+        packet.toNetworkByteOrder();
+        vec[2 * i]     = ((iovec*)packet.m_PacketVector)[0];
+        vec[2 * i + 1] = ((iovec*)packet.m_PacketVector)[1];
+    }
+
+    // Aligned for the cmsghdr structures placed in it.
+    union
+    {
+#ifdef SRT_ENABLE_PKTINFO
+        char buf[sizeof(CMSGNodeIPv4) + sizeof(CMSGNodeIPv6) + sizeof(CMSGNodeGSO)];
+#else
+        char buf[sizeof(CMSGNodeGSO)];
+#endif
+        cmsghdr align;
+    } mh_crtl;
+
+    msghdr mh;
+    mh.msg_name       = (sockaddr*)&addr;
+    mh.msg_namelen    = addr.size();
+    mh.msg_iov        = vec;
+    mh.msg_iovlen     = 2 * size;
+    mh.msg_control    = NULL;
+    mh.msg_controllen = 0;
+    mh.msg_flags      = 0;
+
+#ifdef SRT_ENABLE_PKTINFO
+    const sockaddr_any& source_addr = batch[0].source;
+    if (m_bBindMasked && source_addr.family() != AF_UNSPEC && !source_addr.isany())
+    {
+        if (!setSourceAddress(mh, mh_crtl.buf, source_addr))
+        {
+            LOGC(kslog.Error, log << "CChannel::setSourceAddress: source address invalid family #" << source_addr.family() << ", NOT setting.");
+            mh.msg_controllen = 0;
+        }
+    }
+#endif
+
+    // The UDP_SEGMENT message follows the PKTINFO message, if any.
+    cmsghdr* cmsg_gso   = (cmsghdr*)(mh_crtl.buf + mh.msg_controllen);
+    cmsg_gso->cmsg_level = IPPROTO_UDP;
+    cmsg_gso->cmsg_type  = UDP_SEGMENT;
+    cmsg_gso->cmsg_len   = CMSG_LEN(sizeof segsize);
+    memcpy(CMSG_DATA(cmsg_gso), &segsize, sizeof segsize);
+    mh.msg_control     = mh_crtl.buf;
+    mh.msg_controllen += CMSG_SPACE(sizeof segsize);
+
+    const int res = ::sendmsg(m_iSocket, &mh, 0);
+    const int err = NET_ERROR;
+
+    for (int i = 0; i < size; ++i)
+        batch[i].packet.toHostByteOrder();
+
+    if (res == -1)
+    {
+        // EIO: the network device can't compute the checksums for the segments.
+        // Others: the kernel doesn't support the segmentation for this socket or size.
+        if (err == EIO || err == EINVAL || err == ENOPROTOOPT || err == EOPNOTSUPP)
+        {
+            LOGC(kslog.Warn, log << "CChannel::sendSegmented: segmentation offload refused: " << SysStrError(err)
+                    << " - turning it off, packets will be sent one by one");
+            m_bGSO = false;
+            return -1;
+        }
+
+        // As with sendto(), the packets are simply lost.
+        HLOGC(kslog.Debug, log << "CChannel::sendSegmented: sendmsg failed: " << SysStrError(err)
+                << " - " << size << " packets lost");
+        return 0;
+    }
+
+    return size;
+#else
+    (void)batch;
+    (void)size;
+    return -1;
+#endif
+}
+
 srt::EReadStatus srt::CChannel::recvfrom(sockaddr_any& w_addr, CPacket& w_packet) const
 {
     EReadStatus status    = RST_OK;
@@ -1151,3 +1400,249 @@ Return_error:
     w_packet.setLength(-1);
     return status;
 }
+
+srt::EReadStatus srt::CChannel::recvBatch(sockaddr_any* w_addr, CPacket* const* w_packets, EReadStatus* w_status, int size, int& w_count)
+{
+    SRT_ASSERT(size <= CSrtMuxerConfig::MAX_UDP_RCVBATCH);
+    w_count = 0;
+
+    if (m_bGRO)
+        return recvCoalesced(w_addr, w_packets, w_status, size, (w_count));
+
+#ifdef SRT_ENABLE_RECVMMSG
+    fd_set  set, errset;
+    timeval tv;
+    FD_ZERO(&set);
+    FD_SET(m_iSocket, &set);
+    errset               = set;
+    tv.tv_sec            = 0;
+    tv.tv_usec           = 10000;
+    const int select_ret = ::select((int)m_iSocket + 1, &set, NULL, &errset, &tv);
+
+    if (select_ret == 0) // timeout
+        return RST_AGAIN;
+
+    mmsghdr mm[CSrtMuxerConfig::MAX_UDP_RCVBATCH];
+#ifdef SRT_ENABLE_PKTINFO
+    char mh_crtl_buf[CSrtMuxerConfig::MAX_UDP_RCVBATCH][sizeof(CMSGNodeIPv4) + sizeof(CMSGNodeIPv6)];
+#endif
+
+    int recv_count = -1;
+    if (select_ret > 0)
+    {
+        for (int i = 0; i < size; ++i)
+        {
+            msghdr& mh        = mm[i].msg_hdr;
+            mh.msg_name       = (w_addr[i].get());
+            mh.msg_namelen    = w_addr[i].size();
+            mh.msg_iov        = (w_packets[i]->m_PacketVector);
+            mh.msg_iovlen     = 2;
+            mh.msg_control    = NULL;
+            mh.msg_controllen = 0;
+#ifdef SRT_ENABLE_PKTINFO
+            if (m_bBindMasked)
+            {
+                mh.msg_control    = (mh_crtl_buf[i]);
+                mh.msg_controllen = sizeof mh_crtl_buf[i];
+            }
+#endif
+            mh.msg_flags  = 0;
+            mm[i].msg_len = 0;
+        }
+
+        // The socket was reported readable, so at least one packet is there;
+        // take all others that are already waiting, but don't wait for more.
+        recv_count = ::recvmmsg(m_iSocket, mm, unsigned(size), MSG_DONTWAIT, NULL);
+    }
+
+    // Errors are handled the same way as in recvfrom().
+    if (select_ret == -1 || recv_count == -1)
+    {
+        const int err = NET_ERROR;
+        if (err == EAGAIN || err == EINTR || err == ECONNREFUSED)
+            return RST_AGAIN;
+
+        HLOGC(krlog.Debug, log << CONID() << "(sys)recvmmsg: " << SysStrError(err) << " [" << err << "]");
+        return RST_ERROR;
+    }
+
+    for (int i = 0; i < recv_count; ++i)
+    {
+        CPacket&  packet    = *w_packets[i];
+        const int recv_size = (int)mm[i].msg_len;
+
+        // Too short packets and packets with MSG_TRUNC are dropped, see recvfrom().
+        if (size_t(recv_size) < CPacket::HDR_SIZE || mm[i].msg_hdr.msg_flags != 0)
+        {
+            HLOGC(krlog.Debug,
+                  log << CONID() << "recvBatch: dropping packet [" << i << "] size=" << recv_size << " msg_flags=0x"
+                      << hex << mm[i].msg_hdr.msg_flags);
+            packet.setLength(-1);
+            w_status[i] = RST_AGAIN;
+            continue;
+        }
+
+#ifdef SRT_ENABLE_PKTINFO
+        if (m_bBindMasked)
+            packet.m_DestAddr = getTargetAddress(mm[i].msg_hdr);
+#endif
+
+        packet.setLength(recv_size - CPacket::HDR_SIZE);
+        packet.toHostByteOrder();
+        w_status[i] = RST_OK;
+    }
+
+    w_count = recv_count;
+    return RST_OK;
+#else
+    (void)size;
+    const EReadStatus rst = recvfrom((w_addr[0]), (*w_packets[0]));
+    if (rst != RST_OK)
+        return rst;
+
+    w_status[0] = RST_OK;
+    w_count     = 1;
+    return RST_OK;
+#endif
+}
+
+srt::EReadStatus srt::CChannel::recvCoalesced(sockaddr_any* w_addr, CPacket* const* w_packets, EReadStatus* w_status, int size, int& w_count)
+{
+    w_count = 0;
+    while (w_count < size)
+    {
+        if (m_iGROPos >= m_iGROLen)
+        {
+            // Wait for a datagram only if there's nothing to return yet.
+            const EReadStatus rst = readCoalesced(w_count == 0);
+            if (rst != RST_OK)
+                return w_count > 0 ? RST_OK : rst;
+        }
+
+        const char* segment = m_pGROBuffer + m_iGROPos;
+        const int   seglen  = std::min(m_iGROSegSize, m_iGROLen - m_iGROPos);
+        m_iGROPos += seglen;
+
+        CPacket& packet  = *w_packets[w_count];
+        w_addr[w_count]  = m_GROSource;
+        const size_t len = size_t(seglen) - CPacket::HDR_SIZE;
+
+        // The payload space is given by the packet length set by the caller.
+        if (size_t(seglen) < CPacket::HDR_SIZE || len > packet.getLength())
+        {
+            HLOGC(krlog.Debug, log << CONID() << "recvBatch: dropping coalesced segment size=" << seglen);
+            packet.setLength(-1);
+            w_status[w_count++] = RST_AGAIN;
+            continue;
+        }
+
+        memcpy(packet.getHeader(), segment, CPacket::HDR_SIZE);
+        memcpy(packet.m_pcData, segment + CPacket::HDR_SIZE, len);
+#ifdef SRT_ENABLE_PKTINFO
+        if (m_bBindMasked)
+            packet.m_DestAddr = m_GROTarget;
+#endif
+        packet.setLength(len);
+        packet.toHostByteOrder();
+        w_status[w_count++] = RST_OK;
+    }
+
+    return RST_OK;
+}
+
+srt::EReadStatus srt::CChannel::readCoalesced(bool wait)
+{
+#if defined(SRT_ENABLE_GRO) && !defined(SRT_TEST_FAKE_LOSS)
+    if (wait)
+    {
+        fd_set  set, errset;
+        timeval tv;
+        FD_ZERO(&set);
+        FD_SET(m_iSocket, &set);
+        errset               = set;
+        tv.tv_sec            = 0;
+        tv.tv_usec           = 10000;
+        const int select_ret = ::select((int)m_iSocket + 1, &set, NULL, &errset, &tv);
+
+        if (select_ret == 0) // timeout
+            return RST_AGAIN;
+        if (select_ret == -1)
+            return NET_ERROR == EINTR ? RST_AGAIN : RST_ERROR;
+    }
+
+    // Aligned for the cmsghdr structures placed in it.
+    union
+    {
+#ifdef SRT_ENABLE_PKTINFO
+        char buf[sizeof(CMSGNodeIPv4) + sizeof(CMSGNodeIPv6) + sizeof(CMSGNodeGRO)];
+#else
+        char buf[sizeof(CMSGNodeGRO)];
+#endif
+        cmsghdr align;
+    } mh_crtl;
+
+    iovec vec;
+    vec.iov_base = m_pGROBuffer;
+    vec.iov_len  = MAX_GRO_BYTES;
+
+    m_GROSource = sockaddr_any(m_BindAddr.family());
+
+    msghdr mh;
+    mh.msg_name       = m_GROSource.get();
+    mh.msg_namelen    = m_GROSource.size();
+    mh.msg_iov        = &vec;
+    mh.msg_iovlen     = 1;
+    mh.msg_control    = mh_crtl.buf;
+    mh.msg_controllen = sizeof mh_crtl.buf;
+    mh.msg_flags      = 0;
+
+    const int recv_size = ::recvmsg(m_iSocket, &mh, MSG_DONTWAIT);
+    m_iGROLen = m_iGROPos = 0;
+
+    // Errors are handled the same way as in recvfrom().
+    if (recv_size == -1)
+    {
+        const int err = NET_ERROR;
+        if (err == EAGAIN || err == EINTR || err == ECONNREFUSED)
+            return RST_AGAIN;
+
+        HLOGC(krlog.Debug, log << CONID() << "(sys)recvmsg: " << SysStrError(err) << " [" << err << "]");
+        return RST_ERROR;
+    }
+
+    if (recv_size == 0 || (mh.msg_flags & MSG_TRUNC))
+    {
+        HLOGC(krlog.Debug,
+              log << CONID() << "recvBatch: dropping datagram size=" << recv_size << " msg_flags=0x" << hex << mh.msg_flags);
+        return RST_AGAIN;
+    }
+
+    // Without the UDP_GRO message the datagram is a single packet.
+    int segsize = recv_size;
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&mh); cmsg != NULL; cmsg = CMSG_NXTHDR(&mh, cmsg))
+    {
+        if (cmsg->cmsg_level == IPPROTO_UDP && cmsg->cmsg_type == UDP_GRO)
+        {
+            int gso_size = 0;
+            memcpy(&gso_size, CMSG_DATA(cmsg), sizeof gso_size);
+            if (gso_size > 0)
+                segsize = gso_size;
+            break;
+        }
+    }
+
+#ifdef SRT_ENABLE_PKTINFO
+    if (m_bBindMasked)
+        m_GROTarget = getTargetAddress(mh);
+#endif
+
+    m_iGROLen     = recv_size;
+    m_iGROSegSize = segsize;
+    m_iGROReads.store(m_iGROReads.load() + 1);
+    m_iGROSegments.store(m_iGROSegments.load() + (recv_size + segsize - 1) / segsize);
+    return RST_OK;
+#else
+    (void)wait;
+    return RST_ERROR;
+#endif
+}
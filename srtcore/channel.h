@@ -61,6 +61,14 @@ modified by
 namespace srt
 {
 
+/// A packet to be sent by CChannel::sendBatch together with its addressing.
+struct CBatchPacket
+{
+    sockaddr_any target; //< destination address
+    sockaddr_any source; //< source address to set on the packet (if not ANY)
+    CPacket      packet;
+};
+
 class CChannel
 {
     void createSocket(int family);
@@ -119,6 +127,33 @@ public:
 
     int sendto(const sockaddr_any& addr, srt::CPacket& packet, const sockaddr_any& src) const;
 
+    /// Send multiple packets, possibly to different addresses, using
+    /// as few system calls as possible (sendmmsg, if available).
+    /// As with sendto(), packets that failed to be sent are skipped.
+    /// @param [in,ref] batch array of packets to send
+    /// @param [in] size number of packets in @a batch (up to CSrtMuxerConfig::MAX_UDP_SNDBATCH)
+    /// @return Number of packets passed to the system.
+
+    int sendBatch(CBatchPacket* batch, int size) const;
+
+    /// Send consecutive packets to the same address in one system call,
+    /// letting the system split them (UDP generic segmentation offload).
+    /// All packets must have the size of the first one, except the last
+    /// one, which may be shorter. If the system refuses to do it, the
+    /// segmentation offload is turned off for this channel.
+    /// @param [in,ref] batch array of packets to send, all with the same addressing
+    /// @param [in] size number of packets in @a batch (up to MAX_GSO_SEGMENTS)
+    /// @return Number of packets passed to the system, or -1 if the
+    ///         segmentation offload was refused and nothing was sent.
+
+    int sendSegmented(CBatchPacket* batch, int size) const;
+
+    /// Check if sendSegmented() can be used (SRTO_UDP_GSO is set and supported).
+    bool segmentationEnabled() const { return m_bGSO; }
+
+    static const int MAX_GSO_SEGMENTS = 64;    // UDP_MAX_SEGMENTS in older Linux kernels
+    static const int MAX_GSO_BYTES    = 65507; // Maximum UDP payload over IPv4
+
     /// Receive a packet from the channel and record the source address.
     /// @param [in] addr pointer to the source address.
     /// @param [in] packet reference to a CPacket entity.
@@ -126,6 +161,33 @@ public:
 
     EReadStatus recvfrom(sockaddr_any& addr, srt::CPacket& packet) const;
 
+    /// Receive multiple packets from the channel with one system call
+    /// (recvmmsg, if available) and record their source addresses.
+    /// If receive coalescing is enabled, the packets are instead cut
+    /// out of the coalesced datagrams, which are read one at a time;
+    /// segments that don't fit in @a packets are returned by the next call.
+    /// @param [out] addr array of source addresses, one per packet
+    /// @param [in,out] packets array of packets to fill in
+    /// @param [out] status status of each received packet (RST_AGAIN if it must be dropped)
+    /// @param [in] size capacity of the arrays (up to CSrtMuxerConfig::MAX_UDP_RCVBATCH)
+    /// @param [out] count number of packets received
+    /// @return RST_OK if at least one packet was received, otherwise as for recvfrom().
+
+    EReadStatus recvBatch(sockaddr_any* addr, srt::CPacket* const* packets, EReadStatus* status, int size, int& count);
+
+    /// Check if the received datagrams may contain multiple coalesced
+    /// packets (SRTO_UDP_GRO is set and supported). Such datagrams can
+    /// only be received with recvBatch().
+    bool coalescingEnabled() const { return m_bGRO; }
+
+    /// Number of datagrams read with receive coalescing enabled.
+    int64_t groReadsTotal() const { return m_iGROReads.load(); }
+
+    /// Number of packets (segments) found in the datagrams counted in groReadsTotal().
+    int64_t groSegmentsTotal() const { return m_iGROSegments.load(); }
+
+    static const int MAX_GRO_BYTES = 65535; // Maximum size of a coalesced datagram
+
     void setConfig(const CSrtMuxerConfig& config);
 
     void getSocketOption(int level, int sockoptname, char* pw_dataptr, socklen_t& w_len, int& w_status);
@@ -167,6 +229,13 @@ public:
 private:
     void setUDPSockOpt();
 
+    /// Receive packets cut out of the coalesced datagrams (see recvBatch()).
+    EReadStatus recvCoalesced(sockaddr_any* addr, srt::CPacket* const* packets, EReadStatus* status, int size, int& count);
+
+    /// Read the next coalesced datagram into m_pGROBuffer.
+    /// @param [in] wait whether to wait for the datagram if none is ready
+    EReadStatus readCoalesced(bool wait);
+
 private:
     UDPSOCKET m_iSocket; // socket descriptor
 
@@ -176,6 +245,42 @@ private:
     mutable CSrtMuxerConfig m_mcfg; // Note: ReuseAddr is unused and ineffective.
     sockaddr_any            m_BindAddr;
 
+    // UDP segmentation offload requested and not refused by the system.
+    // Turned off by a sending thread when a segmented send fails.
+    mutable sync::atomic<bool> m_bGSO;
+
+    // UDP receive coalescing (GRO) state, used only by the receiving thread.
+    bool                    m_bGRO;         // Receive coalescing requested and supported
+    char*                   m_pGROBuffer;   // The last coalesced datagram read
+    int                     m_iGROLen;      // Size of the datagram in m_pGROBuffer
+    int                     m_iGROPos;      // Position of the next segment to be taken
+    int                     m_iGROSegSize;  // Size of the segments (the last one may be shorter)
+    sockaddr_any            m_GROSource;    // Source address of the datagram
+    sockaddr_any            m_GROTarget;    // Target address of the datagram (PKTINFO)
+    sync::atomic<int64_t>   m_iGROReads;
+    sync::atomic<int64_t>   m_iGROSegments;
+
+#ifdef SRT_ENABLE_GSO
+    // Used to determine the size of the CMSG buffer for UDP_SEGMENT, like
+    // CMSGNodeIPv4 below. NOT TO BE USED to access any data inside the CMSG message.
+    struct CMSGNodeGSO
+    {
+        uint16_t segsize;
+        size_t extrafill;
+        cmsghdr hdr;
+    };
+#endif
+
+#ifdef SRT_ENABLE_GRO
+    // As CMSGNodeGSO, for the UDP_GRO message with the received segment size.
+    struct CMSGNodeGRO
+    {
+        int segsize;
+        size_t extrafill;
+        cmsghdr hdr;
+    };
+#endif
+
     // This feature is not enabled on Windows, for now.
     // This is also turned off in case of MinGW
 #ifdef SRT_ENABLE_PKTINFO
@@ -167,11 +167,19 @@ struct SrtOptionAction
         flags[SRTO_RCVBUF]             = SRTO_R_PREBIND;
         flags[SRTO_UDP_SNDBUF]         = SRTO_R_PREBIND;
         flags[SRTO_UDP_RCVBUF]         = SRTO_R_PREBIND;
+        flags[SRTO_UDP_SNDBATCH]       = SRTO_R_PREBIND;
+        flags[SRTO_UDP_RCVBATCH]       = SRTO_R_PREBIND;
+        flags[SRTO_UDP_GSO]            = SRTO_R_PREBIND;
+        flags[SRTO_UDP_GRO]            = SRTO_R_PREBIND;
+        flags[SRTO_SNDWORKERS]         = SRTO_R_PREBIND;
+        flags[SRTO_CRYPTOWORKERS]      = SRTO_R_PREBIND;
+        flags[SRTO_LISTENSHARDS]       = SRTO_R_PREBIND;
         flags[SRTO_RENDEZVOUS]         = SRTO_R_PRE;
         flags[SRTO_REUSEADDR]          = SRTO_R_PREBIND;
         flags[SRTO_MAXBW]              = SRTO_POST_SPEC;
         flags[SRTO_SENDER]             = SRTO_R_PRE;
         flags[SRTO_TSBPDMODE]          = SRTO_R_PRE;
+        flags[SRTO_TSBPDSHARED]        = SRTO_R_PRE;
         flags[SRTO_LATENCY]            = SRTO_R_PRE;
         flags[SRTO_INPUTBW]            = SRTO_POST_SPEC;
         flags[SRTO_MININPUTBW]         = SRTO_POST_SPEC;
@@ -208,6 +216,7 @@ struct SrtOptionAction
 #endif
         flags[SRTO_PACKETFILTER]       = SRTO_R_PRE;
         flags[SRTO_RETRANSMITALGO]     = SRTO_R_PRE;
+        flags[SRTO_CRYPTOPRECOMP]      = SRTO_R_PRE;
 #ifdef ENABLE_AEAD_API_PREVIEW
         flags[SRTO_CRYPTOMODE]         = SRTO_R_PRE;
 #endif
@@ -262,6 +271,8 @@ CUDTUnited& srt::CUDT::uglobal()
 void srt::CUDT::construct()
 {
     m_pSndBuffer           = NULL;
+    m_iSndBatchPackets     = 0;
+    m_iTimerChecks         = 0;
     m_pRcvBuffer           = NULL;
     m_pSndLossList         = NULL;
     m_pRcvLossList         = NULL;
@@ -299,6 +310,10 @@ void srt::CUDT::construct()
     m_bPeerTsbPd          = false;
     m_bTsbPd              = false;
     m_bTsbPdNeedsWakeup   = false;
+    m_bTsbPdInPool        = false;
+#if ENABLE_BONDING
+    m_pTsbPdGroup         = NULL;
+#endif
     m_bGroupTsbPd         = false;
     m_bPeerTLPktDrop      = false;
     m_bBufferWasFull      = false;
@@ -517,6 +532,41 @@ void srt::CUDT::getOpt(SRT_SOCKOPT optName, void *optval, int &optlen)
         optlen         = sizeof(int);
         break;
 
+    case SRTO_UDP_SNDBATCH:
+        *(int *)optval = m_config.iUDPSndBatch;
+        optlen         = sizeof(int);
+        break;
+
+    case SRTO_UDP_RCVBATCH:
+        *(int *)optval = m_config.iUDPRcvBatch;
+        optlen         = sizeof(int);
+        break;
+
+    case SRTO_UDP_GSO:
+        *(bool *)optval = m_config.bUDPGSO;
+        optlen          = sizeof(bool);
+        break;
+
+    case SRTO_UDP_GRO:
+        *(bool *)optval = m_config.bUDPGRO;
+        optlen          = sizeof(bool);
+        break;
+
+    case SRTO_SNDWORKERS:
+        *(int *)optval = m_config.iSndWorkers;
+        optlen         = sizeof(int);
+        break;
+
+    case SRTO_CRYPTOWORKERS:
+        *(int *)optval = m_config.iCryptoWorkers;
+        optlen         = sizeof(int);
+        break;
+
+    case SRTO_LISTENSHARDS:
+        *(int *)optval = m_config.iListenShards;
+        optlen         = sizeof(int);
+        break;
+
     case SRTO_RENDEZVOUS:
         *(bool *)optval = m_config.bRendezvous;
         optlen          = sizeof(bool);
@@ -657,6 +707,11 @@ void srt::CUDT::getOpt(SRT_SOCKOPT optName, void *optval, int &optlen)
         optlen             = sizeof(bool);
         break;
 
+    case SRTO_TSBPDSHARED:
+        *(bool *)optval = m_config.bTSBPDShared;
+        optlen          = sizeof(bool);
+        break;
+
     case SRTO_TSBPDMODE:
         *(bool *)optval = m_config.bTSBPD;
         optlen             = sizeof(bool);
@@ -843,6 +898,11 @@ void srt::CUDT::getOpt(SRT_SOCKOPT optName, void *optval, int &optlen)
         *(int32_t *)optval = m_config.iRetransmitAlgo;
         optlen         = sizeof(int32_t);
         break;
+
+    case SRTO_CRYPTOPRECOMP:
+        *(int *)optval = m_config.iCryptoPrecomp;
+        optlen         = sizeof(int);
+        break;
 #ifdef ENABLE_AEAD_API_PREVIEW
     case SRTO_CRYPTOMODE:
         if (m_pCryptoControl)
@@ -930,7 +990,8 @@ void srt::CUDT::clearData()
         m_stats.tsLastSampleTime = steady_clock::now();
         m_stats.traceReorderDistance = 0;
         m_stats.traceBelatedTime = 0;
-        m_stats.sndDuration = m_stats.m_sndDurationTotal = 0;
+        m_stats.sndDuration = 0;
+        m_stats.m_sndDurationTotal = 0;
     }
 
     // Resetting these data because this happens when agent isn't connected.
@@ -966,12 +1027,14 @@ void srt::CUDT::open()
     m_pSNode->m_pUDT      = this;
     m_pSNode->m_tsTimeStamp = steady_clock::now();
     m_pSNode->m_iHeapLoc  = -1;
+    m_pSNode->m_pPrev     = NULL;
+    m_pSNode->m_pNext     = NULL;
 
     if (m_pRNode == NULL)
         m_pRNode = new CRNode;
     m_pRNode->m_pUDT      = this;
     m_pRNode->m_tsTimeStamp = steady_clock::now();
-    m_pRNode->m_pPrev = m_pRNode->m_pNext = NULL;
+    m_pRNode->m_iHeapLoc = -1;
     m_pRNode->m_bOnList                   = false;
 
     // Set initial values of smoothed RTT and RTT variance.
@@ -3464,7 +3527,7 @@ void srt::CUDT::synchronizeWithGroup(CUDTGroup* gp)
     // thing may happen in the meantime.
     steady_clock::time_point start_time, peer_start_time;
 
-    start_time = m_stats.tsStartTime;
+    start_time = m_stats.tsStartTime.load();
     peer_start_time = m_tsRcvPeerStartTime;
 
     if (!gp->applyGroupTime((start_time), (peer_start_time)))
@@ -3527,6 +3590,7 @@ void srt::CUDT::synchronizeWithGroup(CUDTGroup* gp)
 
     // These are the values that are normally set initially by setters.
     int32_t snd_isn = m_iSndLastAck, rcv_isn = m_iRcvLastAck;
+    bool defined_isn = false;
     if (!gp->applyGroupSequences(m_SocketID, (snd_isn), (rcv_isn)))
     {
         HLOGC(gmlog.Debug,
@@ -3541,7 +3605,11 @@ void srt::CUDT::synchronizeWithGroup(CUDTGroup* gp)
         HLOGC(gmlog.Debug,
                 log << CONID() << "synchronizeWithGroup: DEFINED ISN: RCV=%" << m_iRcvLastAck << " SND=%"
                 << m_iSndLastAck);
+        defined_isn = true;
     }
+
+    // A group receiver stores the packets of all members in one buffer.
+    m_bGroupTsbPd = gp->setupRcvBuffer(*this, defined_isn);
 }
 #endif
 
@@ -5517,148 +5585,13 @@ void * srt::CUDT::tsbpd(void* param)
     self->m_bTsbPdNeedsWakeup = true;
     while (!self->m_bClosing)
     {
-        steady_clock::time_point tsNextDelivery; // Next packet delivery time
-        bool                     rxready = false;
-#if ENABLE_BONDING
-        bool shall_update_group = false;
-#endif
-
         INCREMENT_THREAD_ITERATIONS();
 
-        enterCS(self->m_RcvBufferLock);
-        const steady_clock::time_point tnow = steady_clock::now();
-
-        self->m_pRcvBuffer->updRcvAvgDataSize(tnow);
-        const srt::CRcvBuffer::PacketInfo info = self->m_pRcvBuffer->getFirstValidPacketInfo();
-
-        const bool is_time_to_deliver = !is_zero(info.tsbpd_time) && (tnow >= info.tsbpd_time);
-        tsNextDelivery = info.tsbpd_time;
-
-#if ENABLE_HEAVY_LOGGING
-        if (info.seqno == SRT_SEQNO_NONE)
-        {
-            HLOGC(tslog.Debug, log << self->CONID() << "sok/tsbpd: packet check: NO PACKETS");
-        }
-        else
-        {
-            HLOGC(tslog.Debug, log << self->CONID() << "sok/tsbpd: packet check: %"
-                << info.seqno << " T=" << FormatTime(tsNextDelivery)
-                << " diff-now-playtime=" << FormatDuration(tnow - tsNextDelivery)
-                << " ready=" << is_time_to_deliver
-                << " ondrop=" << info.seq_gap);
-        }
-#endif
-
-        if (!self->m_bTLPktDrop)
-        {
-            rxready = !info.seq_gap && is_time_to_deliver;
-        }
-        else if (is_time_to_deliver)
-        {
-            rxready = true;
-            if (info.seq_gap)
-            {
-                const int iDropCnt SRT_ATR_UNUSED = self->rcvDropTooLateUpTo(info.seqno);
-#if ENABLE_BONDING
-                shall_update_group = true;
-#endif
-
-#if ENABLE_LOGGING
-                const int64_t timediff_us = count_microseconds(tnow - info.tsbpd_time);
-#if ENABLE_HEAVY_LOGGING
-                HLOGC(tslog.Debug,
-                    log << self->CONID() << "tsbpd: DROPSEQ: up to seqno %" << CSeqNo::decseq(info.seqno) << " ("
-                    << iDropCnt << " packets) playable at " << FormatTime(info.tsbpd_time) << " delayed "
-                    << (timediff_us / 1000) << "." << std::setw(3) << std::setfill('0') << (timediff_us % 1000) << " ms");
-#endif
-                string why;
-                if (self->frequentLogAllowed(FREQLOGFA_RCV_DROPPED, tnow, (why)))
-                {
-                    LOGC(brlog.Warn, log << self->CONID() << "RCV-DROPPED " << iDropCnt << " packet(s). Packet seqno %" << info.seqno
-                            << " delayed for " << (timediff_us / 1000) << "." << std::setw(3) << std::setfill('0')
-                            << (timediff_us % 1000) << " ms " << why);
-                }
-#if SRT_ENABLE_FREQUENT_LOG_TRACE
-                else
-                {
-                    LOGC(brlog.Warn, log << "SUPPRESSED: RCV-DROPPED LOG: " << why);
-                }
-#endif
-#endif
-
-                tsNextDelivery = steady_clock::time_point(); // Ready to read, nothing to wait for.
-            }
-        }
-        leaveCS(self->m_RcvBufferLock);
-
-        if (rxready)
-        {
-            HLOGC(tslog.Debug,
-                  log << self->CONID() << "tsbpd: PLAYING PACKET seq=" << info.seqno << " (belated "
-                      << FormatDuration<DUNIT_MS>(steady_clock::now() - info.tsbpd_time) << ")");
-            /*
-             * There are packets ready to be delivered
-             * signal a waiting "recv" call if there is any data available
-             */
-            if (self->m_config.bSynRecving)
-            {
-                recvdata_lcc.notify_one();
-            }
-            /*
-             * Set EPOLL_IN to wakeup any thread waiting on epoll
-             */
-            self->uglobal().m_EPoll.update_events(self->m_SocketID, self->m_sPollID, SRT_EPOLL_IN, true);
 #if ENABLE_BONDING
-            // If this is NULL, it means:
-            // - the socket never was a group member
-            // - the socket was a group member, but:
-            //    - was just removed as a part of closure
-            //    - and will never be member of the group anymore
-
-            // If this is not NULL, it means:
-            // - This socket is currently member of the group
-            // - This socket WAS a member of the group, though possibly removed from it already, BUT:
-            //   - the group that this socket IS OR WAS member of is in the GroupKeeper
-            //   - the GroupKeeper prevents the group from being deleted
-            //   - it is then completely safe to access the group here,
-            //     EVEN IF THE SOCKET THAT WAS ITS MEMBER IS BEING DELETED.
-
-            // It is ensured that the group object exists here because GroupKeeper
-            // keeps it busy, even if you just closed the socket, remove it as a member
-            // or even the group is empty and was explicitly closed.
-            if (gkeeper.group)
-            {
-                // Functions called below will lock m_GroupLock, which in hierarchy
-                // lies after m_RecvLock. Must unlock m_RecvLock to be able to lock
-                // m_GroupLock inside the calls.
-                InvertedLock unrecv(self->m_RecvLock);
-                // The current "APP reader" needs to simply decide as to whether
-                // the next CUDTGroup::recv() call should return with no blocking or not.
-                // When the group is read-ready, it should update its pollers as it sees fit.
-
-                // NOTE: this call will set lock to m_IncludedGroup->m_GroupLock
-                HLOGC(tslog.Debug, log << self->CONID() << "tsbpd: GROUP: checking if %" << info.seqno << " makes group readable");
-                gkeeper.group->updateReadState(self->m_SocketID, info.seqno);
-
-                if (shall_update_group)
-                {
-                    // A group may need to update the parallelly used idle links,
-                    // should it have any. Pass the current socket position in order
-                    // to skip it from the group loop.
-                    // NOTE: SELF LOCKING.
-                    gkeeper.group->updateLatestRcv(self->m_parent);
-                }
-            }
-
-            // After re-acquisition of the m_RecvLock, re-check the closing flag
-            if (self->m_bClosing)
-            {
-                break;
-            }
+        const steady_clock::time_point tsNextDelivery = self->tsbpdCheck(recvdata_lcc, gkeeper.group);
+#else
+        const steady_clock::time_point tsNextDelivery = self->tsbpdCheck(recvdata_lcc, NULL);
 #endif
-            CGlobEvent::triggerEvent();
-            tsNextDelivery = steady_clock::time_point(); // Ready to read, nothing to wait for.
-        }
 
         // We may just briefly unlocked the m_RecvLock, so we need to check m_bClosing again to avoid deadlock.
         if (self->m_bClosing)
@@ -5668,15 +5601,15 @@ void * srt::CUDT::tsbpd(void* param)
 
         if (!is_zero(tsNextDelivery))
         {
-            IF_HEAVY_LOGGING(const steady_clock::duration timediff = tsNextDelivery - tnow);
+            IF_HEAVY_LOGGING(const steady_clock::duration timediff = tsNextDelivery - steady_clock::now());
             /*
              * Buffer at head of queue is not ready to play.
              * Schedule wakeup when it will be.
              */
             self->m_bTsbPdNeedsWakeup = false;
             HLOGC(tslog.Debug,
-                  log << self->CONID() << "tsbpd: FUTURE PACKET seq=" << info.seqno
-                      << " T=" << FormatTime(tsNextDelivery) << " - waiting " << FormatDuration<DUNIT_MS>(timediff));
+                  log << self->CONID() << "tsbpd: FUTURE PACKET T=" << FormatTime(tsNextDelivery)
+                      << " - waiting " << FormatDuration<DUNIT_MS>(timediff));
             THREAD_PAUSED();
             bWokeUpOnSignal = tsbpd_cc.wait_until(tsNextDelivery);
             THREAD_RESUMED();
@@ -5711,6 +5644,176 @@ void * srt::CUDT::tsbpd(void* param)
     return NULL;
 }
 
+srt::sync::steady_clock::time_point srt::CUDT::tsbpdCheck(CUniqueSync& recvdata_lcc, CUDTGroup* group SRT_ATR_UNUSED)
+{
+    steady_clock::time_point tsNextDelivery; // Next packet delivery time
+    bool                     rxready = false;
+#if ENABLE_BONDING
+    bool shall_update_group = false;
+#endif
+
+    enterCS(m_RcvBufferLock);
+    const steady_clock::time_point tnow = steady_clock::now();
+
+    m_pRcvBuffer->updRcvAvgDataSize(tnow);
+    const srt::CRcvBuffer::PacketInfo info = m_pRcvBuffer->getFirstValidPacketInfo();
+
+    const bool is_time_to_deliver = !is_zero(info.tsbpd_time) && (tnow >= info.tsbpd_time);
+    tsNextDelivery = info.tsbpd_time;
+
+#if ENABLE_HEAVY_LOGGING
+    if (info.seqno == SRT_SEQNO_NONE)
+    {
+        HLOGC(tslog.Debug, log << CONID() << "sok/tsbpd: packet check: NO PACKETS");
+    }
+    else
+    {
+        HLOGC(tslog.Debug, log << CONID() << "sok/tsbpd: packet check: %"
+            << info.seqno << " T=" << FormatTime(tsNextDelivery)
+            << " diff-now-playtime=" << FormatDuration(tnow - tsNextDelivery)
+            << " ready=" << is_time_to_deliver
+            << " ondrop=" << info.seq_gap);
+    }
+#endif
+
+    if (!m_bTLPktDrop)
+    {
+        rxready = !info.seq_gap && is_time_to_deliver;
+    }
+    else if (is_time_to_deliver)
+    {
+        rxready = true;
+        if (info.seq_gap)
+        {
+            const int iDropCnt SRT_ATR_UNUSED = rcvDropTooLateUpTo(info.seqno);
+#if ENABLE_BONDING
+            shall_update_group = true;
+#endif
+
+#if ENABLE_LOGGING
+            const int64_t timediff_us = count_microseconds(tnow - info.tsbpd_time);
+#if ENABLE_HEAVY_LOGGING
+            HLOGC(tslog.Debug,
+                log << CONID() << "tsbpd: DROPSEQ: up to seqno %" << CSeqNo::decseq(info.seqno) << " ("
+                << iDropCnt << " packets) playable at " << FormatTime(info.tsbpd_time) << " delayed "
+                << (timediff_us / 1000) << "." << std::setw(3) << std::setfill('0') << (timediff_us % 1000) << " ms");
+#endif
+            string why;
+            if (frequentLogAllowed(FREQLOGFA_RCV_DROPPED, tnow, (why)))
+            {
+                LOGC(brlog.Warn, log << CONID() << "RCV-DROPPED " << iDropCnt << " packet(s). Packet seqno %" << info.seqno
+                        << " delayed for " << (timediff_us / 1000) << "." << std::setw(3) << std::setfill('0')
+                        << (timediff_us % 1000) << " ms " << why);
+            }
+#if SRT_ENABLE_FREQUENT_LOG_TRACE
+            else
+            {
+                LOGC(brlog.Warn, log << "SUPPRESSED: RCV-DROPPED LOG: " << why);
+            }
+#endif
+#endif
+
+            tsNextDelivery = steady_clock::time_point(); // Ready to read, nothing to wait for.
+        }
+    }
+    leaveCS(m_RcvBufferLock);
+
+    if (rxready)
+    {
+        HLOGC(tslog.Debug,
+              log << CONID() << "tsbpd: PLAYING PACKET seq=" << info.seqno << " (belated "
+                  << FormatDuration<DUNIT_MS>(steady_clock::now() - info.tsbpd_time) << ")");
+        /*
+         * There are packets ready to be delivered
+         * signal a waiting "recv" call if there is any data available
+         */
+        if (m_config.bSynRecving)
+        {
+            recvdata_lcc.notify_one();
+        }
+        /*
+         * Set EPOLL_IN to wakeup any thread waiting on epoll
+         */
+        uglobal().m_EPoll.update_events(m_SocketID, m_sPollID, SRT_EPOLL_IN, true);
+#if ENABLE_BONDING
+        // If this is NULL, it means:
+        // - the socket never was a group member
+        // - the socket was a group member, but:
+        //    - was just removed as a part of closure
+        //    - and will never be member of the group anymore
+
+        // If this is not NULL, it means:
+        // - This socket is currently member of the group
+        // - This socket WAS a member of the group, though possibly removed from it already, BUT:
+        //   - the group that this socket IS OR WAS member of is in the GroupKeeper
+        //   - the GroupKeeper prevents the group from being deleted
+        //   - it is then completely safe to access the group here,
+        //     EVEN IF THE SOCKET THAT WAS ITS MEMBER IS BEING DELETED.
+
+        // It is ensured that the group object exists here because GroupKeeper
+        // keeps it busy, even if you just closed the socket, remove it as a member
+        // or even the group is empty and was explicitly closed.
+        if (group)
+        {
+            // Functions called below will lock m_GroupLock, which in hierarchy
+            // lies after m_RecvLock. Must unlock m_RecvLock to be able to lock
+            // m_GroupLock inside the calls.
+            InvertedLock unrecv(m_RecvLock);
+            // The current "APP reader" needs to simply decide as to whether
+            // the next CUDTGroup::recv() call should return with no blocking or not.
+            // When the group is read-ready, it should update its pollers as it sees fit.
+
+            // NOTE: this call will set lock to m_IncludedGroup->m_GroupLock
+            HLOGC(tslog.Debug, log << CONID() << "tsbpd: GROUP: checking if %" << info.seqno << " makes group readable");
+            group->updateReadState(m_SocketID, info.seqno);
+
+            if (shall_update_group)
+            {
+                // A group may need to update the parallelly used idle links,
+                // should it have any. Pass the current socket position in order
+                // to skip it from the group loop.
+                // NOTE: SELF LOCKING.
+                group->updateLatestRcv(m_parent);
+            }
+        }
+
+        // After re-acquisition of the m_RecvLock, re-check the closing flag
+        if (m_bClosing)
+        {
+            return steady_clock::time_point();
+        }
+#endif
+        CGlobEvent::triggerEvent();
+        tsNextDelivery = steady_clock::time_point(); // Ready to read, nothing to wait for.
+    }
+
+    return tsNextDelivery;
+}
+
+srt::sync::steady_clock::time_point srt::CUDT::tsbpdSharedCheck()
+{
+    CUniqueSync recvdata_lcc (m_RecvLock, m_RecvDataCond);
+    if (m_bClosing)
+        return steady_clock::time_point();
+
+#if ENABLE_BONDING
+    const steady_clock::time_point tsNextCheck = tsbpdCheck(recvdata_lcc, m_pTsbPdGroup);
+#else
+    const steady_clock::time_point tsNextCheck = tsbpdCheck(recvdata_lcc, NULL);
+#endif
+    // Same as in tsbpd(): if there's no time to wait for, an ACK must wake it up.
+    m_bTsbPdNeedsWakeup = is_zero(tsNextCheck);
+    return tsNextCheck;
+}
+
+void srt::CUDT::notifyTsbPd()
+{
+    if (m_config.bTSBPDShared)
+        uglobal().tsbpdPool().wake(this);
+    else
+        m_RcvTsbPdCond.notify_one();
+}
+
 int srt::CUDT::rcvDropTooLateUpTo(int seqno, DropReason reason)
 {
     // Make sure that it would not drop over m_iRcvCurrSeqNo, which may break senders.
@@ -5728,11 +5831,9 @@ int srt::CUDT::rcvDropTooLateUpTo(int seqno, DropReason reason)
     const int iDropStatCnt = (reason == DROP_DISCARD) ? iDropCnt : iDropCntTotal;
     if (iDropStatCnt > 0)
     {
-        enterCS(m_StatsLock);
         // Estimate dropped bytes from average payload size.
         const uint64_t avgpayloadsz = m_pRcvBuffer->getRcvAvgPayloadSize();
         m_stats.rcvr.dropped.count(stats::BytesPackets(iDropStatCnt * avgpayloadsz, (uint32_t)iDropStatCnt));
-        leaveCS(m_StatsLock);
     }
     return iDropCntTotal;
 }
@@ -5754,7 +5855,6 @@ void srt::CUDT::setInitialRcvSeq(int32_t isn)
             LOGC(cnlog.Error, log << CONID() << "IPE: setInitialRcvSeq expected empty RCV buffer. Dropping all.");
             const int        iDropCnt     = m_pRcvBuffer->dropAll();
             const uint64_t   avgpayloadsz = m_pRcvBuffer->getRcvAvgPayloadSize();
-            sync::ScopedLock sl(m_StatsLock);
             m_stats.rcvr.dropped.count(stats::BytesPackets(iDropCnt * avgpayloadsz, (uint32_t) iDropCnt));
         }
 
@@ -6387,7 +6487,7 @@ bool srt::CUDT::closeInternal() ATR_NOEXCEPT
 
     // remove this socket from the snd queue
     if (m_bConnected)
-        m_pSndQueue->m_pSndUList->remove(this);
+        m_pSndQueue->sndList(this)->remove(this);
 
     /*
      * update_events below useless
@@ -6445,7 +6545,7 @@ bool srt::CUDT::closeInternal() ATR_NOEXCEPT
 
     HLOGC(smlog.Debug, log << CONID() << "CLOSING STATE (closing=true). Acquiring connection lock");
 
-    ScopedLock connectguard(m_ConnectionLock);
+    UniqueLock connectguard(m_ConnectionLock);
 
     // Signal the sender and recver if they are waiting for data.
     releaseSynch();
@@ -6493,8 +6593,8 @@ bool srt::CUDT::closeInternal() ATR_NOEXCEPT
     HLOGC(smlog.Debug, log << CONID() << "CLOSING, joining send/receive threads");
 
     // waiting all send and recv calls to stop
-    ScopedLock sendguard(m_SendLock);
-    ScopedLock recvguard(m_RecvLock);
+    UniqueLock sendguard(m_SendLock);
+    UniqueLock recvguard(m_RecvLock);
 
     // Locking m_RcvBufferLock to protect calling to m_pCryptoControl->decrypt((packet))
     // from the processData(...) function while resetting Crypto Control.
@@ -6508,11 +6608,37 @@ bool srt::CUDT::closeInternal() ATR_NOEXCEPT
     m_uPeerSrtVersion        = SRT_VERSION_UNK;
     m_tsRcvPeerStartTime     = steady_clock::time_point();
 
+    // Nothing will be sent anymore, so the user data of the zero-copy
+    // messages are released before returning, and the application can
+    // reuse them as soon as the socket is closed.
+    if (m_pSndBuffer)
+        m_pSndBuffer->ackData(m_pSndBuffer->getCurrBufSize());
+
     m_bOpened = false;
 
+    recvguard.unlock();
+    sendguard.unlock();
+    connectguard.unlock();
+
+    // Unless a packet packed before still waits in a send batch, in which
+    // case the sending queue does it once it's sent (see waitSndBatchOut()).
+    releaseSndUserData();
+
     return true;
 }
 
+void srt::CUDT::waitSndBatchOut()
+{
+    // Sending out the batch may need the locks of any socket
+    // and m_GlobControlLock, so none can be held here.
+    {
+        UniqueLock lk(m_SndBatchLock);
+        while (m_iSndBatchPackets > 0)
+            m_SndBatchCond.wait(lk);
+    }
+    releaseSndUserData();
+}
+
 bool srt::CUDT::closeAtFork() ATR_NOEXCEPT
 {
     m_bShutdown = true;
@@ -6563,7 +6689,6 @@ int srt::CUDT::receiveBuffer(char *data, int len)
     }
 
     CSync rcond  (m_RecvDataCond, recvguard);
-    CSync tscond (m_RcvTsbPdCond, recvguard);
     if (!isRcvBufferReady())
     {
         if (!m_config.bSynRecving)
@@ -6623,7 +6748,7 @@ int srt::CUDT::receiveBuffer(char *data, int len)
     if (m_bTsbPd)
     {
         HLOGP(tslog.Debug, "Ping TSBPD thread to schedule wakeup");
-        tscond.notify_one_locked(recvguard);
+        notifyTsbPd();
     }
     else
     {
@@ -6683,9 +6808,7 @@ int srt::CUDT::sndDropTooLate()
     m_iFlowWindowSize = m_iFlowWindowSize + dpkts;
 
     // If some packets were dropped update stats, socket state, loss list and the parent group if any.
-    enterCS(m_StatsLock);
     m_stats.sndr.dropped.count(stats::BytesPackets((uint64_t) dbytes, (uint32_t) dpkts));
-    leaveCS(m_StatsLock);
 
     IF_HEAVY_LOGGING(const int32_t realack = m_iSndLastDataAck);
     const int32_t fakeack = CSeqNo::incseq(m_iSndLastDataAck, dpkts);
@@ -6744,7 +6867,8 @@ int srt::CUDT::sendmsg(const char *data, int len, int msttl, bool inorder, int64
 // [[using maybe_locked(CUDTGroup::m_GroupLock, m_parent->m_GroupOf != NULL)]]
 // GroupLock is applied when this function is called from inside CUDTGroup::send,
 // which is the only case when the m_parent->m_GroupOf is not NULL.
-int srt::CUDT::sendmsg2(const char *data, int len, SRT_MSGCTRL& w_mctrl)
+int srt::CUDT::sendmsg2(const char *data, int len, SRT_MSGCTRL& w_mctrl,
+                        srt_sendbuf_release_fn* release_fn, void* opaque)
 {
     // throw an exception if not connected
     if (m_bBroken || m_bClosing)
@@ -6752,9 +6876,19 @@ int srt::CUDT::sendmsg2(const char *data, int len, SRT_MSGCTRL& w_mctrl)
     else if (!m_bConnected || !m_CongCtl.ready())
         throw CUDTException(MJ_CONNECTION, MN_NOCONN, 0);
 
+    // In the buffer mode only a part of the data may be accepted.
+    if (release_fn && !m_config.bMessageAPI)
+        throw CUDTException(MJ_NOTSUP, MN_INVALBUFFERAPI, 0);
+
+    // The payload is encrypted in place in the sender buffer,
+    // so the user data can only be referred to if not encrypted.
+    const bool zerocopy = release_fn && !(m_pCryptoControl && m_pCryptoControl->getSndCryptoFlags() != EK_NOENC);
+
     if (len <= 0)
     {
         LOGC(aslog.Error, log << CONID() << "INVALID: Data size for sending declared with length: " << len);
+        if (release_fn)
+            release_fn(opaque);
         return 0;
     }
 
@@ -6922,6 +7056,8 @@ int srt::CUDT::sendmsg2(const char *data, int len, SRT_MSGCTRL& w_mctrl)
                      << "IPE: sendmsg: the loop exited, while not enough size, still connected, peer healthy. "
                         "Impossible.");
 
+            if (release_fn)
+                release_fn(opaque);
             return 0;
         }
     }
@@ -6930,8 +7066,7 @@ int srt::CUDT::sendmsg2(const char *data, int len, SRT_MSGCTRL& w_mctrl)
     // record total time used for sending
     if (m_pSndBuffer->getCurrBufSize() == 0)
     {
-        ScopedLock lock(m_StatsLock);
-        m_stats.sndDurationCounter = steady_clock::now();
+        m_stats.sndDurationCounter.store(steady_clock::now());
     }
 
     int size = len;
@@ -6969,6 +7104,8 @@ int srt::CUDT::sendmsg2(const char *data, int len, SRT_MSGCTRL& w_mctrl)
             {
                 HLOGC(aslog.Debug, log << CONID() << "sock:SENDING (NOT): group-req %" << w_mctrl.pktseq
                         << " OLDER THAN next expected %" << seqno << " - FAKE-SENDING.");
+                if (release_fn)
+                    release_fn(opaque);
                 return size;
             }
         }
@@ -6987,7 +7124,7 @@ int srt::CUDT::sendmsg2(const char *data, int len, SRT_MSGCTRL& w_mctrl)
                 << " DATA SIZE: " << size << " sched-SEQUENCE: " << seqno
                 << " STAMP: " << BufferStamp(data, size));
 
-        if (w_mctrl.srctime && w_mctrl.srctime < count_microseconds(m_stats.tsStartTime.time_since_epoch()))
+        if (w_mctrl.srctime && w_mctrl.srctime < count_microseconds(m_stats.tsStartTime.load().time_since_epoch()))
         {
             LOGC(aslog.Error,
                 log << CONID() << "Wrong source time was provided. Sending is rejected.");
@@ -7008,7 +7145,10 @@ int srt::CUDT::sendmsg2(const char *data, int len, SRT_MSGCTRL& w_mctrl)
         // - OUTPUT: value of the sequence number to be put on the first packet at the next sendmsg2 call.
         // We need to supply to the output the value that was STAMPED ON THE PACKET,
         // which is seqno. In the output we'll get the next sequence number.
-        m_pSndBuffer->addBuffer(data, size, (w_mctrl));
+        if (zerocopy)
+            m_pSndBuffer->addBuffer(data, size, (w_mctrl), release_fn, opaque);
+        else
+            m_pSndBuffer->addBuffer(data, size, (w_mctrl));
         m_iSndNextSeqNo = w_mctrl.pktseq;
         w_mctrl.pktseq = seqno;
 
@@ -7023,9 +7163,13 @@ int srt::CUDT::sendmsg2(const char *data, int len, SRT_MSGCTRL& w_mctrl)
         }
     }
 
+    // The data were copied, so they are no longer needed.
+    if (release_fn && !zerocopy)
+        release_fn(opaque);
+
     // Insert this socket to the snd list if it is not on the list already.
     // m_pSndUList->pop may lock CSndUList::m_ListLock and then m_RecvAckLock
-    m_pSndQueue->m_pSndUList->update(this, CSndUList::DONT_RESCHEDULE);
+    m_pSndQueue->sndList(this)->update(this, CSndUList::DONT_RESCHEDULE);
 
 #ifdef SRT_ENABLE_ECN
     // IF there was a packet drop on the sender side, report congestion to the app.
@@ -7085,6 +7229,41 @@ int srt::CUDT::recvmsg2(char* data, int len, SRT_MSGCTRL& w_mctrl)
     return receiveBuffer(data, len);
 }
 
+int srt::CUDT::recvmsgZeroCopy(SRT_RCVLOAN& w_loan, SRT_MSGCTRL& w_mctrl)
+{
+#if ENABLE_BONDING
+    if (m_parent->m_GroupOf && m_parent->m_GroupOf->isGroupReceiver())
+    {
+        LOGP(arlog.Error, "recv*: This socket is a receiver group member. Use group ID, NOT socket ID.");
+        throw CUDTException(MJ_NOTSUP, MN_INVALMSGAPI, 0);
+    }
+#endif
+
+    if (!m_bConnected || !m_CongCtl.ready())
+        throw CUDTException(MJ_CONNECTION, MN_NOCONN, 0);
+
+    // In the buffer mode a read may end in the middle of a packet.
+    if (!m_config.bMessageAPI)
+        throw CUDTException(MJ_NOTSUP, MN_INVALBUFFERAPI, 0);
+
+    return receiveMessage(NULL, 0, (w_mctrl), 1, &w_loan);
+}
+
+void srt::CUDT::releaseRecvLoan(const SRT_RCVLOAN& loan)
+{
+    bool released = false;
+    {
+        ScopedLock lck(m_RcvBufferLock);
+        released = m_pRcvBuffer && m_pRcvBuffer->releaseLoan(loan);
+    }
+
+    if (!released)
+    {
+        LOGC(arlog.Error, log << CONID() << "srt_recvmsg_release: no such loan, or already released");
+        throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+    }
+}
+
 // [[using locked(m_RcvBufferLock)]]
 size_t srt::CUDT::getAvailRcvBufferSizeNoLock() const
 {
@@ -7112,7 +7291,7 @@ bool srt::CUDT::isRcvBufferFull() const
 // - 0 - by return value
 // - 1 - by exception
 // - 2 - by abort (unused)
-int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_exception)
+int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_exception, SRT_RCVLOAN* w_loan)
 {
     // Recvmsg isn't restricted to the congctl type, it's the most
     // basic method of passing the data. You can retrieve data as
@@ -7125,11 +7304,11 @@ int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_
     // is only used internally, we state that the problem that would be
     // handled by exception here should not happen, and in case if it does,
     // it's a bug to fix, so the exception is nothing wrong.
-    if (!m_CongCtl->checkTransArgs(SrtCongestion::STA_MESSAGE, SrtCongestion::STAD_RECV, data, len, SRT_MSGTTL_INF, false))
+    // A lent message needs no space in the application buffer.
+    if (!w_loan && !m_CongCtl->checkTransArgs(SrtCongestion::STA_MESSAGE, SrtCongestion::STAD_RECV, data, len, SRT_MSGTTL_INF, false))
         throw CUDTException(MJ_NOTSUP, MN_INVALMSGAPI, 0);
 
     UniqueLock recvguard (m_RecvLock);
-    CSync tscond     (m_RcvTsbPdCond,  recvguard);
 
     /* XXX DEBUG STUFF - enable when required
        char charbool[2] = {'0', '1'};
@@ -7149,7 +7328,7 @@ int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_
         HLOGC(arlog.Debug, log << CONID() << "receiveMessage: CONNECTION BROKEN - reading from recv buffer just for formality");
         enterCS(m_RcvBufferLock);
         const int res = (m_pRcvBuffer->isRcvDataReady(steady_clock::now()))
-            ? m_pRcvBuffer->readMessage(data, len, &w_mctrl)
+            ? (w_loan ? m_pRcvBuffer->lendMessage((*w_loan), &w_mctrl) : m_pRcvBuffer->readMessage(data, len, &w_mctrl))
             : 0;
         leaveCS(m_RcvBufferLock);
 
@@ -7157,7 +7336,7 @@ int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_
         if (m_bTsbPd)
         {
             HLOGP(tslog.Debug, "Ping TSBPD thread to schedule wakeup");
-            tscond.notify_one_locked(recvguard);
+            notifyTsbPd();
         }
         else
         {
@@ -7188,7 +7367,7 @@ int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_
         HLOGC(arlog.Debug, log << CONID() << "receiveMessage: BEGIN ASYNC MODE. Going to extract payload size=" << len);
         enterCS(m_RcvBufferLock);
         const int res = (m_pRcvBuffer->isRcvDataReady(steady_clock::now()))
-            ? m_pRcvBuffer->readMessage(data, len, &w_mctrl)
+            ? (w_loan ? m_pRcvBuffer->lendMessage((*w_loan), &w_mctrl) : m_pRcvBuffer->readMessage(data, len, &w_mctrl))
             : 0;
         leaveCS(m_RcvBufferLock);
         HLOGC(arlog.Debug, log << CONID() << "AFTER readMsg: (NON-BLOCKING) result=" << res);
@@ -7200,7 +7379,7 @@ int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_
             if (m_bTsbPd)
             {
                 HLOGP(arlog.Debug, "receiveMessage: nothing to read, kicking TSBPD, return AGAIN");
-                tscond.notify_one_locked(recvguard);
+                notifyTsbPd();
             }
             else
             {
@@ -7221,7 +7400,7 @@ int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_
             if (m_bTsbPd)
             {
                 HLOGP(arlog.Debug, "receiveMessage: DATA READ, but nothing more - kicking TSBPD.");
-                tscond.notify_one_locked(recvguard);
+                notifyTsbPd();
             }
             else
             {
@@ -7265,7 +7444,7 @@ int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_
                 // bool spurious = (tstime != 0);
 
                 HLOGC(tslog.Debug, log << CONID() << "receiveMessage: KICK tsbpd");
-                tscond.notify_one_locked(recvguard);
+                notifyTsbPd();
             }
 
             THREAD_PAUSED();
@@ -7307,7 +7486,7 @@ int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_
                 */
 
         enterCS(m_RcvBufferLock);
-        res = m_pRcvBuffer->readMessage((data), len, &w_mctrl);
+        res = w_loan ? m_pRcvBuffer->lendMessage((*w_loan), &w_mctrl) : m_pRcvBuffer->readMessage((data), len, &w_mctrl);
         leaveCS(m_RcvBufferLock);
         HLOGC(arlog.Debug, log << CONID() << "AFTER readMsg: (BLOCKING) result=" << res);
 
@@ -7342,7 +7521,7 @@ int srt::CUDT::receiveMessage(char* data, int len, SRT_MSGCTRL& w_mctrl, int by_
         if (m_bTsbPd)
         {
             HLOGP(tslog.Debug, "recvmsg: KICK tsbpd() (buffer empty)");
-            tscond.notify_one_locked(recvguard);
+            notifyTsbPd();
         }
 
         // Shut up EPoll if no more messages in non-blocking mode
@@ -7459,8 +7638,7 @@ int64_t srt::CUDT::sendfile(fstream &ifs, int64_t &offset, int64_t size, int blo
         // record total time used for sending
         if (m_pSndBuffer->getCurrBufSize() == 0)
         {
-            ScopedLock lock(m_StatsLock);
-            m_stats.sndDurationCounter = steady_clock::now();
+            m_stats.sndDurationCounter.store(steady_clock::now());
         }
 
         {
@@ -7481,7 +7659,7 @@ int64_t srt::CUDT::sendfile(fstream &ifs, int64_t &offset, int64_t size, int blo
         }
 
         // insert this socket to snd list if it is not on the list yet
-        m_pSndQueue->m_pSndUList->update(this, CSndUList::DONT_RESCHEDULE);
+        m_pSndQueue->sndList(this)->update(this, CSndUList::DONT_RESCHEDULE);
     }
 
     return size - tosend;
@@ -7624,77 +7802,84 @@ void srt::CUDT::bstats(CBytePerfMon *perf, bool clear, bool instantaneous)
 
         const steady_clock::time_point currtime = steady_clock::now();
 
-        perf->msTimeStamp          = count_milliseconds(currtime - m_stats.tsStartTime);
-        perf->pktSent              = m_stats.sndr.sent.trace.count();
-        perf->pktSentUnique        = m_stats.sndr.sentUnique.trace.count();
-        perf->pktRecv              = m_stats.rcvr.recvd.trace.count();
-        perf->pktRecvUnique        = m_stats.rcvr.recvdUnique.trace.count();
-
-        perf->pktSndLoss           = m_stats.sndr.lost.trace.count();
-        perf->pktRcvLoss           = m_stats.rcvr.lost.trace.count();
-        perf->pktRetrans           = m_stats.sndr.sentRetrans.trace.count();
-        perf->pktRcvRetrans        = m_stats.rcvr.recvdRetrans.trace.count();
-        perf->pktSentACK           = m_stats.rcvr.sentAck.trace.count();
-        perf->pktRecvACK           = m_stats.sndr.recvdAck.trace.count();
-        perf->pktSentNAK           = m_stats.rcvr.sentNak.trace.count();
-        perf->pktRecvNAK           = m_stats.sndr.recvdNak.trace.count();
-        perf->usSndDuration        = m_stats.sndDuration;
+        // The counters are updated without the lock; each one is read
+        // once here for both its trace and total value.
+        stats::SenderSnapshot   sndr;
+        stats::ReceiverSnapshot rcvr;
+        m_stats.sndr.snapshot((sndr), clear);
+        m_stats.rcvr.snapshot((rcvr), clear);
+
+        perf->msTimeStamp          = count_milliseconds(currtime - m_stats.tsStartTime.load());
+        perf->pktSent              = sndr.sent.trace.count();
+        perf->pktSentUnique        = sndr.sentUnique.trace.count();
+        perf->pktRecv              = rcvr.recvd.trace.count();
+        perf->pktRecvUnique        = rcvr.recvdUnique.trace.count();
+
+        perf->pktSndLoss           = sndr.lost.trace.count();
+        perf->pktRcvLoss           = rcvr.lost.trace.count();
+        perf->pktRetrans           = sndr.sentRetrans.trace.count();
+        perf->pktRcvRetrans        = rcvr.recvdRetrans.trace.count();
+        perf->pktSentACK           = rcvr.sentAck.trace.count();
+        perf->pktRecvACK           = sndr.recvdAck.trace.count();
+        perf->pktSentNAK           = rcvr.sentNak.trace.count();
+        perf->pktRecvNAK           = sndr.recvdNak.trace.count();
+        perf->usSndDuration        = clear ? m_stats.sndDuration.exchange(0) : m_stats.sndDuration.load();
         perf->pktReorderDistance   = m_stats.traceReorderDistance;
         perf->pktReorderTolerance  = m_iReorderTolerance;
         perf->pktRcvAvgBelatedTime = m_stats.traceBelatedTime;
-        perf->pktRcvBelated        = m_stats.rcvr.recvdBelated.trace.count();
+        perf->pktRcvBelated        = rcvr.recvdBelated.trace.count();
 
-        perf->pktSndFilterExtra  = m_stats.sndr.sentFilterExtra.trace.count();
-        perf->pktRcvFilterExtra  = m_stats.rcvr.recvdFilterExtra.trace.count();
-        perf->pktRcvFilterSupply = m_stats.rcvr.suppliedByFilter.trace.count();
-        perf->pktRcvFilterLoss   = m_stats.rcvr.lossFilter.trace.count();
+        perf->pktSndFilterExtra  = sndr.sentFilterExtra.trace.count();
+        perf->pktRcvFilterExtra  = rcvr.recvdFilterExtra.trace.count();
+        perf->pktRcvFilterSupply = rcvr.suppliedByFilter.trace.count();
+        perf->pktRcvFilterLoss   = rcvr.lossFilter.trace.count();
 
         /* perf byte counters include all headers (SRT+UDP+IP) */
-        perf->byteSent       = m_stats.sndr.sent.trace.bytesWithHdr(pktHdrSize);
-        perf->byteSentUnique = m_stats.sndr.sentUnique.trace.bytesWithHdr(pktHdrSize);
-        perf->byteRecv       = m_stats.rcvr.recvd.trace.bytesWithHdr(pktHdrSize);
-        perf->byteRecvUnique = m_stats.rcvr.recvdUnique.trace.bytesWithHdr(pktHdrSize);
-        perf->byteRetrans    = m_stats.sndr.sentRetrans.trace.bytesWithHdr(pktHdrSize);
-        perf->byteRcvLoss    = m_stats.rcvr.lost.trace.bytesWithHdr(pktHdrSize);
-
-        perf->pktSndDrop  = m_stats.sndr.dropped.trace.count();
-        perf->pktRcvDrop  = m_stats.rcvr.dropped.trace.count();
-        perf->byteSndDrop = m_stats.sndr.dropped.trace.bytesWithHdr(pktHdrSize);
-        perf->byteRcvDrop = m_stats.rcvr.dropped.trace.bytesWithHdr(pktHdrSize);
-        perf->pktRcvUndecrypt  = m_stats.rcvr.undecrypted.trace.count();
-        perf->byteRcvUndecrypt = m_stats.rcvr.undecrypted.trace.bytes();
-
-        perf->pktSentTotal       = m_stats.sndr.sent.total.count();
-        perf->pktSentUniqueTotal = m_stats.sndr.sentUnique.total.count();
-        perf->pktRecvTotal       = m_stats.rcvr.recvd.total.count();
-        perf->pktRecvUniqueTotal = m_stats.rcvr.recvdUnique.total.count();
-        perf->pktSndLossTotal    = m_stats.sndr.lost.total.count();
-        perf->pktRcvLossTotal    = m_stats.rcvr.lost.total.count();
-        perf->pktRetransTotal    = m_stats.sndr.sentRetrans.total.count();
-        perf->pktSentACKTotal    = m_stats.rcvr.sentAck.total.count();
-        perf->pktRecvACKTotal    = m_stats.sndr.recvdAck.total.count();
-        perf->pktSentNAKTotal    = m_stats.rcvr.sentNak.total.count();
-        perf->pktRecvNAKTotal    = m_stats.sndr.recvdNak.total.count();
+        perf->byteSent       = sndr.sent.trace.bytesWithHdr(pktHdrSize);
+        perf->byteSentUnique = sndr.sentUnique.trace.bytesWithHdr(pktHdrSize);
+        perf->byteRecv       = rcvr.recvd.trace.bytesWithHdr(pktHdrSize);
+        perf->byteRecvUnique = rcvr.recvdUnique.trace.bytesWithHdr(pktHdrSize);
+        perf->byteRetrans    = sndr.sentRetrans.trace.bytesWithHdr(pktHdrSize);
+        perf->byteRcvLoss    = rcvr.lost.trace.bytesWithHdr(pktHdrSize);
+
+        perf->pktSndDrop  = sndr.dropped.trace.count();
+        perf->pktRcvDrop  = rcvr.dropped.trace.count();
+        perf->byteSndDrop = sndr.dropped.trace.bytesWithHdr(pktHdrSize);
+        perf->byteRcvDrop = rcvr.dropped.trace.bytesWithHdr(pktHdrSize);
+        perf->pktRcvUndecrypt  = rcvr.undecrypted.trace.count();
+        perf->byteRcvUndecrypt = rcvr.undecrypted.trace.bytes();
+
+        perf->pktSentTotal       = sndr.sent.total.count();
+        perf->pktSentUniqueTotal = sndr.sentUnique.total.count();
+        perf->pktRecvTotal       = rcvr.recvd.total.count();
+        perf->pktRecvUniqueTotal = rcvr.recvdUnique.total.count();
+        perf->pktSndLossTotal    = sndr.lost.total.count();
+        perf->pktRcvLossTotal    = rcvr.lost.total.count();
+        perf->pktRetransTotal    = sndr.sentRetrans.total.count();
+        perf->pktSentACKTotal    = rcvr.sentAck.total.count();
+        perf->pktRecvACKTotal    = sndr.recvdAck.total.count();
+        perf->pktSentNAKTotal    = rcvr.sentNak.total.count();
+        perf->pktRecvNAKTotal    = sndr.recvdNak.total.count();
         perf->usSndDurationTotal = m_stats.m_sndDurationTotal;
 
-        perf->byteSentTotal           = m_stats.sndr.sent.total.bytesWithHdr(pktHdrSize);
-        perf->byteSentUniqueTotal     = m_stats.sndr.sentUnique.total.bytesWithHdr(pktHdrSize);
-        perf->byteRecvTotal           = m_stats.rcvr.recvd.total.bytesWithHdr(pktHdrSize);
-        perf->byteRecvUniqueTotal     = m_stats.rcvr.recvdUnique.total.bytesWithHdr(pktHdrSize);
-        perf->byteRetransTotal        = m_stats.sndr.sentRetrans.total.bytesWithHdr(pktHdrSize);
-        perf->pktSndFilterExtraTotal  = m_stats.sndr.sentFilterExtra.total.count();
-        perf->pktRcvFilterExtraTotal  = m_stats.rcvr.recvdFilterExtra.total.count();
-        perf->pktRcvFilterSupplyTotal = m_stats.rcvr.suppliedByFilter.total.count();
-        perf->pktRcvFilterLossTotal   = m_stats.rcvr.lossFilter.total.count();
-
-        perf->byteRcvLossTotal = m_stats.rcvr.lost.total.bytesWithHdr(pktHdrSize);
-        perf->pktSndDropTotal  = m_stats.sndr.dropped.total.count();
-        perf->pktRcvDropTotal  = m_stats.rcvr.dropped.total.count();
+        perf->byteSentTotal           = sndr.sent.total.bytesWithHdr(pktHdrSize);
+        perf->byteSentUniqueTotal     = sndr.sentUnique.total.bytesWithHdr(pktHdrSize);
+        perf->byteRecvTotal           = rcvr.recvd.total.bytesWithHdr(pktHdrSize);
+        perf->byteRecvUniqueTotal     = rcvr.recvdUnique.total.bytesWithHdr(pktHdrSize);
+        perf->byteRetransTotal        = sndr.sentRetrans.total.bytesWithHdr(pktHdrSize);
+        perf->pktSndFilterExtraTotal  = sndr.sentFilterExtra.total.count();
+        perf->pktRcvFilterExtraTotal  = rcvr.recvdFilterExtra.total.count();
+        perf->pktRcvFilterSupplyTotal = rcvr.suppliedByFilter.total.count();
+        perf->pktRcvFilterLossTotal   = rcvr.lossFilter.total.count();
+
+        perf->byteRcvLossTotal = rcvr.lost.total.bytesWithHdr(pktHdrSize);
+        perf->pktSndDropTotal  = sndr.dropped.total.count();
+        perf->pktRcvDropTotal  = rcvr.dropped.total.count();
         // TODO: The payload is dropped. Probably header sizes should not be counted?
-        perf->byteSndDropTotal = m_stats.sndr.dropped.total.bytesWithHdr(pktHdrSize);
-        perf->byteRcvDropTotal = m_stats.rcvr.dropped.total.bytesWithHdr(pktHdrSize);
-        perf->pktRcvUndecryptTotal  = m_stats.rcvr.undecrypted.total.count();
-        perf->byteRcvUndecryptTotal = m_stats.rcvr.undecrypted.total.bytes();
+        perf->byteSndDropTotal = sndr.dropped.total.bytesWithHdr(pktHdrSize);
+        perf->byteRcvDropTotal = rcvr.dropped.total.bytesWithHdr(pktHdrSize);
+        perf->pktRcvUndecryptTotal  = rcvr.undecrypted.total.count();
+        perf->byteRcvUndecryptTotal = rcvr.undecrypted.total.bytes();
 
         // TODO: The following class members must be protected with a different mutex, not the m_StatsLock.
         const double interval     = (double) count_microseconds(currtime - m_stats.tsLastSampleTime);
@@ -7715,14 +7900,38 @@ void srt::CUDT::bstats(CBytePerfMon *perf, bool clear, bool instantaneous)
 
         if (clear)
         {
-            m_stats.sndr.resetTrace();
-            m_stats.rcvr.resetTrace();
-
-            m_stats.sndDuration = 0;
             m_stats.tsLastSampleTime = currtime;
         }
     }
 
+    // Statistics of the multiplexer, shared by all sockets bound to the same UDP socket.
+    perf->sndBatchCallsTotal = m_pSndQueue ? m_pSndQueue->batchCallsTotal() : 0;
+    perf->pktSndBatchTotal   = m_pSndQueue ? m_pSndQueue->batchPacketsTotal() : 0;
+    perf->rcvBatchCallsTotal = m_pRcvQueue ? m_pRcvQueue->batchCallsTotal() : 0;
+    perf->pktRcvBatchTotal   = m_pRcvQueue ? m_pRcvQueue->batchPacketsTotal() : 0;
+    perf->sndGSOCallsTotal   = m_pSndQueue ? m_pSndQueue->gsoCallsTotal() : 0;
+    perf->pktSndGSOTotal     = m_pSndQueue ? m_pSndQueue->gsoPacketsTotal() : 0;
+    perf->rcvGROReadsTotal   = m_pRcvQueue ? m_pRcvQueue->groReadsTotal() : 0;
+    perf->pktRcvGROTotal     = m_pRcvQueue ? m_pRcvQueue->groSegmentsTotal() : 0;
+    perf->pktRcvUnitsCapacity = m_pRcvQueue ? m_pRcvQueue->unitsCapacity() : 0;
+    perf->pktRcvUnitsTaken    = m_pRcvQueue ? m_pRcvQueue->unitsTaken() : 0;
+    perf->rcvUnitsShrinkTotal = m_pRcvQueue ? m_pRcvQueue->unitsShrinkTotal() : 0;
+    perf->cryptoJobsTotal     = m_pSndQueue ? m_pSndQueue->cryptoJobsTotal() : 0;
+
+    perf->groupSndShare = 0;
+    perf->groupRcvShare = 0;
+    perf->pktSndKeystreamHitTotal  = 0;
+    perf->pktSndKeystreamMissTotal = 0;
+#if ENABLE_BONDING
+    if (m_parent->m_GroupOf)
+    {
+        // Re-checked under the lock as the socket may be just leaving the group.
+        SharedLock glock (uglobal().m_GlobControlLock);
+        if (m_parent->m_GroupOf)
+            m_parent->m_GroupOf->bstatsMember(m_SocketID, perf);
+    }
+#endif
+
     const int64_t availbw = m_iBandwidth == 1 ? m_RcvTimeWindow.getBandwidth() : m_iBandwidth.load();
 
     perf->mbpsBandwidth = Bps2Mbps(availbw * (m_iMaxSRTPayloadSize + pktHdrSize));
@@ -7773,6 +7982,9 @@ void srt::CUDT::bstats(CBytePerfMon *perf, bool clear, bool instantaneous)
             perf->msRcvBuf   = 0;
         }
 
+        if (m_pCryptoControl)
+            m_pCryptoControl->getKeystreamStats((perf->pktSndKeystreamHitTotal), (perf->pktSndKeystreamMissTotal));
+
         leaveCS(m_ConnectionLock);
     }
     else
@@ -7910,6 +8122,8 @@ void srt::CUDT::initSynch()
 {
     setupMutex(m_SendBlockLock, "SendBlock");
     setupCond(m_SendBlockCond, "SendBlock");
+    setupMutex(m_SndBatchLock, "SndBatch");
+    setupCond(m_SndBatchCond, "SndBatch");
     setupCond(m_RecvDataCond, "RecvData");
     setupMutex(m_SendLock, "Send");
     setupMutex(m_RecvLock, "Recv");
@@ -7932,6 +8146,10 @@ void srt::CUDT::destroySynch()
     m_SendBlockCond.notify_all();
     releaseCond(m_SendBlockCond);
 
+    releaseMutex(m_SndBatchLock);
+    m_SndBatchCond.notify_all();
+    releaseCond(m_SndBatchCond);
+
     m_RecvDataCond.notify_all();
     releaseCond(m_RecvDataCond);
     releaseMutex(m_SendLock);
@@ -7948,6 +8166,7 @@ void srt::CUDT::destroySynch()
 void srt::CUDT::resetAtFork()
 {
     resetCond(m_SendBlockCond);
+    resetCond(m_SndBatchCond);
     resetCond(m_RecvDataCond);
     resetCond(m_RcvTsbPdCond);
 }
@@ -7967,6 +8186,7 @@ void srt::CUDT::releaseSynch()
     leaveCS(m_SendLock);
 
     // Awake tsbpd() and srt_recv*(..) threads for them to check m_bClosing.
+    // A socket served by CTsbpdPool is removed from it below.
     CSync::lock_notify_all(m_RecvDataCond, m_RecvLock);
     CSync::lock_notify_all(m_RcvTsbPdCond, m_RecvLock);
 
@@ -7978,6 +8198,24 @@ void srt::CUDT::releaseSynch()
     {
         m_RcvTsbPdThread.join();
     }
+    if (m_bTsbPdInPool)
+    {
+        uglobal().tsbpdPool().remove(this);
+        m_bTsbPdInPool = false;
+    }
+#if ENABLE_BONDING
+    CUDTGroup* tsbpd_group = NULL;
+    {
+        // The reception reads it to store into the group buffer.
+        ScopedLock bufflock(m_RcvBufferLock);
+        std::swap(tsbpd_group, m_pTsbPdGroup);
+    }
+    if (tsbpd_group)
+    {
+        ScopedLock cgroup(*tsbpd_group->exp_groupLock());
+        tsbpd_group->apiRelease();
+    }
+#endif
     leaveCS(m_RcvTsbPdStartupLock);
 
     // Acquiring the m_RecvLock it is assumed that both tsbpd()
@@ -8054,9 +8292,7 @@ void srt::CUDT::sendCtrl(UDTMessageType pkttype, const int32_t* lparam, void* rp
             ctrlpkt.set_id(m_PeerID);
             nbsent        = m_pSndQueue->sendto(m_PeerAddr, ctrlpkt, m_SourceAddr);
 
-            enterCS(m_StatsLock);
             m_stats.rcvr.sentNak.count(1);
-            leaveCS(m_StatsLock);
         }
         // Call with no arguments - get loss list from internal data.
         else if (m_pRcvLossList->getLossLength() > 0)
@@ -8075,9 +8311,7 @@ void srt::CUDT::sendCtrl(UDTMessageType pkttype, const int32_t* lparam, void* rp
                 ctrlpkt.set_id(m_PeerID);
                 nbsent        = m_pSndQueue->sendto(m_PeerAddr, ctrlpkt, m_SourceAddr);
 
-                enterCS(m_StatsLock);
                 m_stats.rcvr.sentNak.count(1);
-                leaveCS(m_StatsLock);
             }
 
             delete[] data;
@@ -8161,7 +8395,9 @@ void srt::CUDT::sendCtrl(UDTMessageType pkttype, const int32_t* lparam, void* rp
 // [[using locked(m_RcvBufferLock)]]
 bool srt::CUDT::getFirstNoncontSequence(int32_t& w_seq, string& w_log_reason)
 {
-    if (m_config.bTSBPD || !m_config.bMessageAPI)
+    // The receiver buffer of a group member stays empty when the packets
+    // are stored in the group buffer, so the losses are taken from the loss list.
+    if ((m_config.bTSBPD || !m_config.bMessageAPI) && !m_bGroupTsbPd)
     {
         // The getFirstNonreadSeqNo() function retuens the sequence number of the first packet
         // that cannot be read. In cases when a message can consist of several data packets,
@@ -8328,10 +8564,10 @@ int srt::CUDT::sendCtrlAck(CPacket& ctrlpkt, int size)
         if (m_bTsbPd)
         {
             /* Newly acknowledged data, signal TsbPD thread */
-            CUniqueSync tslcc (m_RecvLock, m_RcvTsbPdCond);
+            ScopedLock tslock (m_RecvLock);
             // m_bTsbPdAckWakeup is protected by m_RecvLock in the tsbpd() thread
             if (m_bTsbPdNeedsWakeup)
-                tslcc.notify_one();
+                notifyTsbPd();
         }
         else
         {
@@ -8458,9 +8694,7 @@ int srt::CUDT::sendCtrlAck(CPacket& ctrlpkt, int size)
 
         m_ACKWindow.store(m_iAckSeqNo, m_iRcvLastAck);
 
-        enterCS(m_StatsLock);
         m_stats.rcvr.sentAck.count(1);
-        leaveCS(m_StatsLock);
     }
     else
     {
@@ -8541,9 +8775,13 @@ void srt::CUDT::updateSndLossListOnACK(int32_t ackdata_seqno)
     }
 #endif
 
+    // The acknowledged user data are released here, out of the locks,
+    // so that it doesn't wait for the next round of the sending queue.
+    releaseSndUserData();
+
     // insert this socket to snd list if it is not on the list yet
     const steady_clock::time_point currtime = steady_clock::now();
-    m_pSndQueue->m_pSndUList->update(this, CSndUList::DONT_RESCHEDULE, currtime);
+    m_pSndQueue->sndList(this)->update(this, CSndUList::DONT_RESCHEDULE, currtime);
 
     if (m_config.bSynSending)
     {
@@ -8551,11 +8789,10 @@ void srt::CUDT::updateSndLossListOnACK(int32_t ackdata_seqno)
     }
 
     // record total time used for sending
-    enterCS(m_StatsLock);
-    m_stats.sndDuration += count_microseconds(currtime - m_stats.sndDurationCounter);
-    m_stats.m_sndDurationTotal += count_microseconds(currtime - m_stats.sndDurationCounter);
-    m_stats.sndDurationCounter = currtime;
-    leaveCS(m_StatsLock);
+    const int64_t snd_duration = count_microseconds(currtime - m_stats.sndDurationCounter.load());
+    m_stats.sndDuration.fetch_add_relaxed(snd_duration);
+    m_stats.m_sndDurationTotal.fetch_add_relaxed(snd_duration);
+    m_stats.sndDurationCounter.store(currtime);
 }
 
 void srt::CUDT::processCtrlAck(const CPacket &ctrlpkt, const steady_clock::time_point& currtime)
@@ -8652,7 +8889,7 @@ void srt::CUDT::processCtrlAck(const CPacket &ctrlpkt, const steady_clock::time_
             const int cwnd    = std::min<int>(m_iFlowWindowSize, m_iCongestionWindow);
             if (bWasStuck && cwnd > getFlightSpan())
             {
-                m_pSndQueue->m_pSndUList->update(this, CSndUList::DONT_RESCHEDULE);
+                m_pSndQueue->sndList(this)->update(this, CSndUList::DONT_RESCHEDULE);
                 HLOGC(gglog.Debug,
                         log << CONID() << "processCtrlAck: could reschedule SND. iFlowWindowSize " << m_iFlowWindowSize
                         << " SPAN " << getFlightSpan() << " ackdataseqno %" << ackdata_seqno);
@@ -8724,9 +8961,7 @@ void srt::CUDT::processCtrlAck(const CPacket &ctrlpkt, const steady_clock::time_
     {
         // Suppose transmission is bidirectional if sender is also receiving
         // data packets.
-        enterCS(m_StatsLock);
-        const bool bPktsReceived = m_stats.rcvr.recvd.total.count() != 0;
-        leaveCS(m_StatsLock);
+        const bool bPktsReceived = m_stats.rcvr.recvd.total().count() != 0;
 
         if (bPktsReceived)  // Transmission is bidirectional.
         {
@@ -8816,9 +9051,7 @@ void srt::CUDT::processCtrlAck(const CPacket &ctrlpkt, const steady_clock::time_
 
     updateCC(TEV_ACK, EventVariant(ackdata_seqno));
 
-    enterCS(m_StatsLock);
     m_stats.sndr.recvdAck.count(1);
-    leaveCS(m_StatsLock);
 }
 
 void srt::CUDT::processCtrlAckAck(const CPacket& ctrlpkt, const time_point& tsArrival)
@@ -9012,9 +9245,7 @@ void srt::CUDT::processCtrlLossReport(const CPacket& ctrlpkt)
                     sendCtrl(UMSG_DROPREQ, &no_msgno, seqpair, sizeof(seqpair));
                 }
 
-                enterCS(m_StatsLock);
                 m_stats.sndr.lost.count(num);
-                leaveCS(m_StatsLock);
             }
             // ELSE the loss is a single seq
             else
@@ -9036,9 +9267,7 @@ void srt::CUDT::processCtrlLossReport(const CPacket& ctrlpkt)
                             log << CONID() << "LOSSREPORT: adding %" << losslist[i] << " (1 packet) to loss list");
                     const int num = m_pSndLossList->insert(losslist[i], losslist[i]);
 
-                    enterCS(m_StatsLock);
                     m_stats.sndr.lost.count(num);
-                    leaveCS(m_StatsLock);
                 }
                 // ELSE loss_seq %< m_iSndLastAck
                 else
@@ -9073,11 +9302,9 @@ void srt::CUDT::processCtrlLossReport(const CPacket& ctrlpkt)
     }
 
     // the lost packet (retransmission) should be sent out immediately
-    m_pSndQueue->m_pSndUList->update(this, CSndUList::DONT_RESCHEDULE);
+    m_pSndQueue->sndList(this)->update(this, CSndUList::DONT_RESCHEDULE);
 
-    enterCS(m_StatsLock);
     m_stats.sndr.recvdNak.count(1);
-    leaveCS(m_StatsLock);
 }
 
 void srt::CUDT::processCtrlHS(const CPacket& ctrlpkt)
@@ -9198,7 +9425,7 @@ void srt::CUDT::processCtrlDropReq(const CPacket& ctrlpkt)
     const int32_t* dropdata = (const int32_t*) ctrlpkt.m_pcData;
 
     {
-        CUniqueSync rcvtscc (m_RecvLock, m_RcvTsbPdCond);
+        ScopedLock rcvtslock (m_RecvLock);
         // With both TLPktDrop and TsbPd enabled, a message always consists only of one packet.
         // It will be dropped as too late anyway. Not dropping it from the receiver buffer
         // in advance reduces false drops if the packet somehow manages to arrive.
@@ -9238,7 +9465,7 @@ void srt::CUDT::processCtrlDropReq(const CPacket& ctrlpkt)
         if (m_bTsbPd)
         {
             HLOGP(inlog.Debug, "DROPREQ: signal TSBPD");
-            rcvtscc.notify_one();
+            notifyTsbPd();
         }
     }
 
@@ -9502,10 +9729,9 @@ int srt::CUDT::packLostData(CPacket& w_packet)
             // XXX Likely that this will never be executed because if the upper
             // sequence is not in the sender buffer, then most likely the loss 
             // was completely ignored.
-            LOGC(qrlog.Error,
-                 log << CONID() << "IPE/EPE: packLostData: LOST packet negative offset: seqoff(seqno() "
-                     << w_packet.seqno() << ", m_iSndLastDataAck " << m_iSndLastDataAck << ")=" << offset
-                     << ". Continue, request DROP");
+            LOGB(qrlog.Error,
+                 "@{}: IPE/EPE: packLostData: LOST packet negative offset: seqoff(seqno() {}, m_iSndLastDataAck {})={}. Continue, request DROP",
+                 log << m_SocketID << w_packet.seqno() << m_iSndLastDataAck << offset);
 
             // No matter whether this is right or not (maybe the attack case should be
             // considered, and some LOSSREPORT flood prevention), send the drop request
@@ -9515,10 +9741,8 @@ int srt::CUDT::packLostData(CPacket& w_packet)
                 CSeqNo::decseq(m_iSndLastDataAck)
             };
 
-            HLOGC(qrlog.Debug,
-                  log << CONID() << "PEER reported LOSS not from the sending buffer - requesting DROP: #"
-                      << MSGNO_SEQ::unwrap(w_packet.msgflags()) << " SEQ:" << seqpair[0] << " - " << seqpair[1] << "("
-                      << (-offset) << " packets)");
+            HLOGB(qrlog.Debug, "@{}: PEER reported LOSS not from the sending buffer - requesting DROP: #{} SEQ:{} - {}({} packets)",
+                  log << m_SocketID << MSGNO_SEQ::unwrap(w_packet.msgflags()) << seqpair[0] << seqpair[1] << (-offset));
 
             // See interpretation in processCtrlDropReq(). We don't know the message number,
             // so we request that the drop be exclusively sequence number based.
@@ -9533,10 +9757,8 @@ int srt::CUDT::packLostData(CPacket& w_packet)
             const steady_clock::time_point tsLastRexmit = m_pSndBuffer->getPacketRexmitTime(offset);
             if (tsLastRexmit >= time_nak)
             {
-                HLOGC(qrlog.Debug, log << CONID() << "REXMIT: ignoring seqno "
-                    << w_packet.seqno() << ", last rexmit " << (is_zero(tsLastRexmit) ? "never" : FormatTime(tsLastRexmit))
-                    << " RTT=" << m_iSRTT << " RTTVar=" << m_iRTTVar
-                    << " now=" << FormatTime(time_now));
+                HLOGB(qrlog.Debug, "@{}: REXMIT: ignoring seqno {}, last rexmit {} RTT={} RTTVar={} now={}",
+                    log << m_SocketID << w_packet.seqno() << tsLastRexmit << m_iSRTT << m_iRTTVar << time_now);
                 continue;
             }
         }
@@ -9550,10 +9772,9 @@ int srt::CUDT::packLostData(CPacket& w_packet)
         {
             SRT_ASSERT(CSeqNo::seqoff(buffer_drop.seqno[DropRange::BEGIN], buffer_drop.seqno[DropRange::END]) >= 0);
 
-            HLOGC(qrlog.Debug,
-                  log << CONID() << "loss-reported packets expired in SndBuf - requesting DROP: #"
-                      << buffer_drop.msgno << " %(" << buffer_drop.seqno[DropRange::BEGIN] << " - "
-                      << buffer_drop.seqno[DropRange::END] << ")");
+            HLOGB(qrlog.Debug, "@{}: loss-reported packets expired in SndBuf - requesting DROP: #{} %({} - {})",
+                  log << m_SocketID << buffer_drop.msgno << buffer_drop.seqno[DropRange::BEGIN]
+                      << buffer_drop.seqno[DropRange::END]);
             sendCtrl(UMSG_DROPREQ, &buffer_drop.msgno, buffer_drop.seqno, sizeof(buffer_drop.seqno));
 
             // skip all dropped packets
@@ -9576,9 +9797,7 @@ int srt::CUDT::packLostData(CPacket& w_packet)
         // Therefore unlocking in order not to block other threads.
         ackguard.unlock();
 
-        enterCS(m_StatsLock);
         m_stats.sndr.sentRetrans.count(payload);
-        leaveCS(m_StatsLock);
 
         // Despite the contextual interpretation of packet.m_iMsgNo around
         // CSndBuffer::readData version 2 (version 1 doesn't return -1), in this particular
@@ -9688,17 +9907,13 @@ snd_logger g_snd_logger;
 
 void srt::CUDT::setPacketTS(CPacket& p, const time_point& ts)
 {
-    enterCS(m_StatsLock);
-    const time_point tsStart = m_stats.tsStartTime;
-    leaveCS(m_StatsLock);
+    const time_point tsStart = m_stats.tsStartTime.load();
     p.set_timestamp(makeTS(ts, tsStart));
 }
 
 void srt::CUDT::setDataPacketTS(CPacket& p, const time_point& ts)
 {
-    enterCS(m_StatsLock);
-    const time_point tsStart = m_stats.tsStartTime;
-    leaveCS(m_StatsLock);
+    const time_point tsStart = m_stats.tsStartTime.load();
 
     if (!m_bPeerTsbPd)
     {
@@ -9711,10 +9926,9 @@ void srt::CUDT::setDataPacketTS(CPacket& p, const time_point& ts)
     if (ts < tsStart)
     {
         p.set_timestamp(makeTS(steady_clock::now(), tsStart));
-        LOGC(qslog.Warn,
-            log << CONID() << "setPacketTS: reference time=" << FormatTime(ts)
-            << " is in the past towards start time=" << FormatTime(tsStart)
-            << " - setting NOW as reference time for the data packet");
+        LOGB(qslog.Warn,
+            "@{}: setPacketTS: reference time={} is in the past towards start time={} - setting NOW as reference time for the data packet",
+            log << m_SocketID << ts << tsStart);
         return;
     }
 
@@ -9739,7 +9953,7 @@ bool srt::CUDT::isRetransmissionAllowed(const time_point& tnow SRT_ATR_UNUSED)
     const int msNextUniqueToSend = count_milliseconds(tnow - tsNextPacket) + m_iPeerTsbPdDelay_ms;
 
     g_snd_logger.state.tsNow = tnow;
-    g_snd_logger.state.usElapsed = count_microseconds(tnow - m_stats.tsStartTime);
+    g_snd_logger.state.usElapsed = count_microseconds(tnow - m_stats.tsStartTime.load());
     g_snd_logger.state.usSRTT = m_iSRTT;
     g_snd_logger.state.usRTTVar = m_iRTTVar;
     g_snd_logger.state.msSndBuffSpan = buffdelay_ms;
@@ -9773,12 +9987,15 @@ bool srt::CUDT::isRetransmissionAllowed(const time_point& tnow SRT_ATR_UNUSED)
     return true;
 }
 
-bool srt::CUDT::packData(CPacket& w_packet, steady_clock::time_point& w_nexttime, sockaddr_any& w_src_addr)
+bool srt::CUDT::packData(CPacket& w_packet, steady_clock::time_point& w_nexttime, sockaddr_any& w_src_addr, bool* w_encrypt)
 {
     int payload = 0;
     bool probe = false;
     bool new_packet_packed = false;
 
+    if (w_encrypt)
+        *w_encrypt = false;
+
     const steady_clock::time_point enter_time = steady_clock::now();
 
     w_nexttime = enter_time;
@@ -9811,17 +10028,18 @@ bool srt::CUDT::packData(CPacket& w_packet, steady_clock::time_point& w_nexttime
     else if (m_PacketFilter &&
              m_PacketFilter.packControlPacket(m_iSndCurrSeqNo, m_pCryptoControl->getSndCryptoFlags(), (w_packet)))
     {
-        HLOGC(qslog.Debug, log << CONID() << "filter: filter/CTL packet ready - packing instead of data.");
+        HLOGB(qslog.Debug, "@{}: filter: filter/CTL packet ready - packing instead of data.", log << m_SocketID);
         payload        = (int) w_packet.getLength();
         IF_HEAVY_LOGGING(reason = "filter");
 
         // Stats
-        ScopedLock lg(m_StatsLock);
         m_stats.sndr.sentFilterExtra.count(1);
     }
     else
     {
-        if (!packUniqueData(w_packet))
+        // The packet filter works on the encrypted packets, so it must get them encrypted.
+        bool* encrypt = m_PacketFilter ? NULL : w_encrypt;
+        if (!packUniqueData(w_packet, encrypt))
         {
             m_tsNextSendTime = steady_clock::time_point();
             m_tdSendTimeDiff = steady_clock::duration();
@@ -9834,6 +10052,8 @@ bool srt::CUDT::packData(CPacket& w_packet, steady_clock::time_point& w_nexttime
             probe = true;
 
         payload = (int) w_packet.getLength();
+        if (encrypt && *encrypt)
+            payload += getAuthTagSize(); // Added when encrypted
         IF_HEAVY_LOGGING(reason = "normal");
     }
 
@@ -9841,14 +10061,14 @@ bool srt::CUDT::packData(CPacket& w_packet, steady_clock::time_point& w_nexttime
 
     if (new_packet_packed && m_PacketFilter)
     {
-        HLOGC(qslog.Debug, log << CONID() << "filter: Feeding packet for source clip");
+        HLOGB(qslog.Debug, "@{}: filter: Feeding packet for source clip", log << m_SocketID);
         m_PacketFilter.feedSource((w_packet));
     }
 
-#if ENABLE_HEAVY_LOGGING // Required because of referring to MessageFlagStr()
-    HLOGC(qslog.Debug,
-          log << CONID() << "packData: " << reason << " packet seq=" << w_packet.seqno() << " (ACK=" << m_iSndLastAck
-              << " ACKDATA=" << m_iSndLastDataAck << " MSG/FLAGS: " << w_packet.MessageFlagStr() << ")");
+#if ENABLE_HEAVY_LOGGING // Required because of referring to MessageFlags()
+    HLOGB(qslog.Debug, "@{}: packData: {} packet seq={} (ACK={} ACKDATA={} MSG/FLAGS: {})",
+          log << m_SocketID << reason << w_packet.seqno() << m_iSndLastAck << m_iSndLastDataAck
+              << w_packet.MessageFlags());
 #endif
 
     // Fix keepalive
@@ -9868,11 +10088,9 @@ bool srt::CUDT::packData(CPacket& w_packet, steady_clock::time_point& w_nexttime
     // different thread than the rest of the signals.
     // m_pSndTimeWindow->onPktSent(w_packet.timestamp());
 
-    enterCS(m_StatsLock);
     m_stats.sndr.sent.count(payload);
     if (new_packet_packed)
         m_stats.sndr.sentUnique.count(payload);
-    leaveCS(m_StatsLock);
 
     const duration sendint = m_tdSendInterval;
     if (probe)
@@ -9906,14 +10124,14 @@ bool srt::CUDT::packData(CPacket& w_packet, steady_clock::time_point& w_nexttime
         }
 #endif
     }
-    HLOGC(qslog.Debug, log << "packData: Setting source address: " << m_SourceAddr.str());
+    HLOGB(qslog.Debug, "packData: Setting source address: {}", log << m_SourceAddr.str());
     w_src_addr = m_SourceAddr;
     w_nexttime = m_tsNextSendTime;
 
     return payload >= 0; // XXX shouldn't be > 0 ? == 0 is only when buffer range exceeded.
 }
 
-bool srt::CUDT::packUniqueData(CPacket& w_packet)
+bool srt::CUDT::packUniqueData(CPacket& w_packet, bool* w_encrypt)
 {
     int current_sequence_number; // reflexing variable
     int kflg;
@@ -9927,9 +10145,9 @@ bool srt::CUDT::packUniqueData(CPacket& w_packet)
         const int flightspan = getFlightSpan();
         if (cwnd <= flightspan)
         {
-            HLOGC(qslog.Debug,
-                    log << CONID() << "packUniqueData: CONGESTED: cwnd=min(" << m_iFlowWindowSize << "," << m_iCongestionWindow
-                    << ")=" << cwnd << " seqlen=(" << m_iSndLastAck << "-" << m_iSndCurrSeqNo << ")=" << flightspan);
+            HLOGB(qslog.Debug, "@{}: packUniqueData: CONGESTED: cwnd=min({},{})={} seqlen=({}-{})={}",
+                    log << m_SocketID << m_iFlowWindowSize << m_iCongestionWindow << cwnd << m_iSndLastAck
+                        << m_iSndCurrSeqNo << flightspan);
             return false;
         }
 
@@ -9945,13 +10163,13 @@ bool srt::CUDT::packUniqueData(CPacket& w_packet)
         {
             // Some packets were skipped due to TTL expiry.
             m_iSndCurrSeqNo = CSeqNo::incseq(m_iSndCurrSeqNo, pktskipseqno);
-            HLOGC(qslog.Debug, log << "packUniqueData: reading skipped " << pktskipseqno << " seq up to %" << m_iSndCurrSeqNo
-                    << " due to TTL expiry");
+            HLOGB(qslog.Debug, "packUniqueData: reading skipped {} seq up to %{} due to TTL expiry",
+                    log << pktskipseqno << m_iSndCurrSeqNo);
         }
 
         if (pld_size == 0)
         {
-            HLOGC(qslog.Debug, log << "packUniqueData: nothing extracted from the buffer");
+            HLOGB(qslog.Debug, "packUniqueData: nothing extracted from the buffer", log);
             return false;
         }
 
@@ -9978,18 +10196,18 @@ bool srt::CUDT::packUniqueData(CPacket& w_packet)
                 // after connection. No packets in the buffer, no packets are sent,
                 // no ACK to be awaited. We can screw up all the variables that are
                 // initialized from ISN just after connection.
-                LOGC(qslog.Note,
-                     log << CONID() << "packUniqueData: Fixing EXTRACTION sequence " << current_sequence_number
-                         << " from SCHEDULING sequence " << w_packet.seqno() << " for the first packet: DIFF="
-                         << packetspan << " STAMP=" << BufferStamp(w_packet.m_pcData, w_packet.getLength()));
+                LOGB(qslog.Note,
+                     "@{}: packUniqueData: Fixing EXTRACTION sequence {} from SCHEDULING sequence {} for the first packet: DIFF={} STAMP={}",
+                     log << m_SocketID << current_sequence_number << w_packet.seqno() << packetspan
+                         << BufferStamp(w_packet.m_pcData, w_packet.getLength()));
             }
             else
             {
                 // There will be a serious data discrepancy between the agent and the peer.
-                LOGC(qslog.Error,
-                     log << CONID() << "IPE: packUniqueData: Fixing EXTRACTION sequence " << current_sequence_number
-                         << " from SCHEDULING sequence " << w_packet.seqno() << " in the middle of transition: DIFF="
-                         << packetspan << " STAMP=" << BufferStamp(w_packet.m_pcData, w_packet.getLength()));
+                LOGB(qslog.Error,
+                     "@{}: IPE: packUniqueData: Fixing EXTRACTION sequence {} from SCHEDULING sequence {} in the middle of transition: DIFF={} STAMP={}",
+                     log << m_SocketID << current_sequence_number << w_packet.seqno() << packetspan
+                         << BufferStamp(w_packet.m_pcData, w_packet.getLength()));
             }
 
             // Additionally send the drop request to the peer so that it
@@ -9999,9 +10217,8 @@ bool srt::CUDT::packUniqueData(CPacket& w_packet)
             seqpair[0]             = current_sequence_number;
             seqpair[1]             = CSeqNo::decseq(w_packet.seqno());
             const int32_t no_msgno = 0;
-            LOGC(qslog.Debug,
-                 log << CONID() << "packUniqueData: Sending DROPREQ: SEQ: " << seqpair[0] << " - " << seqpair[1] << " ("
-                     << packetspan << " packets)");
+            LOGB(qslog.Debug, "@{}: packUniqueData: Sending DROPREQ: SEQ: {} - {} ({} packets)",
+                 log << m_SocketID << seqpair[0] << seqpair[1] << packetspan);
             sendCtrl(UMSG_DROPREQ, &no_msgno, seqpair, sizeof(seqpair));
             // In case when this message is lost, the peer will still get the
             // UMSG_DROPREQ message when the agent realizes that the requested
@@ -10017,10 +10234,10 @@ bool srt::CUDT::packUniqueData(CPacket& w_packet)
         }
         else if (packetspan < 0)
         {
-            LOGC(qslog.Error,
-                 log << CONID() << "IPE: packData: SCHEDULING sequence " << w_packet.seqno()
-                     << " is behind of EXTRACTION sequence " << current_sequence_number << ", dropping this packet: DIFF="
-                     << packetspan << " STAMP=" << BufferStamp(w_packet.m_pcData, w_packet.getLength()));
+            LOGB(qslog.Error,
+                 "@{}: IPE: packData: SCHEDULING sequence {} is behind of EXTRACTION sequence {}, dropping this packet: DIFF={} STAMP={}",
+                 log << m_SocketID << w_packet.seqno() << current_sequence_number << packetspan
+                     << BufferStamp(w_packet.m_pcData, w_packet.getLength()));
             // XXX: Probably also change the socket state to broken?
             return false;
         }
@@ -10028,11 +10245,11 @@ bool srt::CUDT::packUniqueData(CPacket& w_packet)
     else
 #endif
     {
-        HLOGC(qslog.Debug,
-              log << CONID() << "packUniqueData: Applying EXTRACTION sequence " << current_sequence_number
-                  << " over SCHEDULING sequence " << w_packet.seqno() << " for socket not in group:"
-                  << " DIFF=" << CSeqNo::seqcmp(current_sequence_number, w_packet.seqno())
-                  << " STAMP=" << BufferStamp(w_packet.m_pcData, w_packet.getLength()));
+        HLOGB(qslog.Debug,
+              "@{}: packUniqueData: Applying EXTRACTION sequence {} over SCHEDULING sequence {} for socket not in group: DIFF={} STAMP={}",
+              log << m_SocketID << current_sequence_number << w_packet.seqno()
+                  << CSeqNo::seqcmp(current_sequence_number, w_packet.seqno())
+                  << BufferStamp(w_packet.m_pcData, w_packet.getLength()));
         // Do this always when not in a group.
         w_packet.set_seqno(current_sequence_number);
     }
@@ -10041,7 +10258,12 @@ bool srt::CUDT::packUniqueData(CPacket& w_packet)
     w_packet.set_id(m_PeerID); // Destination SRT Socket ID
     setDataPacketTS(w_packet, tsOrigin);
 
-    if (kflg != EK_NOENC)
+    if (kflg != EK_NOENC && w_encrypt)
+    {
+        // The key flags are set, the key can't be switched before the packet is encrypted.
+        *w_encrypt = true;
+    }
+    else if (kflg != EK_NOENC)
     {
         // Note that the packet header must have a valid seqno set, as it is used as a counter for encryption.
         // Other fields of the data packet header (e.g. timestamp, destination socket ID) are not used for the counter.
@@ -10050,7 +10272,7 @@ bool srt::CUDT::packUniqueData(CPacket& w_packet)
         {
             // Encryption failed
             //>>Add stats for crypto failure
-            LOGC(qslog.Warn, log << CONID() << "ENCRYPT FAILED - packet won't be sent, size=" << pld_size);
+            LOGB(qslog.Warn, "@{}: ENCRYPT FAILED - packet won't be sent, size={}", log << m_SocketID << pld_size);
             return false;
         }
 
@@ -10066,6 +10288,78 @@ bool srt::CUDT::packUniqueData(CPacket& w_packet)
     return true;
 }
 
+int srt::CUDT::encryptPacked(CPacket* const* packets, int n)
+{
+    ScopedLock connectguard(m_ConnectionLock);
+    // The crypto control is removed when closing, like in packData().
+    if (!m_bOpened)
+        return 0;
+
+    int i = 0;
+    for (; i < n; ++i)
+    {
+        if (m_pCryptoControl->encrypt(*packets[i]) != ENCS_CLEAR)
+        {
+            LOGB(qslog.Warn, "@{}: ENCRYPT FAILED - {} packets won't be sent", log << m_SocketID << (n - i));
+            break;
+        }
+    }
+
+    // Only now, as the key flags of all the packets were set for the current key.
+    checkSndKMRefresh();
+    return i;
+}
+
+void srt::CUDT::releaseSndUserData()
+{
+    // ackData() and dropLateData() remove the blocks under the buffer lock,
+    // so a packet packed after that can't refer to them. A packet packed
+    // before is counted in m_iSndBatchPackets until it's sent out.
+    if (m_pSndBuffer && m_iSndBatchPackets == 0)
+        m_pSndBuffer->releaseAcked();
+}
+
+void srt::CUDT::leaveSndBatch()
+{
+    if (--m_iSndBatchPackets > 0)
+        return;
+
+    if (m_pSndBuffer)
+        m_pSndBuffer->releaseAcked();
+    CSync::lock_notify_all(m_SndBatchCond, m_SndBatchLock);
+}
+
+void srt::CUDT::precomputeKeystream()
+{
+    if (m_config.iCryptoPrecomp == 0)
+        return;
+
+    ScopedLock connectguard(m_ConnectionLock);
+    if (!m_bOpened || !m_pCryptoControl)
+        return;
+
+    m_pCryptoControl->precomputeKeystream(CSeqNo::incseq(m_iSndCurrSeqNo), m_iMaxSRTPayloadSize);
+}
+
+void srt::CUDT::decryptReceived(CUnit* const* units, int n)
+{
+    // Protects m_pCryptoControl, like in processData().
+    ScopedLock lk(m_RcvBufferLock);
+    if (!m_pCryptoControl || m_pCryptoControl->m_RcvKmState != SRT_KM_S_SECURED)
+        return;
+
+    for (int i = 0; i < n; ++i)
+    {
+        CPacket&   pkt           = units[i]->m_Packet;
+        const bool retransmitted = pkt.getRexmitFlag();
+
+        // Reset retransmission flag (must be excluded from GCM auth tag).
+        pkt.setRexmitFlag(false);
+        units[i]->m_bDecrypted = m_pCryptoControl->decrypt((pkt)) == ENCS_CLEAR;
+        pkt.setRexmitFlag(retransmitted);
+    }
+}
+
 // This is a close request, but called from the
 void srt::CUDT::processClose()
 {
@@ -10081,7 +10375,8 @@ void srt::CUDT::processClose()
     if (m_bTsbPd)
     {
         HLOGP(smlog.Debug, "processClose: lock-and-signal TSBPD");
-        CSync::lock_notify_one(m_RcvTsbPdCond, m_RecvLock);
+        ScopedLock tslock (m_RecvLock);
+        notifyTsbPd();
     }
 
     // Signal the sender and recver if they are waiting for data.
@@ -10178,6 +10473,55 @@ int srt::CUDT::checkLazySpawnTsbPdThread()
         return 0;
 
     ScopedLock lock(m_RcvTsbPdStartupLock);
+#if ENABLE_BONDING
+    if (m_bGroupTsbPd)
+    {
+        // The packets are stored in the group buffer and played by the
+        // TSBPD thread of the group. Keep the group while storing.
+        if (m_pTsbPdGroup)
+            return 0;
+
+        if (m_bClosing)
+            return -1;
+
+        m_pTsbPdGroup = uglobal().acquireSocketsGroup(m_parent);
+        return m_pTsbPdGroup ? 0 : -1;
+    }
+#endif
+    if (m_config.bTSBPDShared)
+    {
+        if (m_bTsbPdInPool)
+            return 0;
+
+        if (m_bClosing) // Check m_bClosing to protect the removal in CUDT::releaseSync().
+            return -1;
+
+        HLOGP(qrlog.Debug, "Adding socket to the shared TSBPD pool");
+#if ENABLE_BONDING
+        // Keep the group like the TSBPD thread does.
+        m_pTsbPdGroup = uglobal().acquireSocketsGroup(m_parent);
+#endif
+        if (!uglobal().tsbpdPool().add(this))
+        {
+#if ENABLE_BONDING
+            // Nothing will serve the socket, so don't keep the group.
+            CUDTGroup* tsbpd_group = NULL;
+            {
+                ScopedLock bufflock(m_RcvBufferLock);
+                std::swap(tsbpd_group, m_pTsbPdGroup);
+            }
+            if (tsbpd_group)
+            {
+                ScopedLock cgroup(*tsbpd_group->exp_groupLock());
+                tsbpd_group->apiRelease();
+            }
+#endif
+            return -1;
+        }
+        m_bTsbPdInPool = true;
+        return 0;
+    }
+
     if (!m_RcvTsbPdThread.joinable())
     {
         if (m_bClosing) // Check m_bClosing to protect join() in CUDT::releaseSync().
@@ -10214,7 +10558,18 @@ int srt::CUDT::handleSocketPacketReception(const vector<CUnit*>& incoming, bool&
     bool excessive SRT_ATR_UNUSED = true; // stays true unless it was successfully added
 
     w_new_inserted = false;
+#if ENABLE_BONDING
+    // A group receiver stores the packets in the group buffer, so the
+    // sequence range of the group buffer decides what can be stored.
+    CUDTGroup* const rcvgroup = m_bGroupTsbPd ? m_pTsbPdGroup : NULL;
+    const int32_t bufseq = rcvgroup ? rcvgroup->rcvStartSeqNo() : m_pRcvBuffer->getStartSeqNo();
+    if (rcvgroup)
+        followGroupRcvBuffer(bufseq);
+    const int bufcap = rcvgroup ? rcvgroup->rcvCapacity() : int(m_pRcvBuffer->capacity());
+#else
     const int32_t bufseq = m_pRcvBuffer->getStartSeqNo();
+    const int bufcap = int(m_pRcvBuffer->capacity());
+#endif
 
     // Loop over all incoming packets that were filtered out.
     // In case when there is no filter, there's just one packet in 'incoming',
@@ -10227,6 +10582,7 @@ int srt::CUDT::handleSocketPacketReception(const vector<CUnit*>& incoming, bool&
         const bool retransmitted = pktrexmitflag == 1;
 
         bool adding_successful = true;
+        bool redundant = false; // Already stored, received over another member link
 
         const int32_t bufidx = CSeqNo::seqoff(bufseq, rpkt.seqno());
 
@@ -10265,19 +10621,23 @@ int srt::CUDT::handleSocketPacketReception(const vector<CUnit*>& incoming, bool&
             m_stats.traceBelatedTime = bltime / 1000.0;
             m_stats.rcvr.recvdBelated.count(rpkt.getLength());
             leaveCS(m_StatsLock);
-            HLOGC(qrlog.Debug,
-                    log << CONID() << "RECEIVED: %" << rpkt.seqno() << " bufidx=" << bufidx << " (BELATED/"
-                    << s_rexmitstat_str[pktrexmitflag] << ") with ACK %" << m_iRcvLastAck
-                    << " FLAGS: " << rpkt.MessageFlagStr());
+            HLOGB(qrlog.Debug, "@{}: RECEIVED: %{} bufidx={} (BELATED/{}) with ACK %{} FLAGS: {}",
+                    log << m_SocketID << rpkt.seqno() << bufidx << s_rexmitstat_str[pktrexmitflag] << m_iRcvLastAck
+                    << rpkt.MessageFlags());
             continue;
         }
 
-        if (bufidx >= int(m_pRcvBuffer->capacity()))
+        if (bufidx >= bufcap)
         {
+#if ENABLE_BONDING
+            const bool bufempty = rcvgroup ? rcvgroup->rcvEmpty() : m_pRcvBuffer->empty();
+#else
+            const bool bufempty = m_pRcvBuffer->empty();
+#endif
             // This is already a sequence discrepancy. Probably there could be found
             // some way to make it continue reception by overriding the sequence and
             // make a kinda TLKPTDROP, but there has been found no reliable way to do this.
-            if (m_bTsbPd && m_bTLPktDrop && m_pRcvBuffer->empty())
+            if (m_bTsbPd && m_bTLPktDrop && bufempty)
             {
                 // Only in live mode. In File mode this shall not be possible
                 // because the sender should stop sending in this situation.
@@ -10286,29 +10646,30 @@ int srt::CUDT::handleSocketPacketReception(const vector<CUnit*>& incoming, bool&
                 // that exceeds the buffer size. Receiving data in this situation
                 // is no longer possible and this is a point of no return.
 
-                LOGC(qrlog.Error, log << CONID() <<
-                        "SEQUENCE DISCREPANCY. BREAKING CONNECTION."
-                        " %" << rpkt.seqno()
-                        << " buffer=(%" << bufseq
-                        << ":%" << m_iRcvCurrSeqNo                   // -1 = size to last index
-                        << "+%" << CSeqNo::incseq(bufseq, int(m_pRcvBuffer->capacity()) - 1)
-                        << "), " << (m_pRcvBuffer->capacity() - bufidx + 1)
-                        << " past max. Reception no longer possible. REQUESTING TO CLOSE.");
+                LOGB(qrlog.Error,
+                        "@{}: SEQUENCE DISCREPANCY. BREAKING CONNECTION. %{} buffer=(%{}:%{}+%{}), {} past max."
+                        " Reception no longer possible. REQUESTING TO CLOSE.",
+                        log << m_SocketID << rpkt.seqno() << bufseq
+                        << m_iRcvCurrSeqNo                   // -1 = size to last index
+                        << CSeqNo::incseq(bufseq, bufcap - 1) << (bufcap - bufidx + 1));
 
                 return -2;
             }
             else
             {
-                LOGC(qrlog.Warn, log << CONID() << "No room to store incoming packet seqno " << rpkt.seqno()
-                        << ", insert offset " << bufidx << ". "
-                        << m_pRcvBuffer->strFullnessState(m_iRcvLastAck, steady_clock::now())
-                    );
+                LOGB(qrlog.Warn, "@{}: No room to store incoming packet seqno {}, insert offset {}. {}",
+                        log << m_SocketID << rpkt.seqno() << bufidx
+                        << m_pRcvBuffer->strFullnessState(m_iRcvLastAck, steady_clock::now()));
 
                 return -1;
             }
         }
 
+#if ENABLE_BONDING
+        const int buffer_add_result = rcvgroup ? insertGroupRcvUnit(rcvgroup, u, retransmitted) : m_pRcvBuffer->insert(u);
+#else
         const int buffer_add_result = m_pRcvBuffer->insert(u);
+#endif
         if (buffer_add_result < 0)
         {
             // The insert() result is -1 if at the position evaluated from this packet's
@@ -10316,6 +10677,10 @@ int srt::CUDT::handleSocketPacketReception(const vector<CUnit*>& incoming, bool&
             // So this packet is "redundant".
             IF_HEAVY_LOGGING(exc_type = "UNACKED");
             adding_successful = false;
+#if ENABLE_BONDING
+            // Stored already from another member link, but still received on this one.
+            redundant = rcvgroup && buffer_add_result != -4;
+#endif
         }
         else
         {
@@ -10357,19 +10722,20 @@ int srt::CUDT::handleSocketPacketReception(const vector<CUnit*>& incoming, bool&
                     string why;
                     if (frequentLogAllowed(FREQLOGFA_ENCRYPTION_FAILURE, tnow, (why)))
                     {
-                        LOGC(qrlog.Warn, log << CONID() << "Decryption failed (seqno %" << u->m_Packet.getSeqNo() << "), dropped "
-                            << iDropCnt << ". pktRcvUndecryptTotal=" << m_stats.rcvr.undecrypted.total.count() << "." << why);
+                        LOGB(qrlog.Warn, "@{}: Decryption failed (seqno %{}), dropped {}. pktRcvUndecryptTotal={}.{}",
+                            log << m_SocketID << u->m_Packet.getSeqNo() << iDropCnt
+                            << m_stats.rcvr.undecrypted.total().count() << why);
                     }
 #if SRT_ENABLE_FREQUENT_LOG_TRACE
                     else
                     {
 
-                        LOGC(qrlog.Warn, log << "SUPPRESSED: Decryption failed LOG: " << why);
+                        LOGB(qrlog.Warn, "SUPPRESSED: Decryption failed LOG: {}", log << why);
                     }
 #endif
                 }
             }
-            else if (m_pCryptoControl && m_pCryptoControl->m_RcvKmState == SRT_KM_S_SECURED)
+            else if (!u->m_bDecrypted && m_pCryptoControl && m_pCryptoControl->m_RcvKmState == SRT_KM_S_SECURED)
             {
                 // Unencrypted packets are not allowed.
                 const int iDropCnt = m_pRcvBuffer->dropMessage(u->m_Packet.getSeqNo(), u->m_Packet.getSeqNo(), SRT_MSGNO_NONE, CRcvBuffer::DROP_EXISTING);
@@ -10381,65 +10747,44 @@ int srt::CUDT::handleSocketPacketReception(const vector<CUnit*>& incoming, bool&
                 string why;
                 if (frequentLogAllowed(FREQLOGFA_ENCRYPTION_FAILURE, tnow, (why)))
                 {
-                    LOGC(qrlog.Warn, log << CONID() << "Packet not encrypted (seqno %" << u->m_Packet.getSeqNo() << "), dropped "
-                        << iDropCnt << ". pktRcvUndecryptTotal=" << m_stats.rcvr.undecrypted.total.count() << ".");
+                    LOGB(qrlog.Warn, "@{}: Packet not encrypted (seqno %{}), dropped {}. pktRcvUndecryptTotal={}.",
+                        log << m_SocketID << u->m_Packet.getSeqNo() << iDropCnt
+                        << m_stats.rcvr.undecrypted.total().count());
                 }
             }
         }
 
         if (adding_successful)
         {
-            ScopedLock statslock(m_StatsLock);
             m_stats.rcvr.recvdUnique.count(u->m_Packet.getLength());
         }
 
 #if ENABLE_HEAVY_LOGGING
-        std::ostringstream expectspec;
-        if (excessive)
-            expectspec << "EXCESSIVE(" << exc_type << ")";
-        else
-            expectspec << "ACCEPTED";
-
-        std::ostringstream bufinfo;
-
-        if (m_pRcvBuffer)
-        {
-            // XXX Fix this when the end of contiguous region detection is added.
-            const int ackidx = std::max(0, CSeqNo::seqoff(m_pRcvBuffer->getStartSeqNo(), m_iRcvLastAck));
-
-            bufinfo << " BUF.s=" << m_pRcvBuffer->capacity()
-                << " avail=" << (int(m_pRcvBuffer->capacity()) - ackidx)
-                << " buffer=(%" << bufseq
-                << ":%" << m_iRcvCurrSeqNo                   // -1 = size to last index
-                << "+%" << CSeqNo::incseq(bufseq, int(m_pRcvBuffer->capacity()) - 1)
-                << ")";
-        }
-
-        // Empty buffer info in case of groupwise receiver.
+        // XXX Fix this when the end of contiguous region detection is added.
+        // The buffer info is empty in case of groupwise receiver.
         // There's no way to obtain this information here.
-
-        LOGC(qrlog.Debug, log << CONID() << "RECEIVED: %" << rpkt.seqno()
-                << bufinfo.str()
-                << " RSL=" << expectspec.str()
-                << " SN=" << s_rexmitstat_str[pktrexmitflag]
-                << " FLAGS: "
-                << rpkt.MessageFlagStr());
+        HLOGB(qrlog.Debug, "@{}: RECEIVED: %{} BUF.s={} avail={} buffer=(%{}:%{}+%{}) RSL={}{} SN={} FLAGS: {}",
+                log << m_SocketID << rpkt.seqno() << bufcap
+                << (bufcap - std::max(0, CSeqNo::seqoff(bufseq, m_iRcvLastAck)))
+                << bufseq << m_iRcvCurrSeqNo                   // -1 = size to last index
+                << CSeqNo::incseq(bufseq, bufcap - 1)
+                << (excessive ? "EXCESSIVE:" : "") << (excessive ? exc_type : "ACCEPTED")
+                << s_rexmitstat_str[pktrexmitflag] << rpkt.MessageFlags());
 #endif
 
         // Decryption should have made the crypto flags EK_NOENC.
         // Otherwise it's an error.
-        if (adding_successful)
+        if (adding_successful || redundant)
         {
-            HLOGC(qrlog.Debug,
-                      log << CONID()
-                          << "CONTIGUITY CHECK: sequence distance: " << CSeqNo::seqoff(m_iRcvCurrSeqNo, rpkt.seqno()));
+            HLOGB(qrlog.Debug, "@{}: CONTIGUITY CHECK: sequence distance: {}",
+                      log << m_SocketID << CSeqNo::seqoff(m_iRcvCurrSeqNo, rpkt.seqno()));
 
             if (CSeqNo::seqcmp(rpkt.seqno(), CSeqNo::incseq(m_iRcvCurrSeqNo)) > 0) // Loss detection.
             {
                 int32_t seqlo = CSeqNo::incseq(m_iRcvCurrSeqNo);
                 int32_t seqhi = CSeqNo::decseq(rpkt.seqno());
                 w_srt_loss_seqs.push_back(make_pair(seqlo, seqhi));
-                HLOGC(qrlog.Debug, log << "pkt/LOSS DETECTED: %" << seqlo << " - %" << seqhi);
+                HLOGB(qrlog.Debug, "pkt/LOSS DETECTED: %{} - %{}", log << seqlo << seqhi);
             }
         }
 
@@ -10459,6 +10804,79 @@ int srt::CUDT::handleSocketPacketReception(const vector<CUnit*>& incoming, bool&
     return 0;
 }
 
+#if ENABLE_BONDING
+// [[using locked(m_RcvBufferLock)]]
+void srt::CUDT::followGroupRcvBuffer(int32_t grpstart)
+{
+    // Don't go over m_iRcvCurrSeqNo, like rcvDropTooLateUpTo().
+    int32_t start = grpstart;
+    if (CSeqNo::seqcmp(start, CSeqNo::incseq(m_iRcvCurrSeqNo)) > 0)
+        start = CSeqNo::incseq(m_iRcvCurrSeqNo);
+
+    if (CSeqNo::seqcmp(start, m_pRcvBuffer->getStartSeqNo()) <= 0)
+        return;
+
+    // The group has played or dropped these packets, so they are no longer
+    // requested. The drops are counted in the group statistics.
+    dropFromLossLists(SRT_SEQNO_NONE, CSeqNo::decseq(start));
+    m_pRcvBuffer->setStartSeqNo(start);
+}
+
+// [[using locked(m_RcvBufferLock)]]
+int srt::CUDT::insertGroupRcvUnit(CUDTGroup* grp, CUnit* u, bool retransmitted)
+{
+    CPacket& rpkt = u->m_Packet;
+
+    // A packet received already over another member link
+    // is dropped before it's decrypted.
+    const int probe_result = grp->rcvProbe(rpkt.getSeqNo());
+    if (probe_result < 0)
+        return probe_result;
+
+    bool decrypted = true;
+    if (rpkt.getMsgCryptoFlags() != EK_NOENC)
+    {
+        // Reset retransmission flag (must be excluded from GCM auth tag).
+        rpkt.setRexmitFlag(false);
+        const EncryptionStatus rc = m_pCryptoControl ? m_pCryptoControl->decrypt((rpkt)) : ENCS_NOTSUP;
+        rpkt.setRexmitFlag(retransmitted); // Recover the flag.
+        decrypted = rc == ENCS_CLEAR;
+    }
+    else if (!u->m_bDecrypted && m_pCryptoControl && m_pCryptoControl->m_RcvKmState == SRT_KM_S_SECURED)
+    {
+        // Unencrypted packets are not allowed.
+        decrypted = false;
+    }
+
+    if (!decrypted)
+    {
+        const steady_clock::time_point tnow = steady_clock::now();
+        ScopedLock lg(m_StatsLock);
+        m_stats.rcvr.undecrypted.count(stats::BytesPackets(rpkt.getLength(), 1));
+        string why;
+        if (frequentLogAllowed(FREQLOGFA_ENCRYPTION_FAILURE, tnow, (why)))
+        {
+            LOGC(qrlog.Warn, log << CONID() << "Decryption failed (seqno %" << rpkt.getSeqNo()
+                << "), not stored in the group buffer. pktRcvUndecryptTotal="
+                << m_stats.rcvr.undecrypted.total().count() << "." << why);
+        }
+        return -4;
+    }
+
+    // The decryption is not repeated by the caller.
+    u->m_bDecrypted = true;
+
+    const int result = grp->rcvInsert(rpkt);
+    if (result == 0)
+    {
+        // This socket doesn't read its buffer, which
+        // otherwise tracks the timestamp wrap on reading.
+        m_pRcvBuffer->updateTsbPdTimeBase(rpkt.getMsgTimeStamp());
+    }
+    return result;
+}
+#endif
+
 int srt::CUDT::processData(CUnit* in_unit)
 {
     if (m_bClosing)
@@ -10486,9 +10904,7 @@ int srt::CUDT::processData(CUnit* in_unit)
     if (retransmitted)
     {
         // This packet was retransmitted
-        enterCS(m_StatsLock);
         m_stats.rcvr.recvdRetrans.count(packet.getLength());
-        leaveCS(m_StatsLock);
 
 #if ENABLE_HEAVY_LOGGING
         // Check if packet was retransmitted on request or on ack timeout
@@ -10511,12 +10927,11 @@ int srt::CUDT::processData(CUnit* in_unit)
        steady_clock::time_point pts = m_pRcvBuffer->getPktTsbPdTime(packet.getMsgTimeStamp());
        steady_clock::time_point ets = pts - tsbpddelay;
 
-       HLOGC(qrlog.Debug, log << CONID() << "processData: RECEIVED DATA: size=" << packet.getLength()
-           << " seq=" << packet.getSeqNo()
+       HLOGB(qrlog.Debug, "@{}: processData: RECEIVED DATA: size={} seq={} ETS={} PTS={}",
+           log << m_SocketID << packet.getLength() << packet.getSeqNo()
            // XXX FIX IT. OTS should represent the original sending time, but it's relative.
-           //<< " OTS=" << FormatTime(packet.getMsgTimeStamp())
-           << " ETS=" << FormatTime(ets)
-           << " PTS=" << FormatTime(pts));
+           //<< packet.getMsgTimeStamp()
+           << ets << pts);
    }
 #endif
 
@@ -10546,9 +10961,7 @@ int srt::CUDT::processData(CUnit* in_unit)
     // otherwise measurement must be rejected.
     m_RcvTimeWindow.probeArrival(packet, unordered || retransmitted);
 
-    enterCS(m_StatsLock);
     m_stats.rcvr.recvd.count(pktsz);
-    leaveCS(m_StatsLock);
 
     loss_seqs_t                             filter_loss_seqs;
     loss_seqs_t                             srt_loss_seqs;
@@ -10575,13 +10988,11 @@ int srt::CUDT::processData(CUnit* in_unit)
         {
             const int loss = diff - 1; // loss is all that is above diff == 1
 
-            ScopedLock lg(m_StatsLock);
             const uint64_t avgpayloadsz = m_pRcvBuffer->getRcvAvgPayloadSize();
             m_stats.rcvr.lost.count(stats::BytesPackets(loss * avgpayloadsz, (uint32_t) loss));
 
-            HLOGC(qrlog.Debug,
-                  log << CONID() << "LOSS STATS: n=" << loss << " SEQ: [" << CSeqNo::incseq(m_iRcvCurrPhySeqNo) << " "
-                      << CSeqNo::decseq(packet.seqno()) << "]");
+            HLOGB(qrlog.Debug, "@{}: LOSS STATS: n={} SEQ: [{} {}]",
+                  log << m_SocketID << loss << CSeqNo::incseq(m_iRcvCurrPhySeqNo) << CSeqNo::decseq(packet.seqno()));
         }
 
         if (diff > 0)
@@ -10614,16 +11025,14 @@ int srt::CUDT::processData(CUnit* in_unit)
         {
             if (gi->rcvstate < SRT_GST_RUNNING) // PENDING or IDLE, tho PENDING is unlikely
             {
-                HLOGC(qrlog.Debug,
-                      log << CONID() << "processData: IN-GROUP rcv state transition " << srt_log_grp_state[gi->rcvstate]
-                          << " -> RUNNING.");
+                HLOGB(qrlog.Debug, "@{}: processData: IN-GROUP rcv state transition {} -> RUNNING.",
+                      log << m_SocketID << srt_log_grp_state[gi->rcvstate]);
                 gi->rcvstate = SRT_GST_RUNNING;
             }
             else
             {
-                HLOGC(qrlog.Debug,
-                      log << CONID() << "processData: IN-GROUP rcv state transition NOT DONE - state:"
-                          << srt_log_grp_state[gi->rcvstate]);
+                HLOGB(qrlog.Debug, "@{}: processData: IN-GROUP rcv state transition NOT DONE - state:{}",
+                      log << m_SocketID << srt_log_grp_state[gi->rcvstate]);
             }
         }
     }
@@ -10635,9 +11044,8 @@ int srt::CUDT::processData(CUnit* in_unit)
     {
         // Stuff this data into the filter
         m_PacketFilter.receive(in_unit, (incoming), (filter_loss_seqs));
-        HLOGC(qrlog.Debug,
-              log << CONID() << "(FILTER) fed data, received " << incoming.size() << " pkts, " << Printable(filter_loss_seqs)
-                  << " loss to report, "
+        HLOGB(qrlog.Debug, "@{}: (FILTER) fed data, received {} pkts, {} loss to report, {}",
+              log << m_SocketID << incoming.size() << Printable(filter_loss_seqs)
                   << (m_PktFilterRexmitLevel == SRT_ARQ_ALWAYS ? "FIND & REPORT LOSSES YOURSELF"
                                                                : "REPORT ONLY THOSE"));
     }
@@ -10681,9 +11089,8 @@ int srt::CUDT::processData(CUnit* in_unit)
         {
             ScopedLock lock(m_RcvLossLock);
 
-            HLOGC(qrlog.Debug,
-                  log << CONID() << "processData: RECORDING LOSS: " << Printable(srt_loss_seqs)
-                      << " tolerance=" << initial_loss_ttl);
+            HLOGB(qrlog.Debug, "@{}: processData: RECORDING LOSS: {} tolerance={}",
+                  log << m_SocketID << Printable(srt_loss_seqs) << initial_loss_ttl);
 
             for (loss_seqs_t::iterator i = srt_loss_seqs.begin(); i != srt_loss_seqs.end(); ++i)
             {
@@ -10743,18 +11150,19 @@ int srt::CUDT::processData(CUnit* in_unit)
         const bool report_recorded_loss = !m_PacketFilter || m_PktFilterRexmitLevel == SRT_ARQ_ALWAYS;
         if (!initial_loss_ttl && report_recorded_loss)
         {
-            HLOGC(qrlog.Debug, log << CONID() << "WILL REPORT LOSSES (SRT): " << Printable(srt_loss_seqs));
+            HLOGB(qrlog.Debug, "@{}: WILL REPORT LOSSES (SRT): {}", log << m_SocketID << Printable(srt_loss_seqs));
             sendLossReport(srt_loss_seqs);
         }
 
         if (m_bTsbPd)
         {
-            HLOGC(qrlog.Debug, log << CONID() << "loss: signaling TSBPD cond");
-            CSync::lock_notify_one(m_RcvTsbPdCond, m_RecvLock);
+            HLOGB(qrlog.Debug, "@{}: loss: signaling TSBPD cond", log << m_SocketID);
+            ScopedLock tslock (m_RecvLock);
+            notifyTsbPd();
         }
         else
         {
-            HLOGC(qrlog.Debug, log << CONID() << "loss: socket is not TSBPD, not signaling");
+            HLOGB(qrlog.Debug, "@{}: loss: socket is not TSBPD, not signaling", log << m_SocketID);
         }
     }
 
@@ -10765,13 +11173,14 @@ int srt::CUDT::processData(CUnit* in_unit)
     // With NEVER, nothing is to be reported.
     if (!filter_loss_seqs.empty())
     {
-        HLOGC(qrlog.Debug, log << CONID() << "WILL REPORT LOSSES (filter): " << Printable(filter_loss_seqs));
+        HLOGB(qrlog.Debug, "@{}: WILL REPORT LOSSES (filter): {}", log << m_SocketID << Printable(filter_loss_seqs));
         sendLossReport(filter_loss_seqs);
 
         if (m_bTsbPd)
         {
-            HLOGC(qrlog.Debug, log << CONID() << "loss: signaling TSBPD cond");
-            CSync::lock_notify_one(m_RcvTsbPdCond, m_RecvLock);
+            HLOGB(qrlog.Debug, "@{}: loss: signaling TSBPD cond", log << m_SocketID);
+            ScopedLock tslock (m_RecvLock);
+            notifyTsbPd();
         }
     }
 
@@ -10809,8 +11218,8 @@ int srt::CUDT::processData(CUnit* in_unit)
             // into two records.
             for (; i != m_FreshLoss.end() && i->ttl <= 0; ++i)
             {
-                HLOGC(qrlog.Debug, log << "Packet seq " << i->seq[0] << "-" << i->seq[1]
-                        << " (" << (CSeqNo::seqoff(i->seq[0], i->seq[1]) + 1) << " packets) considered lost - sending LOSSREPORT");
+                HLOGB(qrlog.Debug, "Packet seq {}-{} ({} packets) considered lost - sending LOSSREPORT",
+                        log << i->seq[0] << i->seq[1] << (CSeqNo::seqoff(i->seq[0], i->seq[1]) + 1));
                 addLossRecord(lossdata, i->seq[0], i->seq[1]);
             }
 
@@ -10823,13 +11232,13 @@ int srt::CUDT::processData(CUnit* in_unit)
 
             if (m_FreshLoss.empty())
             {
-                HLOGP(qrlog.Debug, "NO MORE FRESH LOSS RECORDS.");
+                HLOGB(qrlog.Debug, "NO MORE FRESH LOSS RECORDS.", log);
             }
             else
             {
-                HLOGC(qrlog.Debug, log << "STILL " << m_FreshLoss.size() << " FRESH LOSS RECORDS, FIRST: "
-                        << i->seq[0] << "-" << i->seq[1]
-                        << " (" << (1 + CSeqNo::seqoff(i->seq[0], i->seq[1])) << ") TTL: " << i->ttl);
+                HLOGB(qrlog.Debug, "STILL {} FRESH LOSS RECORDS, FIRST: {}-{} ({}) TTL: {}",
+                        log << m_FreshLoss.size() << i->seq[0] << i->seq[1]
+                        << (1 + CSeqNo::seqoff(i->seq[0], i->seq[1])) << i->ttl);
             }
 
             // Phase 2: rest of the records should have TTL decreased.
@@ -10855,9 +11264,7 @@ int srt::CUDT::processData(CUnit* in_unit)
             if (m_iReorderTolerance > 0)
             {
                 m_iReorderTolerance--;
-                enterCS(m_StatsLock);
-                m_stats.traceReorderDistance--;
-                leaveCS(m_StatsLock);
+                --m_stats.traceReorderDistance;
                 HLOGC(qrlog.Debug, log << "ORDERED DELIVERY of 50 packets in a row - decreasing tolerance to "
                         << m_iReorderTolerance);
             }
@@ -10959,9 +11366,8 @@ void srt::CUDT::unlose(const CPacket &packet)
             HLOGC(qrlog.Debug, log << "received out-of-band packet %" << sequence);
 
             const int seqdiff = abs(CSeqNo::seqcmp(m_iRcvCurrSeqNo, packet.seqno()));
-            enterCS(m_StatsLock);
-            m_stats.traceReorderDistance = max(seqdiff, m_stats.traceReorderDistance);
-            leaveCS(m_StatsLock);
+            if (seqdiff > m_stats.traceReorderDistance)
+                m_stats.traceReorderDistance = seqdiff;
             if (seqdiff > m_iReorderTolerance)
             {
                 const int new_tolerance = min(seqdiff, m_config.iMaxReorderTolerance);
@@ -11018,9 +11424,7 @@ void srt::CUDT::unlose(const CPacket &packet)
                 if (m_iReorderTolerance > 0)
                 {
                     m_iReorderTolerance--;
-                    enterCS(m_StatsLock);
-                    m_stats.traceReorderDistance--;
-                    leaveCS(m_StatsLock);
+                    --m_stats.traceReorderDistance;
                     HLOGC(qrlog.Debug, log << "... reached " << m_iConsecEarlyDelivery
                             << " times - decreasing tolerance to " << m_iReorderTolerance);
                 }
@@ -11128,7 +11532,7 @@ int32_t srt::CUDT::bake(const sockaddr_any& addr, int32_t current_cookie, int co
                     clientport,
                     sizeof(clientport),
                     NI_NUMERICHOST | NI_NUMERICSERV);
-        int64_t timestamp = (count_microseconds(steady_clock::now() - m_stats.tsStartTime) / 60000000) + distractor +
+        int64_t timestamp = (count_microseconds(steady_clock::now() - m_stats.tsStartTime.load()) / 60000000) + distractor +
                             correction; // secret changes every one minute
         stringstream cookiestr;
         cookiestr << clienthost << ":" << clientport << ":" << timestamp;
@@ -11170,7 +11574,7 @@ int32_t srt::CUDT::bake(const sockaddr_any& addr, int32_t current_cookie, int co
 // and this will be directly passed to the caller.
 
 // [[using locked(m_pRcvQueue->m_LSLock)]];
-int srt::CUDT::processConnectRequest(const sockaddr_any& addr, CPacket& packet)
+int srt::CUDT::processConnectRequest(const sockaddr_any& addr, CPacket& packet, const CRcvQueue* rcvq)
 {
     // XXX ASSUMPTIONS:
     // [[using assert(packet.id() == 0)]]
@@ -11391,7 +11795,7 @@ int srt::CUDT::processConnectRequest(const sockaddr_any& addr, CPacket& packet)
         // is sent by the function itself (it calls the acceptAndRespond(..)), the `acpu` remains null, the `result` is 1.
         int error  = SRT_REJ_UNKNOWN;
         CUDT* acpu = NULL;
-        int result = uglobal().newConnection(m_SocketID, addr, packet, (hs), (error), (acpu));
+        int result = uglobal().newConnection(m_SocketID, addr, packet, rcvq, (hs), (error), (acpu));
 
         // This is listener - m_RejectReason need not be set
         // because listener has no functionality of giving the app
@@ -11562,8 +11966,9 @@ int srt::CUDT::checkACKTimer(const steady_clock::time_point &currtime)
     return because_decision;
 }
 
-int srt::CUDT::checkNAKTimer(const steady_clock::time_point& currtime)
+int srt::CUDT::checkNAKTimer(const steady_clock::time_point& currtime, bool& w_have_loss)
 {
+    w_have_loss = false;
     // XXX The problem with working NAKREPORT with SRT_ARQ_ONREQ
     // is not that it would be inappropriate, but because it's not
     // implemented. The reason for it is that the structure of the
@@ -11590,6 +11995,7 @@ int srt::CUDT::checkNAKTimer(const steady_clock::time_point& currtime)
 
     SRT_ASSERT(loss_len >= 0);
     int debug_decision = BECAUSE_NO_REASON;
+    w_have_loss = loss_len > 0;
 
     if (loss_len > 0)
     {
@@ -11633,21 +12039,7 @@ bool srt::CUDT::checkExpTimer(const steady_clock::time_point& currtime, int chec
     // In UDT the m_bUserDefinedRTO and m_iRTO were in CCC class.
     // There's nothing in the original code that alters these values.
 
-    steady_clock::time_point next_exp_time;
-    if (m_CongCtl->RTO())
-    {
-        next_exp_time = m_tsLastRspTime.load() + microseconds_from(m_CongCtl->RTO());
-    }
-    else
-    {
-        steady_clock::duration exp_timeout =
-            microseconds_from(m_iEXPCount * (m_iSRTT + 4 * m_iRTTVar) + COMM_SYN_INTERVAL_US);
-        if (exp_timeout < (m_iEXPCount * m_tdMinExpInterval))
-            exp_timeout = m_iEXPCount * m_tdMinExpInterval;
-        next_exp_time = m_tsLastRspTime.load() + exp_timeout;
-    }
-
-    if (currtime <= next_exp_time && !m_bBreakAsUnstable)
+    if (currtime <= nextExpTime() && !m_bBreakAsUnstable)
         return false;
 
     // ms -> us
@@ -11670,7 +12062,7 @@ bool srt::CUDT::checkExpTimer(const steady_clock::time_point& currtime, int chec
         m_iBrokenCounter = 30;
 
         // update snd U list to remove this socket
-        m_pSndQueue->m_pSndUList->update(this, CSndUList::DO_RESCHEDULE);
+        m_pSndQueue->sndList(this)->update(this, CSndUList::DO_RESCHEDULE);
 
         updateBrokenConnection();
         completeBrokenConnectionDependencies(SRT_ECONNLOST); // LOCKS!
@@ -11700,7 +12092,27 @@ bool srt::CUDT::checkExpTimer(const steady_clock::time_point& currtime, int chec
     return false;
 }
 
-void srt::CUDT::checkRexmitTimer(const steady_clock::time_point& currtime)
+srt::sync::steady_clock::time_point srt::CUDT::nextExpTime()
+{
+    if (m_CongCtl->RTO())
+        return m_tsLastRspTime.load() + microseconds_from(m_CongCtl->RTO());
+
+    steady_clock::duration exp_timeout =
+        microseconds_from(m_iEXPCount * (m_iSRTT + 4 * m_iRTTVar) + COMM_SYN_INTERVAL_US);
+    if (exp_timeout < (m_iEXPCount * m_tdMinExpInterval))
+        exp_timeout = m_iEXPCount * m_tdMinExpInterval;
+    return m_tsLastRspTime.load() + exp_timeout;
+}
+
+srt::sync::steady_clock::time_point srt::CUDT::nextRexmitTime() const
+{
+    ScopedLock ack_lock(m_RecvAckLock);
+    const uint64_t rtt_syn = (m_iSRTT + 4 * m_iRTTVar + 2 * COMM_SYN_INTERVAL_US);
+    const uint64_t exp_int_us = (m_iReXmitCount * rtt_syn + COMM_SYN_INTERVAL_US);
+    return m_tsLastRspAckTime + microseconds_from(exp_int_us);
+}
+
+srt::sync::steady_clock::time_point srt::CUDT::checkRexmitTimer(const steady_clock::time_point& currtime)
 {
     // Check if HSv4 should be retransmitted, and if KM_REQ should be resent if the side is INITIATOR.
     checkSndTimers();
@@ -11721,27 +12133,19 @@ void srt::CUDT::checkRexmitTimer(const steady_clock::time_point& currtime)
     // in the sender's buffer will be added to the SND loss list and retransmitted.
     //
 
-    {
-        ScopedLock ack_lock(m_RecvAckLock);
-        const uint64_t rtt_syn = (m_iSRTT + 4 * m_iRTTVar + 2 * COMM_SYN_INTERVAL_US);
-        const uint64_t exp_int_us = (m_iReXmitCount * rtt_syn + COMM_SYN_INTERVAL_US);
-
-        if (currtime <= (m_tsLastRspAckTime + microseconds_from(exp_int_us)))
-            return;
-    }
-
-    // If there is no unacknowledged data in the sending buffer,
-    // then there is nothing to retransmit.
-    if (m_pSndBuffer->getCurrBufSize() <= 0)
-        return;
-
     const bool is_laterexmit = m_CongCtl->rexmitMethod() == SrtCongestion::SRM_LATEREXMIT; // FileCC
     const bool is_fastrexmit = m_CongCtl->rexmitMethod() == SrtCongestion::SRM_FASTREXMIT; // LiveCC
 
+    // If there is no unacknowledged data in the sending buffer,
+    // then there is nothing to retransmit.
     // If the receiver will send periodic NAK reports, then FASTREXMIT (live) is inactive.
     // TODO: Probably some method of "blind rexmit" MUST BE DONE, when TLPKTDROP is off.
-    if (is_fastrexmit && m_bPeerNakReport)
-        return;
+    if (m_pSndBuffer->getCurrBufSize() <= 0 || (is_fastrexmit && m_bPeerNakReport))
+        return steady_clock::time_point::max();
+
+    const steady_clock::time_point rexmit_time = nextRexmitTime();
+    if (currtime <= rexmit_time)
+        return rexmit_time;
 
     // Schedule a retransmission IF:
     // - there are packets in flight (getFlightSpan() > 0);
@@ -11758,9 +12162,7 @@ void srt::CUDT::checkRexmitTimer(const steady_clock::time_point& currtime)
         const int     num = m_pSndLossList->insert(m_iSndLastAck, csn);
         if (num > 0)
         {
-            enterCS(m_StatsLock);
             m_stats.sndr.lost.count(num);
-            leaveCS(m_StatsLock);
 
             HLOGC(xtlog.Debug,
                   log << CONID() << "ENFORCED " << (is_laterexmit ? "LATEREXMIT" : "FASTREXMIT")
@@ -11775,11 +12177,16 @@ void srt::CUDT::checkRexmitTimer(const steady_clock::time_point& currtime)
     updateCC(TEV_CHECKTIMER, EventVariant(stage));
 
     // schedule sending if not scheduled already
-    m_pSndQueue->m_pSndUList->update(this, CSndUList::DONT_RESCHEDULE);
+    m_pSndQueue->sndList(this)->update(this, CSndUList::DONT_RESCHEDULE);
+
+    // The timeout is now longer by m_iReXmitCount.
+    return nextRexmitTime();
 }
 
 void srt::CUDT::checkTimers()
 {
+    ++m_iTimerChecks;
+
     // update CC parameters
     updateCC(TEV_CHECKTIMER, EventVariant(TEV_CHT_INIT));
 
@@ -11796,14 +12203,18 @@ void srt::CUDT::checkTimers()
     int debug_decision = checkACKTimer(currtime);
 
     // Check if it is time to send a loss report
-    debug_decision |= checkNAKTimer(currtime);
+    bool have_loss = false;
+    debug_decision |= checkNAKTimer(currtime, (have_loss));
 
     // Check if the connection is expired
     if (checkExpTimer(currtime, debug_decision))
+    {
+        m_tsNextTimersCheck = currtime + microseconds_from(COMM_IDLE_TIMERS_CHECK_US);
         return;
+    }
 
     // Check if FAST or LATE packet retransmission is required
-    checkRexmitTimer(currtime);
+    const steady_clock::time_point rexmit_time = checkRexmitTimer(currtime);
 
     if (currtime > m_tsLastSndTime.load() + microseconds_from(COMM_KEEPALIVE_PERIOD_US))
     {
@@ -11824,6 +12235,31 @@ void srt::CUDT::checkTimers()
 #endif
         HLOGP(xtlog.Debug, "KEEPALIVE");
     }
+
+    // Things that have no deadline of their own (KM retransmission,
+    // congctl timer events, ACK after a packet drop) are checked at
+    // least with this period.
+    steady_clock::time_point next = currtime + microseconds_from(COMM_IDLE_TIMERS_CHECK_US);
+
+    // The ACK timer matters only if there is something to acknowledge:
+    // packets received since the last ACK, or an ACK not yet confirmed.
+    if (m_iPktCount > 0 || m_iRcvLastAck != m_iRcvLastAckAck)
+        next = min(next, m_tsNextACKTime.load());
+
+    if (have_loss)
+        next = min(next, m_tsNextNAKTime.load());
+
+    next = min(next, nextExpTime());
+    next = min(next, rexmit_time);
+    next = min(next, m_tsLastSndTime.load() + microseconds_from(COMM_KEEPALIVE_PERIOD_US));
+
+    // A deadline that is still due has been checked just now and
+    // the check decided there was nothing to do yet, so checking it
+    // again right away would only spin the receiver worker.
+    if (next <= currtime)
+        next = currtime + microseconds_from(COMM_SYN_INTERVAL_US);
+
+    m_tsNextTimersCheck = next;
 }
 
 void srt::CUDT::updateBrokenConnection()
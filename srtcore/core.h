@@ -66,6 +66,7 @@ modified by
 #include "channel.h"
 #include "cache.h"
 #include "queue.h"
+#include "tsbpd_pool.h"
 #include "handshake.h"
 #include "congctl.h"
 #include "packetfilter.h"
@@ -155,9 +156,7 @@ class CCryptoControl;
 namespace srt {
 class CUDTUnited;
 class CUDTSocket;
-#if ENABLE_BONDING
 class CUDTGroup;
-#endif
 
 // XXX REFACTOR: The 'CUDT' class is to be merged with 'CUDTSocket'.
 // There's no reason for separating them, there's no case of having them
@@ -177,6 +176,7 @@ class CUDT
     friend class CRcvQueue;
     friend class CSndUList;
     friend class CRcvUList;
+    friend class CTsbpdPool;
     friend class PacketFilter;
     friend class CUDTGroup;
     friend class TestMockCUDT; // unit tests
@@ -225,7 +225,10 @@ public: //API
     static int sendmsg(SRTSOCKET u, const char* buf, int len, int ttl = SRT_MSGTTL_INF, bool inorder = false, int64_t srctime = 0);
     static int recvmsg(SRTSOCKET u, char* buf, int len, int64_t& srctime);
     static int sendmsg2(SRTSOCKET u, const char* buf, int len, SRT_MSGCTRL& mctrl);
+    static int sendmsgZeroCopy(SRTSOCKET u, const char* buf, int len, SRT_MSGCTRL& mctrl, srt_sendbuf_release_fn* release_fn, void* opaque);
     static int recvmsg2(SRTSOCKET u, char* buf, int len, SRT_MSGCTRL& w_mctrl);
+    static int recvmsgZeroCopy(SRTSOCKET u, SRT_RCVLOAN* loan, SRT_MSGCTRL& w_mctrl);
+    static int releaseRecvLoan(SRTSOCKET u, const SRT_RCVLOAN* loan);
     static int64_t sendfile(SRTSOCKET u, std::fstream& ifs, int64_t& offset, int64_t size, int block = SRT_DEFAULT_SENDFILE_BLOCK);
     static int64_t recvfile(SRTSOCKET u, std::fstream& ofs, int64_t& offset, int64_t size, int block = SRT_DEFAULT_RECVFILE_BLOCK);
     static int select(int nfds, UDT::UDSET* readfds, UDT::UDSET* writefds, UDT::UDSET* exceptfds, const timeval* timeout);
@@ -282,6 +285,7 @@ public: // internal API
     static const int       COMM_RESPONSE_MAX_EXP                 = 16;
     static const int       SRT_TLPKTDROP_MINTHRESHOLD_MS         = 1000;
     static const uint64_t  COMM_KEEPALIVE_PERIOD_US              = 1*1000*1000;
+    static const uint64_t  COMM_IDLE_TIMERS_CHECK_US             = 100*1000; // Timers check period of a socket without pending ACK
     static const int32_t   COMM_SYN_INTERVAL_US                  = 10*1000;
     static const int       COMM_CLOSE_BROKEN_LISTENER_TIMEOUT_MS = 3000;
     static const uint16_t  MAX_WEIGHT                            = 32767;
@@ -358,6 +362,7 @@ public: // internal API
     int32_t         peerISN()               const { return m_iPeerISN; }
     duration        minNAKInterval()        const { return m_tdMinNakInterval; }
     sockaddr_any    peerAddr()              const { return m_PeerAddr; }
+    int64_t         timerChecks()           const { return m_iTimerChecks; }
 
     /// Returns the number of packets in flight (sent, but not yet acknowledged).
     /// @param lastack is the sequence number of the first unacknowledged packet.
@@ -423,14 +428,12 @@ public: // internal API
     /// @brief Set the timestamp field of the packet using the provided value (no check)
     /// @param p the packet structure to set the timestamp on.
     /// @param ts timestamp to use as a source for packet timestamp.
-    SRT_ATTR_EXCLUDES(m_StatsLock)
     void setPacketTS(CPacket& p, const time_point& ts);
 
     /// @brief Set the timestamp field of the packet according the TSBPD mode.
     /// Also checks the connection start time (m_tsStartTime).
     /// @param p the packet structure to set the timestamp on.
     /// @param ts timestamp to use as a source for packet timestamp. Ignored if m_bPeerTsbPd is false.
-    SRT_ATTR_EXCLUDES(m_StatsLock)
     void setDataPacketTS(CPacket& p, const time_point& ts);
 
     // Utility used for closing a listening socket
@@ -579,7 +582,7 @@ private:
 
     /// @brief Drop packets too late to be delivered if any.
     /// @returns the number of packets actually dropped.
-    SRT_ATTR_REQUIRES2(m_RecvAckLock, m_StatsLock)
+    SRT_ATTR_REQUIRES(m_RecvAckLock)
     int sndDropTooLate();
 
     /// @bried Allow packet retransmission.
@@ -640,11 +643,25 @@ private:
     /// @param len [in] size of the buffer.
     /// @return Actual size of data received.
 
-    SRT_ATR_NODISCARD int sendmsg2(const char* data, int len, SRT_MSGCTRL& w_m);
+    /// Send a message, as srt_sendmsg2() or, with @a release_fn, srt_sendmsg_zc().
+    /// @param release_fn [in] when not NULL, the data are not copied and must stay
+    /// valid until release_fn(opaque) is called. Not called if this function throws.
+    /// @param opaque [in] the argument for release_fn
+    SRT_ATR_NODISCARD int sendmsg2(const char* data, int len, SRT_MSGCTRL& w_m,
+                                   srt_sendbuf_release_fn* release_fn = NULL, void* opaque = NULL);
 
     SRT_ATR_NODISCARD int recvmsg(char* data, int len, int64_t& srctime);
     SRT_ATR_NODISCARD int recvmsg2(char* data, int len, SRT_MSGCTRL& w_m);
-    SRT_ATR_NODISCARD int receiveMessage(char* data, int len, SRT_MSGCTRL& w_m, int erh = 1 /*throw exception*/);
+
+    /// Receive a message as srt_recvmsg_zc(), lending the payloads of its packets.
+    SRT_ATR_NODISCARD int recvmsgZeroCopy(SRT_RCVLOAN& w_loan, SRT_MSGCTRL& w_m);
+
+    /// Free the packets of a message received by recvmsgZeroCopy().
+    void releaseRecvLoan(const SRT_RCVLOAN& loan);
+
+    /// @param w_loan [out] if not NULL, the message is lent instead of copied to @a data.
+    SRT_ATR_NODISCARD int receiveMessage(char* data, int len, SRT_MSGCTRL& w_m, int erh = 1 /*throw exception*/,
+                                         SRT_RCVLOAN* w_loan = NULL);
     SRT_ATR_NODISCARD int receiveBuffer(char* data, int len);
 
     size_t dropMessage(int32_t seqtoskip);
@@ -748,8 +765,7 @@ private:
 
     time_point socketStartTime()
     {
-        sync::ScopedLock lk (m_StatsLock);
-        return m_stats.tsStartTime;
+        return m_stats.tsStartTime.load();
     }
 
     SRT_ATTR_EXCLUDES(m_RcvBufferLock)
@@ -764,6 +780,24 @@ private:
     // TSBPD thread main function.
     static void* tsbpd(void* param);
 
+    /// One round of the TSBPD work: drop the packets that are too late
+    /// and signal the reader if a packet is ready to play.
+    /// @param recvdata_lcc m_RecvLock with m_RecvDataCond, locked
+    /// @param group the group kept by the TSBPD thread, if any
+    /// @return Play time of the next packet to wait for, or zero time
+    /// when the TSBPD must wait for a signal.
+    SRT_ATTR_REQUIRES(m_RecvLock)
+    time_point tsbpdCheck(sync::CUniqueSync& recvdata_lcc, CUDTGroup* group);
+
+    /// TSBPD work for CTsbpdPool, when SRTO_TSBPDSHARED is set.
+    /// @return Time of the next check, or zero time to wait for a signal.
+    SRT_ATTR_EXCLUDES(m_RecvLock)
+    time_point tsbpdSharedCheck();
+
+    /// Wake up the TSBPD thread, or schedule a check in CTsbpdPool.
+    SRT_ATTR_REQUIRES(m_RecvLock)
+    void notifyTsbPd();
+
     enum DropReason
     {
         DROP_TOO_LATE, //< Drop to keep up to the live pace (TLPKTDROP).
@@ -859,6 +893,7 @@ private:
 
 private: // Sending related data
     CSndBuffer* m_pSndBuffer;                    // Sender buffer
+    sync::atomic<int> m_iSndBatchPackets;        // Packets packed into a send batch and not yet sent, which may refer to zero-copy user data
     CSndLossList* m_pSndLossList;                // Sender loss list
     CPktTimeWindow<16, 16> m_SndTimeWindow;      // Packet sending time window
 #ifdef ENABLE_MAXREXMITBW
@@ -1003,6 +1038,12 @@ private: // Receiving related data
     sync::Condition m_RcvTsbPdCond;              // TSBPD signals if reading is ready. Use together with m_RecvLock
     bool m_bTsbPdNeedsWakeup;                    // Signal TsbPd thread to wake up on RCV buffer state change.
     sync::Mutex m_RcvTsbPdStartupLock;           // Protects TSBPD thread creation and joining.
+    SRT_ATTR_GUARDED_BY(m_RcvTsbPdStartupLock)
+    bool m_bTsbPdInPool;                         // TSBPD is done by CTsbpdPool instead of m_RcvTsbPdThread
+    CTsbpdNode m_TsbPdNode;                      // Scheduling data used by CTsbpdPool
+#if ENABLE_BONDING
+    CUDTGroup* m_pTsbPdGroup;                    // Group kept alive while served by CTsbpdPool or storing into the group buffer
+#endif
 
     CallbackHolder<srt_listen_callback_fn> m_cbAcceptHook;
     CallbackHolder<srt_connect_callback_fn> m_cbConnectHook;
@@ -1034,6 +1075,9 @@ private: // synchronization: mutexes and conditions
     sync::Condition m_SendBlockCond;             // used to block "send" call
     sync::Mutex m_SendBlockLock;                 // lock associated to m_SendBlockCond
 
+    sync::Condition m_SndBatchCond;              // signals when no packet of the socket waits in a send batch
+    sync::Mutex m_SndBatchLock;                  // lock associated to m_SndBatchCond
+
     mutable sync::Mutex m_RcvBufferLock;         // Protects the state of the m_pRcvBuffer
     // Protects access to m_iSndCurrSeqNo, m_iSndLastAck
     mutable sync::Mutex m_RecvAckLock;                   // Protects the state changes while processing incoming ACK (SRT_EPOLL_OUT)
@@ -1043,7 +1087,7 @@ private: // synchronization: mutexes and conditions
 
     sync::Mutex m_SendLock;                      // used to synchronize "send" call
     sync::Mutex m_RcvLossLock;                   // Protects the receiver loss list (access: CRcvQueue::worker, CUDT::tsbpd)
-    mutable sync::Mutex m_StatsLock;             // used to synchronize access to trace statistics
+    mutable sync::Mutex m_StatsLock;             // used to synchronize access to trace statistics (except the atomic counters)
 
     void initSynch();
     void destroySynch();
@@ -1120,19 +1164,57 @@ private: // Generation and processing of packets
 
     /// Pack a unique data packet (never sent so far) in CPacket for sending.
     /// @param packet [in, out] a CPacket structure to fill.
+    /// @param encrypt [out] if not NULL, the packet is not encrypted, but it's
+    ///                set to true if it should be, with encryptPacked().
     ///
     /// @return true if a packet has been packets; false otherwise.
-    bool packUniqueData(CPacket& packet);
+    bool packUniqueData(CPacket& packet, bool* encrypt = NULL);
 
     /// Pack in CPacket the next data to be send.
     ///
     /// @param packet [out] a CPacket structure to fill
     /// @param nexttime [out] Time when this socket should be next time picked up for processing.
     /// @param src_addr [out] Source address to pass to channel's sendto
+    /// @param encrypt [out] if not NULL, encryption of a new data packet may be left
+    ///                to the caller, in which case it's set to true (see encryptPacked()).
     ///
     /// @retval true A packet was extracted for sending, the socket should be rechecked at @a nexttime
     /// @retval false Nothing was extracted for sending, @a nexttime should be ignored
-    bool packData(CPacket& packet, time_point& nexttime, sockaddr_any& src_addr);
+    bool packData(CPacket& packet, time_point& nexttime, sockaddr_any& src_addr, bool* encrypt = NULL);
+
+    /// Encrypt packets returned by packData() with the encryption left to the
+    /// caller, in the order they were packed. Called by the crypto pool.
+    /// @param packets the packets
+    /// @param n number of packets
+    /// @return number of packets encrypted; the following ones must not be sent.
+    SRT_ATTR_EXCLUDES(m_ConnectionLock)
+    int encryptPacked(CPacket* const* packets, int n);
+
+    /// Decrypt received data packets before they are dispatched to processData(),
+    /// which then stores them as they are. Called by the crypto pool.
+    /// @param units the units with the packets, in the order of reception
+    /// @param n number of units
+    SRT_ATTR_EXCLUDES(m_RcvBufferLock)
+    void decryptReceived(CUnit* const* units, int n);
+
+    /// Call the release functions of the acknowledged or dropped zero-copy
+    /// messages, unless a packet of the socket waits in a send batch, in
+    /// which case the sending queue does it after the batch is sent.
+    void releaseSndUserData();
+
+    /// Wait until the packets of the closed socket that were packed into a
+    /// send batch are sent out, so that all user data are released.
+    void waitSndBatchOut();
+
+    /// Take back a packet from a send batch, when it was sent or discarded,
+    /// and release the user data that the batch no longer refers to.
+    void leaveSndBatch();
+
+    /// Compute the keystream for the packets to be sent next (SRTO_CRYPTOPRECOMP).
+    /// Called by the sending queue when no packet is due after the packets of
+    /// the socket were sent out.
+    SRT_ATTR_EXCLUDES(m_ConnectionLock)
+    void precomputeKeystream();
 
     /// Also excludes srt::CUDTUnited::m_GlobControlLock.
     SRT_ATTR_EXCLUDES(m_RcvTsbPdStartupLock, m_StatsLock, m_RecvLock, m_RcvLossLock, m_RcvBufferLock)
@@ -1153,6 +1235,21 @@ private: // Generation and processing of packets
     /// @return -2 The incoming packet exceeds the expected sequence by more than a length of the buffer (irrepairable discrepancy).
     int handleSocketPacketReception(const std::vector<CUnit*>& incoming, bool& w_new_inserted, bool& w_was_sent_in_order, CUDT::loss_seqs_t& w_srt_loss_seqs);
 
+#if ENABLE_BONDING
+    /// Move the start of the receiver buffer, which stays empty when the packets
+    /// are stored in the group buffer, forward to the start of the group buffer,
+    /// so that the losses dropped by the group are no longer reported.
+    /// [[using locked(m_RcvBufferLock)]]
+    /// @param grpstart the sequence number of the first packet expected in the group buffer
+    void followGroupRcvBuffer(int32_t grpstart);
+
+    /// Decrypt the packet and store it in the group buffer.
+    /// [[using locked(m_RcvBufferLock)]]
+    /// @return 0 if the packet was stored, -4 if it was rejected as not decrypted,
+    /// otherwise the same as CRcvBuffer::insert()
+    int insertGroupRcvUnit(CUDTGroup* grp, CUnit* u, bool retransmitted);
+#endif
+
     /// Get the packet's TSBPD time -
     /// the time when it is passed to the reading application.
     /// The @a grp passed by void* is not used yet
@@ -1171,8 +1268,9 @@ private: // Generation and processing of packets
     /// modify the object permanently.
     /// @param addr source address from where the request came
     /// @param packet contents of the packet
+    /// @param rcvq the receiving queue that got the request
     /// @return URQ code, possibly containing reject reason
-    int processConnectRequest(const sockaddr_any& addr, CPacket& packet);
+    int processConnectRequest(const sockaddr_any& addr, CPacket& packet, const CRcvQueue* rcvq);
     static void addLossRecord(std::vector<int32_t>& lossrecord, int32_t lo, int32_t hi);
     int32_t bake(const sockaddr_any& addr, int32_t previous_cookie = 0, int correction = 0);
 
@@ -1185,20 +1283,22 @@ private: // Generation and processing of packets
     size_t getAvailRcvBufferSizeNoLock() const;
 
 private: // Trace
+    // The counters in sndr and rcvr and the fields being atomic are updated
+    // without m_StatsLock; the lock guards the remaining fields.
     struct CoreStats
     {
-        time_point tsStartTime;             // timestamp when the UDT entity is started
+        sync::AtomicClock<sync::steady_clock> tsStartTime; // timestamp when the UDT entity is started
         stats::Sender sndr;                 // sender statistics
         stats::Receiver rcvr;               // receiver statistics
 
-        int64_t m_sndDurationTotal;         // total real time for sending
+        sync::atomic<int64_t> m_sndDurationTotal; // total real time for sending
 
         time_point tsLastSampleTime;        // last performance sample time
-        int traceReorderDistance;
+        sync::atomic<int> traceReorderDistance; // written by the receiving thread only
         double traceBelatedTime;
 
-        int64_t sndDuration;                // real time for sending
-        time_point sndDurationCounter;      // timers to record the sending Duration
+        sync::atomic<int64_t> sndDuration;  // real time for sending
+        sync::AtomicClock<sync::steady_clock> sndDurationCounter; // timers to record the sending Duration
 
     } m_stats;
 
@@ -1223,9 +1323,19 @@ private: // Timers functions
     void checkTimers();
     void considerLegacySrtHandshake(const time_point &timebase);
     int checkACKTimer (const time_point& currtime);
-    int checkNAKTimer(const time_point& currtime);
+    int checkNAKTimer(const time_point& currtime, bool& w_have_loss);
     bool checkExpTimer (const time_point& currtime, int check_reason);  // returns true if the connection is expired
-    void checkRexmitTimer(const time_point& currtime);
+    time_point checkRexmitTimer(const time_point& currtime); // returns the next time to check, or max() if none
+    time_point nextExpTime();
+    time_point nextRexmitTime() const;
+
+    /// Time when checkTimers() has anything to do for this socket
+    /// next time, unless a packet arrives earlier. It is computed
+    /// by checkTimers() and always later than its last call.
+    time_point nextTimersCheckTime() const { return m_tsNextTimersCheck; }
+
+    time_point m_tsNextTimersCheck; // Set by checkTimers(), accessed only by the receiver worker
+    sync::atomic<int64_t> m_iTimerChecks; // Number of checkTimers() calls, for diagnostics
 
 
 private: // for UDP multiplexer
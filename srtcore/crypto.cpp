@@ -95,6 +95,125 @@ bool srt::CCryptoControl::isAESGCMSupported()
 #endif
 }
 
+namespace srt
+{
+
+static CKekCache s_KekCache;
+
+static int kekCacheLookup(const char* pwd, size_t pwd_len, const unsigned char* salt, size_t salt_len,
+                          unsigned char* kek, size_t kek_len)
+{
+    return s_KekCache.lookup(pwd, pwd_len, salt, salt_len, (kek), kek_len) ? 0 : -1;
+}
+
+static void kekCacheStore(const char* pwd, size_t pwd_len, const unsigned char* salt, size_t salt_len,
+                          const unsigned char* kek, size_t kek_len)
+{
+    s_KekCache.store(pwd, pwd_len, salt, salt_len, kek, kek_len);
+}
+
+static const HaiCrypt_KekCache s_KekCacheCallbacks = { kekCacheLookup, kekCacheStore };
+
+} // namespace srt
+
+srt::CKekCache::CKekCache(size_t capacity)
+    : m_zCapacity(capacity)
+    , m_iHits(0)
+    , m_iMisses(0)
+{
+}
+
+srt::CKekCache::~CKekCache()
+{
+    clear();
+}
+
+srt::CKekCache& srt::CKekCache::instance()
+{
+    return s_KekCache;
+}
+
+const HaiCrypt_KekCache* srt::CKekCache::callbacks()
+{
+    return &s_KekCacheCallbacks;
+}
+
+bool srt::CKekCache::lookup(const char* pwd, size_t pwd_len, const unsigned char* salt, size_t salt_len,
+                            unsigned char* w_kek, size_t kek_len)
+{
+    sync::ScopedLock lk(m_Lock);
+    for (std::list<Entry>::iterator i = m_Entries.begin(); i != m_Entries.end(); ++i)
+    {
+        if (i->kek_len != kek_len || i->salt_len != salt_len || i->pwd_len != pwd_len
+            || memcmp(i->salt, salt, salt_len) != 0 || memcmp(i->pwd, pwd, pwd_len) != 0)
+            continue;
+
+        memcpy(w_kek, i->kek, kek_len);
+        m_Entries.splice(m_Entries.begin(), m_Entries, i);
+        ++m_iHits;
+        HLOGC(cnlog.Debug, log << "KEK cache: hit, " << m_iHits << " hits " << m_iMisses << " misses");
+        return true;
+    }
+
+    ++m_iMisses;
+    HLOGC(cnlog.Debug, log << "KEK cache: miss, " << m_iHits << " hits " << m_iMisses << " misses");
+    return false;
+}
+
+void srt::CKekCache::store(const char* pwd, size_t pwd_len, const unsigned char* salt, size_t salt_len,
+                           const unsigned char* kek, size_t kek_len)
+{
+    if (m_zCapacity == 0 || pwd_len > sizeof(Entry().pwd) || salt_len > sizeof(Entry().salt)
+        || kek_len > sizeof(Entry().kek))
+        return;
+
+    sync::ScopedLock lk(m_Lock);
+    if (m_Entries.size() >= m_zCapacity)
+    {
+        // Reuse the least recently used entry.
+        wipe(m_Entries.back());
+        m_Entries.splice(m_Entries.begin(), m_Entries, --m_Entries.end());
+    }
+    else
+    {
+        m_Entries.push_front(Entry());
+    }
+
+    Entry& e = m_Entries.front();
+    e.pwd_len = pwd_len;
+    memcpy(e.pwd, pwd, pwd_len);
+    e.salt_len = salt_len;
+    memcpy(e.salt, salt, salt_len);
+    e.kek_len = kek_len;
+    memcpy(e.kek, kek, kek_len);
+}
+
+void srt::CKekCache::clear()
+{
+    sync::ScopedLock lk(m_Lock);
+    for (std::list<Entry>::iterator i = m_Entries.begin(); i != m_Entries.end(); ++i)
+        wipe(*i);
+    m_Entries.clear();
+}
+
+size_t srt::CKekCache::size() const
+{
+    sync::ScopedLock lk(m_Lock);
+    return m_Entries.size();
+}
+
+int64_t srt::CKekCache::hits() const
+{
+    sync::ScopedLock lk(m_Lock);
+    return m_iHits;
+}
+
+int64_t srt::CKekCache::misses() const
+{
+    sync::ScopedLock lk(m_Lock);
+    return m_iMisses;
+}
+
 #if ENABLE_LOGGING
 std::string srt::CCryptoControl::FormatKmMessage(std::string hdr, int cmd, size_t srtlen)
 {
@@ -608,6 +727,8 @@ srt::CCryptoControl::CCryptoControl(SRTSOCKET id)
     , m_KmPreAnnouncePkt(0)
     , m_iCryptoMode(CSrtConfig::CIPHER_MODE_AUTO)
     , m_bUseGcm153(false)
+    , m_iPrecompPkts(0)
+    , m_bPrecompReady(false)
     , m_bErrorReported(false)
 {
     m_KmSecret.len = 0;
@@ -654,6 +775,7 @@ bool srt::CCryptoControl::init(HandshakeSide side, const CSrtConfig& cfg, bool b
 
     m_KmPreAnnouncePkt = cfg.uKmPreAnnouncePkt;
     m_KmRefreshRatePkt = cfg.uKmRefreshRatePkt;
+    m_iPrecompPkts = cfg.iCryptoPrecomp;
 
     if (side == HSD_INITIATOR)
     {
@@ -787,6 +909,7 @@ bool srt::CCryptoControl::createCryptoCtx(HaiCrypt_Handle& w_hCrypto, size_t key
     crypto_cfg.km_refresh_rate_pkt = m_KmRefreshRatePkt == 0 ? HAICRYPT_DEF_KM_REFRESH_RATE : m_KmRefreshRatePkt;
     crypto_cfg.km_pre_announce_pkt = m_KmPreAnnouncePkt == 0 ? SRT_CRYPT_KM_PRE_ANNOUNCE : m_KmPreAnnouncePkt;
     crypto_cfg.secret = m_KmSecret;
+    crypto_cfg.kek_cache = CKekCache::callbacks();
 
     HLOGC(cnlog.Debug, log << "CRYPTO CFG: flags=" << CryptoFlags(crypto_cfg.flags) << " xport=" << crypto_cfg.xport << " cryspr=" << crypto_cfg.cryspr
         << " keylen=" << crypto_cfg.key_len << " passphrase_length=" << crypto_cfg.secret.len);
@@ -836,6 +959,49 @@ srt::EncryptionStatus srt::CCryptoControl::encrypt(CPacket& w_packet SRT_ATR_UNU
 #endif
 }
 
+void srt::CCryptoControl::precomputeKeystream(int32_t seqno SRT_ATR_UNUSED, size_t len SRT_ATR_UNUSED)
+{
+#ifdef SRT_ENABLE_ENCRYPTION
+    if (m_iPrecompPkts == 0 || !m_hSndCrypto || m_iCryptoMode != CSrtConfig::CIPHER_MODE_AES_CTR)
+        return;
+
+    if (!m_bPrecompReady)
+    {
+        if (HaiCrypt_Tx_SetKeystreamCache(m_hSndCrypto, m_iPrecompPkts) != HAICRYPT_OK)
+        {
+            LOGC(cnlog.Warn, log << CONID() << "precomputeKeystream: can't allocate keystream for " << m_iPrecompPkts
+                                 << " packets, encrypting without it");
+            m_iPrecompPkts = 0;
+            return;
+        }
+        m_bPrecompReady = true;
+    }
+
+    // The packet index is the sequence number, so the range
+    // is split where the sequence number wraps around.
+    int       npkts = m_iPrecompPkts;
+    const int first = (CSeqNo::m_iMaxSeqNo - seqno < npkts) ? CSeqNo::m_iMaxSeqNo - seqno + 1 : npkts;
+    HaiCrypt_Tx_PrecomputeKeystream(m_hSndCrypto, seqno, first, len);
+    npkts -= first;
+    if (npkts > 0)
+        HaiCrypt_Tx_PrecomputeKeystream(m_hSndCrypto, 0, npkts, len);
+#endif
+}
+
+void srt::CCryptoControl::getKeystreamStats(int64_t& w_hits, int64_t& w_misses) const
+{
+    w_hits   = 0;
+    w_misses = 0;
+#ifdef SRT_ENABLE_ENCRYPTION
+    unsigned hits = 0, misses = 0;
+    if (m_bPrecompReady && HaiCrypt_Tx_GetKeystreamStats(m_hSndCrypto, &hits, &misses) == 0)
+    {
+        w_hits   = hits;
+        w_misses = misses;
+    }
+#endif
+}
+
 srt::EncryptionStatus srt::CCryptoControl::decrypt(CPacket& w_packet SRT_ATR_UNUSED)
 {
 #ifdef SRT_ENABLE_ENCRYPTION
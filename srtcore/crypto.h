@@ -17,6 +17,7 @@ written by
 #define INC_SRT_CRYPTO_H
 
 #include <cstring>
+#include <list>
 #include <string>
 
 // UDT
@@ -50,6 +51,68 @@ const size_t SRT_KMR_KMSTATE = 0;
 #define SRT_CMD_MAXSZ       HCRYPT_MSG_KM_MAX_SZ  /* Maximum SRT custom messages payload size (bytes) */
 const size_t SRTDATA_MAXSIZE = SRT_CMD_MAXSZ/sizeof(uint32_t);
 
+/// Key Encrypting Keys derived from passphrases, shared by all sockets.
+///
+/// A KEK costs HAICRYPT_PBKDF2_ITER_CNT iterations of PBKDF2, and the same
+/// passphrase, salt and key length always give the same KEK. This happens
+/// when the responder creates both crypto contexts of a connection from
+/// one KMREQ, and whenever a context is rekeyed with the salt already seen.
+/// An entry holds the passphrase itself rather than a hash of it, so a peer
+/// choosing the salt can't get the KEK of another passphrase by a collision.
+class CKekCache
+{
+public:
+    static const size_t DEF_CAPACITY = 64;
+
+    explicit CKekCache(size_t capacity = DEF_CAPACITY);
+    ~CKekCache();
+
+    /// Find the KEK derived from the passphrase and salt.
+    /// @return true if found, then the KEK is in @a w_kek.
+    bool lookup(const char* pwd, size_t pwd_len, const unsigned char* salt, size_t salt_len,
+                unsigned char* w_kek, size_t kek_len);
+
+    /// Add a derived KEK, replacing the least recently used one when full.
+    void store(const char* pwd, size_t pwd_len, const unsigned char* salt, size_t salt_len,
+               const unsigned char* kek, size_t kek_len);
+
+    /// Remove all entries, wiping the keys.
+    void clear();
+
+    size_t  size() const;
+    int64_t hits() const;
+    int64_t misses() const;
+
+    /// The cache used by the crypto contexts of the sockets.
+    static CKekCache& instance();
+
+    /// HaiCrypt callbacks using instance().
+    static const HaiCrypt_KekCache* callbacks();
+
+private:
+    struct Entry
+    {
+        size_t        pwd_len;
+        char          pwd[HAICRYPT_SECRET_MAX_SZ];
+        size_t        salt_len;
+        unsigned char salt[HAICRYPT_SALT_SZ];
+        size_t        kek_len;
+        unsigned char kek[HAICRYPT_KEY_MAX_SZ];
+    };
+
+    static void wipe(Entry& e) { memset(&e, 0, sizeof e); }
+
+    mutable sync::Mutex m_Lock;
+    std::list<Entry>    m_Entries; // Most recently used first
+    size_t              m_zCapacity;
+    int64_t             m_iHits;
+    int64_t             m_iMisses;
+
+private:
+    CKekCache(const CKekCache&);
+    CKekCache& operator=(const CKekCache&);
+};
+
 class CCryptoControl
 {
     SRTSOCKET m_SocketID;
@@ -69,6 +132,8 @@ private:
     int m_KmPreAnnouncePkt;
     int m_iCryptoMode;
     bool m_bUseGcm153; // Older AES-GCM version existed up to SRT v1.5.3.
+    int m_iPrecompPkts; // SRTO_CRYPTOPRECOMP, 0 when not applicable
+    bool m_bPrecompReady; // The keystream cache of m_hSndCrypto is allocated
 
     HaiCrypt_Secret m_KmSecret;     //Key material shared secret
     // Sender
@@ -272,6 +337,18 @@ public:
     /// field in the header must be correctly set before calling.
     EncryptionStatus encrypt(CPacket& w_packet);
 
+    /// Computes the AES-CTR keystream of the packets that will be sent
+    /// next, so that encrypt() only has to XOR it with the payload.
+    /// Does nothing unless SRTO_CRYPTOPRECOMP is set and AES-CTR is used.
+    /// Must be called by the thread that encrypts the packets.
+    /// @param seqno sequence number of the next packet to be sent
+    /// @param len payload size of the packets
+    void precomputeKeystream(int32_t seqno, size_t len);
+
+    /// Get the number of the packets encrypted with and without a
+    /// precomputed keystream, since it is enabled (SRTO_CRYPTOPRECOMP).
+    void getKeystreamStats(int64_t& w_hits, int64_t& w_misses) const;
+
     /// Decrypts the packet. If the packet has ENCKEYSPEC part
     /// in PH_MSGNO set to EK_NOENC, it does nothing. It decrypts
     /// only if the encryption correctly configured, otherwise it
@@ -0,0 +1,171 @@
+/*
+ * SRT - Secure, Reliable, Transport
+ * Copyright (c) 2021 Haivision Systems Inc.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ */
+#include "platform_sys.h"
+
+#include <algorithm>
+
+#include "crypto_pool.h"
+
+#include "common.h"
+#include "udt.h"
+#include "logging.h"
+#include "logger_defs.h"
+
+using namespace srt_logging;
+using namespace srt::sync;
+
+namespace srt
+{
+
+CCryptoPool::CCryptoPool()
+    : m_bStop(false)
+    , m_iJobs(0)
+    , m_iJobsOffloaded(0)
+{
+    setupCond(m_WorkCond, "CryptoPoolWork");
+    setupCond(m_DoneCond, "CryptoPoolDone");
+}
+
+CCryptoPool::~CCryptoPool()
+{
+    stop();
+    releaseCond(m_WorkCond);
+    releaseCond(m_DoneCond);
+}
+
+void CCryptoPool::init(int nthreads)
+{
+    m_bStop = false;
+    for (int i = 0; i < nthreads; ++i)
+    {
+        CThread* th = new CThread;
+        if (!StartThread(*th, CCryptoPool::worker, this, "SRT:Crypto"))
+        {
+            delete th;
+            throw CUDTException(MJ_SYSTEMRES, MN_THREAD);
+        }
+        m_vThreads.push_back(th);
+    }
+    HLOGC(qslog.Debug, log << "crypto pool: started " << nthreads << " threads");
+}
+
+void CCryptoPool::stop()
+{
+    {
+        ScopedLock lk(m_Lock);
+        m_bStop = true;
+        m_WorkCond.notify_all();
+    }
+
+    for (size_t i = 0; i < m_vThreads.size(); ++i)
+    {
+        if (m_vThreads[i]->joinable())
+            m_vThreads[i]->join();
+        delete m_vThreads[i];
+    }
+    m_vThreads.clear();
+}
+
+void CCryptoPool::resetAtFork()
+{
+    for (size_t i = 0; i < m_vThreads.size(); ++i)
+        resetThread(m_vThreads[i]);
+    m_Pending.clear();
+}
+
+int CCryptoPool::takeJob(Batch* b)
+{
+    const int index = b->next++;
+    if (b->next == b->njobs)
+    {
+        // Usually the batch being taken is the oldest one.
+        std::deque<Batch*>::iterator i = std::find(m_Pending.begin(), m_Pending.end(), b);
+        if (i != m_Pending.end())
+            m_Pending.erase(i);
+    }
+    return index;
+}
+
+void CCryptoPool::run(job_fn* fn, void* arg, int njobs)
+{
+    if (njobs <= 0)
+        return;
+
+    m_iJobs.fetch_add_relaxed(njobs);
+    if (njobs == 1 || m_vThreads.empty())
+    {
+        for (int i = 0; i < njobs; ++i)
+            fn(arg, i);
+        return;
+    }
+
+    Batch b;
+    b.fn    = fn;
+    b.arg   = arg;
+    b.njobs = njobs;
+    b.next  = 0;
+    b.done  = 0;
+
+    UniqueLock lk(m_Lock);
+    m_Pending.push_back(&b);
+    m_WorkCond.notify_all();
+
+    // Take part in the work rather than just wait.
+    while (b.next < b.njobs)
+    {
+        const int index = takeJob(&b);
+        lk.unlock();
+        fn(arg, index);
+        lk.lock();
+        ++b.done;
+    }
+
+    while (b.done < b.njobs)
+        m_DoneCond.wait(lk);
+}
+
+void* CCryptoPool::worker(void* param)
+{
+    CCryptoPool* self = (CCryptoPool*)param;
+
+    THREAD_STATE_INIT("SRT:Crypto");
+
+    UniqueLock lk(self->m_Lock);
+    while (!self->m_bStop)
+    {
+        INCREMENT_THREAD_ITERATIONS();
+
+        if (self->m_Pending.empty())
+        {
+            THREAD_PAUSED();
+            self->m_WorkCond.wait(lk);
+            THREAD_RESUMED();
+            continue;
+        }
+
+        Batch*    b     = self->m_Pending.front();
+        const int index = self->takeJob(b);
+        lk.unlock();
+
+        b->fn(b->arg, index);
+
+        lk.lock();
+        self->m_iJobsOffloaded.store(self->m_iJobsOffloaded.load() + 1);
+        // The batch belongs to the caller of run(), which may
+        // return as soon as the last job is finished.
+        if (++b->done == b->njobs)
+            self->m_DoneCond.notify_all();
+    }
+
+    THREAD_EXIT();
+    return NULL;
+}
+
+} // namespace srt
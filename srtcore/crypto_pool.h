@@ -0,0 +1,100 @@
+/*
+ * SRT - Secure, Reliable, Transport
+ * Copyright (c) 2021 Haivision Systems Inc.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ */
+
+#ifndef INC_SRT_CRYPTO_POOL_H
+#define INC_SRT_CRYPTO_POOL_H
+
+#include <deque>
+#include <vector>
+#include "sync.h"
+
+namespace srt
+{
+
+/// @brief Threads encrypting and decrypting packets of a multiplexer.
+///
+/// Used by the sending and receiving queues when SRTO_CRYPTOWORKERS is
+/// set. A queue thread splits the packets it has collected into jobs,
+/// one job per socket, and calls run(). The jobs are executed by the
+/// pool threads and by the calling thread, and run() returns when all
+/// of them are finished. Packets of one socket are always handled by
+/// one job, in order, so the jobs need no synchronization between them.
+class CCryptoPool
+{
+public:
+    /// A job. Called with the argument passed to run() and the index
+    /// of the job, [0, njobs).
+    typedef void job_fn(void* arg, int index);
+
+    CCryptoPool();
+    ~CCryptoPool();
+
+    /// Start the threads.
+    /// @param [in] nthreads number of threads
+    /// @throws CUDTException if a thread could not be started.
+    void init(int nthreads);
+
+    /// Execute jobs and wait until they are finished. May be called
+    /// by several threads at a time.
+    /// @param [in] fn job function
+    /// @param [in] arg argument passed to @a fn
+    /// @param [in] njobs number of jobs
+    void run(job_fn* fn, void* arg, int njobs);
+
+    /// Stop the threads. Must not be called while run() is in progress.
+    void stop();
+
+    /// Forget the threads, which don't exist in the child process.
+    void resetAtFork();
+
+    /// Number of threads.
+    int threads() const { return int(m_vThreads.size()); }
+
+    /// Number of jobs executed, by the pool threads or the callers of run().
+    int64_t jobsTotal() const { return m_iJobs.load(); }
+
+    /// Number of jobs executed by the pool threads, not by the callers of run().
+    int64_t jobsOffloadedTotal() const { return m_iJobsOffloaded.load(); }
+
+private:
+    struct Batch
+    {
+        job_fn* fn;
+        void*   arg;
+        int     njobs;
+        int     next; // Index of the next job to take
+        int     done; // Number of finished jobs
+    };
+
+    static void* worker(void* param);
+
+    // [[using locked(m_Lock)]]
+    /// Take the next job of @a b, removing the batch from the pending
+    /// ones when it was the last one.
+    int takeJob(Batch* b);
+
+    sync::Mutex              m_Lock;
+    sync::Condition          m_WorkCond; // Signalled when a batch is added or the pool is stopped
+    sync::Condition          m_DoneCond; // Signalled when all jobs of a batch are finished
+    std::deque<Batch*>       m_Pending;  // Batches with jobs not taken yet
+    std::vector<sync::CThread*> m_vThreads;
+    bool                     m_bStop;
+
+    sync::atomic<int64_t> m_iJobs;
+    sync::atomic<int64_t> m_iJobsOffloaded;
+
+private:
+    CCryptoPool(const CCryptoPool&);
+    CCryptoPool& operator=(const CCryptoPool&);
+};
+
+} // namespace srt
+
+#endif
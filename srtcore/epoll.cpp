@@ -171,6 +171,7 @@ int srt::CEPoll::clear_usocks(int eid)
    CEPollDesc& d = p->second;
 
    d.clearAll();
+   d.notifyWaiters();
 
    return 0;
 }
@@ -385,6 +386,9 @@ int srt::CEPoll::update_usock(const int eid, const SRTSOCKET& u, const int* even
         HLOGC(ealog.Debug, log << "srt_epoll_update_usock: REMOVED E" << eid << " socket @" << u);
         d.removeSubscription(u);
     }
+
+    // Let the waiters see the new readiness or an empty subscription.
+    d.notifyWaiters();
     return 0;
 }
 
@@ -480,10 +484,20 @@ int srt::CEPoll::setflags(const int eid, int32_t flags)
     {
         ed.set_flags(flags);
     }
+    ed.notifyWaiters();
 
     return oflags;
 }
 
+int64_t srt::CEPoll::wakeups(const int eid) const
+{
+    ScopedLock pg(m_EPollLock);
+    map<int, CEPollDesc>::const_iterator p = m_mPolls.find(eid);
+    if (p == m_mPolls.end())
+        return -1;
+    return p->second.m_iWakeups;
+}
+
 int srt::CEPoll::uwait(const int eid, SRT_EPOLL_EVENT* fdsSet, int fdsSize, int64_t msTimeOut)
 {
     // It is allowed to call this function witn fdsSize == 0
@@ -494,10 +508,10 @@ int srt::CEPoll::uwait(const int eid, SRT_EPOLL_EVENT* fdsSet, int fdsSize, int6
 
     steady_clock::time_point entertime = steady_clock::now();
 
+    UniqueLock pg(m_EPollLock);
     while (true)
     {
         {
-            ScopedLock pg(m_EPollLock);
             map<int, CEPollDesc>::iterator p = m_mPolls.find(eid);
             if (p == m_mPolls.end())
                 throw CUDTException(MJ_NOTSUP, MN_EIDINVAL);
@@ -535,10 +549,15 @@ int srt::CEPoll::uwait(const int eid, SRT_EPOLL_EVENT* fdsSet, int fdsSize, int6
                 return pos;
         }
 
-        if ((msTimeOut >= 0) && (count_microseconds(srt::sync::steady_clock::now() - entertime) >= msTimeOut * int64_t(1000)))
-            break; // official wait does: throw CUDTException(MJ_AGAIN, MN_XMTIMEOUT, 0);
+        int64_t remain_us = -1;
+        if (msTimeOut >= 0)
+        {
+            remain_us = msTimeOut * int64_t(1000) - count_microseconds(steady_clock::now() - entertime);
+            if (remain_us <= 0)
+                break; // official wait does: throw CUDTException(MJ_AGAIN, MN_XMTIMEOUT, 0);
+        }
 
-        CGlobEvent::waitForEvent();
+        waitNotice(pg, eid, remain_us);
     }
 
     return 0;
@@ -559,11 +578,12 @@ int srt::CEPoll::wait(const int eid, set<SRTSOCKET>* readfds, set<SRTSOCKET>* wr
     int total = 0;
 
     srt::sync::steady_clock::time_point entertime = srt::sync::steady_clock::now();
+    UniqueLock epollock(m_EPollLock);
     while (true)
     {
+        // System sockets don't notify the EID, so they are checked periodically.
+        bool has_locals = false;
         {
-            ScopedLock epollock(m_EPollLock);
-
             map<int, CEPollDesc>::iterator p = m_mPolls.find(eid);
             if (p == m_mPolls.end())
             {
@@ -626,6 +646,7 @@ int srt::CEPoll::wait(const int eid, set<SRTSOCKET>* readfds, set<SRTSOCKET>* wr
 
             if ((lrfds || lwfds) && !ed.m_sLocals.empty())
             {
+                has_locals = true;
 #ifdef LINUX
                 const int max_events = ed.m_sLocals.size();
                 SRT_ASSERT(max_events > 0);
@@ -727,13 +748,21 @@ int srt::CEPoll::wait(const int eid, set<SRTSOCKET>* readfds, set<SRTSOCKET>* wr
         if (total > 0)
             return total;
 
-        if ((msTimeOut >= 0) && (count_microseconds(srt::sync::steady_clock::now() - entertime) >= msTimeOut * int64_t(1000)))
+        int64_t remain_us = -1;
+        if (msTimeOut >= 0)
         {
-            HLOGC(ealog.Debug, log << "EID:" << eid << ": TIMEOUT.");
-            throw CUDTException(MJ_AGAIN, MN_XMTIMEOUT, 0);
+            remain_us = msTimeOut * int64_t(1000) - count_microseconds(srt::sync::steady_clock::now() - entertime);
+            if (remain_us <= 0)
+            {
+                HLOGC(ealog.Debug, log << "EID:" << eid << ": TIMEOUT.");
+                throw CUDTException(MJ_AGAIN, MN_XMTIMEOUT, 0);
+            }
         }
 
-        const bool wait_signaled SRT_ATR_UNUSED = CGlobEvent::waitForEvent();
+        if (has_locals && (remain_us < 0 || remain_us > 10000))
+            remain_us = 10000;
+
+        const bool wait_signaled SRT_ATR_UNUSED = waitNotice(epollock, eid, remain_us);
         HLOGC(ealog.Debug, log << "CEPoll::wait: EVENT WAITING: "
             << (wait_signaled ? "TRIGGERED" : "CHECKPOINT"));
     }
@@ -758,6 +787,10 @@ int srt::CEPoll::swait(CEPollDesc& d, map<SRTSOCKET, int>& st, int64_t msTimeOut
     st.clear();
 
     steady_clock::time_point entertime = steady_clock::now();
+
+    // Here we only prevent the pollset be updated simultaneously
+    // with unstable reading.
+    UniqueLock lg (m_EPollLock);
     while (true)
     {
         {
@@ -766,10 +799,6 @@ int srt::CEPoll::swait(CEPollDesc& d, map<SRTSOCKET, int>& st, int64_t msTimeOut
             // not be deleted or changed the target CEPollDesc in the
             // meantime.
 
-            // Here we only prevent the pollset be updated simultaneously
-            // with unstable reading. 
-            ScopedLock lg (m_EPollLock);
-
             if (!d.flags(SRT_EPOLL_ENABLE_EMPTY) && d.watch_empty())
             {
                 // Empty EID is not allowed, report error.
@@ -814,15 +843,20 @@ int srt::CEPoll::swait(CEPollDesc& d, map<SRTSOCKET, int>& st, int64_t msTimeOut
             // extremely often.
         }
 
-        if ((msTimeOut >= 0) && ((steady_clock::now() - entertime) >= microseconds_from(msTimeOut * int64_t(1000))))
+        int64_t remain_us = -1;
+        if (msTimeOut >= 0)
         {
-            HLOGC(ealog.Debug, log << "EID:" << d.m_iID << ": TIMEOUT.");
-            if (report_by_exception)
-                throw CUDTException(MJ_AGAIN, MN_XMTIMEOUT, 0);
-            return 0; // meaning "none is ready"
+            remain_us = msTimeOut * int64_t(1000) - count_microseconds(steady_clock::now() - entertime);
+            if (remain_us <= 0)
+            {
+                HLOGC(ealog.Debug, log << "EID:" << d.m_iID << ": TIMEOUT.");
+                if (report_by_exception)
+                    throw CUDTException(MJ_AGAIN, MN_XMTIMEOUT, 0);
+                return 0; // meaning "none is ready"
+            }
         }
 
-        CGlobEvent::waitForEvent();
+        waitNotice(lg, d.m_iID, remain_us);
     }
 
     return 0;
@@ -849,12 +883,41 @@ int srt::CEPoll::release(const int eid)
    ::close(i->second.m_iLocalID);
    #endif
 
+   // Threads still waiting on this EID will find it gone.
+   i->second.notifyWaiters();
    m_mPolls.erase(i);
 
    return 0;
 }
 
 
+bool srt::CEPoll::waitNotice(UniqueLock& lock, int eid, int64_t timeout_us)
+{
+    map<int, CEPollDesc>::iterator p = m_mPolls.find(eid);
+    if (p == m_mPolls.end())
+        return true; // Released; the caller reports it.
+
+    Condition notice;
+    notice.init();
+    p->second.m_Waiters.push_back(&notice);
+
+    bool signaled = true;
+    if (timeout_us < 0)
+        notice.wait(lock);
+    else
+        signaled = notice.wait_for(lock, microseconds_from(timeout_us));
+
+    // The EID might have been released in the meantime.
+    p = m_mPolls.find(eid);
+    if (p != m_mPolls.end())
+    {
+        vector<Condition*>& waiters = p->second.m_Waiters;
+        waiters.erase(std::remove(waiters.begin(), waiters.end(), &notice), waiters.end());
+    }
+    notice.destroy();
+    return signaled;
+}
+
 int srt::CEPoll::update_events(const SRTSOCKET& uid, std::set<int>& eids, const int events, const bool enable)
 {
     // As event flags no longer contain only event types, check now.
@@ -929,6 +992,8 @@ int srt::CEPoll::update_events(const SRTSOCKET& uid, std::set<int>& eids, const
         // - if !enable, it will clear event flags, possibly remove notice if resulted in 0
         ed.updateEventNotice(*pwait, uid, events, enable);
         ++nupdated;
+        if (enable)
+            ed.notifyWaiters();
 
         HLOGC(eilog.Debug, log << debug.str() << ": E" << (*i)
                 << " TRACKING: " << ed.DisplayEpollWatch());
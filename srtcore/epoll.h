@@ -57,7 +57,9 @@ modified by
 #include <map>
 #include <set>
 #include <list>
+#include <vector>
 #include "udt.h"
+#include "sync.h"
 
 namespace srt
 {
@@ -165,6 +167,21 @@ std::string DisplayEpollWatch();
    // Special behavior
    int32_t m_Flags;
 
+   /// Threads currently blocked on this EID in `uwait`, `wait` or `swait`,
+   /// each with its own condition. A readiness change of a socket subscribed
+   /// in this EID wakes up only these, not the waiters of other EIDs.
+   std::vector<sync::Condition*> m_Waiters;
+
+   /// Number of notifications sent to the waiting threads so far.
+   int64_t m_iWakeups;
+
+   void notifyWaiters()
+   {
+       for (size_t i = 0; i < m_Waiters.size(); ++i)
+           m_Waiters[i]->notify_one();
+       m_iWakeups += m_Waiters.size();
+   }
+
    enotice_t::iterator nullNotice() { return m_USockEventNotice.end(); }
 
    // Only CEPoll class should have access to it.
@@ -175,6 +192,7 @@ std::string DisplayEpollWatch();
    CEPollDesc(int id, int localID)
        : m_iID(id)
        , m_Flags(0)
+       , m_iWakeups(0)
        , m_iLocalID(localID)
     {
     }
@@ -491,7 +509,18 @@ public: // for CUDT to acknowledge IO status
 
    int setflags(const int eid, int32_t flags);
 
+   /// Reports how many times the threads waiting on the EID were notified.
+   /// @param [in] eid EPoll ID.
+   /// @return the number of notifications, or -1 if there's no such EID
+   int64_t wakeups(const int eid) const;
+
 private:
+   /// Blocks the calling thread, that holds m_EPollLock by @a lock,
+   /// until the EID @a eid is notified of a change or the timeout expires.
+   /// @param timeout_us maximum waiting time in microseconds, -1 for infinite
+   /// @return false if the timeout expired, true otherwise
+   bool waitNotice(sync::UniqueLock& lock, int eid, int64_t timeout_us);
+
    int m_iIDSeed;                            // seed to generate a new ID
    srt::sync::Mutex m_SeedLock;
 
@@ -22,6 +22,7 @@
 #include "logging.h"
 
 #include "fec.h"
+#include "fec_xor.h"
 
 // Maximum allowed "history" remembered in the receiver groups.
 // This is calculated in series, that is, this number will be
@@ -602,17 +603,12 @@ void FECFilterBuiltin::ClipData(Group& g, uint16_t length_net, uint8_t kflg,
             << " to a clip buffer size=" << payloadSize());
 
     // Payload goes "as is".
-    for (size_t i = 0; i < payload_size; ++i)
-    {
-        g.payload_clip[i] = g.payload_clip[i] ^ payload[i];
-    }
+    fec::xorInto(&g.payload_clip[0], payload, payload_size);
 
-    // Fill the rest with zeros. When this packet is going to be
-    // recovered, the payload extracted from this process will have
-    // the maximum length, but it will be cut to the right length
-    // and these padding 0s taken out.
-    for (size_t i = payload_size; i < payloadSize(); ++i)
-        g.payload_clip[i] = g.payload_clip[i] ^ 0;
+    // The rest is treated as filled with zeros, which leaves the clip
+    // unchanged. When this packet is going to be recovered, the payload
+    // extracted from this process will have the maximum length, but it
+    // will be cut to the right length and these padding 0s taken out.
 }
 
 bool FECFilterBuiltin::packControlPacket(SrtPacket& rpkt, int32_t seq)
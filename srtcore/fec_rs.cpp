@@ -0,0 +1,529 @@
+/*
+ * SRT - Secure, Reliable, Transport
+ * Copyright (c) 2021 Haivision Systems Inc.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ */
+
+#include "platform_sys.h"
+
+#include <string>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <iterator>
+
+#include "packetfilter.h"
+#include "core.h"
+#include "packet.h"
+#include "logging.h"
+
+#include "fec_rs.h"
+#include "fec_xor.h"
+
+using namespace std;
+using namespace srt_logging;
+
+namespace srt {
+
+const char RSFilterBuiltin::defaultConfig [] = "rsfec,m:2,arq:onreq";
+
+// The code length k+m is limited by the number of elements of GF(2^8)
+// that can make the Cauchy matrix.
+static const int RS_MAX_PACKETS = 255;
+
+static const char* const rs_levelnames [] = {"never", "onreq", "always"};
+
+bool RSFilterBuiltin::verifyConfig(const SrtFilterConfig& cfg, string& w_error)
+{
+    // Both may be missing here, the configurations of the
+    // parties are merged before the filter is created.
+    const string kspec = map_get(cfg.parameters, "k"), mspec = map_get(cfg.parameters, "m");
+
+    int k = 1, m = 2;
+    if (kspec != "")
+    {
+        k = atoi(kspec.c_str());
+        if (k < 1)
+        {
+            w_error = "'k' must be >= 1";
+            return false;
+        }
+    }
+
+    if (mspec != "")
+    {
+        m = atoi(mspec.c_str());
+        if (m < 1)
+        {
+            w_error = "'m' must be >= 1";
+            return false;
+        }
+    }
+
+    if (k + m > RS_MAX_PACKETS)
+    {
+        w_error = "'k' + 'm' must not exceed 255";
+        return false;
+    }
+
+    const string level = map_get(cfg.parameters, "arq");
+    if (level != "")
+    {
+        size_t i = 0;
+        for (i = 0; i < Size(rs_levelnames); ++i)
+        {
+            if (level == rs_levelnames[i])
+                break;
+        }
+
+        if (i == Size(rs_levelnames))
+        {
+            w_error = "'arq' value '" + level + "' invalid. Allowed: never, onreq, always";
+            return false;
+        }
+    }
+
+    for (map<string, string>::const_iterator i = cfg.parameters.begin(); i != cfg.parameters.end(); ++i)
+    {
+        if (i->first != "k" && i->first != "m" && i->first != "arq")
+        {
+            w_error = "Extra parameters. Allowed only: k, m, arq";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+RSFilterBuiltin::RSFilterBuiltin(const SrtFilterInitializer& init, std::vector<SrtPacket>& provided, const string& confstr)
+    : SrtPacketFilterBase(init)
+    , m_iDataCount(0)
+    , m_iParityCount(2)
+    , m_fallback_level(SRT_ARQ_ONREQ)
+    , rcv(provided)
+{
+    if (!ParseFilterConfig(confstr, cfg))
+        throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+
+    string ermsg;
+    if (!verifyConfig(cfg, (ermsg)))
+    {
+        LOGC(pflog.Error, log << "IPE: Filter config failed: " << ermsg);
+        throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+    }
+
+    const string kspec = map_get(cfg.parameters, "k"), mspec = map_get(cfg.parameters, "m");
+    if (kspec == "")
+    {
+        LOGC(pflog.Error, log << "RSFEC filter config: parameter 'k' is mandatory");
+        throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+    }
+
+    m_iDataCount = atoi(kspec.c_str());
+    if (mspec != "")
+        m_iParityCount = atoi(mspec.c_str());
+
+    const string level = map_get(cfg.parameters, "arq");
+    for (size_t i = 0; i < Size(rs_levelnames); ++i)
+    {
+        if (level == rs_levelnames[i])
+            m_fallback_level = SRT_ARQLevel(i);
+    }
+
+    m_Coef.resize(m_iParityCount * m_iDataCount);
+    for (size_t i = 0; i < m_iParityCount; ++i)
+    {
+        for (size_t j = 0; j < m_iDataCount; ++j)
+            m_Coef[i * m_iDataCount + j] = fec::gfInv((unsigned char)((m_iDataCount + i) ^ j));
+    }
+
+    // The ISNs are the values of ISN-1, like in the builtin FEC filter.
+    snd.parity.resize(m_iParityCount * symbolSize());
+    ResetSndGroup(CSeqNo::incseq(sndISN()));
+
+    rcv.id = socketID();
+    rcv.base = CSeqNo::incseq(rcvISN());
+    rcv.groups.resize(RCV_GROUPS);
+    for (size_t i = 0; i < RCV_GROUPS; ++i)
+        ResetRcvGroup(rcv.groups[i], CSeqNo::incseq(rcv.base, int(i * m_iDataCount)));
+
+    HLOGC(pflog.Debug, log << "RSFEC: k=" << m_iDataCount << " m=" << m_iParityCount
+            << " kernel=" << fec::xorMulBest().name << " ISN { snd=" << snd.base << " rcv=" << rcv.base << " }");
+}
+
+RSFilterBuiltin::~RSFilterBuiltin()
+{
+    if (m_stats.sndGroups || m_stats.rcvParity)
+    {
+        LOGC(pflog.Note, log << "RSFEC @" << socketID() << " k=" << m_iDataCount << " m=" << m_iParityCount
+                << ": sent " << m_stats.sndGroups << " groups with " << m_stats.sndParity << " parity packets; received "
+                << m_stats.rcvParity << " parity packets, rebuilt " << m_stats.rcvRecovered
+                << ", unrecoverable " << m_stats.rcvUnrecoverable);
+    }
+}
+
+void RSFilterBuiltin::symbolHeader(uint8_t kflg, uint16_t length_net, uint32_t timestamp_hw, char* w_hdr)
+{
+    // NOTE: As in the builtin FEC filter, the length is taken in the network
+    // order because it is sent in the payload, and the timestamp in the host
+    // order because it is sent in the header.
+    w_hdr[0] = char(kflg);
+    w_hdr[1] = 0;
+    memcpy(w_hdr + 2, &length_net, sizeof length_net);
+    memcpy(w_hdr + 4, &timestamp_hw, sizeof timestamp_hw);
+}
+
+void RSFilterBuiltin::ResetSndGroup(int32_t base)
+{
+    snd.base = base;
+    snd.collected = 0;
+    snd.next_parity = 0;
+    memset(&snd.parity[0], 0, snd.parity.size());
+}
+
+void RSFilterBuiltin::feedSource(CPacket& packet)
+{
+    int offset = CSeqNo::seqoff(snd.base, packet.getSeqNo());
+    if (offset < 0)
+    {
+        LOGC(pflog.Error, log << "RSFEC: IPE: packet %" << packet.getSeqNo() << " older than the group %" << snd.base);
+        return;
+    }
+
+    if (offset >= int(m_iDataCount))
+    {
+        // The parity of the group wasn't sent in whole, which shouldn't
+        // happen because packControlPacket is called before every new packet.
+        LOGC(pflog.Warn, log << "RSFEC: group %" << snd.base << " not completed, %" << packet.getSeqNo() << " starts a new one");
+        ResetSndGroup(CSeqNo::incseq(snd.base, offset - offset % int(m_iDataCount)));
+        offset %= int(m_iDataCount);
+    }
+
+    char hdr[SYMBOL_HDR_SIZE];
+    symbolHeader(uint8_t(packet.getMsgCryptoFlags()), htons(uint16_t(packet.size())), packet.getMsgTimeStamp(), hdr);
+    const size_t length = min(packet.size(), payloadSize());
+
+    for (size_t i = 0; i < m_iParityCount; ++i)
+    {
+        char* parity = &snd.parity[i * symbolSize()];
+        const unsigned char c = coef(i, offset);
+        fec::xorMulInto(parity, hdr, c, SYMBOL_HDR_SIZE);
+        fec::xorMulInto(parity + SYMBOL_HDR_SIZE, packet.data(), c, length);
+    }
+    ++snd.collected;
+}
+
+bool RSFilterBuiltin::packControlPacket(SrtPacket& rpkt, int32_t seq SRT_ATR_UNUSED)
+{
+    if (snd.collected < m_iDataCount)
+        return false;
+
+    const char* parity = &snd.parity[snd.next_parity * symbolSize()];
+    char* out = rpkt.buffer;
+    out[0] = char(snd.next_parity);
+    out[1] = parity[0];
+    memcpy(out + 2, parity + 2, sizeof(uint16_t));
+    memcpy(out + EXTRA_SIZE, parity + SYMBOL_HDR_SIZE, payloadSize());
+    rpkt.length = EXTRA_SIZE + payloadSize();
+
+    uint32_t timestamp_clip;
+    memcpy(&timestamp_clip, parity + 4, sizeof timestamp_clip);
+    rpkt.hdr[SRT_PH_TIMESTAMP] = timestamp_clip;
+
+    // All parity packets of a group carry the sequence number
+    // of the last data packet of the group, same as 'seq'.
+    rpkt.hdr[SRT_PH_SEQNO] = CSeqNo::incseq(snd.base, int(m_iDataCount) - 1);
+
+    HLOGC(pflog.Debug, log << "RSFEC: parity " << snd.next_parity << "/" << m_iParityCount
+            << " of group %" << snd.base << " (last sent %" << seq << ")");
+
+    ++m_stats.sndParity;
+    if (++snd.next_parity == m_iParityCount)
+    {
+        ++m_stats.sndGroups;
+        ResetSndGroup(CSeqNo::incseq(snd.base, int(m_iDataCount)));
+    }
+    return true;
+}
+
+void RSFilterBuiltin::ResetRcvGroup(RcvGroup& g, int32_t base)
+{
+    g.base = base;
+    g.collected = 0;
+    g.nparity = 0;
+    g.done = false;
+    g.have.assign(m_iDataCount + m_iParityCount, false);
+    // Every symbol is overwritten before use.
+    g.symbols.resize((m_iDataCount + m_iParityCount) * symbolSize());
+}
+
+static void AddLoss(SrtPacketFilterBase::loss_seqs_t& w_loss, int32_t lo, int32_t hi)
+{
+    if (!w_loss.empty() && CSeqNo::incseq(w_loss.back().second) == lo)
+        w_loss.back().second = hi;
+    else
+        w_loss.push_back(make_pair(lo, hi));
+}
+
+void RSFilterBuiltin::RcvDismissGroup(RcvGroup& g, loss_seqs_t& w_irrecover)
+{
+    if (g.done)
+        return;
+
+    for (size_t j = 0; j < m_iDataCount; ++j)
+    {
+        if (g.have[j])
+            continue;
+
+        const int32_t seq = CSeqNo::incseq(g.base, int(j));
+        ++m_stats.rcvUnrecoverable;
+        if (m_fallback_level == SRT_ARQ_ONREQ)
+            AddLoss((w_irrecover), seq, seq);
+    }
+
+    HLOGC(pflog.Debug, log << "RSFEC: dismissed group %" << g.base << " with " << g.collected << "/"
+            << m_iDataCount << " data and " << g.nparity << " parity packets");
+}
+
+RSFilterBuiltin::RcvGroup* RSFilterBuiltin::RcvGetGroup(int32_t seq, size_t& w_pos, loss_seqs_t& w_irrecover)
+{
+    int offset = CSeqNo::seqoff(rcv.base, seq);
+    if (offset < 0)
+        return NULL;
+
+    const size_t k = m_iDataCount;
+    const size_t gx = offset / k;
+    if (gx >= RCV_GROUPS)
+    {
+        // Make this group the newest one, dismissing the oldest.
+        const size_t shift = gx - RCV_GROUPS + 1;
+        const size_t ndismiss = min(shift, size_t(RCV_GROUPS));
+        for (size_t i = 0; i < ndismiss; ++i)
+            RcvDismissGroup(rcv.groups[(rcv.head + i) % RCV_GROUPS], (w_irrecover));
+
+        if (shift > RCV_GROUPS)
+        {
+            // Whole groups were skipped.
+            const int32_t lo = CSeqNo::incseq(rcv.base, int(RCV_GROUPS * k));
+            const int32_t hi = CSeqNo::decseq(CSeqNo::incseq(rcv.base, int(shift * k)));
+            m_stats.rcvUnrecoverable += (shift - RCV_GROUPS) * k;
+            if (m_fallback_level == SRT_ARQ_ONREQ)
+                AddLoss((w_irrecover), lo, hi);
+        }
+
+        rcv.base = CSeqNo::incseq(rcv.base, int(shift * k));
+        rcv.head = (rcv.head + shift) % RCV_GROUPS;
+        for (size_t i = RCV_GROUPS - ndismiss; i < RCV_GROUPS; ++i)
+            ResetRcvGroup(rcv.groups[(rcv.head + i) % RCV_GROUPS], CSeqNo::incseq(rcv.base, int(i * k)));
+
+        offset = CSeqNo::seqoff(rcv.base, seq);
+    }
+
+    w_pos = offset % k;
+    return &rcv.groups[(rcv.head + offset / k) % RCV_GROUPS];
+}
+
+bool RSFilterBuiltin::receive(const CPacket& rpkt, loss_seqs_t& loss_seqs)
+{
+    const bool is_parity = rpkt.getMsgSeq() == SRT_MSGNO_CONTROL;
+    const size_t k = m_iDataCount;
+
+    size_t pos = 0;
+    RcvGroup* g = RcvGetGroup(rpkt.getSeqNo(), (pos), (loss_seqs));
+    if (!g)
+    {
+        HLOGC(pflog.Debug, log << "RSFEC: %" << rpkt.getSeqNo() << " belongs to a dismissed group");
+        return !is_parity;
+    }
+
+    if (is_parity)
+    {
+        const size_t index = (unsigned char)rpkt.data()[0];
+        if (pos != k - 1 || index >= m_iParityCount || rpkt.size() < EXTRA_SIZE)
+        {
+            LOGC(pflog.Warn, log << "RSFEC: invalid parity packet %" << rpkt.getSeqNo() << " index=" << index);
+            return false;
+        }
+
+        ++m_stats.rcvParity;
+        if (g->done || g->have[k + index])
+            return false;
+
+        char* sym = &g->symbols[(k + index) * symbolSize()];
+        const char* payload = rpkt.data();
+        uint16_t length_clip;
+        memcpy(&length_clip, payload + 2, sizeof length_clip);
+        symbolHeader(uint8_t(payload[1]), length_clip, rpkt.getMsgTimeStamp(), sym);
+        const size_t length = min(rpkt.size() - EXTRA_SIZE, payloadSize());
+        memcpy(sym + SYMBOL_HDR_SIZE, payload + EXTRA_SIZE, length);
+        memset(sym + SYMBOL_HDR_SIZE + length, 0, payloadSize() - length);
+
+        g->have[k + index] = true;
+        ++g->nparity;
+        HLOGC(pflog.Debug, log << "RSFEC: parity " << index << " of group %" << g->base << ", have "
+                << g->collected << "/" << k << " data and " << g->nparity << " parity packets");
+    }
+    else
+    {
+        if (g->have[pos])
+        {
+            HLOGC(pflog.Debug, log << "RSFEC: packet %" << rpkt.getSeqNo() << " already known");
+            return true;
+        }
+
+        rcv.order_required = rpkt.getMsgOrderFlag();
+        g->have[pos] = true;
+        if (++g->collected == k)
+            g->done = true;
+
+        if (!g->done)
+        {
+            // Keep it for rebuilding the others.
+            char* sym = &g->symbols[pos * symbolSize()];
+            symbolHeader(uint8_t(rpkt.getMsgCryptoFlags()), htons(uint16_t(rpkt.size())), rpkt.getMsgTimeStamp(), sym);
+            const size_t length = min(rpkt.size(), payloadSize());
+            memcpy(sym + SYMBOL_HDR_SIZE, rpkt.data(), length);
+            memset(sym + SYMBOL_HDR_SIZE + length, 0, payloadSize() - length);
+        }
+    }
+
+    if (!g->done && g->nparity >= k - g->collected)
+        RcvRebuild(*g);
+
+    return !is_parity;
+}
+
+void RSFilterBuiltin::RcvRebuild(RcvGroup& g)
+{
+    const size_t k = m_iDataCount;
+    const size_t ss = symbolSize();
+
+    vector<size_t> lost, rows;
+    for (size_t j = 0; j < k; ++j)
+    {
+        if (!g.have[j])
+            lost.push_back(j);
+    }
+    const size_t n = lost.size();
+    for (size_t i = 0; i < m_iParityCount && rows.size() < n; ++i)
+    {
+        if (g.have[k + i])
+            rows.push_back(i);
+    }
+
+    // Take out the data packets that are there from the parity,
+    // leaving the sum of the lost ones only.
+    for (size_t r = 0; r < n; ++r)
+    {
+        char* s = &g.symbols[(k + rows[r]) * ss];
+        for (size_t j = 0; j < k; ++j)
+        {
+            if (g.have[j])
+                fec::xorMulInto(s, &g.symbols[j * ss], coef(rows[r], j), ss);
+        }
+    }
+
+    // Invert the matrix of the coefficients of the lost packets.
+    vector<unsigned char> a(n * n), inv(n * n, 0);
+    for (size_t r = 0; r < n; ++r)
+    {
+        for (size_t c = 0; c < n; ++c)
+            a[r * n + c] = coef(rows[r], lost[c]);
+        inv[r * n + r] = 1;
+    }
+
+    for (size_t c = 0; c < n; ++c)
+    {
+        size_t p = c;
+        while (p < n && a[p * n + c] == 0)
+            ++p;
+        if (p == n)
+        {
+            LOGC(pflog.Error, log << "RSFEC: IPE: singular matrix in group %" << g.base);
+            return;
+        }
+        if (p != c)
+        {
+            swap_ranges(a.begin() + p * n, a.begin() + (p + 1) * n, a.begin() + c * n);
+            swap_ranges(inv.begin() + p * n, inv.begin() + (p + 1) * n, inv.begin() + c * n);
+        }
+
+        const unsigned char pivinv = fec::gfInv(a[c * n + c]);
+        for (size_t x = 0; x < n; ++x)
+        {
+            a[c * n + x] = fec::gfMul(a[c * n + x], pivinv);
+            inv[c * n + x] = fec::gfMul(inv[c * n + x], pivinv);
+        }
+
+        for (size_t r = 0; r < n; ++r)
+        {
+            const unsigned char f = a[r * n + c];
+            if (r == c || f == 0)
+                continue;
+            for (size_t x = 0; x < n; ++x)
+            {
+                a[r * n + x] ^= fec::gfMul(f, a[c * n + x]);
+                inv[r * n + x] ^= fec::gfMul(f, inv[c * n + x]);
+            }
+        }
+    }
+
+    for (size_t c = 0; c < n; ++c)
+    {
+        char* d = &g.symbols[lost[c] * ss];
+        memset(d, 0, ss);
+        for (size_t r = 0; r < n; ++r)
+            fec::xorMulInto(d, &g.symbols[(k + rows[r]) * ss], inv[c * n + r], ss);
+    }
+
+    for (size_t c = 0; c < n; ++c)
+    {
+        g.have[lost[c]] = true;
+        RcvProvide(g, lost[c]);
+    }
+    g.collected = k;
+    g.done = true;
+    m_stats.rcvRecovered += n;
+}
+
+void RSFilterBuiltin::RcvProvide(const RcvGroup& g, size_t pos)
+{
+    const char* sym = &g.symbols[pos * symbolSize()];
+
+    uint16_t length_net;
+    memcpy(&length_net, sym + 2, sizeof length_net);
+    const uint16_t length_hw = ntohs(length_net);
+    if (length_hw > payloadSize())
+    {
+        LOGC(pflog.Warn, log << "RSFEC: rebuilt length '" << length_hw << "' exceeds payload size. NOT REBUILDING.");
+        return;
+    }
+
+    rcv.rebuilt.push_back(SrtPacket(length_hw));
+    SrtPacket& p = rcv.rebuilt.back();
+
+    uint32_t timestamp_hw;
+    memcpy(&timestamp_hw, sym + 4, sizeof timestamp_hw);
+
+    // Same as with the builtin FEC filter: live mode only, the message
+    // number is 1 and the REXMIT flag is set, as the packet comes out
+    // of sequence order.
+    p.hdr[SRT_PH_SEQNO] = CSeqNo::incseq(g.base, int(pos));
+    p.hdr[SRT_PH_MSGNO] = 1
+        | MSGNO_PACKET_BOUNDARY::wrap(PB_SOLO)
+        | MSGNO_PACKET_INORDER::wrap(rcv.order_required)
+        | MSGNO_ENCKEYSPEC::wrap((unsigned char)sym[0])
+        | MSGNO_REXMIT::wrap(true)
+        ;
+    p.hdr[SRT_PH_TIMESTAMP] = timestamp_hw;
+    p.hdr[SRT_PH_ID] = rcv.id;
+    memcpy(p.buffer, sym + SYMBOL_HDR_SIZE, length_hw);
+
+    HLOGC(pflog.Debug, log << "RSFEC: REBUILT: %" << p.hdr[SRT_PH_SEQNO] << " size=" << length_hw);
+}
+
+} // namespace srt
@@ -0,0 +1,133 @@
+/*
+ * SRT - Secure, Reliable, Transport
+ * Copyright (c) 2021 Haivision Systems Inc.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ */
+
+#ifndef INC_SRT_FEC_RS_H
+#define INC_SRT_FEC_RS_H
+
+#include <string>
+#include <vector>
+
+#include "packetfilter_api.h"
+
+namespace srt {
+
+/// @brief Reed-Solomon packet filter ("rsfec").
+///
+/// Data packets are taken in groups of @a k consecutive packets, and
+/// after each group the sender sends @a m parity packets, computed with
+/// a systematic Reed-Solomon code over GF(2^8). The receiver rebuilds
+/// the lost data packets of a group as soon as it has any @a k packets
+/// of the group's @a k + @a m, so up to @a m losses in a group, in any
+/// positions, are recovered.
+///
+/// The code is defined by a Cauchy matrix: parity packet i is the sum of
+/// the data packets j multiplied by 1/(x_i + y_j), with x_i = k + i and
+/// y_j = j. Every square submatrix of a Cauchy matrix is invertible, which
+/// is what makes any @a k packets of a group sufficient.
+class RSFilterBuiltin: public SrtPacketFilterBase
+{
+public:
+    struct Stats
+    {
+        uint64_t sndGroups;        //< Groups of data packets protected by the sender
+        uint64_t sndParity;        //< Parity packets sent
+        uint64_t rcvParity;        //< Parity packets received
+        uint64_t rcvRecovered;     //< Data packets rebuilt
+        uint64_t rcvUnrecoverable; //< Data packets lost and not rebuilt
+
+        Stats(): sndGroups(0), sndParity(0), rcvParity(0), rcvRecovered(0), rcvUnrecoverable(0) {}
+    };
+
+private:
+    SrtFilterConfig cfg;
+    size_t m_iDataCount;   // k
+    size_t m_iParityCount; // m
+    SRT_ARQLevel m_fallback_level;
+
+    // Cauchy matrix, m rows of k coefficients
+    std::vector<unsigned char> m_Coef;
+    unsigned char coef(size_t parity, size_t data) const { return m_Coef[parity * m_iDataCount + data]; }
+
+    // A packet, as seen by the code: the encryption flags, the length
+    // and the timestamp, followed by the payload padded with zeros.
+    static const size_t SYMBOL_HDR_SIZE = 8;
+    size_t symbolSize() const { return SYMBOL_HDR_SIZE + payloadSize(); }
+    static void symbolHeader(uint8_t kflg, uint16_t length_net, uint32_t timestamp_hw, char* w_hdr);
+
+    Stats m_stats;
+
+    struct Send
+    {
+        int32_t base;             // Sequence of the first packet in the group
+        size_t collected;         // Data packets taken in the group
+        size_t next_parity;       // Index of the next parity packet to send
+        std::vector<char> parity; // m parity symbols
+    } snd;
+
+    struct RcvGroup
+    {
+        int32_t base;
+        size_t collected;          // Data packets received or rebuilt
+        size_t nparity;            // Parity packets received
+        bool done;                 // All data packets are there
+        std::vector<bool> have;    // k data packets, then m parity packets
+        std::vector<char> symbols; // k data symbols, then m parity symbols
+    };
+
+    // The groups that can still receive packets. A group remains there
+    // until a packet of the second next group arrives, to let its parity
+    // packets come after some data packets of the next group.
+    static const size_t RCV_GROUPS = 2;
+
+    struct Receive
+    {
+        SRTSOCKET id;
+        bool order_required;
+        int32_t base;                 // Base sequence of the oldest group
+        size_t head;                  // Index of the oldest group in groups
+        std::vector<RcvGroup> groups; // Ring of RCV_GROUPS groups
+        std::vector<char> scratch;
+        std::vector<SrtPacket>& rebuilt;
+
+        Receive(std::vector<SrtPacket>& provided): id(SRT_INVALID_SOCK), order_required(false), base(0), head(0), rebuilt(provided) {}
+    } rcv;
+
+    void ResetSndGroup(int32_t base);
+    void ResetRcvGroup(RcvGroup& g, int32_t base);
+    RcvGroup* RcvGetGroup(int32_t seq, size_t& w_pos, loss_seqs_t& w_irrecover);
+    void RcvDismissGroup(RcvGroup& g, loss_seqs_t& w_irrecover);
+    void RcvRebuild(RcvGroup& g);
+    void RcvProvide(const RcvGroup& g, size_t pos);
+
+public:
+
+    RSFilterBuiltin(const SrtFilterInitializer& init, std::vector<SrtPacket>& provided, const std::string& confstr);
+    ~RSFilterBuiltin();
+
+    virtual bool packControlPacket(SrtPacket& r_packet, int32_t seq) ATR_OVERRIDE;
+    virtual void feedSource(CPacket& r_packet) ATR_OVERRIDE;
+    virtual bool receive(const CPacket& pkt, loss_seqs_t& loss_seqs) ATR_OVERRIDE;
+    virtual SRT_ARQLevel arqLevel() ATR_OVERRIDE { return m_fallback_level; }
+
+    const Stats& stats() const { return m_stats; }
+
+    // The parity packet carries in the payload the index of the parity,
+    // the parity of the flags and of the length (the same as the builtin
+    // FEC filter) and the parity of the payloads. The parity of the
+    // timestamps is placed in the timestamp field of the header.
+    static const size_t EXTRA_SIZE = 4;
+
+    static const char defaultConfig [];
+    static bool verifyConfig(const SrtFilterConfig& config, std::string& w_errormsg);
+};
+
+} // namespace srt
+
+#endif
@@ -0,0 +1,342 @@
+/*
+ * SRT - Secure, Reliable, Transport
+ * Copyright (c) 2021 Haivision Systems Inc.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ */
+
+#include "platform_sys.h"
+
+#include "fec_xor.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SRT_FEC_XOR_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SRT_FEC_XOR_TARGET(name)
+#elif defined(__GNUC__) && (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+// The kernels are compiled for their instruction set regardless of
+// the -m flags of the build and only called when the CPU has it.
+#define SRT_FEC_XOR_TARGET(name) __attribute__((target(name)))
+#else
+#undef SRT_FEC_XOR_X86
+#endif
+#endif
+
+#if defined(SRT_FEC_XOR_X86)
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <immintrin.h>
+#endif
+
+// There's no portable way to detect NEON at runtime on 32-bit ARM, so it
+// is only used when the compiler may use it anyway.
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+#define SRT_FEC_XOR_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace srt
+{
+namespace fec
+{
+
+static void xorScalar(char* dst, const char* src, size_t len)
+{
+    for (size_t i = 0; i < len; ++i)
+        dst[i] ^= src[i];
+}
+
+// GF(2^8) arithmetic. A product c*b is also split by the nibbles of b,
+// c*b = c*(b & 0xF) ^ c*(b & 0xF0), so that the kernels need only two
+// 16-byte tables per constant, which fit in a vector register.
+struct GfTables
+{
+    unsigned char exp[512];
+    unsigned char log[256];
+    unsigned char lo[256][16]; // lo[c][x] = c * x
+    unsigned char hi[256][16]; // hi[c][x] = c * (x << 4)
+
+    GfTables()
+    {
+        unsigned x = 1;
+        for (int i = 0; i < 255; ++i)
+        {
+            exp[i] = (unsigned char)x;
+            exp[i + 255] = (unsigned char)x;
+            log[x] = (unsigned char)i;
+            x <<= 1;
+            if (x & 0x100)
+                x ^= 0x11D;
+        }
+        exp[510] = exp[0];
+        exp[511] = exp[1];
+        log[0] = 0; // Unused
+
+        for (int c = 0; c < 256; ++c)
+        {
+            for (int n = 0; n < 16; ++n)
+            {
+                lo[c][n] = mul((unsigned char)c, (unsigned char)n);
+                hi[c][n] = mul((unsigned char)c, (unsigned char)(n << 4));
+            }
+        }
+    }
+
+    unsigned char mul(unsigned char a, unsigned char b) const
+    {
+        if (a == 0 || b == 0)
+            return 0;
+        return exp[log[a] + log[b]];
+    }
+};
+
+static const GfTables s_Gf;
+
+unsigned char gfMul(unsigned char a, unsigned char b)
+{
+    return s_Gf.mul(a, b);
+}
+
+unsigned char gfInv(unsigned char a)
+{
+    return s_Gf.exp[255 - s_Gf.log[a]];
+}
+
+static void xorMulScalar(char* dst, const char* src, unsigned char c, size_t len)
+{
+    const unsigned char* lo = s_Gf.lo[c];
+    const unsigned char* hi = s_Gf.hi[c];
+    for (size_t i = 0; i < len; ++i)
+    {
+        const unsigned char b = (unsigned char)src[i];
+        dst[i] ^= char(lo[b & 0xF] ^ hi[b >> 4]);
+    }
+}
+
+#if defined(SRT_FEC_XOR_X86)
+
+SRT_FEC_XOR_TARGET("sse2")
+static void xorSSE2(char* dst, const char* src, size_t len)
+{
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+        const __m128i a = _mm_loadu_si128((const __m128i*)(dst + i));
+        const __m128i b = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(a, b));
+    }
+    xorScalar(dst + i, src + i, len - i);
+}
+
+SRT_FEC_XOR_TARGET("avx2")
+static void xorAVX2(char* dst, const char* src, size_t len)
+{
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64)
+    {
+        const __m256i a0 = _mm256_loadu_si256((const __m256i*)(dst + i));
+        const __m256i a1 = _mm256_loadu_si256((const __m256i*)(dst + i + 32));
+        const __m256i b0 = _mm256_loadu_si256((const __m256i*)(src + i));
+        const __m256i b1 = _mm256_loadu_si256((const __m256i*)(src + i + 32));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_xor_si256(a0, b0));
+        _mm256_storeu_si256((__m256i*)(dst + i + 32), _mm256_xor_si256(a1, b1));
+    }
+    for (; i + 16 <= len; i += 16)
+    {
+        const __m128i a = _mm_loadu_si128((const __m128i*)(dst + i));
+        const __m128i b = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(a, b));
+    }
+    xorScalar(dst + i, src + i, len - i);
+}
+
+SRT_FEC_XOR_TARGET("ssse3")
+static void xorMulSSSE3(char* dst, const char* src, unsigned char c, size_t len)
+{
+    const __m128i lo   = _mm_loadu_si128((const __m128i*)s_Gf.lo[c]);
+    const __m128i hi   = _mm_loadu_si128((const __m128i*)s_Gf.hi[c]);
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+        const __m128i b = _mm_loadu_si128((const __m128i*)(src + i));
+        const __m128i p = _mm_xor_si128(_mm_shuffle_epi8(lo, _mm_and_si128(b, mask)),
+                                        _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi64(b, 4), mask)));
+        const __m128i a = _mm_loadu_si128((const __m128i*)(dst + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(a, p));
+    }
+    xorMulScalar(dst + i, src + i, c, len - i);
+}
+
+SRT_FEC_XOR_TARGET("avx2")
+static void xorMulAVX2(char* dst, const char* src, unsigned char c, size_t len)
+{
+    const __m256i lo   = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)s_Gf.lo[c]));
+    const __m256i hi   = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)s_Gf.hi[c]));
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32)
+    {
+        const __m256i b = _mm256_loadu_si256((const __m256i*)(src + i));
+        const __m256i p = _mm256_xor_si256(_mm256_shuffle_epi8(lo, _mm256_and_si256(b, mask)),
+                                           _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi64(b, 4), mask)));
+        const __m256i a = _mm256_loadu_si256((const __m256i*)(dst + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_xor_si256(a, p));
+    }
+    xorMulScalar(dst + i, src + i, c, len - i);
+}
+
+static void cpuFeatures(bool& w_sse2, bool& w_ssse3, bool& w_avx2)
+{
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0);
+    const int maxleaf = regs[0];
+    __cpuid(regs, 1);
+    w_sse2 = (regs[3] & (1 << 26)) != 0;
+    w_ssse3 = (regs[2] & (1 << 9)) != 0;
+    // AVX2 needs also the OS to save the YMM registers.
+    const bool ymm = (regs[2] & (1 << 27)) && (regs[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+    w_avx2 = false;
+    if (ymm && maxleaf >= 7)
+    {
+        __cpuidex(regs, 7, 0);
+        w_avx2 = (regs[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    w_sse2 = __builtin_cpu_supports("sse2");
+    w_ssse3 = __builtin_cpu_supports("ssse3");
+    w_avx2 = __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // SRT_FEC_XOR_X86
+
+#if defined(SRT_FEC_XOR_NEON)
+
+static void xorNEON(char* dst, const char* src, size_t len)
+{
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32)
+    {
+        const uint8x16_t a0 = vld1q_u8((const uint8_t*)(dst + i));
+        const uint8x16_t a1 = vld1q_u8((const uint8_t*)(dst + i + 16));
+        const uint8x16_t b0 = vld1q_u8((const uint8_t*)(src + i));
+        const uint8x16_t b1 = vld1q_u8((const uint8_t*)(src + i + 16));
+        vst1q_u8((uint8_t*)(dst + i), veorq_u8(a0, b0));
+        vst1q_u8((uint8_t*)(dst + i + 16), veorq_u8(a1, b1));
+    }
+    for (; i + 16 <= len; i += 16)
+    {
+        const uint8x16_t a = vld1q_u8((const uint8_t*)(dst + i));
+        const uint8x16_t b = vld1q_u8((const uint8_t*)(src + i));
+        vst1q_u8((uint8_t*)(dst + i), veorq_u8(a, b));
+    }
+    xorScalar(dst + i, src + i, len - i);
+}
+
+// The table lookup of 16 lanes is available only in AArch64.
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define SRT_FEC_XOR_NEON_TBL 1
+
+static void xorMulNEON(char* dst, const char* src, unsigned char c, size_t len)
+{
+    const uint8x16_t lo   = vld1q_u8(s_Gf.lo[c]);
+    const uint8x16_t hi   = vld1q_u8(s_Gf.hi[c]);
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+        const uint8x16_t b = vld1q_u8((const uint8_t*)(src + i));
+        const uint8x16_t p = veorq_u8(vqtbl1q_u8(lo, vandq_u8(b, mask)), vqtbl1q_u8(hi, vshrq_n_u8(b, 4)));
+        const uint8x16_t a = vld1q_u8((const uint8_t*)(dst + i));
+        vst1q_u8((uint8_t*)(dst + i), veorq_u8(a, p));
+    }
+    xorMulScalar(dst + i, src + i, c, len - i);
+}
+#endif
+
+#endif // SRT_FEC_XOR_NEON
+
+static const size_t MAX_KERNELS = 3;
+
+struct XorKernels
+{
+    XorKernel    kernels[MAX_KERNELS];
+    size_t       count;
+    XorMulKernel mulKernels[MAX_KERNELS];
+    size_t       mulCount;
+
+    XorKernels()
+        : count(0)
+        , mulCount(0)
+    {
+        add("scalar", &xorScalar);
+        addMul("table", &xorMulScalar);
+#if defined(SRT_FEC_XOR_X86)
+        bool sse2 = false, ssse3 = false, avx2 = false;
+        cpuFeatures((sse2), (ssse3), (avx2));
+        if (sse2)
+            add("sse2", &xorSSE2);
+        if (ssse3)
+            addMul("ssse3", &xorMulSSSE3);
+        if (avx2)
+        {
+            add("avx2", &xorAVX2);
+            addMul("avx2", &xorMulAVX2);
+        }
+#endif
+#if defined(SRT_FEC_XOR_NEON)
+        add("neon", &xorNEON);
+#endif
+#if defined(SRT_FEC_XOR_NEON_TBL)
+        addMul("neon", &xorMulNEON);
+#endif
+    }
+
+    void add(const char* name, xor_fn* fn)
+    {
+        kernels[count].name = name;
+        kernels[count].fn   = fn;
+        ++count;
+    }
+
+    void addMul(const char* name, xor_mul_fn* fn)
+    {
+        mulKernels[mulCount].name = name;
+        mulKernels[mulCount].fn   = fn;
+        ++mulCount;
+    }
+};
+
+static const XorKernels s_Kernels;
+
+const XorKernel* xorKernels(size_t& w_count)
+{
+    w_count = s_Kernels.count;
+    return s_Kernels.kernels;
+}
+
+const XorKernel& xorBest()
+{
+    return s_Kernels.kernels[s_Kernels.count - 1];
+}
+
+const XorMulKernel* xorMulKernels(size_t& w_count)
+{
+    w_count = s_Kernels.mulCount;
+    return s_Kernels.mulKernels;
+}
+
+const XorMulKernel& xorMulBest()
+{
+    return s_Kernels.mulKernels[s_Kernels.mulCount - 1];
+}
+
+} // namespace fec
+} // namespace srt
@@ -0,0 +1,84 @@
+/*
+ * SRT - Secure, Reliable, Transport
+ * Copyright (c) 2021 Haivision Systems Inc.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ */
+
+#ifndef INC_SRT_FEC_XOR_H
+#define INC_SRT_FEC_XOR_H
+
+#include <cstddef>
+
+namespace srt
+{
+namespace fec
+{
+
+/// XOR @a len bytes of @a src into @a dst. The buffers need not be
+/// aligned, but must not overlap.
+typedef void xor_fn(char* dst, const char* src, size_t len);
+
+struct XorKernel
+{
+    const char* name;
+    xor_fn*     fn;
+};
+
+/// Kernels that can run on this CPU, from the slowest to the fastest.
+/// The first one is the portable scalar kernel.
+/// @param [out] w_count number of kernels
+const XorKernel* xorKernels(size_t& w_count);
+
+/// The fastest kernel that can run on this CPU, selected once when
+/// the library is loaded.
+const XorKernel& xorBest();
+
+/// XOR @a src into @a dst with the fastest kernel.
+inline void xorInto(char* dst, const char* src, size_t len)
+{
+    xorBest().fn(dst, src, len);
+}
+
+/// Multiplication in GF(2^8) with the polynomial 0x11D.
+unsigned char gfMul(unsigned char a, unsigned char b);
+
+/// Multiplicative inverse in GF(2^8). @a a must not be 0.
+unsigned char gfInv(unsigned char a);
+
+/// XOR @a len bytes of @a src, each multiplied by @a c in GF(2^8),
+/// into @a dst. The buffers must not overlap.
+typedef void xor_mul_fn(char* dst, const char* src, unsigned char c, size_t len);
+
+struct XorMulKernel
+{
+    const char* name;
+    xor_mul_fn* fn;
+};
+
+/// Multiplying kernels that can run on this CPU, from the slowest to
+/// the fastest. The first one is the portable table-driven kernel.
+/// @param [out] w_count number of kernels
+const XorMulKernel* xorMulKernels(size_t& w_count);
+
+/// The fastest multiplying kernel that can run on this CPU.
+const XorMulKernel& xorMulBest();
+
+/// XOR @a src multiplied by @a c into @a dst with the fastest kernel.
+inline void xorMulInto(char* dst, const char* src, unsigned char c, size_t len)
+{
+    if (c == 0)
+        return;
+    if (c == 1)
+        xorInto(dst, src, len);
+    else
+        xorMulBest().fn(dst, src, c, len);
+}
+
+} // namespace fec
+} // namespace srt
+
+#endif
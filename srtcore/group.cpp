@@ -272,15 +272,24 @@ CUDTGroup::CUDTGroup(SRT_GROUP_TYPE gtype)
     , m_tsStartTime()
     , m_tsRcvPeerStartTime()
     , m_RcvBaseSeqNo(SRT_SEQNO_NONE)
+    , m_RcvBaseMsgNo(SRT_MSGNO_NONE)
     , m_bOpened(false)
     , m_bConnected(false)
     , m_bClosing(false)
+    , m_pRcvBuffer(NULL)
+    , m_pRcvUnitQueue(NULL)
+    , m_iRcvUnitSize(0)
+    , m_bRcvTLPktDrop(true)
+    , m_bTsbPdNeedsWakeup(false)
+    , m_iTsbPdWaitSeqNo(SRT_SEQNO_NONE)
     , m_iLastSchedSeqNo(SRT_SEQNO_NONE)
     , m_iLastSchedMsgNo(SRT_MSGNO_NONE)
 {
     setupMutex(m_GroupLock, "Group");
     setupMutex(m_RcvDataLock, "G/RcvData");
     setupCond(m_RcvDataCond, "G/RcvData");
+    setupMutex(m_RcvBufferLock, "G/RcvBuffer");
+    setupCond(m_RcvTsbPdCond, "G/RcvTsbPd");
     m_RcvEID = m_Global.m_EPoll.create(&m_RcvEpolld);
     m_SndEID = m_Global.m_EPoll.create(&m_SndEpolld);
 
@@ -293,11 +302,23 @@ CUDTGroup::CUDTGroup(SRT_GROUP_TYPE gtype)
 
 CUDTGroup::~CUDTGroup()
 {
+    // Normally the TSBPD thread is joined on close().
+    m_bClosing = true;
+    if (m_RcvTsbPdThread.joinable())
+    {
+        CSync::lock_notify_all(m_RcvTsbPdCond, m_RcvDataLock);
+        m_RcvTsbPdThread.join();
+    }
+    delete m_pRcvBuffer;
+    delete m_pRcvUnitQueue;
+
     srt_epoll_release(m_RcvEID);
     srt_epoll_release(m_SndEID);
     releaseMutex(m_GroupLock);
     releaseMutex(m_RcvDataLock);
     releaseCond(m_RcvDataCond);
+    releaseMutex(m_RcvBufferLock);
+    releaseCond(m_RcvTsbPdCond);
 }
 
 void CUDTGroup::GroupContainer::erase(CUDTGroup::gli_t it)
@@ -576,6 +597,13 @@ void CUDTGroup::deriveSettings(CUDT* u)
 
     IM(SRTO_UDP_SNDBUF, iUDPSndBufSize);
     IM(SRTO_UDP_RCVBUF, iUDPRcvBufSize);
+    IM(SRTO_UDP_SNDBATCH, iUDPSndBatch);
+    IM(SRTO_UDP_RCVBATCH, iUDPRcvBatch);
+    IM(SRTO_UDP_GSO, bUDPGSO);
+    IM(SRTO_UDP_GRO, bUDPGRO);
+    IM(SRTO_SNDWORKERS, iSndWorkers);
+    IM(SRTO_CRYPTOWORKERS, iCryptoWorkers);
+    IM(SRTO_LISTENSHARDS, iListenShards);
     // SRTO_RENDEZVOUS: impossible to have it set on a listener socket.
     // SRTO_SNDTIMEO/RCVTIMEO: groupwise setting
 
@@ -592,6 +620,7 @@ void CUDTGroup::deriveSettings(CUDT* u)
     IM(SRTO_IPTOS, iIpToS);
     IM(SRTO_IPTTL, iIpTTL);
     IM(SRTO_TSBPDMODE, bTSBPD);
+    IM(SRTO_TSBPDSHARED, bTSBPDShared);
     IM(SRTO_RCVLATENCY, iRcvLatency);
     IM(SRTO_PEERLATENCY, iPeerLatency);
     IM(SRTO_SNDDROPDELAY, iSndDropDelay);
@@ -623,6 +652,7 @@ void CUDTGroup::deriveSettings(CUDT* u)
 
     IM(SRTO_KMREFRESHRATE, uKmRefreshRatePkt);
     IM(SRTO_KMPREANNOUNCE, uKmPreAnnouncePkt);
+    IM(SRTO_CRYPTOPRECOMP, iCryptoPrecomp);
 
     const string cc = u->m_CongCtl.selected_name();
     if (cc != "live")
@@ -720,6 +750,19 @@ static bool getOptDefault(SRT_SOCKOPT optname, void* pw_optval, int& w_optlen)
     case SRTO_UDP_SNDBUF:
     case SRTO_UDP_RCVBUF:
         RD(CSrtConfig::DEF_UDP_BUFFER_SIZE);
+    case SRTO_UDP_SNDBATCH:
+        RD(CSrtConfig::DEF_UDP_SNDBATCH);
+    case SRTO_UDP_RCVBATCH:
+        RD(CSrtConfig::DEF_UDP_RCVBATCH);
+    case SRTO_UDP_GSO:
+    case SRTO_UDP_GRO:
+        RD(false);
+    case SRTO_SNDWORKERS:
+        RD(CSrtConfig::DEF_SNDWORKERS);
+    case SRTO_CRYPTOWORKERS:
+        RD(CSrtConfig::DEF_CRYPTOWORKERS);
+    case SRTO_LISTENSHARDS:
+        RD(CSrtConfig::DEF_LISTENSHARDS);
     case SRTO_RENDEZVOUS:
         RD(false);
     case SRTO_SNDTIMEO:
@@ -754,6 +797,8 @@ static bool getOptDefault(SRT_SOCKOPT optname, void* pw_optval, int& w_optlen)
         RD(false);
     case SRTO_TSBPDMODE:
         RD(false);
+    case SRTO_TSBPDSHARED:
+        RD(false);
     case SRTO_LATENCY:
     case SRTO_RCVLATENCY:
         RD(SRT_LIVE_DEF_LATENCY_MS);
@@ -792,6 +837,8 @@ static bool getOptDefault(SRT_SOCKOPT optname, void* pw_optval, int& w_optlen)
         RD(0);
     case SRTO_RETRANSMITALGO:
         RD(1);
+    case SRTO_CRYPTOPRECOMP:
+        RD(CSrtConfig::DEF_CRYPTOPRECOMP);
     }
 
 #undef RD
@@ -1143,11 +1190,12 @@ void CUDTGroup::close()
         // The external part will be done in Global (CUDTUnited)
     }
 
-    // Release blocked clients
-    // XXX This looks like a dead code. Group receiver functions
-    // do not use any lock on m_RcvDataLock, it is likely a remainder
-    // of the old, internal impementation. 
-    // CSync::lock_notify_one(m_RcvDataCond, m_RcvDataLock);
+    // Release blocked clients reading from the group buffer
+    // and stop its TSBPD thread.
+    CSync::lock_notify_all(m_RcvDataCond, m_RcvDataLock);
+    CSync::lock_notify_all(m_RcvTsbPdCond, m_RcvDataLock);
+    if (m_RcvTsbPdThread.joinable())
+        m_RcvTsbPdThread.join();
 }
 
 // [[using locked(m_Global->m_GlobControlLock)]]
@@ -1190,17 +1238,39 @@ int CUDTGroup::send(const char* buf, int len, SRT_MSGCTRL& w_mc)
     case SRT_GTYPE_BACKUP:
         return sendBackup(buf, len, (w_mc));
 
-        /* to be implemented
-
     case SRT_GTYPE_BALANCING:
         return sendBalancing(buf, len, (w_mc));
 
+        /* to be implemented
+
     case SRT_GTYPE_MULTICAST:
         return sendMulticast(buf, len, (w_mc));
         */
     }
 }
 
+int CUDTGroup::sendBroadcast_Member(CUDT& core, SharedPayload* payload, SRT_MSGCTRL& w_mc)
+{
+    // The reference-passing call is only allowed with the message API.
+    if (!core.m_config.bMessageAPI)
+        return core.sendmsg2(payload->data(), payload->size, (w_mc));
+
+    // The reference is taken over by the member's sender buffer, which
+    // releases it after the message is acknowledged or dropped. It is also
+    // released immediately if the member must copy the data anyway (when
+    // encrypting), but not when the call fails.
+    payload->acquire();
+    try
+    {
+        return core.sendmsg2(payload->data(), payload->size, (w_mc), &SharedPayload::release, payload);
+    }
+    catch (...)
+    {
+        SharedPayload::release(payload);
+        throw;
+    }
+}
+
 int CUDTGroup::sendBroadcast(const char* buf, int len, SRT_MSGCTRL& w_mc)
 {
     // Avoid stupid errors in the beginning.
@@ -1335,6 +1405,15 @@ int CUDTGroup::sendBroadcast(const char* buf, int len, SRT_MSGCTRL& w_mc)
     if (w_mc.srctime == 0)
         w_mc.srctime = count_microseconds(steady_clock::now().time_since_epoch());
 
+    // The payload is copied once and the member sender buffers refer to this
+    // copy. The reference taken here is kept until this function exits.
+    SharedPayload* const payload = SharedPayload::create(buf, len);
+    struct PayloadGuard
+    {
+        SharedPayload* p;
+        ~PayloadGuard() { SharedPayload::release(p); }
+    } payload_guard = {payload};
+
     for (vector<gli_t>::iterator snd = activeLinks.begin(); snd != activeLinks.end(); ++snd)
     {
         gli_t d   = *snd;
@@ -1346,7 +1425,7 @@ int CUDTGroup::sendBroadcast(const char* buf, int len, SRT_MSGCTRL& w_mc)
             // Possible return values are only 0, in case when len was passed 0, or a positive
             // >0 value that defines the size of the data that it has sent, that is, in case
             // of Live mode, equal to 'len'.
-            stat = d->ps->core().sendmsg2(buf, len, (w_mc));
+            stat = sendBroadcast_Member(d->ps->core(), payload, (w_mc));
         }
         catch (CUDTException& e)
         {
@@ -1434,7 +1513,7 @@ int CUDTGroup::sendBroadcast(const char* buf, int len, SRT_MSGCTRL& w_mc)
 
         try
         {
-            stat = d->ps->core().sendmsg2(buf, len, (w_mc));
+            stat = sendBroadcast_Member(d->ps->core(), payload, (w_mc));
         }
         catch (CUDTException& e)
         {
@@ -1791,7 +1870,7 @@ int CUDTGroup::sendBroadcast(const char* buf, int len, SRT_MSGCTRL& w_mc)
                     // Possible return values are only 0, in case when len was passed 0, or a positive
                     // >0 value that defines the size of the data that it has sent, that is, in case
                     // of Live mode, equal to 'len'.
-                    stat = d->ps->core().sendmsg2(buf, len, (w_mc));
+                    stat = sendBroadcast_Member(d->ps->core(), payload, (w_mc));
                 }
                 catch (CUDTException& e)
                 {
@@ -1921,6 +2000,291 @@ int CUDTGroup::sendBroadcast(const char* buf, int len, SRT_MSGCTRL& w_mc)
     return rstat;
 }
 
+// Capacity of the member link in packets per second, as measured by the
+// peer with packet pairs. Zero is returned until the first measurement.
+static int64_t balancingCapacity(const CUDT& u)
+{
+    const int bw = u.bandwidth();
+    return bw > 1 ? bw : 0; // 1 is the initial value
+}
+
+// Whether the link has more packets in flight than it can carry until
+// the next ACK reports them, that is, whether it is already queueing.
+static bool balancingCongested(const CUDT& u, int64_t capacity)
+{
+    if (capacity == 0)
+        return false;
+
+    const int64_t window_us = u.SRTT() + 4 * int64_t(u.RTTVar()) + int64_t(CUDT::COMM_SYN_INTERVAL_US);
+    return u.getFlightSpan() > capacity * window_us / 1000000;
+}
+
+int CUDTGroup::sendBalancing(const char* buf, int len, SRT_MSGCTRL& w_mc)
+{
+    // Avoid stupid errors in the beginning.
+    if (len <= 0)
+    {
+        throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+    }
+
+    vector<SRTSOCKET> wipeme;
+
+    // First, acquire GlobControlLock to make sure all member sockets still exist
+    enterCS(m_Global.m_GlobControlLock);
+    ScopedLock guard(m_GroupLock);
+
+    if (m_bClosing)
+    {
+        leaveCS(m_Global.m_GlobControlLock);
+        throw CUDTException(MJ_CONNECTION, MN_CONNLOST, 0);
+    }
+
+    // LOCKED: GlobControlLock, GroupLock (RIGHT ORDER!)
+    send_CheckValidSockets();
+    leaveCS(m_Global.m_GlobControlLock);
+    // LOCKED: GroupLock (only)
+
+    if (m_bClosing)
+        throw CUDTException(MJ_CONNECTION, MN_CONNLOST, 0);
+
+    if (w_mc.srctime == 0)
+        w_mc.srctime = count_microseconds(steady_clock::now().time_since_epoch());
+
+    // Every message is sent over one member only, so the sequence numbers
+    // of the members are independent of each other. The message number,
+    // assigned here for the whole group, is what the receiver uses to
+    // restore the order.
+    int32_t msgno = 1;
+    if (m_iLastSchedMsgNo != SRT_MSGNO_NONE)
+        msgno = ++MsgNo(m_iLastSchedMsgNo.load());
+
+    SRT_MSGCTRL mc     = w_mc;
+    int         rstat  = -1;
+    bool        sent   = false;
+
+    while (!sent)
+    {
+        vector<gli_t>     candidates;
+        vector<SRTSOCKET> pendingSockets;
+
+        // The broken members stay in the container until they are closed,
+        // so the list is collected from scratch in every round.
+        wipeme.clear();
+
+        for (gli_t d = m_Group.begin(); d != m_Group.end(); ++d)
+        {
+            if (d->sndstate != SRT_GST_BROKEN && (!d->ps || d->ps->core().m_bBroken))
+            {
+                HLOGC(gslog.Debug,
+                      log << "grp/sendBalancing: socket @" << d->id << " detected +Broken - transit to BROKEN");
+                d->sndstate = SRT_GST_BROKEN;
+                d->rcvstate = SRT_GST_BROKEN;
+            }
+
+            if (d->sndstate == SRT_GST_BROKEN)
+            {
+                wipeme.push_back(d->id);
+                continue;
+            }
+
+            if (d->sndstate == SRT_GST_IDLE)
+            {
+                const SRT_SOCKSTATUS st = d->ps->getStatus();
+                if (int(st) >= int(SRTS_BROKEN))
+                {
+                    HLOGC(gslog.Debug,
+                          log << "grp/sendBalancing: @" << d->id << " became " << SockStatusStr(st)
+                              << ", WILL BE CLOSED.");
+                    wipeme.push_back(d->id);
+                    continue;
+                }
+
+                if (st != SRTS_CONNECTED)
+                {
+                    pendingSockets.push_back(d->id);
+                    continue;
+                }
+
+                // There's no sequence to synchronize between the members
+                // of a balancing group, so an idle link is used right away.
+                HLOGC(gslog.Debug, log << "grp/sendBalancing: socket @" << d->id << " IDLE -> RUNNING");
+                d->sndstate  = SRT_GST_RUNNING;
+                d->sndCredit = 0;
+            }
+
+            if (d->sndstate == SRT_GST_RUNNING)
+                candidates.push_back(d);
+            else
+                pendingSockets.push_back(d->id);
+        }
+
+        // Weigh the links by their capacity. The links that are congested
+        // are only tried when no other link took the message.
+        const size_t     ncand = candidates.size();
+        SendBalancingCtx balancing;
+        for (size_t i = 0; i < ncand; ++i)
+        {
+            CUDT&         u        = candidates[i]->ps->core();
+            const int64_t capacity = balancingCapacity(u);
+            balancing.addMember(&*candidates[i], capacity, balancingCongested(u, capacity));
+        }
+        balancing.weigh();
+
+        vector<SocketData*> blocked;
+        for (size_t n = 0; n < ncand && !sent; ++n)
+        {
+            const size_t best = balancing.next();
+            gli_t d   = candidates[best];
+            int   erc = 0;
+            int   stat = -1;
+
+            mc        = w_mc;
+            mc.msgno  = msgno;
+            mc.pktseq = SRT_SEQNO_NONE; // not a group sequence
+            try
+            {
+                stat = d->ps->core().sendmsg2(buf, len, (mc));
+            }
+            catch (CUDTException& e)
+            {
+                erc = e.getErrorCode();
+            }
+
+            d->sndresult  = stat;
+            d->laststatus = d->ps->getStatus();
+
+            if (stat != -1)
+            {
+                HLOGC(gslog.Debug,
+                      log << "grp/sendBalancing: #" << msgno << " sent over @" << d->id << " (weight "
+                          << balancing.weight(best) << "/" << balancing.totalWeight()
+                          << (balancing.congested(best) ? ", congested" : "") << ")");
+                balancing.charge(best);
+                ++d->pktSndShareTotal;
+                rstat = stat;
+                sent  = true;
+                break;
+            }
+
+            if (erc == SRT_EASYNCSND)
+            {
+                blocked.push_back(&*d);
+                continue;
+            }
+
+            HLOGC(gslog.Debug,
+                  log << "grp/sendBalancing: sending over @" << d->id << " FAILED (" << erc
+                      << "). Setting this socket broken status.");
+            d->sndstate = SRT_GST_BROKEN;
+            wipeme.push_back(d->id);
+        }
+
+        if (sent)
+            break;
+
+        // None of the links took the message.
+        m_Global.m_EPoll.update_events(id(), m_sPollID, SRT_EPOLL_OUT, false);
+
+        const bool can_wait = !blocked.empty() || !pendingSockets.empty();
+        if (can_wait && !m_bSynSending)
+        {
+            send_CloseBrokenSockets((wipeme));
+            HLOGC(gslog.Debug, log << "grp/sendBalancing: no links are ready for sending");
+            throw CUDTException(MJ_AGAIN, MN_WRAVAIL, 0);
+        }
+
+        const int modes = SRT_EPOLL_OUT | SRT_EPOLL_ERR;
+        for (vector<SocketData*>::iterator b = blocked.begin(); b != blocked.end(); ++b)
+        {
+            CUDT::uglobal().epoll_add_usock_INTERNAL(m_SndEID, (*b)->ps, &modes);
+        }
+
+        if (!can_wait || m_Global.m_EPoll.empty(*m_SndEpolld))
+        {
+            send_CloseBrokenSockets((wipeme));
+            HLOGC(gslog.Debug, log << "grp/sendBalancing: all links broken (none succeeded to send a payload)");
+            m_Global.m_EPoll.update_events(id(), m_sPollID, SRT_EPOLL_ERR, true);
+            throw CUDTException(MJ_CONNECTION, MN_CONNLOST, 0);
+        }
+
+        HLOGC(gslog.Debug,
+              log << "grp/sendBalancing: " << blocked.size() << " blocked, " << pendingSockets.size()
+                  << " pending, waiting for any writable");
+
+        CEPoll::fmap_t sready;
+        {
+            // Lift the group lock for a while, to avoid possible deadlocks.
+            InvertedLock ug(m_GroupLock);
+
+            // m_iSndTimeOut is -1 by default, which matches the meaning of waiting forever.
+            // XTIMEOUT is propagated as this is what should be reported to API.
+            THREAD_PAUSED();
+            m_Global.m_EPoll.swait(*m_SndEpolld, sready, m_iSndTimeOut);
+            THREAD_RESUMED();
+        }
+
+        // Re-check after the waiting lock has been reacquired
+        if (m_bClosing)
+            throw CUDTException(MJ_CONNECTION, MN_CONNLOST, 0);
+
+        HLOGC(gslog.Debug, log << "grp/sendBalancing: RDY: " << DisplayEpollResults(sready));
+
+        // The container may have changed while the lock was lifted.
+        for (gli_t dd = m_Group.begin(); dd != m_Group.end(); ++dd)
+        {
+            if (CEPoll::ready(sready, dd->id) & SRT_EPOLL_ERR)
+                dd->sndstate = SRT_GST_BROKEN;
+        }
+
+        // Remove the sockets reported writable; the blocked ones
+        // will be added again if they block again.
+        m_Global.m_EPoll.clear_ready_usocks(*m_SndEpolld, SRT_EPOLL_CONNECT);
+    }
+
+    w_mc.msgno  = msgno;
+    w_mc.pktseq = mc.pktseq;
+    m_iLastSchedMsgNo = msgno;
+
+    // Update sending stats.
+    m_stats.sent.count(len);
+
+    send_CloseBrokenSockets((wipeme)); // wipeme will be cleared by this function
+
+    // Re-check after the waiting lock has been reacquired
+    if (m_bClosing)
+        throw CUDTException(MJ_CONNECTION, MN_CONNLOST, 0);
+
+    // Fill in the socket table and update the write readiness as with broadcast.
+    size_t grpsize = m_Group.size();
+
+    if (w_mc.grpdata_size < grpsize)
+    {
+        w_mc.grpdata = NULL;
+    }
+
+    size_t i = 0;
+
+    bool ready_again = false;
+    for (gli_t d = m_Group.begin(); d != m_Group.end(); ++d, ++i)
+    {
+        if (w_mc.grpdata)
+        {
+            // Enough space to fill
+            copyGroupData(*d, (w_mc.grpdata[i]));
+        }
+
+        ready_again = ready_again || d->ps->writeReady();
+    }
+    w_mc.grpdata_size = i;
+
+    if (!ready_again)
+    {
+        m_Global.m_EPoll.update_events(id(), m_sPollID, SRT_EPOLL_OUT, false);
+    }
+
+    return rstat;
+}
+
 int CUDTGroup::getGroupData(SRT_SOCKGROUPDATA* pdata, size_t* psize)
 {
     if (!psize)
@@ -2287,11 +2651,13 @@ void CUDTGroup::updateReadState(SRTSOCKET /* not sure if needed */, int32_t sequ
     ScopedLock lg(m_GroupLock);
     int        seqdiff = 0;
 
-    if (m_RcvBaseSeqNo == SRT_SEQNO_NONE)
+    if (m_RcvBaseSeqNo == SRT_SEQNO_NONE || m_type == SRT_GTYPE_BALANCING)
     {
         // One socket reported readiness, while no reading operation
         // has ever been done. Whatever the sequence number is, it will
         // be taken as a good deal and reading will be accepted.
+        // The members of a balancing group don't share the sequence
+        // numbers, so any readiness of them is the group readiness.
         ready = true;
     }
     else if ((seqdiff = CSeqNo::seqcmp(sequence, m_RcvBaseSeqNo)) > 0)
@@ -2404,6 +2770,13 @@ int CUDTGroup::recv(char* buf, int len, SRT_MSGCTRL& w_mc)
     if (m_bClosing)
         throw CUDTException(MJ_CONNECTION, MN_CONNLOST, 0);
 
+    // The members store the packets in the group buffer.
+    if (m_pRcvBuffer)
+        return recv_FromBuffer(buf, len, (w_mc));
+
+    if (m_type == SRT_GTYPE_BALANCING)
+        return recv_Balancing(buf, len, (w_mc));
+
     // Later iteration over it might be less efficient than
     // by vector, but we'll also often try to check a single id
     // if it was ever seen broken, so that it's skipped.
@@ -2590,51 +2963,566 @@ int CUDTGroup::recv(char* buf, int len, SRT_MSGCTRL& w_mc)
     throw CUDTException(MJ_AGAIN, MN_RDAVAIL, 0);
 }
 
-const char* CUDTGroup::StateStr(CUDTGroup::GroupState st)
+// [[using locked(m_GroupLock)]]
+int CUDTGroup::recv_Balancing(char* buf, int len, SRT_MSGCTRL& w_mc)
 {
-    static const char* const states[] = {"PENDING", "IDLE", "RUNNING", "BROKEN"};
-    static const size_t      size     = Size(states);
-    static const char* const unknown  = "UNKNOWN";
-    if (size_t(st) < size)
-        return states[st];
-    return unknown;
-}
+    set<CUDTSocket*> broken;
 
-void CUDTGroup::synchronizeDrift(const srt::CUDT* srcMember)
-{
-    SRT_ASSERT(srcMember != NULL);
-    ScopedLock glock(m_GroupLock);
-    if (m_Group.size() <= 1)
+    for (;;)
     {
-        HLOGC(grlog.Debug, log << "GROUP: synch uDRIFT NOT DONE, no other links");
-        return;
-    }
+        if (!m_bOpened || !m_bConnected)
+        {
+            LOGC(grlog.Error,
+                 log << boolalpha << "grp/recv: $" << id() << ": ABANDONING: opened=" << m_bOpened
+                     << " connected=" << m_bConnected);
+            throw CUDTException(MJ_CONNECTION, MN_NOCONN, 0);
+        }
 
-    steady_clock::time_point timebase;
-    steady_clock::duration   udrift(0);
-    bool wrap_period = false;
-    srcMember->m_pRcvBuffer->getInternalTimeBase((timebase), (wrap_period), (udrift));
+        vector<CUDTSocket*> aliveMembers;
+        recv_CollectAliveAndBroken(aliveMembers, broken);
+        if (aliveMembers.empty())
+        {
+            LOGC(grlog.Error, log << "grp/recv: ALL LINKS BROKEN, ABANDONING.");
+            m_Global.m_EPoll.update_events(id(), m_sPollID, SRT_EPOLL_IN, false);
+            throw CUDTException(MJ_CONNECTION, MN_NOCONN, 0);
+        }
 
-    HLOGC(grlog.Debug,
-        log << "GROUP: synch uDRIFT=" << FormatDuration(udrift) << " TB=" << FormatTime(timebase) << "("
-        << (wrap_period ? "" : "NO ") << "wrap period)");
+        vector<CUDTSocket*> readySockets;
+        if (m_bSynRecving)
+            readySockets = recv_WaitForReadReady(aliveMembers, broken);
+        else
+            readySockets = aliveMembers;
 
-    // Now that we have the minimum timebase and drift calculated, apply this to every link,
-    // INCLUDING THE REPORTER.
+        if (m_bClosing)
+        {
+            HLOGC(grlog.Debug, log << "grp/recv: $" << id() << ": GROUP CLOSED, ABANDONING.");
+            throw CUDTException(MJ_CONNECTION, MN_CONNLOST, 0);
+        }
 
-    for (gli_t gi = m_Group.begin(); gi != m_Group.end(); ++gi)
-    {
-        // Skip non-connected; these will be synchronized when ready
-        if (gi->laststatus != SRTS_CONNECTED)
-            continue;
-        CUDT& member = gi->ps->core();
-        if (srcMember == &member)
-            continue;
+        // Every message came over one member only, so the sequence numbers
+        // of the members are unrelated. Of the messages ready to play on
+        // all members the one with the lowest message number goes first.
+        const steady_clock::time_point tnow = steady_clock::now();
+        CUDTSocket* socketToRead = NULL;
+        int32_t     msgnoToRead  = SRT_MSGNO_NONE;
+        for (vector<CUDTSocket*>::const_iterator si = readySockets.begin(); si != readySockets.end(); ++si)
+        {
+            CUDTSocket* ps = *si;
+            if (broken.count(ps))
+                continue;
+
+            ScopedLock lg(ps->core().m_RcvBufferLock);
+            if (!ps->core().m_pRcvBuffer)
+                continue;
+
+            const CRcvBuffer::PacketInfo info = ps->core().m_pRcvBuffer->getFirstReadablePacketInfo(tnow);
+            if (info.seqno == SRT_SEQNO_NONE)
+                continue;
+
+            const int32_t msgno = ps->core().m_pRcvBuffer->getMsgNoAt(info.seqno);
+            if (msgno == SRT_MSGNO_NONE)
+                continue;
+
+            if (socketToRead == NULL || MsgNo(msgno) < MsgNo(msgnoToRead))
+            {
+                socketToRead = ps;
+                msgnoToRead  = msgno;
+            }
+        }
+
+        if (socketToRead == NULL)
+        {
+            if (m_bSynRecving)
+            {
+                HLOGC(grlog.Debug,
+                      log << "grp/recv: $" << id() << ": No links reported any ready message, re-polling.");
+                continue;
+            }
+
+            HLOGC(grlog.Debug,
+                  log << "grp/recv: $" << id() << ": No links reported any ready message, clearing readiness.");
+            m_Global.m_EPoll.update_events(id(), m_sPollID, SRT_EPOLL_IN, false);
+            throw CUDTException(MJ_AGAIN, MN_RDAVAIL, 0);
+        }
+
+        const int res = socketToRead->core().receiveMessage((buf), len, (w_mc), CUDTUnited::ERH_RETURN);
+        HLOGC(grlog.Debug,
+              log << "grp/recv: $" << id() << ": @" << socketToRead->m_SocketID << ": Extracted data with %"
+                  << w_mc.pktseq << " #" << w_mc.msgno << ": " << (res <= 0 ? "(NOTHING)" : BufferStamp(buf, res)));
+        if (res == 0)
+        {
+            LOGC(grlog.Warn,
+                 log << "grp/recv: $" << id() << ": @" << socketToRead->m_SocketID << ": Retrying next socket...");
+            continue;
+        }
+        if (res == SRT_ERROR)
+        {
+            LOGC(grlog.Warn,
+                 log << "grp/recv: $" << id() << ": @" << socketToRead->m_SocketID << ": " << srt_getlasterror_str()
+                     << ". Retrying next socket...");
+            broken.insert(socketToRead);
+            continue;
+        }
+
+        // A message that came later than a message after it had
+        // been delivered is too late to be delivered in order.
+        if (m_RcvBaseMsgNo != SRT_MSGNO_NONE && MsgNo(w_mc.msgno) <= MsgNo(m_RcvBaseMsgNo.load()))
+        {
+            LOGC(grlog.Warn,
+                 log << "@" << m_GroupID << " GROUP RCV-DISCARDED #" << w_mc.msgno << " from @"
+                     << socketToRead->m_SocketID << ": already delivered up to #" << m_RcvBaseMsgNo);
+            continue;
+        }
+
+        fillGroupData((w_mc), w_mc);
+
+        if (m_RcvBaseMsgNo != SRT_MSGNO_NONE)
+        {
+            const int32_t iNumDropped = (MsgNo(w_mc.msgno) - MsgNo(m_RcvBaseMsgNo.load())) - 1;
+            if (iNumDropped > 0)
+            {
+                m_stats.recvDrop.count(stats::BytesPackets(iNumDropped * static_cast<uint64_t>(avgRcvPacketSize()), iNumDropped));
+                LOGC(grlog.Warn,
+                    log << "@" << m_GroupID << " GROUP RCV-DROPPED " << iNumDropped << " message(s) before #"
+                        << w_mc.msgno);
+            }
+        }
+        m_RcvBaseMsgNo = w_mc.msgno;
+
+        // Update stats as per delivery
+        m_stats.recv.count(res);
+        updateAvgPayloadSize(res);
+
+        // The member could have been removed while the group lock was lifted.
+        for (gli_t gi = m_Group.begin(); gi != m_Group.end(); ++gi)
+        {
+            if (gi->ps == socketToRead)
+            {
+                ++gi->pktRcvShareTotal;
+                break;
+            }
+        }
+
+        bool canReadFurther = false;
+        for (vector<CUDTSocket*>::const_iterator si = aliveMembers.begin(); si != aliveMembers.end(); ++si)
+        {
+            CUDTSocket* ps = *si;
+            ScopedLock  lg(ps->core().m_RcvBufferLock);
+            if (!ps->core().isRcvBufferReadyNoLock())
+                m_Global.m_EPoll.update_events(ps->m_SocketID, ps->core().m_sPollID, SRT_EPOLL_IN, false);
+            else
+                canReadFurther = true;
+        }
+
+        if (!canReadFurther)
+            m_Global.m_EPoll.update_events(id(), m_sPollID, SRT_EPOLL_IN, false);
+
+        return res;
+    }
+}
+
+// [[using locked(m_GroupLock)]]
+int CUDTGroup::recv_FromBuffer(char* buf, int len, SRT_MSGCTRL& w_mc)
+{
+    steady_clock::time_point deadline;
+    if (m_iRcvTimeOut >= 0)
+        deadline = steady_clock::now() + milliseconds_from(m_iRcvTimeOut);
+
+    for (;;)
+    {
+        if (!m_bOpened || !m_bConnected)
+        {
+            LOGC(grlog.Error,
+                 log << boolalpha << "grp/recv: $" << id() << ": ABANDONING: opened=" << m_bOpened
+                     << " connected=" << m_bConnected);
+            throw CUDTException(MJ_CONNECTION, MN_NOCONN, 0);
+        }
+
+        CUDT* member = NULL;
+        for (gli_t gi = m_Group.begin(); gi != m_Group.end(); ++gi)
+        {
+            if (gi->ps->core().stillConnected())
+            {
+                member = &gi->ps->core();
+                break;
+            }
+        }
+
+        if (!member)
+        {
+            LOGC(grlog.Error, log << "grp/recv: ALL LINKS BROKEN, ABANDONING.");
+            m_Global.m_EPoll.update_events(id(), m_sPollID, SRT_EPOLL_IN, false);
+            throw CUDTException(MJ_CONNECTION, MN_NOCONN, 0);
+        }
+
+        if (!member->m_CongCtl->checkTransArgs(SrtCongestion::STA_MESSAGE, SrtCongestion::STAD_RECV, buf, len, SRT_MSGTTL_INF, false))
+            throw CUDTException(MJ_NOTSUP, MN_INVALMSGAPI, 0);
+
+        int res = 0;
+        {
+            ScopedLock bufflock(m_RcvBufferLock);
+            if (m_pRcvBuffer->isRcvDataReady(steady_clock::now()))
+                res = m_pRcvBuffer->readMessage(buf, len, &w_mc);
+        }
+
+        if (res > 0)
+        {
+            HLOGC(grlog.Debug,
+                  log << "grp/recv: $" << id() << ": Extracted data with %" << w_mc.pktseq << " #" << w_mc.msgno
+                      << ": " << BufferStamp(buf, res));
+            fillGroupData((w_mc), w_mc);
+
+            // Packets dropped by the TSBPD thread of the group are seen as a gap in the
+            // sequence, like the packets dropped by the member sockets otherwise.
+            if (m_RcvBaseSeqNo != SRT_SEQNO_NONE)
+            {
+                const int32_t iNumDropped = (CSeqNo(w_mc.pktseq) - CSeqNo(m_RcvBaseSeqNo)) - 1;
+                if (iNumDropped > 0)
+                {
+                    m_stats.recvDrop.count(stats::BytesPackets(iNumDropped * static_cast<uint64_t>(avgRcvPacketSize()), iNumDropped));
+                    LOGC(grlog.Warn,
+                        log << "@" << m_GroupID << " GROUP RCV-DROPPED " << iNumDropped << " packet(s): seqno %"
+                            << CSeqNo::incseq(m_RcvBaseSeqNo) << " to %" << CSeqNo::decseq(w_mc.pktseq));
+                }
+            }
+            m_RcvBaseSeqNo = w_mc.pktseq;
+
+            m_stats.recv.count(res);
+            updateAvgPayloadSize(res);
+
+            // Let the TSBPD thread schedule the next packet.
+            CUniqueSync tscc(m_RcvDataLock, m_RcvTsbPdCond);
+            if (!isRcvBufferReady())
+                m_Global.m_EPoll.update_events(id(), m_sPollID, SRT_EPOLL_IN, false);
+            tscc.notify_one();
+            return res;
+        }
+
+        if (!m_bSynRecving)
+        {
+            // Clear the readiness under m_RcvDataLock, so that
+            // it's not done after the TSBPD thread has set it.
+            ScopedLock lk(m_RcvDataLock);
+            if (!isRcvBufferReady())
+                m_Global.m_EPoll.update_events(id(), m_sPollID, SRT_EPOLL_IN, false);
+            throw CUDTException(MJ_AGAIN, MN_RDAVAIL, 0);
+        }
+
+        const steady_clock::time_point tnow = steady_clock::now();
+        if (!is_zero(deadline) && tnow >= deadline)
+            throw CUDTException(MJ_AGAIN, MN_XMTIMEOUT, 0);
+
+        {
+            // Wait for the TSBPD thread with the group unlocked. Recheck the
+            // connection every second, when no packet comes from any link.
+            InvertedLock ung(m_GroupLock);
+            CUniqueSync rdcc(m_RcvDataLock, m_RcvDataCond);
+            if (!m_bClosing && !isRcvBufferReady())
+            {
+                steady_clock::time_point exptime = tnow + milliseconds_from(1000);
+                if (!is_zero(deadline) && deadline < exptime)
+                    exptime = deadline;
+                rdcc.wait_until(exptime);
+            }
+        }
+
+        if (m_bClosing)
+        {
+            HLOGC(grlog.Debug, log << "grp/recv: $" << id() << ": GROUP CLOSED, ABANDONING.");
+            throw CUDTException(MJ_CONNECTION, MN_CONNLOST, 0);
+        }
+    }
+}
+
+const char* CUDTGroup::StateStr(CUDTGroup::GroupState st)
+{
+    static const char* const states[] = {"PENDING", "IDLE", "RUNNING", "BROKEN"};
+    static const size_t      size     = Size(states);
+    static const char* const unknown  = "UNKNOWN";
+    if (size_t(st) < size)
+        return states[st];
+    return unknown;
+}
+
+void CUDTGroup::synchronizeDrift(const srt::CUDT* srcMember)
+{
+    SRT_ASSERT(srcMember != NULL);
+    ScopedLock glock(m_GroupLock);
+
+    steady_clock::time_point timebase;
+    steady_clock::duration   udrift(0);
+    bool wrap_period = false;
+    srcMember->m_pRcvBuffer->getInternalTimeBase((timebase), (wrap_period), (udrift));
+
+    if (m_pRcvBuffer)
+    {
+        ScopedLock bufflock(m_RcvBufferLock);
+        m_pRcvBuffer->applyGroupDrift(timebase, wrap_period, udrift);
+    }
+
+    if (m_Group.size() <= 1)
+    {
+        HLOGC(grlog.Debug, log << "GROUP: synch uDRIFT NOT DONE, no other links");
+        return;
+    }
+
+    HLOGC(grlog.Debug,
+        log << "GROUP: synch uDRIFT=" << FormatDuration(udrift) << " TB=" << FormatTime(timebase) << "("
+        << (wrap_period ? "" : "NO ") << "wrap period)");
+
+    // Now that we have the minimum timebase and drift calculated, apply this to every link,
+    // INCLUDING THE REPORTER.
+
+    for (gli_t gi = m_Group.begin(); gi != m_Group.end(); ++gi)
+    {
+        // Skip non-connected; these will be synchronized when ready
+        if (gi->laststatus != SRTS_CONNECTED)
+            continue;
+        CUDT& member = gi->ps->core();
+        if (srcMember == &member)
+            continue;
 
         member.m_pRcvBuffer->applyGroupDrift(timebase, wrap_period, udrift);
     }
 }
 
+// [[using locked(m_GroupLock)]]
+bool CUDTGroup::setupRcvBuffer(const CUDT& member, bool first)
+{
+    if (!isGroupReceiver() || !member.m_bTsbPd || m_bClosing)
+        return false;
+
+    const bool created = !m_pRcvBuffer;
+    if (created)
+    {
+        CUnitQueue* unitq = NULL;
+        CRcvBuffer* rcvbuf = NULL;
+        try
+        {
+            unitq  = new CUnitQueue(128, (int)member.maxPayloadSize());
+            rcvbuf = new CRcvBuffer(member.m_iRcvLastAck, member.m_config.iRcvBufSize, unitq, member.m_config.bMessageAPI);
+        }
+        catch (...)
+        {
+            LOGC(grlog.Error, log << "group/setupRcvBuffer: $" << id() << ": can't create the buffer, members store the packets");
+            delete unitq;
+            return false;
+        }
+
+        m_iRcvUnitSize  = (int)member.maxPayloadSize();
+        m_bRcvTLPktDrop = member.m_bTLPktDrop;
+        {
+            // The TSBPD thread uses them from the very beginning.
+            ScopedLock bufflock(m_RcvBufferLock);
+            m_pRcvUnitQueue = unitq;
+            m_pRcvBuffer    = rcvbuf;
+        }
+
+        if (!StartThread(m_RcvTsbPdThread, CUDTGroup::tsbpd, this, "SRT:GrpTsbPd"))
+        {
+            LOGC(grlog.Error, log << "group/setupRcvBuffer: $" << id() << ": can't start the TSBPD thread, members store the packets");
+            {
+                ScopedLock bufflock(m_RcvBufferLock);
+                m_pRcvBuffer    = NULL;
+                m_pRcvUnitQueue = NULL;
+            }
+            delete rcvbuf;
+            delete unitq;
+            return false;
+        }
+    }
+
+    if (created || first)
+    {
+        // The member defines the receiver sequence and the time base
+        // for the group. Packets left over from the previous connection
+        // are useless now.
+        ScopedLock bufflock(m_RcvBufferLock);
+        if (!m_pRcvBuffer->empty())
+        {
+            const int iDropCnt = m_pRcvBuffer->dropAll();
+            LOGC(grlog.Warn, log << "group/setupRcvBuffer: $" << id() << ": dropped " << iDropCnt
+                    << " packets of the previous connection");
+        }
+        m_pRcvBuffer->setStartSeqNo(member.m_iRcvLastAck);
+        m_RcvBaseSeqNo = CSeqNo::decseq(member.m_iRcvLastAck);
+
+        steady_clock::time_point timebase;
+        steady_clock::duration   udrift(0);
+        bool wrap_period = false;
+        member.m_pRcvBuffer->getInternalTimeBase((timebase), (wrap_period), (udrift));
+        m_pRcvBuffer->applyGroupTime(timebase, wrap_period, member.m_iTsbPdDelay_ms * 1000, udrift);
+        m_pRcvBuffer->setPeerRexmitFlag(member.m_bPeerRexmitFlag);
+    }
+
+    HLOGC(grlog.Debug, log << "group/setupRcvBuffer: $" << id() << ": @" << member.m_SocketID
+            << " stores into the group buffer from %" << member.m_iRcvLastAck
+            << (first ? " (DEFINED ISN)" : ""));
+    return true;
+}
+
+int32_t CUDTGroup::rcvStartSeqNo() const
+{
+    ScopedLock bufflock(m_RcvBufferLock);
+    return m_pRcvBuffer->getStartSeqNo();
+}
+
+int CUDTGroup::rcvCapacity() const
+{
+    ScopedLock bufflock(m_RcvBufferLock);
+    return (int)m_pRcvBuffer->capacity();
+}
+
+bool CUDTGroup::rcvEmpty() const
+{
+    ScopedLock bufflock(m_RcvBufferLock);
+    return m_pRcvBuffer->empty();
+}
+
+int CUDTGroup::rcvProbe(int32_t seqno) const
+{
+    ScopedLock bufflock(m_RcvBufferLock);
+    return m_pRcvBuffer->probe(seqno);
+}
+
+int CUDTGroup::rcvInsert(CPacket& packet)
+{
+    const int32_t seqno = packet.getSeqNo();
+    if ((int)packet.getLength() > m_iRcvUnitSize)
+    {
+        LOGC(grlog.Error, log << "group/rcvInsert: $" << id() << ": %" << seqno << " size " << packet.getLength()
+                << " exceeds the unit size " << m_iRcvUnitSize);
+        return -1;
+    }
+
+    {
+        ScopedLock bufflock(m_RcvBufferLock);
+        const int probe_result = m_pRcvBuffer->probe(seqno);
+        if (probe_result < 0)
+            return probe_result;
+
+        CUnit* u = m_pRcvUnitQueue->getNextAvailUnit();
+        if (!u)
+        {
+            LOGC(grlog.Error, log << "group/rcvInsert: $" << id() << ": no free unit for %" << seqno);
+            return -3;
+        }
+
+        // A unit not taken by insert() is simply used for the next packet.
+        memcpy((u->m_Packet.getHeader()), packet.getHeader(), CPacket::HDR_SIZE);
+        memcpy((u->m_Packet.m_pcData), packet.m_pcData, packet.getLength());
+        u->m_Packet.setLength(packet.getLength());
+
+        const int result = m_pRcvBuffer->insert(u);
+        if (result < 0)
+            return result;
+    }
+
+    // Wake up the TSBPD thread if it waits for any packet,
+    // or for a packet following the inserted one.
+    ScopedLock lk(m_RcvDataLock);
+    if (m_bTsbPdNeedsWakeup
+            || (m_iTsbPdWaitSeqNo != SRT_SEQNO_NONE && CSeqNo::seqcmp(seqno, m_iTsbPdWaitSeqNo) < 0))
+    {
+        m_RcvTsbPdCond.notify_one();
+    }
+    return 0;
+}
+
+// [[using locked(m_RcvDataLock)]]
+bool CUDTGroup::isRcvBufferReady() const
+{
+    ScopedLock bufflock(m_RcvBufferLock);
+    return m_pRcvBuffer->isRcvDataReady(steady_clock::now());
+}
+
+void* CUDTGroup::tsbpd(void* param)
+{
+    CUDTGroup* self = (CUDTGroup*)param;
+
+    THREAD_STATE_INIT("SRT:GrpTsbPd");
+
+    CUniqueSync recvdata_lcc (self->m_RcvDataLock, self->m_RcvDataCond);
+    CSync tsbpd_cc(self->m_RcvTsbPdCond, recvdata_lcc.locker());
+
+    while (!self->m_bClosing)
+    {
+        INCREMENT_THREAD_ITERATIONS();
+
+        const steady_clock::time_point tsNextDelivery = self->tsbpdCheck(recvdata_lcc);
+        if (self->m_bClosing)
+            break;
+
+        THREAD_PAUSED();
+        if (!is_zero(tsNextDelivery))
+            tsbpd_cc.wait_until(tsNextDelivery);
+        else
+            tsbpd_cc.wait();
+        THREAD_RESUMED();
+    }
+    THREAD_EXIT();
+    HLOGC(tslog.Debug, log << "grp/tsbpd: $" << self->id() << ": EXITING");
+    return NULL;
+}
+
+// [[using locked(m_RcvDataLock)]]
+steady_clock::time_point CUDTGroup::tsbpdCheck(CUniqueSync& recvdata_lcc)
+{
+    bool rxready = false;
+
+    enterCS(m_RcvBufferLock);
+    const steady_clock::time_point tnow = steady_clock::now();
+
+    m_pRcvUnitQueue->shrink(tnow);
+    const CRcvBuffer::PacketInfo info = m_pRcvBuffer->getFirstValidPacketInfo();
+    const bool is_time_to_deliver = !is_zero(info.tsbpd_time) && (tnow >= info.tsbpd_time);
+
+    if (!m_bRcvTLPktDrop)
+    {
+        rxready = !info.seq_gap && is_time_to_deliver;
+    }
+    else if (is_time_to_deliver)
+    {
+        rxready = true;
+        if (info.seq_gap)
+        {
+            // Not received over any link in time. The drop is counted
+            // by recv() as a gap in the sequence of the delivered packets.
+            const int iDropCnt SRT_ATR_UNUSED = m_pRcvBuffer->dropUpTo(info.seqno).first;
+            HLOGC(tslog.Debug, log << "grp/tsbpd: $" << id() << ": DROPSEQ: up to seqno %"
+                    << CSeqNo::decseq(info.seqno) << " (" << iDropCnt << " packets)");
+        }
+    }
+    leaveCS(m_RcvBufferLock);
+
+    if (rxready)
+    {
+        HLOGC(tslog.Debug, log << "grp/tsbpd: $" << id() << ": PLAYING PACKET seq=" << info.seqno << " (belated "
+                << FormatDuration<DUNIT_MS>(steady_clock::now() - info.tsbpd_time) << ")");
+        recvdata_lcc.notify_all();
+        m_Global.m_EPoll.update_events(id(), m_sPollID, SRT_EPOLL_IN, true);
+        CGlobEvent::triggerEvent();
+
+        // Wait for the reader.
+        m_bTsbPdNeedsWakeup = false;
+        m_iTsbPdWaitSeqNo   = SRT_SEQNO_NONE;
+        return steady_clock::time_point();
+    }
+
+    if (is_zero(info.tsbpd_time) || is_time_to_deliver)
+    {
+        // No packets or a gap that can't be dropped: wait for a packet.
+        m_bTsbPdNeedsWakeup = true;
+        m_iTsbPdWaitSeqNo   = SRT_SEQNO_NONE;
+        return steady_clock::time_point();
+    }
+
+    // Wait for the time to play the packet, unless a packet before it comes.
+    m_bTsbPdNeedsWakeup = false;
+    m_iTsbPdWaitSeqNo   = info.seqno;
+    return info.tsbpd_time;
+}
+
 void CUDTGroup::bstatsSocket(CBytePerfMon* perf, bool clear)
 {
     if (!m_bConnected)
@@ -2682,6 +3570,26 @@ void CUDTGroup::bstatsSocket(CBytePerfMon* perf, bool clear)
     }
 }
 
+void CUDTGroup::bstatsMember(SRTSOCKET sid, CBytePerfMon* perf)
+{
+    ScopedLock gg(m_GroupLock);
+
+    if (m_type != SRT_GTYPE_BALANCING)
+        return;
+
+    for (gli_t gi = m_Group.begin(); gi != m_Group.end(); ++gi)
+    {
+        if (gi->id != sid)
+            continue;
+
+        const uint64_t sent = m_stats.sent.total.count();
+        const uint64_t recv = m_stats.recv.total.count();
+        perf->groupSndShare = sent ? 100.0 * gi->pktSndShareTotal / sent : 0;
+        perf->groupRcvShare = recv ? 100.0 * gi->pktRcvShareTotal / recv : 0;
+        break;
+    }
+}
+
 /// @brief Compares group members by their weight (higher weight comes first).
 struct FCompareByWeight
 {
@@ -2991,9 +3899,7 @@ CUDTGroup::BackupMemberState CUDTGroup::sendBackup_QualifyActiveState(const gli_
         return BKUPST_ACTIVE_UNSTABLE;
     }
 
-    enterCS(u.m_StatsLock);
-    const int64_t drop_total = u.m_stats.sndr.dropped.total.count();
-    leaveCS(u.m_StatsLock);
+    const int64_t drop_total = u.m_stats.sndr.dropped.total().count();
 
     const bool have_new_drops = d->pktSndDropTotal != drop_total;
     if (have_new_drops)
@@ -4208,6 +5114,30 @@ void CUDTGroup::internalKeepalive(SocketData* gli)
 
 CUDTGroup::BufferedMessageStorage CUDTGroup::BufferedMessage::storage(SRT_LIVE_MAX_PLSIZE /*, 1000*/);
 
+sync::atomic<int> CUDTGroup::SharedPayload::s_iAllocated(0);
+
+CUDTGroup::SharedPayload* CUDTGroup::SharedPayload::create(const char* buf, int len)
+{
+    // The header and the payload share one allocation; the alignment
+    // of new char[] is sufficient for the header.
+    char*          block = new char[sizeof(SharedPayload) + len];
+    SharedPayload* p     = new (block) SharedPayload(len);
+    memcpy(p->data(), buf, len);
+    ++s_iAllocated;
+    return p;
+}
+
+void CUDTGroup::SharedPayload::release(void* opaque)
+{
+    SharedPayload* p = static_cast<SharedPayload*>(opaque);
+    if (--p->refcount > 0)
+        return;
+
+    p->~SharedPayload();
+    delete[] reinterpret_cast<char*>(p);
+    --s_iAllocated;
+}
+
 // Forwarder needed due to class definition order
 int32_t CUDTGroup::generateISN()
 {
@@ -4392,6 +5322,9 @@ void CUDTGroup::updateFailedLink()
         // No healthy links, set ERR on epoll.
         HLOGC(gmlog.Debug, log << "group/updateFailedLink: All sockets broken");
         m_Global.m_EPoll.update_events(id(), m_sPollID, SRT_EPOLL_IN | SRT_EPOLL_OUT | SRT_EPOLL_ERR, true);
+
+        // Release a reader blocked on the group buffer.
+        CSync::lock_notify_all(m_RcvDataCond, m_RcvDataLock);
     }
     else
     {
@@ -19,8 +19,10 @@ Written by
 #include "srt.h"
 #include "common.h"
 #include "packet.h"
+#include "buffer_rcv.h"
 #include "group_common.h"
 #include "group_backup.h"
+#include "group_balancing.h"
 
 namespace srt
 {
@@ -208,6 +210,7 @@ public:
     int            send(const char* buf, int len, SRT_MSGCTRL& w_mc);
     int            sendBroadcast(const char* buf, int len, SRT_MSGCTRL& w_mc);
     int            sendBackup(const char* buf, int len, SRT_MSGCTRL& w_mc);
+    int            sendBalancing(const char* buf, int len, SRT_MSGCTRL& w_mc);
     static int32_t generateISN();
 
 private:
@@ -611,7 +614,41 @@ public:
     typedef std::deque<BufferedMessage> senderBuffer_t;
     // typedef StaticBuffer<BufferedMessage, 1000> senderBuffer_t;
 
+    /// A single copy of a message payload sent over all links of a
+    /// broadcast group. The member sender buffers refer to it instead
+    /// of copying the data, and every member holds one reference that
+    /// is dropped when the member's buffer releases the message
+    /// (acknowledged or dropped). The block is deleted with the last one.
+    struct SharedPayload
+    {
+        sync::atomic<int> refcount;
+        int               size;
+
+        char* data() { return reinterpret_cast<char*>(this + 1); }
+
+        /// Allocates the block holding a copy of @a buf with one reference.
+        static SharedPayload* create(const char* buf, int len);
+
+        void        acquire() { ++refcount; }
+        static void release(void* opaque); // srt_sendbuf_release_fn
+
+        /// Number of blocks not freed yet, in all groups.
+        static int allocated() { return s_iAllocated; }
+
+    private:
+        static sync::atomic<int> s_iAllocated;
+
+        SharedPayload(int len)
+            : refcount(1)
+            , size(len)
+        {
+        }
+    };
+
 private:
+    /// Sends the shared payload over one member of a broadcast group.
+    int sendBroadcast_Member(srt::CUDT& core, SharedPayload* payload, SRT_MSGCTRL& w_mc);
+
     // Fields required for SRT_GTYPE_BACKUP groups.
     senderBuffer_t        m_SenderBuffer; // This mechanism is to be removed on group-common sndbuf
     int32_t               m_iSndOldestMsgNo; // oldest position in the sender buffer
@@ -656,14 +693,45 @@ private:
     /// @throws CUDTException(MJ_AGAIN, MN_RDAVAIL, 0)
     std::vector<srt::CUDTSocket*> recv_WaitForReadReady(const std::vector<srt::CUDTSocket*>& aliveMembers, std::set<srt::CUDTSocket*>& w_broken);
 
+    /// Read the next message from the group receiver buffer.
+    /// [[using locked(m_GroupLock)]] temporally unlocks-locks internally
+    /// @throws CUDTException(MJ_CONNECTION, MN_NOCONN, 0)
+    /// @throws CUDTException(MJ_AGAIN, MN_RDAVAIL, 0)
+    /// @throws CUDTException(MJ_AGAIN, MN_XMTIMEOUT, 0)
+    int recv_FromBuffer(char* buf, int len, SRT_MSGCTRL& w_mc);
+
+    /// Read the next message of a balancing group from the member
+    /// that has it, in the order of the message numbers.
+    /// [[using locked(m_GroupLock)]] temporally unlocks-locks internally
+    /// @throws CUDTException(MJ_CONNECTION, MN_NOCONN, 0)
+    /// @throws CUDTException(MJ_AGAIN, MN_RDAVAIL, 0)
+    int recv_Balancing(char* buf, int len, SRT_MSGCTRL& w_mc);
+
+    /// [[using locked(m_RcvDataLock)]]
+    bool isRcvBufferReady() const;
+
+    // TSBPD thread of the group receiver buffer.
+    static void* tsbpd(void* param);
+
+    /// One round of the TSBPD work on the group receiver buffer,
+    /// see CUDT::tsbpdCheck().
+    /// @param recvdata_lcc m_RcvDataLock with m_RcvDataCond, locked
+    /// @return Play time of the next packet to wait for, or zero time
+    /// when the TSBPD must wait for a signal.
+    time_point tsbpdCheck(sync::CUniqueSync& recvdata_lcc);
+
     // This is the sequence number of a packet that has been previously
     // delivered. Initially it should be set to SRT_SEQNO_NONE so that the sequence read
     // from the first delivering socket will be taken as a good deal.
     sync::atomic<int32_t> m_RcvBaseSeqNo;
 
+    // The same for the message number, used by the balancing groups
+    // where the members don't share the sequence numbers.
+    sync::atomic<int32_t> m_RcvBaseMsgNo;
+
     bool m_bOpened;    // Set to true when at least one link is at least pending
     bool m_bConnected; // Set to true on first link confirmed connected
-    bool m_bClosing;
+    sync::atomic<bool> m_bClosing;
 
     // There's no simple way of transforming config
     // items that are predicted to be used on socket.
@@ -675,6 +743,19 @@ private:
     // is ready to deliver.
     sync::Condition       m_RcvDataCond;
     sync::Mutex           m_RcvDataLock;
+
+    // Receiver buffer of a group receiver. The members insert their packets
+    // here, so a packet received over several links is stored and read once.
+    // Locking order: m_GroupLock, member's m_RcvBufferLock, m_RcvDataLock, m_RcvBufferLock.
+    CRcvBuffer*         m_pRcvBuffer;
+    CUnitQueue*         m_pRcvUnitQueue; // Units of m_pRcvBuffer, as the members' units belong to their multiplexers
+    int                 m_iRcvUnitSize;      // Payload size of the units
+    bool                m_bRcvTLPktDrop;     // TLPKTDROP as agreed with the peer by the members
+    mutable sync::Mutex m_RcvBufferLock;
+    sync::CThread       m_RcvTsbPdThread;
+    sync::Condition     m_RcvTsbPdCond;      // Use together with m_RcvDataLock
+    bool                m_bTsbPdNeedsWakeup; // Wake up the TSBPD thread on a new packet
+    int32_t             m_iTsbPdWaitSeqNo;   // Packet the TSBPD thread waits to play, or SRT_SEQNO_NONE
     sync::atomic<int32_t> m_iLastSchedSeqNo; // represetnts the value of CUDT::m_iSndNextSeqNo for each running socket
     sync::atomic<int32_t> m_iLastSchedMsgNo;
     // Statistics
@@ -733,6 +814,9 @@ private:
 public:
     void bstatsSocket(CBytePerfMon* perf, bool clear);
 
+    /// Fill in the balancing share statistics of the member socket.
+    void bstatsMember(SRTSOCKET id, CBytePerfMon* perf);
+
     // Required after the call on newGroup on the listener side.
     // On the listener side the group is lazily created just before
     // accepting a new socket and therefore always open.
@@ -756,6 +840,7 @@ public:
         // this is going to be past the ISN, at worst it will be caused
         // by TLPKTDROP.
         m_RcvBaseSeqNo = SRT_SEQNO_NONE;
+        m_RcvBaseMsgNo = SRT_MSGNO_NONE;
     }
 
     bool applyGroupTime(time_point& w_start_time, time_point& w_peer_start_time)
@@ -794,6 +879,34 @@ public:
     /// @param srcMember a reference for synchronization.
     void synchronizeDrift(const srt::CUDT* srcMember);
 
+    /// Create the receiver buffer of a group receiver, shared by its members,
+    /// if it doesn't exist yet. The buffer takes the receiver sequence and the
+    /// time base from the member that defines them for the group.
+    /// [[using locked(m_GroupLock)]]
+    /// @param member the member socket that has just connected
+    /// @param first true if the member has defined the group receiver sequence
+    /// @return true if the member shall insert its packets into the group buffer
+    bool setupRcvBuffer(const srt::CUDT& member, bool first);
+
+    // The functions below are called by the members inserting their packets
+    // into the group buffer, with their m_RcvBufferLock locked.
+
+    /// @return the sequence number of the first packet expected in the group buffer
+    int32_t rcvStartSeqNo() const;
+
+    /// @return the capacity of the group buffer in packets
+    int  rcvCapacity() const;
+    bool rcvEmpty() const;
+
+    /// Check if the packet with @a seqno can be inserted into the group buffer.
+    /// @return 0 if it can, otherwise the same as CRcvBuffer::insert()
+    int rcvProbe(int32_t seqno) const;
+
+    /// Copy the packet into the group buffer. Packets that are already there,
+    /// received over another member, are dropped.
+    /// @return 0 if the packet was inserted, otherwise the same as CRcvBuffer::insert()
+    int rcvInsert(CPacket& packet);
+
     void updateLatestRcv(srt::CUDTSocket*);
 
     // Property accessors
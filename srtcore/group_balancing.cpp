@@ -0,0 +1,94 @@
+/*
+ * SRT - Secure, Reliable, Transport
+ * Copyright (c) 2021 Haivision Systems Inc.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ */
+
+ /*****************************************************************************
+ Written by
+    Haivision Systems Inc.
+ *****************************************************************************/
+
+#include "platform_sys.h"
+
+#include "group_balancing.h"
+
+
+namespace srt
+{
+namespace groups
+{
+
+void SendBalancingCtx::addMember(SocketData* d, int64_t capacity, bool congested)
+{
+    Member m;
+    m.pSocketData = d;
+    m.weight      = capacity;
+    m.congested   = congested;
+    m.tried       = false;
+    m_Members.push_back(m);
+}
+
+void SendBalancingCtx::weigh()
+{
+    int64_t known_sum = 0;
+    size_t  nknown    = 0;
+    for (size_t i = 0; i < m_Members.size(); ++i)
+    {
+        if (m_Members[i].weight)
+        {
+            known_sum += m_Members[i].weight;
+            ++nknown;
+        }
+    }
+
+    const int64_t default_weight = nknown ? known_sum / int64_t(nknown) : 1;
+    m_iTotalWeight = 0;
+    for (size_t i = 0; i < m_Members.size(); ++i)
+    {
+        if (!m_Members[i].weight)
+            m_Members[i].weight = default_weight;
+        m_iTotalWeight += m_Members[i].weight;
+    }
+}
+
+size_t SendBalancingCtx::next()
+{
+    const size_t n = m_Members.size();
+    size_t best = n;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Member& m = m_Members[i];
+        if (m.tried)
+            continue;
+        if (best == n)
+        {
+            best = i;
+            continue;
+        }
+
+        const Member& b = m_Members[best];
+        if ((b.congested && !m.congested)
+            || (b.congested == m.congested
+                && m.pSocketData->sndCredit + m.weight > b.pSocketData->sndCredit + b.weight))
+            best = i;
+    }
+
+    if (best != n)
+        m_Members[best].tried = true;
+    return best;
+}
+
+void SendBalancingCtx::charge(size_t i)
+{
+    for (size_t k = 0; k < m_Members.size(); ++k)
+        m_Members[k].pSocketData->sndCredit += m_Members[k].weight;
+    m_Members[i].pSocketData->sndCredit -= m_iTotalWeight;
+}
+
+} // namespace groups
+} // namespace srt
@@ -0,0 +1,83 @@
+/*
+ * SRT - Secure, Reliable, Transport
+ * Copyright (c) 2021 Haivision Systems Inc.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ */
+
+ /*****************************************************************************
+ Written by
+    Haivision Systems Inc.
+ *****************************************************************************/
+
+#ifndef INC_SRT_GROUP_BALANCING_H
+#define INC_SRT_GROUP_BALANCING_H
+
+#include "srt.h"
+#include "common.h"
+#include "group_common.h"
+
+#include <vector>
+
+namespace srt
+{
+namespace groups
+{
+    /// @brief A context choosing the member that sends the next message of a balancing group.
+    /// The members share the messages in proportion to their weights by a smooth weighted
+    /// round-robin: every member earns its weight in credit (SocketData::sndCredit) for every
+    /// message, and the member that sends it pays back the total weight.
+    class SendBalancingCtx
+    {
+    public:
+        SendBalancingCtx()
+            : m_iTotalWeight(0)
+        {
+        }
+
+        /// @brief Adds a member that can send the message.
+        /// @param d the member
+        /// @param capacity capacity of the link in packets per second, 0 if not measured yet
+        /// @param congested whether the link is already queueing
+        void addMember(SocketData* d, int64_t capacity, bool congested);
+
+        /// @brief Weighs the members by their capacity, once all are added.
+        /// The members not measured yet get the average capacity of the measured
+        /// ones, or all get the same weight when none is measured.
+        void weigh();
+
+        /// @brief Selects the member to try next and marks it tried.
+        /// This is the member with the highest credit, but the congested members
+        /// come only after all the others.
+        /// @return index of the member, or size() if all have been tried
+        size_t next();
+
+        /// @brief Records that the member @a i sent the message.
+        void charge(size_t i);
+
+        size_t      size() const { return m_Members.size(); }
+        SocketData* member(size_t i) const { return m_Members[i].pSocketData; }
+        int64_t     weight(size_t i) const { return m_Members[i].weight; }
+        bool        congested(size_t i) const { return m_Members[i].congested; }
+        int64_t     totalWeight() const { return m_iTotalWeight; }
+
+    private:
+        struct Member
+        {
+            SocketData* pSocketData;
+            int64_t     weight;
+            bool        congested;
+            bool        tried;
+        };
+
+        std::vector<Member> m_Members;
+        int64_t             m_iTotalWeight;
+    };
+
+} // namespace groups
+} // namespace srt
+
+#endif // INC_SRT_GROUP_BALANCING_H
@@ -54,7 +54,10 @@ SocketData prepareSocketData(CUDTSocket* s)
         false,
         false,
         0, // weight
-        0  // pktSndDropTotal
+        0, // sndCredit
+        0, // pktSndDropTotal
+        0, // pktSndShareTotal
+        0  // pktRcvShareTotal
     };
     return sd;
 }
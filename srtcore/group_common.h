@@ -47,8 +47,13 @@ namespace groups
         // Configuration
         uint16_t       weight;
 
+        // Balancing: smooth weighted round-robin credit
+        int64_t        sndCredit;
+
         // Stats
         int64_t        pktSndDropTotal;
+        int64_t        pktSndShareTotal; // messages sent over this member (balancing)
+        int64_t        pktRcvShareTotal; // messages received over this member (balancing)
     };
 
     SocketData prepareSocketData(CUDTSocket* s);
@@ -0,0 +1,112 @@
+/*
+ * SRT - Secure, Reliable, Transport
+ * Copyright (c) 2021 Haivision Systems Inc.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ */
+
+#ifndef INC_SRT_HEAP_H
+#define INC_SRT_HEAP_H
+
+#include <vector>
+#include "sync.h"
+
+namespace srt
+{
+
+/// A binary min-heap of nodes ordered by the time in their member @a TIME.
+/// The heap is intrusive: every node keeps its position on the heap in its
+/// m_iHeapLoc member, -1 when not on the heap, so that any node can be
+/// removed or moved in O(log n). Not thread-safe.
+template <class Node, sync::steady_clock::time_point Node::*TIME>
+class CIntrusiveHeap
+{
+public:
+    bool   empty() const { return m_vHeap.empty(); }
+    size_t size() const { return m_vHeap.size(); }
+
+    /// @return The node with the earliest time, or NULL if the heap is empty.
+    Node* top() const { return m_vHeap.empty() ? NULL : m_vHeap[0]; }
+
+    /// Add a node that is not on the heap.
+    void insert(Node* n)
+    {
+        n->m_iHeapLoc = int(m_vHeap.size());
+        m_vHeap.push_back(n);
+        siftUp(n->m_iHeapLoc);
+    }
+
+    /// Remove a node, if it is on the heap.
+    void remove(Node* n)
+    {
+        const int pos = n->m_iHeapLoc;
+        if (pos < 0)
+            return;
+
+        n->m_iHeapLoc = -1;
+        Node* last    = m_vHeap.back();
+        m_vHeap.pop_back();
+        if (last == n)
+            return;
+
+        m_vHeap[pos]     = last;
+        last->m_iHeapLoc = pos;
+        update(last);
+    }
+
+    /// Restore the order after the time of a node on the heap was changed.
+    void update(Node* n)
+    {
+        siftUp(n->m_iHeapLoc);
+        siftDown(n->m_iHeapLoc);
+    }
+
+    void clear() { m_vHeap.clear(); }
+
+private:
+    void siftUp(int pos)
+    {
+        Node* n = m_vHeap[pos];
+        while (pos > 0)
+        {
+            const int parent = (pos - 1) / 2;
+            if (!(n->*TIME < m_vHeap[parent]->*TIME))
+                break;
+            m_vHeap[pos]             = m_vHeap[parent];
+            m_vHeap[pos]->m_iHeapLoc = pos;
+            pos                      = parent;
+        }
+        m_vHeap[pos]  = n;
+        n->m_iHeapLoc = pos;
+    }
+
+    void siftDown(int pos)
+    {
+        const int size = int(m_vHeap.size());
+        Node*     n    = m_vHeap[pos];
+        for (;;)
+        {
+            int child = pos * 2 + 1;
+            if (child >= size)
+                break;
+            if (child + 1 < size && m_vHeap[child + 1]->*TIME < m_vHeap[child]->*TIME)
+                ++child;
+            if (!(m_vHeap[child]->*TIME < n->*TIME))
+                break;
+            m_vHeap[pos]             = m_vHeap[child];
+            m_vHeap[pos]->m_iHeapLoc = pos;
+            pos                      = child;
+        }
+        m_vHeap[pos]  = n;
+        n->m_iHeapLoc = pos;
+    }
+
+    std::vector<Node*> m_vHeap;
+};
+
+} // namespace srt
+
+#endif
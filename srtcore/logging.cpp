@@ -43,7 +43,57 @@ LogDispatcher::Proxy LogDispatcher::operator()()
     return Proxy(*this);
 }
 
+LogDispatcher::BinaryProxy::BinaryProxy(LogDispatcher& guy, const char* fmt)
+    : that(guy)
+    , ring(NULL)
+    , rec(NULL)
+{
+    if (that.src_config->flags & SRT_LOGF_ASYNC)
+    {
+        rec = LogQueue::instance().reserve(that, (ring));
+        if (!rec && ring)
+            return; // The ring is full, the record is lost.
+    }
+
+    if (!rec)
+        rec = &local;
+    rec->reset(&that, fmt);
+}
+
+LogDispatcher::BinaryProxy::~BinaryProxy()
+{
+    if (!rec)
+        return;
+
+    if (ring)
+    {
+        LogQueue::instance().commit(ring);
+        return;
+    }
+
+    char threadname[srt::ThreadName::BUFSIZE];
+    const bool has_name = !that.isset(SRT_LOGF_DISABLE_THREADNAME) && srt::ThreadName::get(threadname);
+    that.SendLogRecord(*rec, has_name ? threadname : NULL);
+}
+
 void LogDispatcher::CreateLogLinePrefix(std::ostringstream& serr)
+{
+    using namespace srt;
+
+    timeval tv = timeval();
+    if ( !isset(SRT_LOGF_DISABLE_TIME) )
+    {
+        // Not necessary if sending through the queue.
+        gettimeofday(&tv, NULL);
+    }
+
+    // Note: ThreadName::get needs a buffer of size min. ThreadName::BUFSIZE
+    char tname[ThreadName::BUFSIZE];
+    const bool has_name = !isset(SRT_LOGF_DISABLE_THREADNAME) && ThreadName::get(tname);
+    CreateLogLinePrefix(serr, tv, has_name ? tname : NULL);
+}
+
+void LogDispatcher::CreateLogLinePrefix(std::ostringstream& serr, const timeval& tv, const char* threadname)
 {
     using namespace std;
     using namespace srt;
@@ -53,9 +103,6 @@ void LogDispatcher::CreateLogLinePrefix(std::ostringstream& serr)
     char tmp_buf[ThreadName::BUFSIZE];
     if ( !isset(SRT_LOGF_DISABLE_TIME) )
     {
-        // Not necessary if sending through the queue.
-        timeval tv;
-        gettimeofday(&tv, NULL);
         struct tm tm = SysLocalTime((time_t) tv.tv_sec);
 
         if (strftime(tmp_buf, sizeof(tmp_buf), "%X.", &tm))
@@ -70,10 +117,9 @@ void LogDispatcher::CreateLogLinePrefix(std::ostringstream& serr)
         out_prefix = prefix;
     }
 
-    // Note: ThreadName::get needs a buffer of size min. ThreadName::BUFSIZE
-    if ( !isset(SRT_LOGF_DISABLE_THREADNAME) && ThreadName::get(tmp_buf) )
+    if ( !isset(SRT_LOGF_DISABLE_THREADNAME) && threadname )
     {
-        serr << "/" << tmp_buf << out_prefix << ": ";
+        serr << "/" << threadname << out_prefix << ": ";
     }
     else
     {
@@ -81,6 +127,28 @@ void LogDispatcher::CreateLogLinePrefix(std::ostringstream& serr)
     }
 }
 
+std::string LogFormatTime(int64_t ticks)
+{
+    using namespace srt::sync;
+    return FormatTime(steady_clock::time_point(steady_clock::duration(ticks)));
+}
+
+void LogDispatcher::SendLogRecord(const LogRecord& rec, const char* threadname)
+{
+    timeval tv;
+    tv.tv_sec  = (time_t) (rec.time_us / 1000000);
+    tv.tv_usec = (long) (rec.time_us % 1000000);
+
+    std::ostringstream serr;
+    CreateLogLinePrefix(serr, tv, threadname);
+    rec.print(serr);
+
+    if ( !isset(SRT_LOGF_DISABLE_EOL) )
+        serr << std::endl;
+
+    SendLogLine(rec.file, rec.line, rec.function, serr.str());
+}
+
 std::string LogDispatcher::Proxy::ExtractName(std::string pretty_function)
 {
     if ( pretty_function == "" )
@@ -19,6 +19,7 @@ written by
 
 #include <iostream>
 #include <iomanip>
+#include <limits>
 #include <set>
 #include <sstream>
 #include <cstdarg>
@@ -33,6 +34,7 @@ written by
 #include "utilities.h"
 #include "threadname.h"
 #include "logging_api.h"
+#include "logqueue.h"
 #include "sync.h"
 
 #ifdef __GNUC__
@@ -66,6 +68,18 @@ written by
 // Usage: LOGP(gglog.Debug, param1, param2, param3);
 #define LOGP(logdes, ...) if (logdes.CheckEnabled()) logdes.printloc(__FILE__, __LINE__, __FUNCTION__,##__VA_ARGS__)
 
+// LOGB writes the arguments in binary form, to be formatted later.
+// With SRT_LOGF_ASYNC set, the formatting and writing is done by a
+// background thread. Each {} in the format is replaced with the next
+// argument. The format must be a string literal.
+// Usage: LOGB(gglog.Debug, "@{}: sent %{}", log << m_SocketID << seqno);
+#define LOGB(logdes, fmt, args) if (logdes.CheckEnabled()) \
+{ \
+    srt_logging::LogDispatcher::BinaryProxy log(logdes, fmt); \
+    log.setloc(__FILE__, __LINE__, __FUNCTION__); \
+    { (void)(const srt_logging::LogDispatcher::BinaryProxy&)(args); } \
+}
+
 #define IF_LOGGING(instr) instr
 
 #if ENABLE_HEAVY_LOGGING
@@ -73,6 +87,7 @@ written by
 #define HLOGC LOGC
 #define HLOGP LOGP
 #define HLOGF LOGF
+#define HLOGB LOGB
 
 #define IF_HEAVY_LOGGING(instr,...) instr,##__VA_ARGS__
 
@@ -81,6 +96,7 @@ written by
 #define HLOGC(...)
 #define HLOGF(...)
 #define HLOGP(...)
+#define HLOGB(...)
 
 #define IF_HEAVY_LOGGING(instr) (void)0
 
@@ -91,10 +107,12 @@ written by
 #define LOGC(...)
 #define LOGF(...)
 #define LOGP(...)
+#define LOGB(...)
 
 #define HLOGC(...)
 #define HLOGF(...)
 #define HLOGP(...)
+#define HLOGB(...)
 
 #define IF_HEAVY_LOGGING(instr) (void)0
 #define IF_LOGGING(instr) (void)0
@@ -194,7 +212,9 @@ public:
     bool CheckEnabled();
 
     void CreateLogLinePrefix(std::ostringstream&);
+    void CreateLogLinePrefix(std::ostringstream&, const timeval& tv, const char* threadname /*[[nullable]]*/);
     void SendLogLine(const char* file, int line, const std::string& area, const std::string& sl);
+    void SendLogRecord(const LogRecord& rec, const char* threadname /*[[nullable]]*/);
 
     // log.Debug("This is the ", nth, " time");  <--- C++11 only.
     // log.Debug() << "This is the " << nth << " time";  <--- C++03 available.
@@ -237,6 +257,9 @@ public:
     struct Proxy;
     friend struct Proxy;
 
+    struct BinaryProxy;
+    friend struct BinaryProxy;
+
     Proxy operator()();
 #else
 
@@ -387,6 +410,126 @@ struct LogDispatcher::Proxy
     }
 };
 
+// Puts a LOGB argument into the record: numbers as they are,
+// everything else formatted as text.
+template <class T, bool IS_NUMBER = std::numeric_limits<T>::is_specialized>
+struct LogArg
+{
+    static void add(LogRecord& rec, const T& arg)
+    {
+        std::ostringstream os;
+        os << arg;
+        const std::string s = os.str();
+        rec.addText(s.data(), s.size());
+    }
+};
+
+template <class T>
+struct LogArg<T, true>
+{
+    static void add(LogRecord& rec, const T& arg)
+    {
+        if (!std::numeric_limits<T>::is_integer)
+            rec.addDouble(double(arg));
+        else if (std::numeric_limits<T>::is_signed)
+            rec.addInt(int64_t(arg));
+        else
+            rec.addUInt(uint64_t(arg));
+    }
+};
+
+// Printed as characters, as with LOGC.
+template <> struct LogArg<char, true> { static void add(LogRecord& rec, char arg) { rec.addChar(arg); } };
+template <> struct LogArg<signed char, true> { static void add(LogRecord& rec, signed char arg) { rec.addChar(char(arg)); } };
+template <> struct LogArg<unsigned char, true> { static void add(LogRecord& rec, unsigned char arg) { rec.addChar(char(arg)); } };
+template <> struct LogArg<bool, true> { static void add(LogRecord& rec, bool arg) { rec.addBool(arg); } };
+template <> struct LogArg<char*, false> { static void add(LogRecord& rec, const char* arg) { rec.addText(arg, strlen(arg)); } };
+
+template <class T>
+struct LogArg<srt::sync::atomic<T>, false>
+{
+    static void add(LogRecord& rec, const srt::sync::atomic<T>& arg) { LogArg<T>::add(rec, arg.load()); }
+};
+
+template <> struct LogArg<LogDeferred, false> { static void add(LogRecord& rec, const LogDeferred& arg) { rec.addDeferred(arg); } };
+
+// FormatTime() of the time kept in ticks.
+std::string LogFormatTime(int64_t ticks);
+
+// Printed as FormatTime() does, when the record is written.
+template <>
+struct LogArg<srt::sync::steady_clock::time_point, false>
+{
+    static void add(LogRecord& rec, const srt::sync::steady_clock::time_point& arg)
+    {
+        rec.addDeferred(LogDeferred(&LogFormatTime, arg.time_since_epoch().count()));
+    }
+};
+
+struct LogDispatcher::BinaryProxy
+{
+    LogDispatcher& that;
+    LogRing*       ring;  // NULL if the record is written synchronously
+    LogRecord*     rec;   // NULL if the record is lost
+    LogRecord      local; // The record written synchronously
+
+    BinaryProxy(LogDispatcher& guy, const char* fmt);
+    ~BinaryProxy();
+
+    BinaryProxy& setloc(const char* f, int l, const char* func)
+    {
+        if (rec)
+        {
+            rec->file     = f;
+            rec->line     = l;
+            rec->function = func;
+        }
+        return *this;
+    }
+
+    template <class T>
+    BinaryProxy& operator<<(const T& arg)
+    {
+        if (rec)
+            LogArg<T>::add(*rec, arg);
+        return *this;
+    }
+
+    BinaryProxy& operator<<(const char* arg)
+    {
+        if (rec)
+            rec->addText(arg, strlen(arg));
+        return *this;
+    }
+
+    // Character buffers, which otherwise bind to the template.
+    template <size_t N>
+    BinaryProxy& operator<<(const char (&arg)[N])
+    {
+        if (rec)
+            rec->addText(arg, strlen(arg));
+        return *this;
+    }
+
+    BinaryProxy& operator<<(const std::string& arg)
+    {
+        if (rec)
+            rec->addText(arg.data(), arg.size());
+        return *this;
+    }
+
+    BinaryProxy& operator<<(const void* arg)
+    {
+        if (rec)
+            rec->addPtr(arg);
+        return *this;
+    }
+
+private:
+    BinaryProxy(const BinaryProxy&);
+    BinaryProxy& operator=(const BinaryProxy&);
+};
+
 
 #endif
 
@@ -0,0 +1,411 @@
+/*
+ * SRT - Secure, Reliable, Transport
+ * Copyright (c) 2021 Haivision Systems Inc.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ */
+#include "platform_sys.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "logqueue.h"
+#include "logging.h"
+#include "threadname.h"
+
+using namespace srt::sync;
+
+namespace srt_logging
+{
+
+#if ENABLE_LOGGING
+
+void LogRecord::reset(LogDispatcher* d, const char* fmt)
+{
+    timeval tv;
+    gettimeofday(&tv, NULL);
+
+    dispatcher = d;
+    format     = fmt;
+    file       = "";
+    function   = "";
+    line       = 0;
+    time_us    = int64_t(tv.tv_sec) * 1000000 + tv.tv_usec;
+    nargs      = 0;
+    text_len   = 0;
+}
+
+void LogRecord::addText(const char* s, size_t len)
+{
+    Arg* a = next(ARG_TEXT);
+    if (!a)
+        return;
+
+    len = std::min(len, TEXT_SIZE - text_len);
+    memcpy(text + text_len, s, len);
+    a->text.off = text_len;
+    a->text.len = (unsigned char)len;
+    text_len    = (unsigned char)(text_len + len);
+}
+
+static void PrintArg(std::ostream& os, unsigned char type, const LogRecord::Arg& a, const char* text)
+{
+    switch (type)
+    {
+    case LogRecord::ARG_INT:    os << a.i; break;
+    case LogRecord::ARG_UINT:   os << a.u; break;
+    case LogRecord::ARG_DOUBLE: os << a.d; break;
+    case LogRecord::ARG_CHAR:   os << char(a.i); break;
+    case LogRecord::ARG_BOOL:   os << bool(a.i != 0); break;
+    case LogRecord::ARG_PTR:    os << a.p; break;
+    case LogRecord::ARG_TEXT:   os.write(text + a.text.off, a.text.len); break;
+    case LogRecord::ARG_DEFERRED: os << a.deferred.fn(a.deferred.value); break;
+    default: break;
+    }
+}
+
+void LogRecord::print(std::ostream& os) const
+{
+    size_t      argi = 0;
+    const char* p    = format;
+    for (;;)
+    {
+        const char* mark = strstr(p, "{}");
+        if (!mark || argi == nargs)
+        {
+            os << p;
+            break;
+        }
+        os.write(p, mark - p);
+        PrintArg(os, types[argi], args[argi], text);
+        ++argi;
+        p = mark + 2;
+    }
+
+    for (; argi < nargs; ++argi)
+    {
+        os << " ";
+        PrintArg(os, types[argi], args[argi], text);
+    }
+}
+
+// Single-producer single-consumer ring of records. The producer is the
+// thread owning the ring, the consumer is whoever holds m_DrainLock.
+// The indexes run freely and wrap around at 2^32, which SIZE divides.
+// The last free slot is kept for the report of the dropped records.
+class LogRing
+{
+public:
+    static const uint32_t SIZE = 256;
+
+    // Set in m_iDropState while the report is in the ring.
+    static const uint32_t DROP_REPORT_QUEUED = 0x80000000;
+
+    LogRing()
+        : m_iDropState(0)
+        , m_iHead(0)
+        , m_iTail(0)
+        , m_bOrphan(false)
+    {
+        m_ThreadName[0] = '\0';
+    }
+
+    LogRecord* reserve()
+    {
+        const uint32_t tail = m_iTail.load();
+        if (tail - m_iHead.load() >= SIZE - 1)
+            return NULL;
+        return &m_Records[tail % SIZE];
+    }
+
+    /// Count a dropped record.
+    /// @return the slot for the report of the drop, or NULL if it is already queued
+    LogRecord* drop()
+    {
+        for (;;)
+        {
+            const uint32_t state = m_iDropState.load();
+            const bool     queue = !(state & DROP_REPORT_QUEUED);
+            if (m_iDropState.compare_exchange(state, (state + 1) | DROP_REPORT_QUEUED))
+                return queue ? &m_Records[m_iTail.load() % SIZE] : NULL;
+        }
+    }
+
+    /// Take the number of records dropped so far, after the report was taken
+    /// from the ring, so that the next drop queues a new one.
+    uint32_t takeDropped() { return m_iDropState.exchange(0) & ~DROP_REPORT_QUEUED; }
+
+    /// @return number of records in the ring
+    uint32_t commit()
+    {
+        const uint32_t tail = m_iTail.load() + 1;
+        m_iTail.store(tail);
+        return tail - m_iHead.load();
+    }
+
+    uint32_t head() const { return m_iHead.load(); }
+    uint32_t tail() const { return m_iTail.load(); }
+    const LogRecord& at(uint32_t pos) const { return m_Records[pos % SIZE]; }
+    void pop() { m_iHead.store(m_iHead.load() + 1); }
+
+    // The thread name is taken once, when the thread writes its first
+    // record, as reading it is a system call on some platforms.
+    char m_ThreadName[srt::ThreadName::BUFSIZE];
+
+    atomic<uint32_t> m_iDropState; // Records dropped and not reported yet, and DROP_REPORT_QUEUED
+
+    atomic<uint32_t> m_iHead;
+    atomic<uint32_t> m_iTail;
+    atomic<bool>     m_bOrphan; // The owning thread has exited
+
+private:
+    LogRecord m_Records[SIZE];
+};
+
+#ifdef ENABLE_STDCXX_SYNC
+
+struct ThreadRing
+{
+    LogRing* ring;
+
+    ThreadRing()
+        : ring(NULL)
+    {
+    }
+
+    ~ThreadRing()
+    {
+        if (ring)
+            LogQueue::releaseRing(ring);
+    }
+};
+
+static thread_local ThreadRing s_ThreadRing;
+
+static LogRing* getThreadRing() { return s_ThreadRing.ring; }
+static void     setThreadRing(LogRing* ring) { s_ThreadRing.ring = ring; }
+
+#else
+
+static pthread_key_t s_ThreadRingKey;
+
+static void ThreadRingKeyDestroy(void* ring)
+{
+    LogQueue::releaseRing((LogRing*)ring);
+}
+
+static LogRing* getThreadRing() { return (LogRing*)pthread_getspecific(s_ThreadRingKey); }
+static void     setThreadRing(LogRing* ring) { pthread_setspecific(s_ThreadRingKey, ring); }
+
+#endif
+
+// Period of writing out the records when the rings are not getting full.
+static const int DRAIN_PERIOD_MS = 50;
+
+bool LogQueue::s_bClosed = false;
+
+static const char s_DropReportFormat[] = "{} log records dropped, the log queue was full";
+
+LogQueue& LogQueue::instance()
+{
+    static LogQueue queue;
+    return queue;
+}
+
+LogQueue::LogQueue()
+    : m_bRunning(false)
+    , m_bStop(false)
+    , m_iOverflow(0)
+{
+    setupCond(m_DrainCond, "LogDrain");
+#ifndef ENABLE_STDCXX_SYNC
+    pthread_key_create(&s_ThreadRingKey, ThreadRingKeyDestroy);
+#endif
+}
+
+LogQueue::~LogQueue()
+{
+    {
+        ScopedLock lk(m_RingsLock);
+        m_bStop = true;
+    }
+    m_DrainCond.notify_one();
+    if (m_DrainThread.joinable())
+        m_DrainThread.join();
+
+    drain();
+
+    // Threads still running may have a ring and write into it.
+    // Their records are from now on written synchronously.
+    s_bClosed = true;
+#ifndef ENABLE_STDCXX_SYNC
+    pthread_key_delete(s_ThreadRingKey);
+#endif
+    for (size_t i = 0; i < m_Rings.size(); ++i)
+        delete m_Rings[i];
+    releaseCond(m_DrainCond);
+}
+
+LogRecord* LogQueue::reserve(LogDispatcher& d, LogRing*& w_ring)
+{
+    w_ring = NULL;
+    if (s_bClosed)
+        return NULL;
+
+    LogRing* ring = getThreadRing();
+    if (!ring)
+    {
+        ring = createRing();
+        if (!ring)
+            return NULL;
+        setThreadRing(ring);
+    }
+
+    w_ring = ring;
+    LogRecord* rec = ring->reserve();
+    if (rec)
+        return rec;
+
+    ++m_iOverflow;
+    if (LogRecord* report = ring->drop())
+    {
+        // Tell in the log where the records are missing. The number
+        // is filled in when written, to cover the drops until then.
+        report->reset(&d, s_DropReportFormat);
+        commit(ring);
+    }
+    return NULL;
+}
+
+void LogQueue::commit(LogRing* ring)
+{
+    // Wake up the writing thread before the ring gets full,
+    // otherwise let it come at its own pace.
+    if (ring->commit() == LogRing::SIZE / 2)
+        m_DrainCond.notify_one();
+}
+
+void LogQueue::flush()
+{
+    drain();
+}
+
+void LogQueue::releaseRing(LogRing* ring)
+{
+    if (!s_bClosed)
+        ring->m_bOrphan = true;
+}
+
+LogRing* LogQueue::createRing()
+{
+    LogRing* ring = new (std::nothrow) LogRing;
+    if (!ring)
+        return NULL;
+
+    if (!srt::ThreadName::get(ring->m_ThreadName))
+        ring->m_ThreadName[0] = '\0';
+
+    ScopedLock lk(m_RingsLock);
+    if (!m_bRunning)
+    {
+        if (!StartThread(m_DrainThread, LogQueue::drainThread, this, "SRT:Log"))
+        {
+            delete ring;
+            return NULL;
+        }
+        m_bRunning = true;
+    }
+    m_Rings.push_back(ring);
+    return ring;
+}
+
+void LogQueue::drain()
+{
+    ScopedLock dl(m_DrainLock);
+
+    std::vector<LogRing*> rings;
+    {
+        ScopedLock lk(m_RingsLock);
+        rings = m_Rings;
+    }
+
+    // Take only the records that are there now, so that threads
+    // logging all the time don't keep the caller of flush() here.
+    std::vector<uint32_t> ends(rings.size());
+    for (size_t i = 0; i < rings.size(); ++i)
+        ends[i] = rings[i]->tail();
+
+    // Records of different threads are merged in the order of their time.
+    for (;;)
+    {
+        LogRing*         first = NULL;
+        const LogRecord* rec   = NULL;
+        for (size_t i = 0; i < rings.size(); ++i)
+        {
+            const uint32_t head = rings[i]->head();
+            if (head == ends[i])
+                continue;
+            const LogRecord& r = rings[i]->at(head);
+            if (!rec || r.time_us < rec->time_us)
+            {
+                first = rings[i];
+                rec   = &r;
+            }
+        }
+        if (!first)
+            break;
+
+        const bool has_name = first->m_ThreadName[0] != '\0';
+        if (rec->format == s_DropReportFormat)
+        {
+            // Free the slot first, so that a drop after
+            // taking the number queues a new report.
+            LogRecord report = *rec;
+            first->pop();
+            report.addUInt(first->takeDropped());
+            report.dispatcher->SendLogRecord(report, has_name ? first->m_ThreadName : NULL);
+            continue;
+        }
+        rec->dispatcher->SendLogRecord(*rec, has_name ? first->m_ThreadName : NULL);
+        first->pop();
+    }
+
+    // The rings of the threads that have exited are deleted when empty.
+    // The flag must be read before the ring is checked for records.
+    ScopedLock lk(m_RingsLock);
+    for (size_t i = 0; i < m_Rings.size();)
+    {
+        LogRing* ring = m_Rings[i];
+        if (ring->m_bOrphan && ring->head() == ring->tail())
+        {
+            delete ring;
+            m_Rings.erase(m_Rings.begin() + i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+void* LogQueue::drainThread(void* arg)
+{
+    LogQueue* self = (LogQueue*)arg;
+
+    UniqueLock lk(self->m_RingsLock);
+    while (!self->m_bStop)
+    {
+        self->m_DrainCond.wait_for(lk, milliseconds_from(DRAIN_PERIOD_MS));
+        lk.unlock();
+        self->drain();
+        lk.lock();
+    }
+    return NULL;
+}
+
+#endif // ENABLE_LOGGING
+
+} // namespace srt_logging
@@ -0,0 +1,215 @@
+/*
+ * SRT - Secure, Reliable, Transport
+ * Copyright (c) 2021 Haivision Systems Inc.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ */
+
+#ifndef INC_SRT_LOGQUEUE_H
+#define INC_SRT_LOGQUEUE_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "atomic.h"
+#include "sync.h"
+
+namespace srt_logging
+{
+
+struct LogDispatcher;
+class LogRing;
+
+/// Formats a LOGB argument kept as a number until the record is written.
+typedef std::string LogFormatFn(int64_t value);
+
+/// @brief A LOGB argument formatted with @a fn only when the record is
+/// written, so that in the asynchronous mode the logging thread doesn't
+/// pay for the formatting.
+struct LogDeferred
+{
+    LogFormatFn* fn;
+    int64_t      value;
+
+    LogDeferred(LogFormatFn* f, int64_t v)
+        : fn(f)
+        , value(v)
+    {
+    }
+};
+
+/// @brief A log line in binary form, as written by the LOGB log sites.
+///
+/// The format string identifies the log site and is kept as a pointer,
+/// so it must be a string literal. Each "{}" in it is replaced with the
+/// next argument when the record is formatted. Numbers are kept as they
+/// are; strings and values of other types are copied as text, truncated
+/// to what fits in the record.
+struct LogRecord
+{
+    static const size_t MAX_ARGS  = 12;
+    static const size_t TEXT_SIZE = 96;
+
+    enum ArgType
+    {
+        ARG_INT,
+        ARG_UINT,
+        ARG_DOUBLE,
+        ARG_CHAR,
+        ARG_BOOL,
+        ARG_PTR,
+        ARG_TEXT,
+        ARG_DEFERRED
+    };
+
+    union Arg
+    {
+        int64_t     i;
+        uint64_t    u;
+        double      d;
+        const void* p;
+        struct
+        {
+            unsigned char off;
+            unsigned char len;
+        } text;
+        struct
+        {
+            int64_t      value;
+            LogFormatFn* fn;
+        } deferred;
+    };
+
+    LogDispatcher* dispatcher;
+    const char*    format;
+    const char*    file;
+    const char*    function;
+    int            line;
+    int64_t        time_us; // Wall clock time, microseconds since epoch
+
+    unsigned char nargs;
+    unsigned char text_len;
+    unsigned char types[MAX_ARGS];
+    Arg           args[MAX_ARGS];
+    char          text[TEXT_SIZE];
+
+    void reset(LogDispatcher* d, const char* fmt);
+
+    // Arguments over MAX_ARGS are dropped.
+    void addInt(int64_t v)
+    {
+        if (Arg* a = next(ARG_INT))
+            a->i = v;
+    }
+    void addUInt(uint64_t v)
+    {
+        if (Arg* a = next(ARG_UINT))
+            a->u = v;
+    }
+    void addDouble(double v)
+    {
+        if (Arg* a = next(ARG_DOUBLE))
+            a->d = v;
+    }
+    void addChar(char v)
+    {
+        if (Arg* a = next(ARG_CHAR))
+            a->i = v;
+    }
+    void addBool(bool v)
+    {
+        if (Arg* a = next(ARG_BOOL))
+            a->i = v;
+    }
+    void addPtr(const void* v)
+    {
+        if (Arg* a = next(ARG_PTR))
+            a->p = v;
+    }
+    void addDeferred(const LogDeferred& v)
+    {
+        if (Arg* a = next(ARG_DEFERRED))
+        {
+            a->deferred.value = v.value;
+            a->deferred.fn    = v.fn;
+        }
+    }
+    void addText(const char* s, size_t len);
+
+    /// Write the message with the arguments put in place of the "{}" marks.
+    /// Arguments without a mark are appended, separated with a space.
+    void print(std::ostream& os) const;
+
+private:
+    Arg* next(ArgType type)
+    {
+        if (nargs == MAX_ARGS)
+            return NULL;
+        types[nargs] = (unsigned char)type;
+        return &args[nargs++];
+    }
+};
+
+/// @brief Queue of the log records written in the asynchronous mode
+/// (SRT_LOGF_ASYNC).
+///
+/// Every thread writes its records into its own ring, without locking.
+/// A background thread takes the records from all the rings, in the
+/// order of their time, formats them and passes them to the log handler
+/// or stream. When the ring of a thread is full, the record is dropped
+/// and counted as lost, so that the logging thread never waits. The next
+/// record that fits is preceded by a record telling how many were dropped.
+class LogQueue
+{
+public:
+    static LogQueue& instance();
+
+    /// Get a record in the ring of the calling thread, to be passed on
+    /// with commit().
+    /// @param d the dispatcher of the record, also writing the report
+    ///          of the records dropped before
+    /// @param [out] w_ring the ring of the calling thread, or NULL if
+    ///              it could not be created
+    /// @return the record, or NULL if the ring is full or could not be created
+    LogRecord* reserve(LogDispatcher& d, LogRing*& w_ring);
+
+    /// Pass the record obtained from reserve() to the writing thread.
+    void commit(LogRing* ring);
+
+    /// Write out the records queued so far, in the calling thread.
+    void flush();
+
+    /// Number of records dropped because the ring was full.
+    uint64_t overflow() const { return m_iOverflow.load(); }
+
+    /// Called on exit of the thread owning the ring. The ring is deleted
+    /// when all its records are written out.
+    static void releaseRing(LogRing* ring);
+
+private:
+    LogQueue();
+    ~LogQueue();
+
+    LogRing* createRing();
+    void     drain();
+
+    static void* drainThread(void* arg);
+
+    srt::sync::Mutex            m_RingsLock; // Protects m_Rings and the thread state
+    std::vector<LogRing*>       m_Rings;
+    srt::sync::Mutex            m_DrainLock; // Held while the records are taken from the rings
+    srt::sync::Condition        m_DrainCond;
+    srt::sync::CThread          m_DrainThread;
+    bool                        m_bRunning;
+    srt::sync::atomic<bool>     m_bStop;
+    srt::sync::atomic<uint64_t> m_iOverflow;
+
+    static bool s_bClosed; // Set when the queue is destroyed at exit
+};
+
+} // namespace srt_logging
+
+#endif // INC_SRT_LOGQUEUE_H
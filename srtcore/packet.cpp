@@ -585,6 +585,16 @@ inline void SprintSpecialWord(std::ostream& os, int32_t val)
 }
 
 #if ENABLE_LOGGING
+static std::string FormatMessageFlags(int64_t msgno_field)
+{
+    return PacketMessageFlagStr(uint32_t(msgno_field));
+}
+
+srt_logging::LogDeferred CPacket::MessageFlags() const
+{
+    return srt_logging::LogDeferred(&FormatMessageFlags, m_nHeader[SRT_PH_MSGNO]);
+}
+
 std::string CPacket::Info()
 {
     std::ostringstream os;
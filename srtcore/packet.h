@@ -58,6 +58,7 @@ modified by
 #include "utilities.h"
 #include "netinet_any.h"
 #include "packetfilter_api.h"
+#include "logqueue.h"
 
 namespace srt
 {
@@ -392,6 +393,8 @@ public:
 
 #if ENABLE_LOGGING
     std::string MessageFlagStr() { return PacketMessageFlagStr(m_nHeader[SRT_PH_MSGNO]); }
+    /// The message flags for a LOGB argument, formatted only when written.
+    srt_logging::LogDeferred MessageFlags() const;
     std::string Info();
 #else
     std::string           MessageFlagStr() { return std::string(); }
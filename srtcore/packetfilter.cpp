@@ -129,16 +129,15 @@ void PacketFilter::receive(CUnit* unit, std::vector<CUnit*>& w_incoming, loss_se
 
     if (m_filter->receive(rpkt, w_loss_seqs))
     {
-        // For the sake of rebuilding MARK THIS UNIT GOOD, otherwise the
+        // For the sake of rebuilding MARK THIS UNIT TAKEN, otherwise the
         // unit factory will supply it from getNextAvailUnit() as if it were not in use.
-        unit->m_bTaken = true;
+        m_unitq->makeUnitTaken(unit);
         HLOGC(pflog.Debug, log << "FILTER: PASSTHRU current packet %" << unit->m_Packet.getSeqNo());
         w_incoming.push_back(unit);
     }
     else
     {
         // Packet not to be passthru, update stats
-        ScopedLock lg(m_parent->m_StatsLock);
         m_parent->m_stats.rcvr.recvdFilterExtra.count(1);
     }
 
@@ -151,7 +150,6 @@ void PacketFilter::receive(CUnit* unit, std::vector<CUnit*>& w_incoming, loss_se
         int dist = CSeqNo::seqoff(i->first, i->second) + 1;
         if (dist > 0)
         {
-            ScopedLock lg(m_parent->m_StatsLock);
             m_parent->m_stats.rcvr.lossFilter.count(dist);
         }
         else
@@ -169,21 +167,18 @@ void PacketFilter::receive(CUnit* unit, std::vector<CUnit*>& w_incoming, loss_se
         size_t nsupply = m_provided.size();
         InsertRebuilt(w_incoming, m_unitq);
 
-        ScopedLock lg(m_parent->m_StatsLock);
         m_parent->m_stats.rcvr.suppliedByFilter.count((uint32_t)nsupply);
     }
 
     // Now that all units have been filled as they should be,
     // SET THEM ALL FREE. This is because now it's up to the 
     // buffer to decide as to whether it wants them or not.
-    // Wanted units will be set GOOD flag, unwanted will remain
-    // with FREE and therefore will be returned at the next
+    // Wanted units will be taken again, unwanted will remain
+    // free and therefore will be returned at the next
     // call to getNextAvailUnit().
-    unit->m_bTaken = false;
     for (vector<CUnit*>::iterator i = w_incoming.begin(); i != w_incoming.end(); ++i)
     {
-        CUnit* u = *i;
-        u->m_bTaken = false;
+        m_unitq->makeUnitFree(*i);
     }
 
     // Packets must be sorted by sequence number, ascending, in order
@@ -254,7 +249,7 @@ void PacketFilter::InsertRebuilt(vector<CUnit*>& incoming, CUnitQueue* uq)
 
         // LOCK the unit as taken because otherwise the next
         // call to getNextAvailUnit will return THE SAME UNIT.
-        u->m_bTaken = true;
+        uq->makeUnitTaken(u);
         // After returning from this function, all units will be
         // set back to FREE so that the buffer can decide whether
         // it wants them or not.
@@ -314,6 +309,8 @@ PacketFilter::Internal::Internal()
 
     m_filters["fec"] = new PacketFilter::Creator<FECFilterBuiltin>;
     m_builtin_filters.insert("fec");
+    m_filters["rsfec"] = new PacketFilter::Creator<RSFilterBuiltin>;
+    m_builtin_filters.insert("rsfec");
 }
 
 bool PacketFilter::configure(CUDT* parent, CUnitQueue* uq, const std::string& confstr)
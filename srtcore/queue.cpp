@@ -53,6 +53,7 @@ modified by
 #include "platform_sys.h"
 
 #include <cstring>
+#include <algorithm>
 
 #include "common.h"
 #include "api.h"
@@ -66,21 +67,20 @@ using namespace srt::sync;
 using namespace srt_logging;
 
 srt::CUnitQueue::CUnitQueue(int initNumUnits, int mss)
-    : m_iNumTaken(0)
+    : m_pQEntry(NULL)
+    , m_pFreeHead(NULL)
+    , m_iSize(0)
+    , m_iNumTaken(0)
+    , m_iPeakTaken(0)
+    , m_iShrinkCount(0)
     , m_iMSS(mss)
     , m_iBlockSize(initNumUnits)
 {
-    CQEntry* tempq = allocateEntry(m_iBlockSize, m_iMSS);
-
-    if (tempq == NULL)
+    ScopedLock lk(m_FreeLock);
+    if (increase_() == -1)
         throw CUDTException(MJ_SYSTEMRES, MN_MEMORY);
 
-    m_pQEntry = m_pCurrQueue = m_pLastQueue = tempq;
-    m_pQEntry->m_pNext = m_pQEntry;
-
-    m_pAvailUnit = m_pCurrQueue->m_pUnit;
-
-    m_iSize = m_iBlockSize;
+    m_tsLastShrinkCheck = steady_clock::now();
 }
 
 srt::CUnitQueue::~CUnitQueue()
@@ -93,10 +93,7 @@ srt::CUnitQueue::~CUnitQueue()
         delete[] p->m_pBuffer;
 
         CQEntry* q = p;
-        if (p == m_pLastQueue)
-            p = NULL;
-        else
-            p = p->m_pNext;
+        p = p->m_pNext;
         delete q;
     }
 }
@@ -126,12 +123,16 @@ srt::CUnitQueue::CQEntry* srt::CUnitQueue::allocateEntry(const int iNumUnits, co
     for (int i = 0; i < iNumUnits; ++i)
     {
         tempu[i].m_bTaken = false;
+        tempu[i].m_bDecrypted = false;
         tempu[i].m_Packet.m_pcData = tempb + i * mss;
+        tempu[i].m_pPrevFree = NULL;
+        tempu[i].m_pNextFree = NULL;
     }
 
     tempq->m_pUnit   = tempu;
     tempq->m_pBuffer = tempb;
     tempq->m_iSize   = iNumUnits;
+    tempq->m_pNext   = NULL;
 
     return tempq;
 }
@@ -145,79 +146,388 @@ int srt::CUnitQueue::increase_()
     if (tempq == NULL)
         return -1;
 
-    m_pLastQueue->m_pNext = tempq;
-    m_pLastQueue          = tempq;
-    m_pLastQueue->m_pNext = m_pQEntry;
+    tempq->m_pNext = m_pQEntry;
+    m_pQEntry      = tempq;
 
-    m_iSize += numUnits;
+    // Push in reverse order so that the units are handed out in memory order.
+    for (int i = numUnits - 1; i >= 0; --i)
+        pushFree(&tempq->m_pUnit[i]);
+
+    m_iSize = m_iSize + numUnits;
 
     return 0;
 }
 
+void srt::CUnitQueue::pushFree(CUnit* unit)
+{
+    unit->m_pPrevFree = NULL;
+    unit->m_pNextFree = m_pFreeHead;
+    if (m_pFreeHead)
+        m_pFreeHead->m_pPrevFree = unit;
+    m_pFreeHead = unit;
+}
+
+void srt::CUnitQueue::unlinkFree(CUnit* unit)
+{
+    if (unit->m_pPrevFree)
+        unit->m_pPrevFree->m_pNextFree = unit->m_pNextFree;
+    else
+        m_pFreeHead = unit->m_pNextFree;
+
+    if (unit->m_pNextFree)
+        unit->m_pNextFree->m_pPrevFree = unit->m_pPrevFree;
+
+    unit->m_pPrevFree = unit->m_pNextFree = NULL;
+}
+
 srt::CUnit* srt::CUnitQueue::getNextAvailUnit()
 {
-    const int iNumUnitsTotal = capacity();
-    if (m_iNumTaken * 10 > iNumUnitsTotal * 9) // 90% or more are in use.
+    ScopedLock lk(m_FreeLock);
+    if (m_iNumTaken * 10 > m_iSize * 9) // 90% or more are in use.
         increase_();
 
-    if (m_iNumTaken >= capacity())
+    if (m_pFreeHead == NULL)
     {
         LOGC(qrlog.Error, log << "CUnitQueue: No free units to take. Capacity" << capacity() << ".");
         return NULL;
     }
 
-    int units_checked = 0;
-    do
-    {
-        const CUnit* end = m_pCurrQueue->m_pUnit + m_pCurrQueue->m_iSize;
-        for (; m_pAvailUnit != end; ++m_pAvailUnit, ++units_checked)
-        {
-            if (!m_pAvailUnit->m_bTaken)
-            {
-                return m_pAvailUnit;
-            }
-        }
-
-        m_pCurrQueue = m_pCurrQueue->m_pNext;
-        m_pAvailUnit = m_pCurrQueue->m_pUnit;
-    } while (units_checked < m_iSize);
-
-    return NULL;
+    m_pFreeHead->m_bDecrypted = false;
+    return m_pFreeHead;
 }
 
 void srt::CUnitQueue::makeUnitFree(CUnit* unit)
 {
     SRT_ASSERT(unit != NULL);
+    ScopedLock lk(m_FreeLock);
     SRT_ASSERT(unit->m_bTaken);
     unit->m_bTaken.store(false);
+    pushFree(unit);
 
     --m_iNumTaken;
 }
 
 void srt::CUnitQueue::makeUnitTaken(CUnit* unit)
 {
-    ++m_iNumTaken;
-
     SRT_ASSERT(unit != NULL);
+    ScopedLock lk(m_FreeLock);
     SRT_ASSERT(!unit->m_bTaken);
+    unlinkFree(unit);
     unit->m_bTaken.store(true);
+
+    ++m_iNumTaken;
+    if (m_iNumTaken > m_iPeakTaken)
+        m_iPeakTaken = m_iNumTaken;
+}
+
+int srt::CUnitQueue::shrink(const steady_clock::time_point& now)
+{
+    ScopedLock lk(m_FreeLock);
+    if (now - m_tsLastShrinkCheck < milliseconds_from(SHRINK_PERIOD_MS))
+        return 0;
+
+    const int peak = m_iPeakTaken;
+    m_iPeakTaken        = m_iNumTaken;
+    m_tsLastShrinkCheck = now;
+
+    int      released = 0;
+    CQEntry* prev     = NULL;
+    CQEntry* p        = m_pQEntry;
+    while (p != NULL)
+    {
+        const int remaining = m_iSize - p->m_iSize;
+        // Keep the initial capacity and leave enough free units not to grow again right away.
+        if (remaining < m_iBlockSize || peak * 2 > remaining)
+            break;
+
+        bool all_free = true;
+        for (int i = 0; i < p->m_iSize; ++i)
+        {
+            if (p->m_pUnit[i].m_bTaken)
+            {
+                all_free = false;
+                break;
+            }
+        }
+
+        if (!all_free)
+        {
+            prev = p;
+            p    = p->m_pNext;
+            continue;
+        }
+
+        for (int i = 0; i < p->m_iSize; ++i)
+            unlinkFree(&p->m_pUnit[i]);
+
+        CQEntry* next = p->m_pNext;
+        if (prev)
+            prev->m_pNext = next;
+        else
+            m_pQEntry = next;
+
+        m_iSize = remaining;
+        released += p->m_iSize;
+
+        delete[] p->m_pUnit;
+        delete[] p->m_pBuffer;
+        delete p;
+        p = next;
+    }
+
+    if (released > 0)
+    {
+        m_iShrinkCount.store(m_iShrinkCount.load() + 1);
+        HLOGC(qrlog.Debug, log << "CUnitQueue::shrink: released " << released << " units, capacity " << capacity()
+                               << ", " << m_iNumTaken << " in use, peak " << peak << ".");
+    }
+
+    return released;
 }
 
-srt::CSndUList::CSndUList(sync::CTimer* pTimer)
-    : m_pHeap(NULL)
-    , m_iArrayLength(512)
-    , m_iLastEntry(-1)
+void srt::CSndHeap::insert(CSNode* n)
+{
+    // do not insert repeated node
+    if (n->m_iHeapLoc >= 0)
+        return;
+
+    try
+    {
+        m_Heap.insert(n);
+    }
+    catch (const std::bad_alloc&)
+    {
+        throw CUDTException(MJ_SYSTEMRES, MN_MEMORY, 0);
+    }
+}
+
+void srt::CSndHeap::advance(CSNode* n, const steady_clock::time_point& ts)
+{
+    if (n->m_iHeapLoc < 0)
+        return;
+
+    n->m_tsTimeStamp = ts;
+    m_Heap.update(n);
+}
+
+namespace srt
+{
+// Index of the lowest set bit; mask must not be 0.
+static inline int lowestBit(uint64_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(mask);
+#else
+    int bit = 0;
+    while (!(mask & 1))
+    {
+        mask >>= 1;
+        ++bit;
+    }
+    return bit;
+#endif
+}
+}
+
+srt::CSndTimingWheel::CSndTimingWheel()
+    : m_tsBase(steady_clock::now())
+    , m_iNow(0)
+    , m_iCount(0)
+    , m_pTop(NULL)
+{
+    std::fill(m_pSlots, m_pSlots + FAR_SLOT + 1, (CSNode*)NULL);
+    std::fill(m_uMask, m_uMask + LEVELS, uint64_t(0));
+}
+
+int64_t srt::CSndTimingWheel::tick(const CSNode* n) const
+{
+    // Times earlier than the current tick are due already.
+    return std::max(count_microseconds(n->m_tsTimeStamp - m_tsBase), m_iNow);
+}
+
+void srt::CSndTimingWheel::link_(CSNode* n, int loc)
+{
+    n->m_pPrev = NULL;
+    n->m_pNext = m_pSlots[loc];
+    if (n->m_pNext)
+        n->m_pNext->m_pPrev = n;
+    m_pSlots[loc] = n;
+    n->m_iHeapLoc = loc;
+
+    if (loc < FAR_SLOT)
+        m_uMask[loc / SLOTS] |= uint64_t(1) << (loc % SLOTS);
+}
+
+void srt::CSndTimingWheel::unlink_(CSNode* n)
+{
+    const int loc = n->m_iHeapLoc;
+    if (n->m_pPrev)
+        n->m_pPrev->m_pNext = n->m_pNext;
+    else
+        m_pSlots[loc] = n->m_pNext;
+    if (n->m_pNext)
+        n->m_pNext->m_pPrev = n->m_pPrev;
+
+    if (!m_pSlots[loc] && loc < FAR_SLOT)
+        m_uMask[loc / SLOTS] &= ~(uint64_t(1) << (loc % SLOTS));
+
+    n->m_pPrev = n->m_pNext = NULL;
+    n->m_iHeapLoc = -1;
+}
+
+void srt::CSndTimingWheel::place_(CSNode* n)
+{
+    const int64_t t = tick(n);
+    for (int level = 0; level < LEVELS; ++level)
+    {
+        const int shift = LEVEL_BITS * (level + 1);
+        if ((t >> shift) == (m_iNow >> shift))
+        {
+            const int slot = int((t >> (LEVEL_BITS * level)) & (SLOTS - 1));
+            link_(n, level * SLOTS + slot);
+            return;
+        }
+    }
+
+    link_(n, FAR_SLOT);
+}
+
+void srt::CSndTimingWheel::insert(CSNode* n)
+{
+    // do not insert repeated node
+    if (n->m_iHeapLoc >= 0)
+        return;
+
+    // Nothing holds the current tick back, so bring it closer to the
+    // inserted node to spare cascading it later.
+    if (m_iCount == 0)
+        m_iNow = tick(n);
+
+    place_(n);
+    ++m_iCount;
+
+    if (m_pTop && n->m_tsTimeStamp < m_pTop->m_tsTimeStamp)
+        m_pTop = n;
+}
+
+void srt::CSndTimingWheel::remove(CSNode* n)
+{
+    if (n->m_iHeapLoc < 0)
+        return;
+
+    unlink_(n);
+    --m_iCount;
+
+    if (n == m_pTop)
+        m_pTop = NULL;
+}
+
+void srt::CSndTimingWheel::advance(CSNode* n, const steady_clock::time_point& ts)
+{
+    remove(n);
+    n->m_tsTimeStamp = ts;
+    insert(n);
+}
+
+bool srt::CSndTimingWheel::cascade_()
+{
+    for (int level = 1; level < LEVELS; ++level)
+    {
+        if (!m_uMask[level])
+            continue;
+
+        // All nodes in the slot are later than its beginning, and
+        // all other nodes are later than the slot.
+        const int     slot  = lowestBit(m_uMask[level]);
+        const int     shift = LEVEL_BITS * level;
+        const int64_t begin = ((m_iNow >> (shift + LEVEL_BITS)) << (shift + LEVEL_BITS)) | (int64_t(slot) << shift);
+        m_iNow              = std::max(m_iNow, begin);
+
+        const int loc  = level * SLOTS + slot;
+        CSNode*   list = m_pSlots[loc];
+        m_pSlots[loc]  = NULL;
+        m_uMask[level] &= ~(uint64_t(1) << slot);
+
+        while (list)
+        {
+            CSNode* n = list;
+            list      = n->m_pNext;
+            place_(n);
+        }
+        return true;
+    }
+
+    if (!m_pSlots[FAR_SLOT])
+        return false;
+
+    // The wheel is empty, so it can be moved to the earliest far node.
+    CSNode* list = m_pSlots[FAR_SLOT];
+    int64_t next = tick(list);
+    for (CSNode* n = list->m_pNext; n; n = n->m_pNext)
+        next = std::min(next, tick(n));
+
+    m_iNow              = next;
+    m_pSlots[FAR_SLOT] = NULL;
+    while (list)
+    {
+        CSNode* n = list;
+        list      = n->m_pNext;
+        place_(n);
+    }
+    return true;
+}
+
+srt::CSNode* srt::CSndTimingWheel::top()
+{
+    if (m_pTop || m_iCount == 0)
+        return m_pTop;
+
+    while (!m_uMask[0])
+    {
+        if (!cascade_())
+            return NULL;
+    }
+
+    // A slot of the lowest level is one tick, but the nodes due
+    // before the current tick are put in its slot, too.
+    CSNode* best = m_pSlots[lowestBit(m_uMask[0])];
+    for (CSNode* n = best->m_pNext; n; n = n->m_pNext)
+    {
+        if (n->m_tsTimeStamp < best->m_tsTimeStamp)
+            best = n;
+    }
+
+    // Nothing is scheduled earlier, so the current tick can follow.
+    m_iNow = tick(best);
+    m_pTop = best;
+    return best;
+}
+
+srt::CSndUList::CSndUList(sync::CTimer* pTimer, EScheduler sched)
+    : m_pSchedule(NULL)
     , m_ListLock()
     , m_pTimer(pTimer)
 {
+    if (sched == SCHED_DEFAULT)
+    {
+#if SRT_SNDQ_TIMING_WHEEL
+        sched = SCHED_WHEEL;
+#else
+        sched = SCHED_HEAP;
+#endif
+    }
+
     setupCond(m_ListCond, "CSndUListCond");
-    m_pHeap = new CSNode*[m_iArrayLength];
+    if (sched == SCHED_WHEEL)
+        m_pSchedule = new CSndTimingWheel;
+    else
+        m_pSchedule = new CSndHeap;
 }
 
 srt::CSndUList::~CSndUList()
 {
     releaseCond(m_ListCond);
-    delete[] m_pHeap;
+    delete m_pSchedule;
 }
 
 void srt::CSndUList::resetAtFork()
@@ -239,15 +549,11 @@ void srt::CSndUList::update(const CUDT* u, EReschedule reschedule, sync::steady_
         if (n->m_tsTimeStamp <= ts)
             return;
 
-        if (n->m_iHeapLoc == 0)
-        {
-            n->m_tsTimeStamp = ts;
-            m_pTimer->interrupt();
-            return;
-        }
+        m_pSchedule->advance(n, ts);
 
-        remove_(u);
-        insert_norealloc_(ts, u);
+        // an earlier event is now first, wake up sending worker
+        if (m_pSchedule->top() == n)
+            m_pTimer->interrupt();
         return;
     }
 
@@ -258,14 +564,15 @@ srt::CUDT* srt::CSndUList::pop()
 {
     ScopedLock listguard(m_ListLock);
 
-    if (-1 == m_iLastEntry)
+    CSNode* n = m_pSchedule->top();
+    if (n == NULL)
         return NULL;
 
     // no pop until the next scheduled time
-    if (m_pHeap[0]->m_tsTimeStamp > steady_clock::now())
+    if (n->m_tsTimeStamp > steady_clock::now())
         return NULL;
 
-    CUDT* u = m_pHeap[0]->m_pUDT;
+    CUDT* u = n->m_pUDT;
     remove_(u);
     return u;
 }
@@ -280,16 +587,17 @@ steady_clock::time_point srt::CSndUList::getNextProcTime()
 {
     ScopedLock listguard(m_ListLock);
 
-    if (-1 == m_iLastEntry)
+    CSNode* n = m_pSchedule->top();
+    if (n == NULL)
         return steady_clock::time_point();
 
-    return m_pHeap[0]->m_tsTimeStamp;
+    return n->m_tsTimeStamp;
 }
 
 void srt::CSndUList::waitNonEmpty() const
 {
     UniqueLock listguard(m_ListLock);
-    if (m_iLastEntry >= 0)
+    if (m_pSchedule->size() > 0)
         return;
 
     m_ListCond.wait(listguard);
@@ -301,35 +609,7 @@ void srt::CSndUList::signalInterrupt() const
     m_ListCond.notify_one();
 }
 
-void srt::CSndUList::realloc_()
-{
-    CSNode** temp = NULL;
-
-    try
-    {
-        temp = new CSNode*[2 * m_iArrayLength];
-    }
-    catch (...)
-    {
-        throw CUDTException(MJ_SYSTEMRES, MN_MEMORY, 0);
-    }
-
-    memcpy((temp), m_pHeap, sizeof(CSNode*) * m_iArrayLength);
-    m_iArrayLength *= 2;
-    delete[] m_pHeap;
-    m_pHeap = temp;
-}
-
 void srt::CSndUList::insert_(const steady_clock::time_point& ts, const CUDT* u)
-{
-    // increase the heap array size if necessary
-    if (m_iLastEntry == m_iArrayLength - 1)
-        realloc_();
-
-    insert_norealloc_(ts, u);
-}
-
-void srt::CSndUList::insert_norealloc_(const steady_clock::time_point& ts, const CUDT* u)
 {
     CSNode* n = u->m_pSNode;
 
@@ -337,33 +617,15 @@ void srt::CSndUList::insert_norealloc_(const steady_clock::time_point& ts, const
     if (n->m_iHeapLoc >= 0)
         return;
 
-    SRT_ASSERT(m_iLastEntry < m_iArrayLength);
-
-    m_iLastEntry++;
-    m_pHeap[m_iLastEntry] = n;
-    n->m_tsTimeStamp      = ts;
-
-    int q = m_iLastEntry;
-    int p = q;
-    while (p != 0)
-    {
-        p = (q - 1) >> 1;
-        if (m_pHeap[p]->m_tsTimeStamp <= m_pHeap[q]->m_tsTimeStamp)
-            break;
-
-        swap(m_pHeap[p], m_pHeap[q]);
-        m_pHeap[q]->m_iHeapLoc = q;
-        q                      = p;
-    }
-
-    n->m_iHeapLoc = q;
+    n->m_tsTimeStamp = ts;
+    m_pSchedule->insert(n);
 
     // an earlier event has been inserted, wake up sending worker
-    if (n->m_iHeapLoc == 0)
+    if (m_pSchedule->top() == n)
         m_pTimer->interrupt();
 
     // first entry, activate the sending queue
-    if (0 == m_iLastEntry)
+    if (m_pSchedule->size() == 1)
     {
         // m_ListLock is assumed to be locked.
         m_ListCond.notify_one();
@@ -372,79 +634,89 @@ void srt::CSndUList::insert_norealloc_(const steady_clock::time_point& ts, const
 
 void srt::CSndUList::remove_(const CUDT* u)
 {
-    CSNode* n = u->m_pSNode;
-
-    if (n->m_iHeapLoc >= 0)
-    {
-        // remove the node from heap
-        m_pHeap[n->m_iHeapLoc] = m_pHeap[m_iLastEntry];
-        m_iLastEntry--;
-        m_pHeap[n->m_iHeapLoc]->m_iHeapLoc = n->m_iHeapLoc.load();
-
-        int q = n->m_iHeapLoc;
-        int p = q * 2 + 1;
-        while (p <= m_iLastEntry)
-        {
-            if ((p + 1 <= m_iLastEntry) && (m_pHeap[p]->m_tsTimeStamp > m_pHeap[p + 1]->m_tsTimeStamp))
-                p++;
-
-            if (m_pHeap[q]->m_tsTimeStamp > m_pHeap[p]->m_tsTimeStamp)
-            {
-                swap(m_pHeap[p], m_pHeap[q]);
-                m_pHeap[p]->m_iHeapLoc = p;
-                m_pHeap[q]->m_iHeapLoc = q;
-
-                q = p;
-                p = q * 2 + 1;
-            }
-            else
-                break;
-        }
-
-        n->m_iHeapLoc = -1;
-    }
+    m_pSchedule->remove(u->m_pSNode);
 
     // the only event has been deleted, wake up immediately
-    if (0 == m_iLastEntry)
+    if (m_pSchedule->size() == 1)
         m_pTimer->interrupt();
 }
 
 //
+srt::CSndQueue::Worker::Worker()
+    : m_pQueue(NULL)
+    , m_pSndUList(NULL)
+    , m_pTimer(NULL)
+    , m_bOwnTimer(false)
+    , m_pBatch(NULL)
+    , m_pBatchSocket(NULL)
+    , m_pBatchCtlBuf(NULL)
+    , m_pBatchEncrypt(NULL)
+    , m_iBatchCalls(0)
+    , m_iBatchPackets(0)
+    , m_iGSOCalls(0)
+    , m_iGSOPackets(0)
+{
+}
+
+srt::CSndQueue::Worker::~Worker()
+{
+    delete m_pSndUList;
+    if (m_bOwnTimer)
+        delete m_pTimer;
+    delete[] m_pBatch;
+    delete[] m_pBatchSocket;
+    delete[] m_pBatchCtlBuf;
+    delete[] m_pBatchEncrypt;
+}
+
 srt::CSndQueue::CSndQueue()
-    : m_pSndUList(NULL)
+    : m_pWorkers(NULL)
+    , m_iWorkers(0)
     , m_pChannel(NULL)
-    , m_pTimer(NULL)
+    , m_pCryptoPool(NULL)
     , m_bClosing(false)
+    , m_iBatchSize(CSrtMuxerConfig::DEF_UDP_SNDBATCH)
 {
 }
 
 srt::CSndQueue::~CSndQueue()
 {
-    delete m_pSndUList;
+    delete[] m_pWorkers;
 }
 
 void srt::CSndQueue::resetAtFork()
 {
-    resetThread(&m_WorkerThread);
-    m_pSndUList->resetAtFork();
+    for (int i = 0; i < m_iWorkers; ++i)
+    {
+        resetThread(&m_pWorkers[i].m_WorkerThread);
+        m_pWorkers[i].m_pSndUList->resetAtFork();
+    }
 }
 
 void srt::CSndQueue::stop()
 {
     m_bClosing = true;
 
-    if (m_pTimer != NULL)
+    for (int i = 0; i < m_iWorkers; ++i)
     {
-        m_pTimer->interrupt();
-    }
+        Worker& w = m_pWorkers[i];
+        if (w.m_pTimer != NULL)
+        {
+            w.m_pTimer->interrupt();
+        }
 
-    // Unblock CSndQueue worker thread if it is waiting.
-    m_pSndUList->signalInterrupt();
+        // Unblock CSndQueue worker thread if it is waiting.
+        if (w.m_pSndUList != NULL)
+            w.m_pSndUList->signalInterrupt();
+    }
 
-    if (m_WorkerThread.joinable())
+    for (int i = 0; i < m_iWorkers; ++i)
     {
-        HLOGC(rslog.Debug, log << "SndQueue: EXIT");
-        m_WorkerThread.join();
+        if (m_pWorkers[i].m_WorkerThread.joinable())
+        {
+            HLOGC(rslog.Debug, log << "SndQueue: EXIT");
+            m_pWorkers[i].m_WorkerThread.join();
+        }
     }
 }
 
@@ -461,21 +733,99 @@ int srt::CSndQueue::sockoptQuery(int level, int type) const
 srt::sync::atomic<int> srt::CSndQueue::m_counter(0);
 #endif
 
-void srt::CSndQueue::init(CChannel* c, CTimer* t)
+void srt::CSndQueue::init(CChannel* c, CTimer* t, int batchsize, int workers, CCryptoPool* crypto)
 {
-    m_pChannel  = c;
-    m_pTimer    = t;
-    m_pSndUList = new CSndUList(t);
+    m_pChannel    = c;
+    m_pCryptoPool = crypto;
+    m_iBatchSize = std::max(1, std::min(batchsize, int(CSrtMuxerConfig::MAX_UDP_SNDBATCH)));
+    m_iWorkers   = std::max(1, std::min(workers, int(CSrtMuxerConfig::MAX_SNDWORKERS)));
+    m_pWorkers   = new Worker[m_iWorkers];
 
 #if ENABLE_LOGGING
     ++m_counter;
-    const std::string thrname = "SRT:SndQ:w" + Sprint(m_counter);
-    const char*       thname  = thrname.c_str();
+#endif
+
+    for (int i = 0; i < m_iWorkers; ++i)
+    {
+        Worker& w = m_pWorkers[i];
+        w.m_pQueue = this;
+
+        // The first thread uses the timer shared with the receiving queue,
+        // every other one sleeps on its own.
+        if (i == 0)
+        {
+            w.m_pTimer = t;
+        }
+        else
+        {
+            w.m_pTimer    = new CTimer;
+            w.m_bOwnTimer = true;
+        }
+        w.m_pSndUList = new CSndUList(w.m_pTimer);
+
+        w.m_pBatch       = new CBatchPacket[m_iBatchSize];
+        w.m_pBatchSocket = new CUDTSocket*[m_iBatchSize];
+        std::fill(w.m_pBatchSocket, w.m_pBatchSocket + m_iBatchSize, (CUDTSocket*)NULL);
+        if (m_iBatchSize > 1)
+            w.m_pBatchCtlBuf = new char[m_iBatchSize * SRT_LIVE_MAX_PLSIZE];
+        if (m_pCryptoPool)
+        {
+            w.m_pBatchEncrypt = new bool[m_iBatchSize];
+            std::fill(w.m_pBatchEncrypt, w.m_pBatchEncrypt + m_iBatchSize, false);
+        }
+    }
+
+    for (int i = 0; i < m_iWorkers; ++i)
+    {
+#if ENABLE_LOGGING
+        std::string thrname = "SRT:SndQ:w" + Sprint(m_counter.load());
+        if (m_iWorkers > 1)
+            thrname += "." + Sprint(i);
+        const char* thname = thrname.c_str();
 #else
-    const char* thname = "SRT:SndQ";
+        const char* thname = "SRT:SndQ";
 #endif
-    if (!StartThread(m_WorkerThread, CSndQueue::worker, this, thname))
-        throw CUDTException(MJ_SYSTEMRES, MN_THREAD);
+        if (!StartThread(m_pWorkers[i].m_WorkerThread, CSndQueue::worker, &m_pWorkers[i], thname))
+            throw CUDTException(MJ_SYSTEMRES, MN_THREAD);
+    }
+}
+
+srt::CSndUList* srt::CSndQueue::sndList(const CUDT* u) const
+{
+    // Socket IDs are assigned sequentially, so they spread evenly.
+    return m_pWorkers[uint32_t(u->id()) % uint32_t(m_iWorkers)].m_pSndUList;
+}
+
+int64_t srt::CSndQueue::batchCallsTotal() const
+{
+    int64_t total = 0;
+    for (int i = 0; i < m_iWorkers; ++i)
+        total += m_pWorkers[i].m_iBatchCalls.load();
+    return total;
+}
+
+int64_t srt::CSndQueue::batchPacketsTotal() const
+{
+    int64_t total = 0;
+    for (int i = 0; i < m_iWorkers; ++i)
+        total += m_pWorkers[i].m_iBatchPackets.load();
+    return total;
+}
+
+int64_t srt::CSndQueue::gsoCallsTotal() const
+{
+    int64_t total = 0;
+    for (int i = 0; i < m_iWorkers; ++i)
+        total += m_pWorkers[i].m_iGSOCalls.load();
+    return total;
+}
+
+int64_t srt::CSndQueue::gsoPacketsTotal() const
+{
+    int64_t total = 0;
+    for (int i = 0; i < m_iWorkers; ++i)
+        total += m_pWorkers[i].m_iGSOPackets.load();
+    return total;
 }
 
 int srt::CSndQueue::getIpTTL() const
@@ -516,7 +866,8 @@ static void CSndQueueDebugHighratePrint(const srt::CSndQueue* self, const steady
 
 void* srt::CSndQueue::worker(void* param)
 {
-    CSndQueue* self = (CSndQueue*)param;
+    Worker&    w    = *(Worker*)param;
+    CSndQueue* self = w.m_pQueue;
 
     std::string thname;
     ThreadName::get(thname);
@@ -533,12 +884,20 @@ void* srt::CSndQueue::worker(void* param)
 
     while (!self->m_bClosing)
     {
-        const steady_clock::time_point next_time = self->m_pSndUList->getNextProcTime();
+        const steady_clock::time_point next_time = w.m_pSndUList->getNextProcTime();
 
         INCREMENT_THREAD_ITERATIONS();
 
         IF_DEBUG_HIGHRATE(self->m_WorkerStats.lIteration++);
 
+        // Prepare the encryption of the next packets while nothing waits
+        // for sending, then check again what is due.
+        if (!w.m_vPrecompSockets.empty() && (is_zero(next_time) || steady_clock::now() < next_time))
+        {
+            precomputeIdle(w, true);
+            continue;
+        }
+
         if (is_zero(next_time))
         {
             IF_DEBUG_HIGHRATE(self->m_WorkerStats.lNotReadyTs++);
@@ -547,7 +906,7 @@ void* srt::CSndQueue::worker(void* param)
             THREAD_PAUSED();
             if (!self->m_bClosing)
             {
-                self->m_pSndUList->waitNonEmpty();
+                w.m_pSndUList->waitNonEmpty();
                 IF_DEBUG_HIGHRATE(self->m_WorkerStats.lCondWait++);
             }
             THREAD_RESUMED();
@@ -562,249 +921,467 @@ void* srt::CSndQueue::worker(void* param)
         if (currtime < next_time)
         {
             THREAD_PAUSED();
-            self->m_pTimer->sleep_until(next_time);
+            w.m_pTimer->sleep_until(next_time);
             THREAD_RESUMED();
             IF_DEBUG_HIGHRATE(self->m_WorkerStats.lSleepTo++);
         }
 
-        // Get a socket with a send request if any.
-        CUDT* u = self->m_pSndUList->pop();
-        if (u == NULL)
+        // Collect packets from all sockets whose sending time has come, up to
+        // the batch size, so that they can be sent out with one system call.
+        int nbatch = 0;
+        while (nbatch < self->m_iBatchSize)
         {
-            IF_DEBUG_HIGHRATE(self->m_WorkerStats.lNotReadyPop++);
-            continue;
+            const EPackResult res = self->packNextReady(w, nbatch);
+            if (res == PACK_NOTREADY)
+                break;
+
+            if (res == PACK_DONE)
+                ++nbatch;
         }
 
-#define UST(field) ((u->m_b##field) ? "+" : "-") << #field << " "
-        HLOGC(qslog.Debug,
-            log << "CSndQueue: requesting packet from @" << u->socketID() << " STATUS: " << UST(Listening)
-                << UST(Connecting) << UST(Connected) << UST(Closing) << UST(Shutdown) << UST(Broken) << UST(PeerHealth)
-                << UST(Opened));
+        if (nbatch == 0)
+            continue;
+
+        self->flushBatch(w, nbatch);
+    }
+
+    precomputeIdle(w, false);
+
+    THREAD_EXIT();
+    return NULL;
+}
+
+srt::CSndQueue::EPackResult srt::CSndQueue::packNextReady(Worker& w, int pos)
+{
+    // Get a socket with a send request if any.
+    CUDT* u = w.m_pSndUList->pop();
+    if (u == NULL)
+    {
+        IF_DEBUG_HIGHRATE(m_WorkerStats.lNotReadyPop++);
+        return PACK_NOTREADY;
+    }
+
+#define UST(field) ((u->m_b##field) ? '+' : '-')
+    HLOGB(qslog.Debug,
+        "CSndQueue: requesting packet from @{} STATUS: {}Listening {}Connecting {}Connected {}Closing {}Shutdown {}Broken {}PeerHealth {}Opened",
+        log << u->socketID() << UST(Listening) << UST(Connecting) << UST(Connected) << UST(Closing) << UST(Shutdown)
+            << UST(Broken) << UST(PeerHealth) << UST(Opened));
 #undef UST
 
-        if (!u->m_bConnected || u->m_bBroken)
-        {
-            IF_DEBUG_HIGHRATE(self->m_WorkerStats.lNotReadyPop++);
-            continue;
-        }
+    if (!u->m_bConnected || u->m_bBroken)
+    {
+        IF_DEBUG_HIGHRATE(m_WorkerStats.lNotReadyPop++);
+        return PACK_SKIPPED;
+    }
 
-        CUDTUnited::SocketKeeper sk (CUDT::uglobal(), u->id());
-        if (!sk.socket)
+    // The socket is kept acquired until its packet is sent out,
+    // as the packet payload is in the socket's sender buffer.
+    CUDTSocket* s = CUDT::uglobal().locateAcquireSocket(u->id());
+    if (!s)
+    {
+        HLOGB(qslog.Debug, "Socket to be processed was deleted in the meantime, not packing", log);
+        return PACK_SKIPPED;
+    }
+
+    // pack a packet from the socket
+    CBatchPacket& slot = w.m_pBatch[pos];
+    steady_clock::time_point next_send_time;
+    // With the crypto pool the packets are encrypted when the batch is complete.
+    bool* encrypt = w.m_pBatchEncrypt ? &w.m_pBatchEncrypt[pos] : NULL;
+    // Counted before packing, so that the data of zero-copy messages
+    // acknowledged in the meantime aren't released under the packet.
+    ++u->m_iSndBatchPackets;
+    const bool res = u->packData((slot.packet), (next_send_time), (slot.source), encrypt);
+
+    // Check if extracted anything to send
+    if (res == false)
+    {
+        // Nothing more to send, which is also the case after a drop.
+        u->leaveSndBatch();
+        s->apiRelease();
+        IF_DEBUG_HIGHRATE(m_WorkerStats.lNotReadyPop++);
+        return PACK_SKIPPED;
+    }
+
+    slot.target = u->m_PeerAddr;
+    if (!is_zero(next_send_time))
+        w.m_pSndUList->update(u, CSndUList::DO_RESCHEDULE, next_send_time);
+
+    // A control packet of the packet filter is built in a buffer of the socket's
+    // filter, which is overwritten when the same socket is packed again.
+    if (w.m_pBatchCtlBuf && !slot.packet.isControl() && slot.packet.getMsgSeq() == SRT_MSGNO_CONTROL)
+    {
+        char* ctlbuf = w.m_pBatchCtlBuf + pos * SRT_LIVE_MAX_PLSIZE;
+        const size_t len = std::min(slot.packet.getLength(), size_t(SRT_LIVE_MAX_PLSIZE));
+        memcpy(ctlbuf, slot.packet.m_pcData, len);
+        slot.packet.m_pcData = ctlbuf;
+        slot.packet.setLength(len);
+    }
+
+    w.m_pBatchSocket[pos] = s;
+    return PACK_DONE;
+}
+
+void srt::CSndQueue::flushBatch(Worker& w, int size)
+{
+    if (m_pCryptoPool)
+        size = encryptBatch(w, size);
+
+    int begin = 0;
+
+    // Consecutive full packets of one socket go out in one segmented
+    // send, the packets between such runs are sent normally.
+    for (int pos = 0; pos < size && m_pChannel->segmentationEnabled();)
+    {
+        const int run = segmentRun(w, pos, size);
+        if (run < 2)
         {
-            HLOGC(qslog.Debug, log << "Socket to be processed was deleted in the meantime, not packing");
+            ++pos;
             continue;
         }
 
-        // pack a packet from the socket
-        CPacket pkt;
-        steady_clock::time_point next_send_time;
-        sockaddr_any source_addr;
-        const bool res = u->packData((pkt), (next_send_time), (source_addr));
+        sendPackets(w, begin, pos - begin);
 
-        // Check if extracted anything to send
-        if (res == false)
+        HLOGB(qslog.Debug, "chn:SENDING: {} packets segmented", log << run);
+        if (m_pChannel->sendSegmented(w.m_pBatch + pos, run) == -1)
         {
-            IF_DEBUG_HIGHRATE(self->m_WorkerStats.lNotReadyPop++);
-            continue;
+            sendPackets(w, pos, run);
+        }
+        else
+        {
+            w.m_iGSOCalls.store(w.m_iGSOCalls.load() + 1);
+            w.m_iGSOPackets.store(w.m_iGSOPackets.load() + run);
         }
 
-        const sockaddr_any addr = u->m_PeerAddr;
-        if (!is_zero(next_send_time))
-            self->m_pSndUList->update(u, CSndUList::DO_RESCHEDULE, next_send_time);
+        pos  += run;
+        begin = pos;
+    }
 
-        HLOGC(qslog.Debug, log << self->CONID() << "chn:SENDING: " << pkt.Info());
-        self->m_pChannel->sendto(addr, pkt, source_addr);
+    sendPackets(w, begin, size - begin);
 
-        IF_DEBUG_HIGHRATE(self->m_WorkerStats.lSendTo++);
-    }
+    IF_DEBUG_HIGHRATE(m_WorkerStats.lSendTo += size);
 
-    THREAD_EXIT();
-    return NULL;
-}
+    for (int i = 0; i < size; ++i)
+    {
+        CUDTSocket* s = w.m_pBatchSocket[i];
+        w.m_pBatchSocket[i] = NULL;
 
-int srt::CSndQueue::sendto(const sockaddr_any& addr, CPacket& w_packet, const sockaddr_any& src)
-{
-    // send out the packet immediately (high priority), this is a control packet
-    // NOTE: w_packet is passed by mutable reference because this function will do
-    // a modification in place and then it will revert it. After returning this object
-    // should look unmodified, hence it is here passed without a reference marker.
-    m_pChannel->sendto(addr, w_packet, src);
-    return (int)w_packet.getLength();
+        // The packet is sent out, so the acknowledged user data are no longer needed.
+        s->core().leaveSndBatch();
+
+        // The keystream of the next packets is prepared when the queue is
+        // idle, so the socket stays acquired until then, once per socket.
+        if (s->core().m_config.iCryptoPrecomp > 0
+            && std::find(w.m_vPrecompSockets.begin(), w.m_vPrecompSockets.end(), s) == w.m_vPrecompSockets.end())
+        {
+            w.m_vPrecompSockets.push_back(s);
+            continue;
+        }
+        s->apiRelease();
+    }
 }
 
-//
-srt::CRcvUList::CRcvUList()
-    : m_pUList(NULL)
-    , m_pLast(NULL)
+void srt::CSndQueue::precomputeIdle(Worker& w, bool compute)
 {
+    for (size_t i = 0; i < w.m_vPrecompSockets.size(); ++i)
+    {
+        CUDTSocket* s = w.m_vPrecompSockets[i];
+        if (compute)
+            s->core().precomputeKeystream();
+        s->apiRelease();
+    }
+    w.m_vPrecompSockets.clear();
 }
 
-srt::CRcvUList::~CRcvUList() {}
-
-void srt::CRcvUList::insert(const CUDT* u)
+int srt::CSndQueue::encryptBatch(Worker& w, int size)
 {
-    CRNode* n        = u->m_pRNode;
-    n->m_tsTimeStamp = steady_clock::now();
+    w.m_vCryptoSlots.clear();
+    w.m_vCryptoPackets.clear();
+    w.m_vCryptoJobs.clear();
 
-    if (NULL == m_pUList)
+    // The packets of a socket must be encrypted in order by one thread, as
+    // the crypto context is not thread-safe, and the key may be switched
+    // after the packets are encrypted.
+    for (int i = 0; i < size; ++i)
     {
-        // empty list, insert as the single node
-        n->m_pPrev = n->m_pNext = NULL;
-        m_pLast = m_pUList = n;
+        if (!w.m_pBatchEncrypt[i])
+            continue;
 
-        return;
-    }
+        w.m_vCryptoJobs.push_back(int(w.m_vCryptoSlots.size()));
+        for (int j = i; j < size; ++j)
+        {
+            if (!w.m_pBatchEncrypt[j] || w.m_pBatchSocket[j] != w.m_pBatchSocket[i])
+                continue;
 
-    // always insert at the end for RcvUList
-    n->m_pPrev       = m_pLast;
-    n->m_pNext       = NULL;
-    m_pLast->m_pNext = n;
-    m_pLast          = n;
-}
+            w.m_pBatchEncrypt[j] = false;
+            w.m_vCryptoSlots.push_back(j);
+            w.m_vCryptoPackets.push_back(&w.m_pBatch[j].packet);
+        }
+    }
 
-void srt::CRcvUList::remove(const CUDT* u)
-{
-    CRNode* n = u->m_pRNode;
+    const int njobs = int(w.m_vCryptoJobs.size());
+    if (njobs == 0)
+        return size;
 
-    if (!n->m_bOnList)
-        return;
+    w.m_vCryptoJobs.push_back(int(w.m_vCryptoSlots.size()));
+    w.m_vCryptoDone.assign(njobs, 0);
+    m_pCryptoPool->run(&CSndQueue::encryptJob, &w, njobs);
 
-    if (NULL == n->m_pPrev)
+    // Mark the packets that were not encrypted, which must not be sent.
+    bool failed = false;
+    for (int i = 0; i < njobs; ++i)
     {
-        // n is the first node
-        m_pUList = n->m_pNext;
-        if (NULL == m_pUList)
-            m_pLast = NULL;
-        else
-            m_pUList->m_pPrev = NULL;
+        for (int k = w.m_vCryptoJobs[i] + w.m_vCryptoDone[i]; k < w.m_vCryptoJobs[i + 1]; ++k)
+        {
+            w.m_pBatchEncrypt[w.m_vCryptoSlots[k]] = true;
+            failed = true;
+        }
     }
-    else
+
+    if (!failed)
+        return size;
+
+    int out = 0;
+    for (int i = 0; i < size; ++i)
     {
-        n->m_pPrev->m_pNext = n->m_pNext;
-        if (NULL == n->m_pNext)
+        if (w.m_pBatchEncrypt[i])
+        {
+            w.m_pBatchEncrypt[i] = false;
+            w.m_pBatchSocket[i]->core().leaveSndBatch();
+            w.m_pBatchSocket[i]->apiRelease();
+            w.m_pBatchSocket[i] = NULL;
+            continue;
+        }
+
+        if (out != i)
         {
-            // n is the last node
-            m_pLast = n->m_pPrev;
+            // CPacket can't be copied, but the batch packets don't own their payload.
+            CBatchPacket& from = w.m_pBatch[i];
+            CBatchPacket& to   = w.m_pBatch[out];
+            memcpy(to.packet.getHeader(), from.packet.getHeader(), CPacket::HDR_SIZE);
+            to.packet.m_pcData = from.packet.m_pcData;
+            to.packet.setLength(from.packet.getLength());
+            to.target = from.target;
+            to.source = from.source;
+            w.m_pBatchSocket[out] = w.m_pBatchSocket[i];
+            w.m_pBatchSocket[i]   = NULL;
         }
-        else
-            n->m_pNext->m_pPrev = n->m_pPrev;
+        ++out;
     }
 
-    n->m_pNext = n->m_pPrev = NULL;
+    HLOGB(qslog.Debug, "encryptBatch: {} packets failed to be encrypted", log << (size - out));
+    return out;
 }
 
-void srt::CRcvUList::update(const CUDT* u)
+void srt::CSndQueue::encryptJob(void* arg, int index)
 {
-    CRNode* n = u->m_pRNode;
-
-    if (!n->m_bOnList)
-        return;
+    Worker&   w     = *(Worker*)arg;
+    const int begin = w.m_vCryptoJobs[index];
+    CUDT&     u     = w.m_pBatchSocket[w.m_vCryptoSlots[begin]]->core();
 
-    n->m_tsTimeStamp = steady_clock::now();
+    w.m_vCryptoDone[index] = u.encryptPacked(&w.m_vCryptoPackets[begin], w.m_vCryptoJobs[index + 1] - begin);
+}
 
-    // if n is the last node, do not need to change
-    if (NULL == n->m_pNext)
+void srt::CSndQueue::sendPackets(Worker& w, int pos, int size)
+{
+    if (size == 0)
         return;
 
-    if (NULL == n->m_pPrev)
+    if (size == 1)
     {
-        m_pUList          = n->m_pNext;
-        m_pUList->m_pPrev = NULL;
+        HLOGB(qslog.Debug, "chn:SENDING: {}", log << w.m_pBatch[pos].packet.Info());
+        m_pChannel->sendto(w.m_pBatch[pos].target, w.m_pBatch[pos].packet, w.m_pBatch[pos].source);
+        return;
     }
-    else
+
+    HLOGB(qslog.Debug, "chn:SENDING: batch of {} packets", log << size);
+    m_pChannel->sendBatch(w.m_pBatch + pos, size);
+    w.m_iBatchCalls.store(w.m_iBatchCalls.load() + 1);
+    w.m_iBatchPackets.store(w.m_iBatchPackets.load() + size);
+}
+
+int srt::CSndQueue::segmentRun(const Worker& w, int pos, int size) const
+{
+    // All segments must have the size of the first one, except the last one,
+    // which may be shorter, and they must go to the same peer. Packets of one
+    // socket are also in the right order and come from the same source.
+    const CBatchPacket& first   = w.m_pBatch[pos];
+    const size_t        segsize = first.packet.getLength();
+    const int           maxrun  = std::min(size - pos, int(CChannel::MAX_GSO_SEGMENTS));
+
+    size_t total = 0;
+    int    n     = 0;
+    while (n < maxrun)
     {
-        n->m_pPrev->m_pNext = n->m_pNext;
-        n->m_pNext->m_pPrev = n->m_pPrev;
+        const CBatchPacket& next = w.m_pBatch[pos + n];
+        const size_t        len  = next.packet.getLength();
+        if (w.m_pBatchSocket[pos + n] != w.m_pBatchSocket[pos] || len > segsize
+                || total + CPacket::HDR_SIZE + len > size_t(CChannel::MAX_GSO_BYTES))
+            break;
+
+        total += CPacket::HDR_SIZE + len;
+        ++n;
+
+        if (len < segsize)
+            break;
     }
 
-    n->m_pPrev       = m_pLast;
-    n->m_pNext       = NULL;
-    m_pLast->m_pNext = n;
-    m_pLast          = n;
+    return n;
+}
+
+int srt::CSndQueue::sendto(const sockaddr_any& addr, CPacket& w_packet, const sockaddr_any& src)
+{
+    // send out the packet immediately (high priority), this is a control packet
+    // NOTE: w_packet is passed by mutable reference because this function will do
+    // a modification in place and then it will revert it. After returning this object
+    // should look unmodified, hence it is here passed without a reference marker.
+    m_pChannel->sendto(addr, w_packet, src);
+    return (int)w_packet.getLength();
 }
 
 //
+srt::CRcvUList::CRcvUList() {}
+
+srt::CRcvUList::~CRcvUList() {}
+
+void srt::CRcvUList::insert(const CUDT* u)
+{
+    CRNode* n        = u->m_pRNode;
+    n->m_tsTimeStamp = steady_clock::now() + microseconds_from(CUDT::COMM_SYN_INTERVAL_US);
+    m_Heap.insert(n);
+}
+
+void srt::CRcvUList::remove(const CUDT* u)
+{
+    m_Heap.remove(u->m_pRNode);
+}
+
+void srt::CRcvUList::update(CUDT* u)
+{
+    CRNode* n = u->m_pRNode;
+    if (n->m_iHeapLoc < 0)
+        return;
+
+    n->m_tsTimeStamp = u->nextTimersCheckTime();
+    m_Heap.update(n);
+}
+
 srt::CHash::CHash()
-    : m_pBucket(NULL)
-    , m_iHashSize(0)
+    : m_pEntries(NULL)
+    , m_iMask(0)
+    , m_iShift(32)
+    , m_iCount(0)
 {
 }
 
 srt::CHash::~CHash()
 {
-    for (int i = 0; i < m_iHashSize; ++i)
-    {
-        CBucket* b = m_pBucket[i];
-        while (NULL != b)
-        {
-            CBucket* n = b->m_pNext;
-            delete b;
-            b = n;
-        }
-    }
-
-    delete[] m_pBucket;
+    delete[] m_pEntries;
 }
 
 void srt::CHash::init(int size)
 {
-    m_pBucket = new CBucket*[size];
-
-    for (int i = 0; i < size; ++i)
-        m_pBucket[i] = NULL;
+    int slots = 16;
+    while (slots < size)
+        slots *= 2;
 
-    m_iHashSize = size;
+    resize(slots);
 }
 
-srt::CUDT* srt::CHash::lookup(int32_t id)
+void srt::CHash::resize(int slots)
 {
-    // simple hash function (% hash table size); suitable for socket descriptors
-    CBucket* b = m_pBucket[id % m_iHashSize];
+    CEntry*   old      = m_pEntries;
+    const int oldslots = old ? m_iMask + 1 : 0;
 
-    while (NULL != b)
+    m_pEntries = new CEntry[slots];
+    for (int i = 0; i < slots; ++i)
     {
-        if (id == b->m_iID)
-            return b->m_pUDT;
-        b = b->m_pNext;
+        m_pEntries[i].m_iID   = 0;
+        m_pEntries[i].m_iDist = -1;
+        m_pEntries[i].m_pUDT  = NULL;
     }
 
-    return NULL;
+    m_iMask  = slots - 1;
+    m_iShift = 32;
+    for (int s = slots; s > 1; s /= 2)
+        --m_iShift;
+    m_iCount = 0;
+
+    for (int i = 0; i < oldslots; ++i)
+    {
+        if (old[i].m_iDist >= 0)
+            place(old[i].m_iID, old[i].m_pUDT);
+    }
+
+    delete[] old;
 }
 
-void srt::CHash::insert(int32_t id, CUDT* u)
+void srt::CHash::place(int32_t id, CUDT* u)
 {
-    CBucket* b = m_pBucket[id % m_iHashSize];
+    CEntry e;
+    e.m_iID   = id;
+    e.m_iDist = 0;
+    e.m_pUDT  = u;
+
+    int pos = home(id);
+    for (;;)
+    {
+        CEntry& slot = m_pEntries[pos];
+        if (slot.m_iDist < 0)
+        {
+            slot = e;
+            ++m_iCount;
+            return;
+        }
 
-    CBucket* n = new CBucket;
-    n->m_iID   = id;
-    n->m_pUDT  = u;
-    n->m_pNext = b;
+        // Take the slot from an entry that is closer to its home.
+        if (slot.m_iDist < e.m_iDist)
+            std::swap(slot, e);
 
-    m_pBucket[id % m_iHashSize] = n;
+        pos = (pos + 1) & m_iMask;
+        ++e.m_iDist;
+    }
 }
 
-void srt::CHash::remove(int32_t id)
+void srt::CHash::insert(int32_t id, CUDT* u)
 {
-    CBucket* b = m_pBucket[id % m_iHashSize];
-    CBucket* p = NULL;
+    remove(id);
 
-    while (NULL != b)
-    {
-        if (id == b->m_iID)
-        {
-            if (NULL == p)
-                m_pBucket[id % m_iHashSize] = b->m_pNext;
-            else
-                p->m_pNext = b->m_pNext;
+    if ((m_iCount + 1) * 4 > (m_iMask + 1) * 3)
+        resize((m_iMask + 1) * 2);
 
-            delete b;
+    place(id, u);
+}
 
+void srt::CHash::remove(int32_t id)
+{
+    int pos = home(id);
+    for (int dist = 0;; ++dist)
+    {
+        CEntry& e = m_pEntries[pos];
+        if (e.m_iDist < dist)
             return;
-        }
+        if (e.m_iID == id)
+            break;
+        pos = (pos + 1) & m_iMask;
+    }
+
+    // Shift the following entries back by one slot until one
+    // that is already in its home slot or an empty slot.
+    for (;;)
+    {
+        const int next = (pos + 1) & m_iMask;
+        if (m_pEntries[next].m_iDist <= 0)
+            break;
 
-        p = b;
-        b = b->m_pNext;
+        m_pEntries[pos] = m_pEntries[next];
+        --m_pEntries[pos].m_iDist;
+        pos = next;
     }
+
+    m_pEntries[pos].m_iDist = -1;
+    m_pEntries[pos].m_pUDT  = NULL;
+    --m_iCount;
 }
 
 //
@@ -1171,6 +1748,16 @@ srt::CRcvQueue::CRcvQueue()
     , m_iIPversion()
     , m_szPayloadSize()
     , m_bClosing(false)
+    , m_iBatchSize(CSrtMuxerConfig::DEF_UDP_RCVBATCH)
+    , m_pBatchUnit(NULL)
+    , m_pBatchPacket(NULL)
+    , m_pBatchAddr(NULL)
+    , m_pBatchStatus(NULL)
+    , m_iBatchPos(0)
+    , m_iBatchCount(0)
+    , m_pCryptoPool(NULL)
+    , m_iBatchCalls(0)
+    , m_iBatchPackets(0)
     , m_pRendezvousQueue(NULL)
     , m_vNewEntry()
     , m_IDLock()
@@ -1186,6 +1773,10 @@ srt::CRcvQueue::~CRcvQueue()
     delete m_pRcvUList;
     delete m_pHash;
     delete m_pRendezvousQueue;
+    delete[] m_pBatchUnit;
+    delete[] m_pBatchPacket;
+    delete[] m_pBatchAddr;
+    delete[] m_pBatchStatus;
 
     // remove all queued messages
     for (map<int32_t, std::queue<CPacket*> >::iterator i = m_mBuffer.begin(); i != m_mBuffer.end(); ++i)
@@ -1221,10 +1812,24 @@ void srt::CRcvQueue::stop()
 srt::sync::atomic<int> srt::CRcvQueue::m_counter(0);
 #endif
 
-void srt::CRcvQueue::init(int qsize, size_t payload, int version, int hsize, CChannel* cc, CTimer* t)
+void srt::CRcvQueue::init(int qsize, size_t payload, int version, int hsize, CChannel* cc, CTimer* t, int batchsize,
+                          CCryptoPool* crypto)
 {
     m_iIPversion    = version;
     m_szPayloadSize = payload;
+    m_pCryptoPool   = crypto;
+
+    // Coalesced datagrams can only be received in the batch mode,
+    // even if it's one packet at a time.
+    m_iBatchSize = std::max(1, std::min(batchsize, int(CSrtMuxerConfig::MAX_UDP_RCVBATCH)));
+    if (m_iBatchSize > 1 || cc->coalescingEnabled())
+    {
+        m_pBatchUnit   = new CUnit*[m_iBatchSize];
+        m_pBatchPacket = new CPacket*[m_iBatchSize];
+        m_pBatchAddr   = new sockaddr_any[m_iBatchSize];
+        m_pBatchStatus = new EReadStatus[m_iBatchSize];
+        std::fill(m_pBatchAddr, m_pBatchAddr + m_iBatchSize, sockaddr_any(version));
+    }
 
     SRT_ASSERT(m_pUnitQueue == NULL);
     m_pUnitQueue = new CUnitQueue(qsize, (int)payload);
@@ -1301,10 +1906,10 @@ void* srt::CRcvQueue::worker(void* param)
                 cst = self->worker_ProcessAddressedPacket(id, unit, sa);
                 // CAN RETURN CONN_REJECT, but m_RejectReason is already set
             }
-            HLOGC(qrlog.Debug, log << self->CONID() << "worker: result for the unit: " << ConnectStatusStr(cst));
+            HLOGB(qrlog.Debug, "worker: result for the unit: {}", log << ConnectStatusStr(cst));
             if (cst == CONN_AGAIN)
             {
-                HLOGC(qrlog.Debug, log << self->CONID() << "worker: packet not dispatched, continuing reading.");
+                HLOGB(qrlog.Debug, "worker: packet not dispatched, continuing reading.", log);
                 continue;
             }
             have_received = true;
@@ -1332,12 +1937,13 @@ void* srt::CRcvQueue::worker(void* param)
         }
         // OTHERWISE: this is an "AGAIN" situation. No data was read, but the process should continue.
 
-        // take care of the timing event for all UDT sockets
-        const steady_clock::time_point curtime_minus_syn =
-            steady_clock::now() - microseconds_from(CUDT::COMM_SYN_INTERVAL_US);
+        // take care of the timing event for the UDT sockets whose timers are due
+        const steady_clock::time_point curtime = steady_clock::now();
 
-        CRNode* ul = self->m_pRcvUList->m_pUList;
-        while ((NULL != ul) && (ul->m_tsTimeStamp < curtime_minus_syn))
+        // Every socket is checked at most once per pass, whatever its
+        // new time is, so that the worker gets back to receiving.
+        CRNode* ul = self->m_pRcvUList->top();
+        for (size_t nleft = self->m_pRcvUList->size(); nleft > 0 && (NULL != ul) && (ul->m_tsTimeStamp <= curtime); --nleft)
         {
             CUDT* u = ul->m_pUDT;
 
@@ -1356,14 +1962,13 @@ void* srt::CRcvQueue::worker(void* param)
                 u->m_pRNode->m_bOnList = false;
             }
 
-            ul = self->m_pRcvUList->m_pUList;
+            ul = self->m_pRcvUList->top();
         }
 
         if (have_received)
         {
-            HLOGC(qrlog.Debug,
-                  log << "worker: RECEIVED PACKET --> updateConnStatus. cst=" << ConnectStatusStr(cst) << " id=" << id
-                      << " pkt-payload-size=" << unit->m_Packet.getLength());
+            HLOGB(qrlog.Debug, "worker: RECEIVED PACKET --> updateConnStatus. cst={} id={} pkt-payload-size={}",
+                  log << ConnectStatusStr(cst) << id << unit->m_Packet.getLength());
         }
 
         // Check connection requests status for all sockets in the RendezvousQueue.
@@ -1376,6 +1981,10 @@ void* srt::CRcvQueue::worker(void* param)
 
         // XXX updateConnStatus may have removed the connector from the list,
         // however there's still m_mBuffer in CRcvQueue for that socket to care about.
+
+        // No unit is in use by this thread at this point, so the free
+        // units left after a burst can be released.
+        self->m_pUnitQueue->shrink(curtime);
     }
 
     HLOGC(qrlog.Debug, log << "worker: EXIT");
@@ -1405,6 +2014,19 @@ srt::EReadStatus srt::CRcvQueue::worker_RetrieveUnit(int32_t& w_id, CUnit*& w_un
             m_pHash->insert(ne->m_SocketID, ne);
         }
     }
+
+    // Dispatch the packets remaining from the last batched read first.
+    if (m_iBatchPos < m_iBatchCount)
+        return worker_NextBatchUnit((w_id), (w_unit), (w_addr));
+
+    if (m_pBatchUnit)
+    {
+        const int nunits = worker_ReserveBatch();
+        if (nunits > 0)
+            return worker_RetrieveBatch(nunits, (w_id), (w_unit), (w_addr));
+        // Otherwise no free units; proceed the usual way
+    }
+
     // find next available slot for incoming packet
     w_unit = m_pUnitQueue->getNextAvailUnit();
     if (!w_unit)
@@ -1433,13 +2055,180 @@ srt::EReadStatus srt::CRcvQueue::worker_RetrieveUnit(int32_t& w_id, CUnit*& w_un
     if (rst == RST_OK)
     {
         w_id = w_unit->m_Packet.id();
-        HLOGC(qrlog.Debug,
-              log << "INCOMING PACKET: FROM=" << w_addr.str() << " BOUND=" << m_pChannel->bindAddressAny().str() << " "
-                  << w_unit->m_Packet.Info());
+        HLOGB(qrlog.Debug, "INCOMING PACKET: FROM={} BOUND={} {}",
+              log << w_addr.str() << m_pChannel->bindAddressAny().str() << w_unit->m_Packet.Info());
     }
     return rst;
 }
 
+int64_t srt::CRcvQueue::groReadsTotal() const
+{
+    return m_pChannel ? m_pChannel->groReadsTotal() : 0;
+}
+
+int64_t srt::CRcvQueue::groSegmentsTotal() const
+{
+    return m_pChannel ? m_pChannel->groSegmentsTotal() : 0;
+}
+
+int srt::CRcvQueue::worker_ReserveBatch()
+{
+    // Reserve the units for the packets to be read. They stay marked as taken
+    // until dispatched, so that nothing else (like the packet filter rebuilding
+    // packets) takes them while the earlier packets of the batch are processed.
+    int nunits = 0;
+    for (; nunits < m_iBatchSize; ++nunits)
+    {
+        CUnit* unit = m_pUnitQueue->getNextAvailUnit();
+        if (!unit)
+            break;
+
+        m_pUnitQueue->makeUnitTaken(unit);
+        unit->m_Packet.setLength(m_szPayloadSize);
+        m_pBatchUnit[nunits]   = unit;
+        m_pBatchPacket[nunits] = &unit->m_Packet;
+    }
+    return nunits;
+}
+
+srt::EReadStatus srt::CRcvQueue::worker_RetrieveBatch(int nunits, int32_t& w_id, CUnit*& w_unit, sockaddr_any& w_addr)
+{
+    int count = 0;
+    THREAD_PAUSED();
+    const EReadStatus rst = m_pChannel->recvBatch(m_pBatchAddr, m_pBatchPacket, m_pBatchStatus, nunits, (count));
+    THREAD_RESUMED();
+
+    // Give back the units that were not filled.
+    for (int i = count; i < nunits; ++i)
+        m_pUnitQueue->makeUnitFree(m_pBatchUnit[i]);
+
+    if (rst != RST_OK)
+    {
+        m_iBatchPos = m_iBatchCount = 0;
+        return rst;
+    }
+
+    HLOGB(qrlog.Debug, "INCOMING BATCH: {}/{} packets", log << count << nunits);
+    if (m_iBatchSize > 1)
+    {
+        m_iBatchCalls.store(m_iBatchCalls.load() + 1);
+        m_iBatchPackets.store(m_iBatchPackets.load() + count);
+    }
+
+    if (m_pCryptoPool)
+        worker_DecryptBatch(count);
+
+    m_iBatchPos   = 0;
+    m_iBatchCount = count;
+    return worker_NextBatchUnit((w_id), (w_unit), (w_addr));
+}
+
+void srt::CRcvQueue::worker_DecryptBatch(int count)
+{
+    m_vCryptoUnits.clear();
+    m_vCryptoSockets.clear();
+    m_vCryptoJobs.clear();
+
+    // Find the job of every encrypted data packet, one job per socket.
+    // Packets that can't be decrypted here, because they are not for a
+    // connected socket or for a socket using a packet filter, which works
+    // on the encrypted payload, are decrypted when dispatched.
+    int jobof[CSrtMuxerConfig::MAX_UDP_RCVBATCH];
+    for (int i = 0; i < count; ++i)
+    {
+        jobof[i] = -1;
+        const CPacket& pkt = m_pBatchUnit[i]->m_Packet;
+        if (m_pBatchStatus[i] != RST_OK || pkt.isControl() || pkt.id() == 0 || pkt.getMsgCryptoFlags() == EK_NOENC)
+            continue;
+
+        CUDT* u = m_pHash->lookup(pkt.id());
+        if (!u)
+            continue;
+
+        int job = 0;
+        while (job < int(m_vCryptoSockets.size()) && &m_vCryptoSockets[job]->core() != u)
+            ++job;
+
+        if (job == int(m_vCryptoSockets.size()))
+        {
+            CUDTSocket* s = CUDT::uglobal().locateAcquireSocket(u->socketID());
+            if (!s)
+                continue;
+
+            if (m_pBatchAddr[i] != u->m_PeerAddr || u->m_PacketFilter || !u->m_bConnected || u->m_bBroken
+                    || u->m_bClosing)
+            {
+                s->apiRelease();
+                continue;
+            }
+            m_vCryptoSockets.push_back(s);
+            m_vCryptoJobs.push_back(0);
+        }
+        else if (m_pBatchAddr[i] != u->m_PeerAddr)
+        {
+            continue;
+        }
+        ++m_vCryptoJobs[job];
+        jobof[i] = job;
+    }
+
+    const int njobs = int(m_vCryptoSockets.size());
+    if (njobs == 0)
+        return;
+
+    // Turn the counts into the starts of the jobs, keeping the order of
+    // the packets within every job.
+    int next[CSrtMuxerConfig::MAX_UDP_RCVBATCH];
+    int start = 0;
+    for (int j = 0; j < njobs; ++j)
+    {
+        const int n      = m_vCryptoJobs[j];
+        m_vCryptoJobs[j] = next[j] = start;
+        start += n;
+    }
+    m_vCryptoJobs.push_back(start);
+
+    m_vCryptoUnits.resize(start);
+    for (int i = 0; i < count; ++i)
+    {
+        if (jobof[i] != -1)
+            m_vCryptoUnits[next[jobof[i]]++] = m_pBatchUnit[i];
+    }
+
+    m_pCryptoPool->run(&CRcvQueue::decryptJob, this, njobs);
+
+    for (int j = 0; j < njobs; ++j)
+        m_vCryptoSockets[j]->apiRelease();
+}
+
+void srt::CRcvQueue::decryptJob(void* arg, int index)
+{
+    CRcvQueue* self  = (CRcvQueue*)arg;
+    const int  begin = self->m_vCryptoJobs[index];
+
+    self->m_vCryptoSockets[index]->core().decryptReceived(&self->m_vCryptoUnits[begin],
+                                                          self->m_vCryptoJobs[index + 1] - begin);
+}
+
+srt::EReadStatus srt::CRcvQueue::worker_NextBatchUnit(int32_t& w_id, CUnit*& w_unit, sockaddr_any& w_addr)
+{
+    const int pos = m_iBatchPos++;
+    w_unit = m_pBatchUnit[pos];
+    w_addr = m_pBatchAddr[pos];
+
+    // From now on the unit is handled as if it was just received:
+    // it becomes taken again only when stored in the receiver buffer.
+    m_pUnitQueue->makeUnitFree(w_unit);
+
+    if (m_pBatchStatus[pos] != RST_OK)
+        return RST_AGAIN;
+
+    w_id = w_unit->m_Packet.id();
+    HLOGB(qrlog.Debug, "INCOMING PACKET: FROM={} BOUND={} {}",
+          log << w_addr.str() << m_pChannel->bindAddressAny().str() << w_unit->m_Packet.Info());
+    return RST_OK;
+}
+
 srt::EConnectStatus srt::CRcvQueue::worker_ProcessConnectionRequest(CUnit* unit, const sockaddr_any& addr)
 {
     HLOGC(cnlog.Debug,
@@ -1457,7 +2246,7 @@ srt::EConnectStatus srt::CRcvQueue::worker_ProcessConnectionRequest(CUnit* unit,
         if (pListener)
         {
             LOGC(cnlog.Debug, log << "PASSING request from: " << addr.str() << " to listener:" << pListener->socketID());
-            listener_ret = pListener->processConnectRequest(addr, unit->m_Packet);
+            listener_ret = pListener->processConnectRequest(addr, unit->m_Packet, this);
 
             // This function does return a code, but it's hard to say as to whether
             // anything can be done about it. In case when it's stated possible, the
@@ -1492,7 +2281,7 @@ srt::EConnectStatus srt::CRcvQueue::worker_ProcessAddressedPacket(int32_t id, CU
     {
         // Pass this to either async rendezvous connection,
         // or store the packet in the queue.
-        HLOGC(cnlog.Debug, log << "worker_ProcessAddressedPacket: resending to QUEUED socket @" << id);
+        HLOGB(cnlog.Debug, "worker_ProcessAddressedPacket: resending to QUEUED socket @{}", log << id);
         return worker_TryAsyncRend_OrStore(id, unit, addr);
     }
     // Although we don´t have an exclusive passing here,
@@ -1506,9 +2295,8 @@ srt::EConnectStatus srt::CRcvQueue::worker_ProcessAddressedPacket(int32_t id, CU
     // addressed to an associated socket.
     if (addr != u->m_PeerAddr)
     {
-        HLOGC(cnlog.Debug,
-              log << CONID() << "Packet for SID=" << id << " asoc with " << u->m_PeerAddr.str() << " received from "
-                  << addr.str() << " (CONSIDERED ATTACK ATTEMPT)");
+        HLOGB(cnlog.Debug, "Packet for SID={} asoc with {} received from {} (CONSIDERED ATTACK ATTEMPT)",
+              log << id << u->m_PeerAddr.str() << addr.str());
         // This came not from the address that is the peer associated
         // with the socket. Ignore it.
         return CONN_AGAIN;
@@ -1848,6 +2636,8 @@ void srt::CMultiplexer::resetAtFork()
         m_pRcvQueue->resetAtFork();
     if (m_pSndQueue != NULL)
         m_pSndQueue->resetAtFork();
+    if (m_pCryptoPool != NULL)
+        m_pCryptoPool->resetAtFork();
 }
 
 void srt::CMultiplexer::close()
@@ -1866,6 +2656,8 @@ void srt::CMultiplexer::stop()
         m_pRcvQueue->stop();
     if (m_pSndQueue != NULL)
         m_pSndQueue->stop();
+    if (m_pCryptoPool != NULL)
+        m_pCryptoPool->stop();
 }
 
 void srt::CMultiplexer::destroy()
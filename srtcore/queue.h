@@ -58,6 +58,8 @@ modified by
 #include "socketconfig.h"
 #include "netinet_any.h"
 #include "utilities.h"
+#include "crypto_pool.h"
+#include "heap.h"
 #include <list>
 #include <map>
 #include <queue>
@@ -67,11 +69,16 @@ namespace srt
 {
 class CChannel;
 class CUDT;
+class CUDTSocket;
+struct CBatchPacket;
 
 struct CUnit
 {
     CPacket m_Packet; // packet
     sync::atomic<bool> m_bTaken; // true if the unit is is use (can be stored in the RCV buffer).
+    bool m_bDecrypted; // true if the payload was decrypted before dispatching (SRTO_CRYPTOWORKERS)
+    CUnit* m_pPrevFree; // previous unit on the free list of CUnitQueue, if not taken
+    CUnit* m_pNextFree; // next unit on the free list of CUnitQueue, if not taken
 };
 
 class CUnitQueue
@@ -88,10 +95,18 @@ public:
     int capacity() const { return m_iSize; }
     int size() const { return m_iSize - m_iNumTaken; }
 
+    /// Number of units currently taken (holding packets stored in receiver buffers).
+    int takenUnits() const { return m_iNumTaken; }
+
+    /// Number of times shrink() released memory.
+    int64_t shrinkCount() const { return m_iShrinkCount.load(); }
+
 public:
     /// @brief Find an available unit for incoming packet. Allocate new units if 90% or more are in use.
-    /// @note This function is not thread-safe. Currently only CRcvQueue::worker thread calls it, thus
-    /// it is not an issue. However, must be protected if used from several threads in the future.
+    /// The unit stays available until makeUnitTaken() is called for it, so the next call
+    /// returns the same unit if this one wasn't taken in the meantime.
+    /// @note The unit must not be kept across a call to shrink(). Currently only CRcvQueue::worker
+    /// thread calls both.
     /// @return Pointer to the available unit, NULL if not found.
     CUnit* getNextAvailUnit();
 
@@ -99,6 +114,15 @@ public:
 
     void makeUnitTaken(CUnit* unit);
 
+    /// @brief Release the blocks of units that are all free, if the number of taken units has been
+    /// at most half of the remaining capacity since the last check. Checks at most once per SHRINK_PERIOD_MS
+    /// and never goes below the initial capacity.
+    /// @param now current time
+    /// @return number of units released.
+    int shrink(const sync::steady_clock::time_point& now);
+
+    static const int SHRINK_PERIOD_MS = 1000;
+
 private:
     struct CQEntry
     {
@@ -110,8 +134,8 @@ private:
     };
 
     /// Increase the unit queue size (by @a m_iBlockSize units).
-    /// Uses m_mtx to protect access and changes of the queue state.
     /// @return 0: success, -1: failure.
+    SRT_ATTR_REQUIRES(m_FreeLock)
     int increase_();
 
     /// @brief Allocated a CQEntry of iNumUnits with each unit of mss bytes.
@@ -120,13 +144,21 @@ private:
     /// @return a pointer to a newly allocated entry on success, NULL otherwise.
     static CQEntry* allocateEntry(const int iNumUnits, const int mss);
 
+    SRT_ATTR_REQUIRES(m_FreeLock)
+    void pushFree(CUnit* unit);
+
+    SRT_ATTR_REQUIRES(m_FreeLock)
+    void unlinkFree(CUnit* unit);
+
 private:
+    sync::Mutex m_FreeLock; // Protects the free list and the list of entries
     CQEntry* m_pQEntry;    // pointer to the first unit queue
-    CQEntry* m_pCurrQueue; // pointer to the current available queue
-    CQEntry* m_pLastQueue; // pointer to the last unit queue
-    CUnit* m_pAvailUnit; // recent available unit
-    int m_iSize;  // total size of the unit queue, in number of packets
+    CUnit* m_pFreeHead; // first free unit, the most recently freed one
+    sync::atomic<int> m_iSize;  // total size of the unit queue, in number of packets
     sync::atomic<int> m_iNumTaken; // total number of valid (occupied) packets in the queue
+    int m_iPeakTaken; // highest m_iNumTaken since the last shrink check
+    sync::steady_clock::time_point m_tsLastShrinkCheck;
+    sync::atomic<int64_t> m_iShrinkCount; // number of shrinks that released units
     const int m_iMSS; // unit buffer size
     const int m_iBlockSize; // Number of units in each CQEntry.
 
@@ -140,13 +172,114 @@ struct CSNode
     CUDT*                          m_pUDT; // Pointer to the instance of CUDT socket
     sync::steady_clock::time_point m_tsTimeStamp;
 
-    sync::atomic<int> m_iHeapLoc; // location on the heap, -1 means not on the heap
+    sync::atomic<int> m_iHeapLoc; // location on the heap (or slot in the wheel), -1 means not scheduled
+
+    CSNode* m_pPrev; // neighbours in the timing wheel slot
+    CSNode* m_pNext;
+};
+
+/// An ordered set of sending nodes, keyed by their m_tsTimeStamp.
+/// Not thread-safe; CSndUList serializes the access.
+class CSndSchedule
+{
+public:
+    virtual ~CSndSchedule() {}
+
+    /// Add a node that is not scheduled yet, at its m_tsTimeStamp.
+    virtual void insert(CSNode* n) = 0;
+
+    /// Remove a scheduled node.
+    virtual void remove(CSNode* n) = 0;
+
+    /// Move a scheduled node to an earlier time @a ts.
+    virtual void advance(CSNode* n, const sync::steady_clock::time_point& ts) = 0;
+
+    /// Get the node with the earliest time stamp, or NULL if empty.
+    virtual CSNode* top() = 0;
+
+    /// Get the number of scheduled nodes.
+    virtual int size() const = 0;
+};
+
+/// The binary heap: O(log n) insertion and removal.
+class CSndHeap : public CSndSchedule
+{
+public:
+    CSndHeap() {}
+
+    void    insert(CSNode* n);
+    void    remove(CSNode* n) { m_Heap.remove(n); }
+    void    advance(CSNode* n, const sync::steady_clock::time_point& ts);
+    CSNode* top() { return m_Heap.top(); }
+    int     size() const { return int(m_Heap.size()); }
+
+private:
+    CIntrusiveHeap<CSNode, &CSNode::m_tsTimeStamp> m_Heap;
+
+    CSndHeap(const CSndHeap&);
+    CSndHeap& operator=(const CSndHeap&);
+};
+
+/// The hierarchical timing wheel: O(1) insertion and removal.
+///
+/// Every level has 64 slots, a slot of level L covers 64^L ticks of 1us.
+/// A node is kept on the lowest level on which it shares the slot group
+/// with the wheel's current tick, so the lowest nonempty slot of the lowest
+/// nonempty level contains the earliest nodes. When the lowest level gets
+/// empty, the current tick moves to the next nonempty slot above and its
+/// nodes are moved down ("cascaded"). Nodes further than the wheel range
+/// (about 16s) wait on a separate list.
+class CSndTimingWheel : public CSndSchedule
+{
+public:
+    CSndTimingWheel();
+
+    void    insert(CSNode* n);
+    void    remove(CSNode* n);
+    void    advance(CSNode* n, const sync::steady_clock::time_point& ts);
+    CSNode* top();
+    int     size() const { return m_iCount; }
+
+private:
+    static const int LEVEL_BITS = 6;
+    static const int SLOTS      = 1 << LEVEL_BITS;
+    static const int LEVELS     = 4;
+    static const int FAR_SLOT   = LEVELS * SLOTS; // m_iHeapLoc value for the nodes out of range
+
+    int64_t tick(const CSNode* n) const;
+
+    /// Put the node into the slot matching its time stamp.
+    void place_(CSNode* n);
+
+    /// Move the current tick to the next nonempty slot and cascade its nodes.
+    /// @return false if the wheel is empty
+    bool cascade_();
+
+    void link_(CSNode* n, int loc);
+    void unlink_(CSNode* n);
+
+    sync::steady_clock::time_point m_tsBase; // time of tick 0
+    int64_t  m_iNow;                         // current tick, not later than any scheduled node
+    int      m_iCount;                       // number of scheduled nodes
+    CSNode*  m_pSlots[FAR_SLOT + 1];         // lists of nodes in slots, the last one for far nodes
+    uint64_t m_uMask[LEVELS];                // nonempty slots of each level
+    CSNode*  m_pTop;                         // cached earliest node, NULL if to be found
+
+    CSndTimingWheel(const CSndTimingWheel&);
+    CSndTimingWheel& operator=(const CSndTimingWheel&);
 };
 
 class CSndUList
 {
 public:
-    CSndUList(sync::CTimer* pTimer);
+    enum EScheduler
+    {
+        SCHED_DEFAULT = 0, // as selected at build time (USE_SNDQ_TIMING_WHEEL)
+        SCHED_HEAP,
+        SCHED_WHEEL
+    };
+
+    CSndUList(sync::CTimer* pTimer, EScheduler sched = SCHED_DEFAULT);
     ~CSndUList();
 
 public:
@@ -184,33 +317,20 @@ public:
     void signalInterrupt() const;
 
 private:
-    /// Doubles the size of the list.
-    ///
-    void realloc_();// REQUIRES(m_ListLock);
-
-    /// Insert a new UDT instance into the list with realloc if required.
+    /// Insert a new UDT instance into the list.
     ///
     /// @param [in] ts time stamp: next processing time
     /// @param [in] u pointer to the UDT instance
-    void insert_(const sync::steady_clock::time_point& ts, const CUDT* u);
-
-    /// Insert a new UDT instance into the list without realloc.
-    /// Should be called if there is a guaranteed space for the element.
-    ///
-    /// @param [in] ts time stamp: next processing time
-    /// @param [in] u pointer to the UDT instance
-    void insert_norealloc_(const sync::steady_clock::time_point& ts, const CUDT* u);// REQUIRES(m_ListLock);
+    void insert_(const sync::steady_clock::time_point& ts, const CUDT* u);// REQUIRES(m_ListLock);
 
     /// Removes CUDT entry from the list.
     /// If the last entry is removed, calls sync::CTimer::interrupt().
     void remove_(const CUDT* u);
 
 private:
-    CSNode** m_pHeap;        // The heap array
-    int      m_iArrayLength; // physical length of the array
-    int      m_iLastEntry;   // position of last entry on the heap array or -1 if empty.
+    CSndSchedule* m_pSchedule; // The heap or the timing wheel
 
-    mutable sync::Mutex     m_ListLock; // Protects the list (m_pHeap, m_iArrayLength, m_iLastEntry).
+    mutable sync::Mutex     m_ListLock; // Protects the list (m_pSchedule).
     mutable sync::Condition m_ListCond;
 
     sync::CTimer* const m_pTimer;
@@ -223,14 +343,16 @@ private:
 struct CRNode
 {
     CUDT*                          m_pUDT;        // Pointer to the instance of CUDT socket
-    sync::steady_clock::time_point m_tsTimeStamp; // Time Stamp
+    sync::steady_clock::time_point m_tsTimeStamp; // Time when the timers of the socket must be checked
 
-    CRNode* m_pPrev; // previous link
-    CRNode* m_pNext; // next link
+    int m_iHeapLoc; // location on the heap, -1 means not on the heap
 
     sync::atomic<bool> m_bOnList; // if the node is already on the list
 };
 
+/// Sockets of a receive queue ordered by the time when their timers must
+/// be checked, so that the receive worker only touches the sockets that
+/// have something to do. This is a binary min-heap.
 class CRcvUList
 {
 public:
@@ -238,7 +360,7 @@ public:
     ~CRcvUList();
 
 public:
-    /// Insert a new UDT instance to the list.
+    /// Insert a new UDT instance into the list, to be checked after the SYN interval.
     /// @param [in] u pointer to the UDT instance
 
     void insert(const CUDT* u);
@@ -248,22 +370,35 @@ public:
 
     void remove(const CUDT* u);
 
-    /// Move the UDT instance to the end of the list, if it already exists; otherwise, do nothing.
-    /// @param [in] u pointer to the UDT instance
+    /// Reschedule the UDT instance according to its timers, if it is on the list.
+    /// @param [in] u pointer to the UDT instance, after its checkTimers() call
 
-    void update(const CUDT* u);
+    void update(CUDT* u);
 
-public:
-    CRNode* m_pUList; // the head node
+    /// @return The node with the earliest time, or NULL if the list is empty.
+    CRNode* top() const { return m_Heap.top(); }
+
+    size_t size() const { return m_Heap.size(); }
 
 private:
-    CRNode* m_pLast; // the last node
+    CIntrusiveHeap<CRNode, &CRNode::m_tsTimeStamp> m_Heap;
 
 private:
     CRcvUList(const CRcvUList&);
     CRcvUList& operator=(const CRcvUList&);
 };
 
+/// Table of the sockets bound to a receive queue, looked up by the
+/// destination socket ID of every received packet.
+///
+/// This is an open-addressing hash table with robin-hood probing: entries
+/// are kept in one array, and an entry that is further from its home slot
+/// takes the place of one that is closer, which keeps the probe sequences
+/// short even at high load. The table grows when it becomes 3/4 full.
+///
+/// The table is only accessed by the worker thread of the receive queue,
+/// which is also the one that inserts and removes the sockets, so it needs
+/// no locking.
 class CHash
 {
 public:
@@ -272,7 +407,7 @@ public:
 
 public:
     /// Initialize the hash table.
-    /// @param [in] size hash table size
+    /// @param [in] size initial number of slots (rounded up to a power of 2)
 
     void init(int size);
 
@@ -280,9 +415,23 @@ public:
     /// @param [in] id socket ID
     /// @return Pointer to a UDT instance, or NULL if not found.
 
-    CUDT* lookup(int32_t id);
+    CUDT* lookup(int32_t id) const
+    {
+        int pos = home(id);
+        for (int dist = 0;; ++dist)
+        {
+            const CEntry& e = m_pEntries[pos];
+            // A robin-hood table has no entry further from its home slot
+            // than the one being looked for would be.
+            if (e.m_iDist < dist)
+                return NULL;
+            if (e.m_iID == id)
+                return e.m_pUDT;
+            pos = (pos + 1) & m_iMask;
+        }
+    }
 
-    /// Insert an entry to the hash table.
+    /// Insert an entry to the hash table. An existing entry with the same ID is replaced.
     /// @param [in] id socket ID
     /// @param [in] u pointer to the UDT instance
 
@@ -293,16 +442,34 @@ public:
 
     void remove(int32_t id);
 
+    /// @return Number of entries in the table.
+    int size() const { return m_iCount; }
+
+    /// @return Number of slots in the table.
+    int capacity() const { return m_iMask + 1; }
+
 private:
-    struct CBucket
+    struct CEntry
+    {
+        int32_t m_iID;   // Socket ID
+        int32_t m_iDist; // Distance from the home slot, -1 if the slot is empty
+        CUDT*   m_pUDT;  // Socket instance
+    };
+
+    int home(int32_t id) const
     {
-        int32_t m_iID;  // Socket ID
-        CUDT*   m_pUDT; // Socket instance
+        // Fibonacci hashing: socket IDs are allocated sequentially,
+        // multiplying spreads them over the whole table.
+        return int((uint32_t(id) * 2654435769u) >> m_iShift);
+    }
 
-        CBucket* m_pNext; // next bucket
-    } * *m_pBucket;       // list of buckets (the hash table)
+    void place(int32_t id, CUDT* u);
+    void resize(int slots);
 
-    int m_iHashSize; // size of hash table
+    CEntry* m_pEntries; // array of slots
+    int     m_iMask;    // number of slots - 1
+    int     m_iShift;   // 32 - log2(number of slots)
+    int     m_iCount;   // number of occupied slots
 
 private:
     CHash(const CHash&);
@@ -412,7 +579,11 @@ public:
     /// Initialize the sending queue.
     /// @param [in] c UDP channel to be associated to the queue
     /// @param [in] t Timer
-    void init(CChannel* c, sync::CTimer* t);
+    /// @param [in] batchsize maximum number of packets sent in one system call
+    /// @param [in] workers number of sending threads
+    /// @param [in] crypto threads encrypting the batched packets, or NULL
+    void init(CChannel* c, sync::CTimer* t, int batchsize = CSrtMuxerConfig::DEF_UDP_SNDBATCH,
+              int workers = CSrtMuxerConfig::DEF_SNDWORKERS, CCryptoPool* crypto = NULL);
 
     /// Send out a packet to a given address. The @a src parameter is
     /// blindly passed by the caller down the call with intention to
@@ -443,17 +614,116 @@ public:
     void setClosing() { m_bClosing = true; }
     void stop();
 
+    /// Get the list of the sending thread that serves the socket.
+    /// @param [in] u the socket
+    CSndUList* sndList(const CUDT* u) const;
+
+    /// Number of sending threads.
+    int workers() const { return m_iWorkers; }
+
+    /// Number of system calls that sent more than one packet at once.
+    int64_t batchCallsTotal() const;
+
+    /// Number of packets sent by system calls that sent more than one packet at once.
+    int64_t batchPacketsTotal() const;
+
+    /// Number of system calls that sent packets with UDP segmentation offload.
+    int64_t gsoCallsTotal() const;
+
+    /// Number of packets sent with UDP segmentation offload.
+    int64_t gsoPacketsTotal() const;
+
+    /// Number of jobs run by the crypto pool (SRTO_CRYPTOWORKERS), which
+    /// is shared with the receiving queue.
+    int64_t cryptoJobsTotal() const { return m_pCryptoPool ? m_pCryptoPool->jobsTotal() : 0; }
+
 private:
-    static void*  worker(void* param);
-    sync::CThread m_WorkerThread;
+    /// A sending thread with the sockets it serves. The sockets are
+    /// distributed among the threads by their ID, all threads send
+    /// through the same channel.
+    struct Worker
+    {
+        Worker();
+        ~Worker();
+
+        CSndQueue*    m_pQueue;
+        CSndUList*    m_pSndUList; // List of UDT instances for data sending
+        sync::CTimer* m_pTimer;    // Timing facility
+        bool          m_bOwnTimer; // The timer is not shared with the receiving queue
+        sync::CThread m_WorkerThread;
+
+        CBatchPacket* m_pBatch;        // Packets collected to be sent in one system call
+        CUDTSocket**  m_pBatchSocket;  // Sockets of the collected packets, acquired until the packets are sent
+        char*         m_pBatchCtlBuf;  // Storage for the packet filter control packets in the batch
+        bool*         m_pBatchEncrypt; // The packet is to be encrypted before sending (SRTO_CRYPTOWORKERS)
+
+        // Packets to be encrypted, grouped by socket, one job per socket.
+        std::vector<int>      m_vCryptoSlots;   // Positions in the batch
+        std::vector<CPacket*> m_vCryptoPackets; // The packets at these positions
+        std::vector<int>      m_vCryptoJobs;    // Start of every job in the above, followed by the end
+        std::vector<int>      m_vCryptoDone;    // Number of packets encrypted by every job
+
+        // Sockets that sent packets since the queue was last idle, acquired
+        // until their keystream is computed (SRTO_CRYPTOPRECOMP).
+        std::vector<CUDTSocket*> m_vPrecompSockets;
+
+        // Written only by the worker thread.
+        sync::atomic<int64_t> m_iBatchCalls;
+        sync::atomic<int64_t> m_iBatchPackets;
+        sync::atomic<int64_t> m_iGSOCalls;
+        sync::atomic<int64_t> m_iGSOPackets;
+
+    private:
+        Worker(const Worker&);
+        Worker& operator=(const Worker&);
+    };
+
+    static void* worker(void* param);
+
+    enum EPackResult
+    {
+        PACK_NOTREADY, // no socket is ready to send now
+        PACK_SKIPPED,  // the socket had nothing to send
+        PACK_DONE      // a packet was stored in the batch
+    };
+
+    /// Take the next socket ready to send from the list of @a w and
+    /// pack a packet from it into the batch at position @a pos.
+    EPackResult packNextReady(Worker& w, int pos);
+
+    /// Send out the first @a size packets collected in the batch of @a w.
+    void flushBatch(Worker& w, int size);
+
+    /// Encrypt the packets of the batch of @a w that were packed without
+    /// encryption, using the crypto pool. Packets that failed to be
+    /// encrypted are removed from the batch.
+    /// @return the new number of packets in the batch.
+    int encryptBatch(Worker& w, int size);
+
+    static void encryptJob(void* arg, int index);
+
+    /// Send out @a size packets from the batch of @a w starting at @a pos,
+    /// without segmentation offload.
+    void sendPackets(Worker& w, int pos, int size);
+
+    /// Compute the keystream of the sockets of @a w that sent packets, while
+    /// no packet is due, and release them. With @a compute false only release.
+    static void precomputeIdle(Worker& w, bool compute);
+
+    /// Get the number of packets starting at @a pos in the batch of @a w
+    /// that can be sent together with segmentation offload.
+    int segmentRun(const Worker& w, int pos, int size) const;
 
 private:
-    CSndUList*    m_pSndUList; // List of UDT instances for data sending
-    CChannel*     m_pChannel;  // The UDP channel for data sending
-    sync::CTimer* m_pTimer;    // Timing facility
+    Worker*      m_pWorkers; // Sending threads (SRTO_SNDWORKERS)
+    int          m_iWorkers;
+    CChannel*    m_pChannel;    // The UDP channel for data sending
+    CCryptoPool* m_pCryptoPool; // Threads encrypting the batched packets (SRTO_CRYPTOWORKERS)
 
     sync::atomic<bool> m_bClosing;            // closing the worker
 
+    int m_iBatchSize; // Maximum number of packets sent in one system call (SRTO_UDP_SNDBATCH)
+
 public:
 #if defined(SRT_DEBUG_SNDQ_HIGHRATE) //>>debug high freq worker
     sync::steady_clock::duration m_DbgPeriod;
@@ -503,7 +773,10 @@ public:
     /// @param [in] hsize hash table size
     /// @param [in] c UDP channel to be associated to the queue
     /// @param [in] t timer
-    void init(int size, size_t payload, int version, int hsize, CChannel* c, sync::CTimer* t);
+    /// @param [in] batchsize maximum number of packets received in one system call
+    /// @param [in] crypto threads decrypting the batched packets, or NULL
+    void init(int size, size_t payload, int version, int hsize, CChannel* c, sync::CTimer* t,
+              int batchsize = CSrtMuxerConfig::DEF_UDP_RCVBATCH, CCryptoPool* crypto = NULL);
 
     /// Read a packet for a specific UDT socket id.
     /// @param [in] id Socket ID
@@ -518,11 +791,38 @@ public:
     int getIPversion() { return m_iIPversion; }
 
     void stop();
+
+    /// Number of batched receive system calls that returned packets.
+    int64_t batchCallsTotal() const { return m_iBatchCalls.load(); }
+
+    /// Number of packets received by batched receive system calls.
+    int64_t batchPacketsTotal() const { return m_iBatchPackets.load(); }
+
+    /// Number of datagrams read with receive coalescing (SRTO_UDP_GRO).
+    int64_t groReadsTotal() const;
+
+    /// Number of packets found in the datagrams counted in groReadsTotal().
+    int64_t groSegmentsTotal() const;
+
+    /// Number of units allocated for the received packets.
+    int unitsCapacity() const { return m_pUnitQueue ? m_pUnitQueue->capacity() : 0; }
+
+    /// Number of units holding received packets.
+    int unitsTaken() const { return m_pUnitQueue ? m_pUnitQueue->takenUnits() : 0; }
+
+    /// Number of times the unused units were released.
+    int64_t unitsShrinkTotal() const { return m_pUnitQueue ? m_pUnitQueue->shrinkCount() : 0; }
+
 private:
     static void*  worker(void* param);
     sync::CThread m_WorkerThread;
     // Subroutines of worker
     EReadStatus    worker_RetrieveUnit(int32_t& id, CUnit*& unit, sockaddr_any& sa);
+    int            worker_ReserveBatch();
+    EReadStatus    worker_RetrieveBatch(int nunits, int32_t& id, CUnit*& unit, sockaddr_any& sa);
+    EReadStatus    worker_NextBatchUnit(int32_t& id, CUnit*& unit, sockaddr_any& sa);
+    void           worker_DecryptBatch(int count);
+    static void    decryptJob(void* arg, int index);
     EConnectStatus worker_ProcessConnectionRequest(CUnit* unit, const sockaddr_any& sa);
     EConnectStatus worker_TryAsyncRend_OrStore(int32_t id, CUnit* unit, const sockaddr_any& sa);
     EConnectStatus worker_ProcessAddressedPacket(int32_t id, CUnit* unit, const sockaddr_any& sa);
@@ -542,6 +842,24 @@ private:
     static srt::sync::atomic<int> m_counter; // A static counter to log RcvQueue worker thread number.
 #endif
 
+    int           m_iBatchSize;    // Maximum number of packets received in one system call (SRTO_UDP_RCVBATCH)
+    CUnit**       m_pBatchUnit;    // Units reserved for a batched read
+    CPacket**     m_pBatchPacket;  // Packets of the reserved units
+    sockaddr_any* m_pBatchAddr;    // Source addresses of the received packets
+    EReadStatus*  m_pBatchStatus;  // Read status of the received packets
+    int           m_iBatchPos;     // Next received packet to be dispatched
+    int           m_iBatchCount;   // Number of packets received in the last batched read
+
+    // Encrypted data packets of the batch, grouped by socket, one job per socket.
+    CCryptoPool*             m_pCryptoPool;    // Threads decrypting the batched packets (SRTO_CRYPTOWORKERS)
+    std::vector<CUnit*>      m_vCryptoUnits;   // The units to decrypt
+    std::vector<CUDTSocket*> m_vCryptoSockets; // Socket of every job, acquired until decrypted
+    std::vector<int>         m_vCryptoJobs;    // Start of every job in m_vCryptoUnits, followed by the end
+
+    // Written only by the worker thread.
+    sync::atomic<int64_t> m_iBatchCalls;
+    sync::atomic<int64_t> m_iBatchPackets;
+
 private:
     bool setListener(CUDT* u);
     CUDT* getListener();
@@ -581,6 +899,7 @@ struct CMultiplexer
     CRcvQueue*    m_pRcvQueue; // The receiving queue
     CChannel*     m_pChannel;  // The UDP channel for sending and receiving
     sync::CTimer* m_pTimer;    // The timer
+    CCryptoPool*  m_pCryptoPool; // Threads encrypting and decrypting packets, or NULL
 
     int m_iPort;      // The UDP port number of this multiplexer
     int m_iIPversion; // Address family (AF_INET or AF_INET6)
@@ -590,6 +909,10 @@ struct CMultiplexer
 
     int m_iID; // multiplexer ID
 
+    // ID of the first multiplexer of the group bound to the same address
+    // with SO_REUSEPORT (SRTO_LISTENSHARDS), or -1 if not in a group.
+    int m_iShardGroup;
+
     // Constructor should reset all pointers to NULL
     // to prevent dangling pointer when checking for memory alloc fails
     CMultiplexer()
@@ -597,10 +920,12 @@ struct CMultiplexer
         , m_pRcvQueue(NULL)
         , m_pChannel(NULL)
         , m_pTimer(NULL)
+        , m_pCryptoPool(NULL)
         , m_iPort(0)
         , m_iIPversion(0)
         , m_iRefCount(1)
         , m_iID(-1)
+        , m_iShardGroup(-1)
     {
     }
 
@@ -612,6 +937,8 @@ struct CMultiplexer
             delete m_pSndQueue;
         if (m_pTimer != NULL)
             delete m_pTimer;
+        // After the queues, which use it.
+        delete m_pCryptoPool;
         close();
     }
     void resetAtFork();
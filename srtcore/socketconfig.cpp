@@ -173,6 +173,96 @@ struct CSrtConfigSetter<SRTO_UDP_RCVBUF>
         co.iUDPRcvBufSize = std::max(co.iMSS, cast_optval<int>(optval, optlen));
     }
 };
+template<>
+struct CSrtConfigSetter<SRTO_UDP_SNDBATCH>
+{
+    static void set(CSrtConfig& co, const void* optval, int optlen)
+    {
+        const int val = cast_optval<int>(optval, optlen);
+        if (val < 1 || val > CSrtMuxerConfig::MAX_UDP_SNDBATCH)
+            throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+
+        co.iUDPSndBatch = val;
+    }
+};
+
+template<>
+struct CSrtConfigSetter<SRTO_UDP_RCVBATCH>
+{
+    static void set(CSrtConfig& co, const void* optval, int optlen)
+    {
+        const int val = cast_optval<int>(optval, optlen);
+        if (val < 1 || val > CSrtMuxerConfig::MAX_UDP_RCVBATCH)
+            throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+
+        co.iUDPRcvBatch = val;
+    }
+};
+
+template<>
+struct CSrtConfigSetter<SRTO_UDP_GSO>
+{
+    static void set(CSrtConfig& co, const void* optval, int optlen)
+    {
+        co.bUDPGSO = cast_optval<bool>(optval, optlen);
+    }
+};
+
+template<>
+struct CSrtConfigSetter<SRTO_UDP_GRO>
+{
+    static void set(CSrtConfig& co, const void* optval, int optlen)
+    {
+        co.bUDPGRO = cast_optval<bool>(optval, optlen);
+    }
+};
+
+template<>
+struct CSrtConfigSetter<SRTO_SNDWORKERS>
+{
+    static void set(CSrtConfig& co, const void* optval, int optlen)
+    {
+        const int val = cast_optval<int>(optval, optlen);
+        if (val < 1 || val > CSrtMuxerConfig::MAX_SNDWORKERS)
+            throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+
+        co.iSndWorkers = val;
+    }
+};
+
+template<>
+struct CSrtConfigSetter<SRTO_CRYPTOWORKERS>
+{
+    static void set(CSrtConfig& co, const void* optval, int optlen)
+    {
+        const int val = cast_optval<int>(optval, optlen);
+        if (val < 0 || val > CSrtMuxerConfig::MAX_CRYPTOWORKERS)
+            throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+
+        co.iCryptoWorkers = val;
+    }
+};
+
+template<>
+struct CSrtConfigSetter<SRTO_LISTENSHARDS>
+{
+    static void set(CSrtConfig& co, const void* optval, int optlen)
+    {
+        const int val = cast_optval<int>(optval, optlen);
+        if (val < 1 || val > CSrtMuxerConfig::MAX_LISTENSHARDS)
+            throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+
+#if !(defined(__linux__) && defined(SO_REUSEPORT))
+        // Sharding requires the system to spread the datagrams among the UDP
+        // sockets bound to the same address, which only Linux does.
+        if (val > 1)
+            throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+#endif
+
+        co.iListenShards = val;
+    }
+};
+
 template<>
 struct CSrtConfigSetter<SRTO_RENDEZVOUS>
 {
@@ -541,6 +631,15 @@ struct CSrtConfigSetter<SRTO_CONNTIMEO>
     }
 };
 
+template<>
+struct CSrtConfigSetter<SRTO_TSBPDSHARED>
+{
+    static void set(CSrtConfig& co, const void* optval, int optlen)
+    {
+        co.bTSBPDShared = cast_optval<bool>(optval, optlen);
+    }
+};
+
 template<>
 struct CSrtConfigSetter<SRTO_DRIFTTRACER>
 {
@@ -889,6 +988,19 @@ struct CSrtConfigSetter<SRTO_RETRANSMITALGO>
     }
 };
 
+template<>
+struct CSrtConfigSetter<SRTO_CRYPTOPRECOMP>
+{
+    static void set(CSrtConfig& co, const void* optval, int optlen)
+    {
+        const int val = cast_optval<int>(optval, optlen);
+        if (val < 0 || val > CSrtConfig::MAX_CRYPTOPRECOMP)
+            throw CUDTException(MJ_NOTSUP, MN_INVAL, 0);
+
+        co.iCryptoPrecomp = val;
+    }
+};
+
 #ifdef ENABLE_AEAD_API_PREVIEW
 template<>
 struct CSrtConfigSetter<SRTO_CRYPTOMODE>
@@ -936,6 +1048,13 @@ int dispatchSet(SRT_SOCKOPT optName, CSrtConfig& co, const void* optval, int opt
         DISPATCH(SRTO_LINGER);
         DISPATCH(SRTO_UDP_SNDBUF);
         DISPATCH(SRTO_UDP_RCVBUF);
+        DISPATCH(SRTO_UDP_SNDBATCH);
+        DISPATCH(SRTO_UDP_RCVBATCH);
+        DISPATCH(SRTO_UDP_GSO);
+        DISPATCH(SRTO_UDP_GRO);
+        DISPATCH(SRTO_SNDWORKERS);
+        DISPATCH(SRTO_CRYPTOWORKERS);
+        DISPATCH(SRTO_LISTENSHARDS);
         DISPATCH(SRTO_RENDEZVOUS);
         DISPATCH(SRTO_SNDTIMEO);
         DISPATCH(SRTO_RCVTIMEO);
@@ -951,6 +1070,7 @@ int dispatchSet(SRT_SOCKOPT optName, CSrtConfig& co, const void* optval, int opt
         DISPATCH(SRTO_OHEADBW);
         DISPATCH(SRTO_SENDER);
         DISPATCH(SRTO_TSBPDMODE);
+        DISPATCH(SRTO_TSBPDSHARED);
         DISPATCH(SRTO_LATENCY);
         DISPATCH(SRTO_RCVLATENCY);
         DISPATCH(SRTO_PEERLATENCY);
@@ -979,6 +1099,7 @@ int dispatchSet(SRT_SOCKOPT optName, CSrtConfig& co, const void* optval, int opt
         DISPATCH(SRTO_IPV6ONLY);
         DISPATCH(SRTO_PACKETFILTER);
         DISPATCH(SRTO_RETRANSMITALGO);
+        DISPATCH(SRTO_CRYPTOPRECOMP);
 #ifdef ENABLE_AEAD_API_PREVIEW
         DISPATCH(SRTO_CRYPTOMODE);
 #endif
@@ -1050,6 +1171,7 @@ bool SRT_SocketOptionObject::add(SRT_SOCKOPT optname, const void* optval, size_t
     {
     case SRTO_BINDTODEVICE:
     case SRTO_CONNTIMEO:
+    case SRTO_CRYPTOPRECOMP:
     case SRTO_DRIFTTRACER:
         //SRTO_FC - not allowed to be different among group members
     case SRTO_GROUPMINSTABLETIMEO:
@@ -1078,8 +1200,16 @@ bool SRT_SocketOptionObject::add(SRT_SOCKOPT optname, const void* optval, size_t
     case SRTO_SNDDROPDELAY:
         //SRTO_TLPKTDROP - per transmission setting
         //SRTO_TSBPDMODE - per transmission setting
+    case SRTO_TSBPDSHARED:
     case SRTO_UDP_RCVBUF:
     case SRTO_UDP_SNDBUF:
+    case SRTO_UDP_SNDBATCH:
+    case SRTO_UDP_RCVBATCH:
+    case SRTO_UDP_GSO:
+    case SRTO_UDP_GRO:
+    case SRTO_SNDWORKERS:
+    case SRTO_CRYPTOWORKERS:
+    case SRTO_LISTENSHARDS:
         break;
 
     default:
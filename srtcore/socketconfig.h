@@ -81,6 +81,16 @@ namespace srt
 struct CSrtMuxerConfig
 {
     static const int DEF_UDP_BUFFER_SIZE = 65536;
+    static const int DEF_UDP_SNDBATCH = 1;   // One packet per system call (no batching)
+    static const int MAX_UDP_SNDBATCH = 64;  // Upper limit for packets sent in one system call
+    static const int DEF_UDP_RCVBATCH = 1;   // One packet per system call (no batching)
+    static const int MAX_UDP_RCVBATCH = 64;  // Upper limit for packets received in one system call
+    static const int DEF_SNDWORKERS = 1;     // One sending thread per multiplexer
+    static const int MAX_SNDWORKERS = 16;    // Upper limit for sending threads per multiplexer
+    static const int DEF_CRYPTOWORKERS = 0;  // Encryption done by the sending and receiving threads
+    static const int MAX_CRYPTOWORKERS = 16; // Upper limit for crypto threads per multiplexer
+    static const int DEF_LISTENSHARDS = 1;   // One UDP socket per bound address
+    static const int MAX_LISTENSHARDS = 32;  // Upper limit for UDP sockets sharing the bound address
 
     int  iIpTTL;
     int  iIpToS;
@@ -92,6 +102,13 @@ struct CSrtMuxerConfig
 #endif
     int iUDPSndBufSize; // UDP sending buffer size
     int iUDPRcvBufSize; // UDP receiving buffer size
+    int iUDPSndBatch;   // Maximum number of packets sent in one system call
+    int iUDPRcvBatch;   // Maximum number of packets received in one system call
+    bool bUDPGSO;       // Use UDP generic segmentation offload for the batched packets
+    bool bUDPGRO;       // Accept packets coalesced by UDP generic receive offload
+    int iSndWorkers;    // Number of sending threads
+    int iCryptoWorkers; // Number of threads encrypting and decrypting packets (0: none)
+    int iListenShards;  // Number of multiplexers sharing the address with SO_REUSEPORT
 
     // NOTE: this operator is not reversable. The syntax must use:
     //  muxer_entry == socket_entry
@@ -106,6 +123,13 @@ struct CSrtMuxerConfig
 #endif
             && CEQUAL(iUDPSndBufSize)
             && CEQUAL(iUDPRcvBufSize)
+            && CEQUAL(iUDPSndBatch)
+            && CEQUAL(iUDPRcvBatch)
+            && CEQUAL(bUDPGSO)
+            && CEQUAL(bUDPGRO)
+            && CEQUAL(iSndWorkers)
+            && CEQUAL(iCryptoWorkers)
+            && CEQUAL(iListenShards)
             && (other.iIpV6Only == -1 || CEQUAL(iIpV6Only))
             // NOTE: iIpV6Only is not regarded because
             // this matches only in case of IPv6 with "any" address.
@@ -123,6 +147,13 @@ struct CSrtMuxerConfig
         , bReuseAddr(true) // This is default in SRT
         , iUDPSndBufSize(DEF_UDP_BUFFER_SIZE)
         , iUDPRcvBufSize(DEF_UDP_BUFFER_SIZE)
+        , iUDPSndBatch(DEF_UDP_SNDBATCH)
+        , iUDPRcvBatch(DEF_UDP_RCVBATCH)
+        , bUDPGSO(false)
+        , bUDPGRO(false)
+        , iSndWorkers(DEF_SNDWORKERS)
+        , iCryptoWorkers(DEF_CRYPTOWORKERS)
+        , iListenShards(DEF_LISTENSHARDS)
     {
     }
 };
@@ -218,6 +249,9 @@ struct CSrtConfig: CSrtMuxerConfig
     static const size_t MAX_PFILTER_LENGTH = 64;
     static const size_t MAX_CONG_LENGTH    = 16;
 
+    static const int DEF_CRYPTOPRECOMP = 0;    // Keystream computed when the packet is encrypted
+    static const int MAX_CRYPTOPRECOMP = 1024; // Upper limit for packets with a precomputed keystream
+
     int    iMSS;            // Maximum Segment Size, in bytes
     size_t zExpPayloadSize; // Expected average payload size (user option)
 
@@ -251,6 +285,7 @@ struct CSrtConfig: CSrtMuxerConfig
 
     bool     bMessageAPI;
     bool     bTSBPD;        // Whether AGENT will do TSBPD Rx (whether peer does, is not agent's problem)
+    bool     bTSBPDShared;  // Whether TSBPD Rx is done by the shared threads
     int      iRcvLatency;   // Agent's Rx latency
     int      iPeerLatency;  // Peer's Rx latency for the traffic made by Agent's Tx.
     bool     bTLPktDrop;    // Whether Agent WILL DO TLPKTDROP on Rx.
@@ -261,6 +296,7 @@ struct CSrtConfig: CSrtMuxerConfig
     uint32_t uMinStabilityTimeout_ms;
     int      iRetransmitAlgo;
     int      iCryptoMode; // SRTO_CRYPTOMODE
+    int      iCryptoPrecomp; // SRTO_CRYPTOPRECOMP
 
     int64_t llInputBW;         // Input stream rate (bytes/sec). 0: use internally estimated input bandwidth
     int64_t llMinInputBW;      // Minimum input stream rate estimate (bytes/sec)
@@ -306,6 +342,7 @@ struct CSrtConfig: CSrtMuxerConfig
         , bDataSender(false)
         , bMessageAPI(true)
         , bTSBPD(true)
+        , bTSBPDShared(false)
         , iRcvLatency(SRT_LIVE_DEF_LATENCY_MS)
         , iPeerLatency(0)
         , bTLPktDrop(true)
@@ -316,6 +353,7 @@ struct CSrtConfig: CSrtMuxerConfig
         , uMinStabilityTimeout_ms(COMM_DEF_MIN_STABILITY_TIMEOUT_MS)
         , iRetransmitAlgo(1)
         , iCryptoMode(CIPHER_MODE_AUTO)
+        , iCryptoPrecomp(DEF_CRYPTOPRECOMP)
         , llInputBW(0)
         , llMinInputBW(0)
         , iOverheadBW(SRT_OHEAD_DEFAULT_P100)
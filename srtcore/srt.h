@@ -237,6 +237,15 @@ typedef enum SRT_SOCKOPT {
 #ifdef ENABLE_MAXREXMITBW
    SRTO_MAXREXMITBW = 63,    // Maximum bandwidth limit for retransmision (Bytes/s)
 #endif
+   SRTO_UDP_SNDBATCH = 64,   // Maximum number of packets sent in one system call by the multiplexer
+   SRTO_UDP_RCVBATCH = 65,   // Maximum number of packets received in one system call by the multiplexer
+   SRTO_UDP_GSO = 66,        // Send consecutive same-size packets of a socket with UDP segmentation offload
+   SRTO_UDP_GRO = 67,        // Receive packets coalesced by UDP generic receive offload
+   SRTO_SNDWORKERS = 68,     // Number of threads sending packets of the sockets of the multiplexer
+   SRTO_LISTENSHARDS = 69,   // Number of UDP sockets bound with SO_REUSEPORT to share the incoming traffic
+   SRTO_TSBPDSHARED = 70,    // Deliver received packets with the shared TSBPD threads instead of a thread per socket
+   SRTO_CRYPTOWORKERS = 71,  // Number of threads encrypting and decrypting packets of the sockets of the multiplexer
+   SRTO_CRYPTOPRECOMP = 72,  // Number of upcoming packets with the AES-CTR keystream computed ahead of sending
 
    SRTO_E_SIZE // Always last element, not a valid option.
 } SRT_SOCKOPT;
@@ -405,6 +414,26 @@ struct CBytePerfMon
    int64_t  pktRecvUnique;              // number of packets to be received by the application
    uint64_t byteSentUnique;             // number of data bytes, sent by the application
    uint64_t byteRecvUnique;             // number of data bytes to be received by the application
+
+   // New stats in 1.6.0
+
+   // Multiplexer (shared by all sockets bound to the same UDP socket)
+   int64_t  sndBatchCallsTotal;         // total number of batched send system calls issued by the multiplexer
+   int64_t  pktSndBatchTotal;           // total number of packets sent by the multiplexer in batched send calls
+   int64_t  rcvBatchCallsTotal;         // total number of batched receive system calls that returned packets
+   int64_t  pktRcvBatchTotal;           // total number of packets received by the multiplexer in batched receive calls
+   int64_t  sndGSOCallsTotal;           // total number of send system calls using UDP segmentation offload
+   int64_t  pktSndGSOTotal;             // total number of packets sent with UDP segmentation offload
+   int64_t  rcvGROReadsTotal;           // total number of datagrams read with UDP receive coalescing
+   int64_t  pktRcvGROTotal;             // total number of packets found in the datagrams read with UDP receive coalescing
+   int      pktRcvUnitsCapacity;        // number of units allocated by the multiplexer for received packets
+   int      pktRcvUnitsTaken;           // number of those units holding packets not yet read or dropped
+   int64_t  rcvUnitsShrinkTotal;        // total number of times the multiplexer released unused units
+   double   groupSndShare;              // percentage of the messages of a balancing group sent over this member
+   double   groupRcvShare;              // percentage of the messages of a balancing group received over this member
+   int64_t  pktSndKeystreamHitTotal;    // total number of packets encrypted with a precomputed keystream
+   int64_t  pktSndKeystreamMissTotal;   // total number of packets encrypted without a precomputed keystream, while enabled
+   int64_t  cryptoJobsTotal;            // total number of encryption and decryption jobs run by the crypto threads of the multiplexer
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -839,6 +868,15 @@ SRT_API int srt_send    (SRTSOCKET u, const char* buf, int len);
 SRT_API int srt_sendmsg (SRTSOCKET u, const char* buf, int len, int ttl/* = -1*/, int inorder/* = false*/);
 SRT_API int srt_sendmsg2(SRTSOCKET u, const char* buf, int len, SRT_MSGCTRL *mctrl);
 
+// Zero-copy sending: the payload isn't copied into the sender buffer, so the
+// buffer must stay unchanged until SRT calls release_fn(opaque) for it. This
+// happens once for every successful call, when all packets of the message
+// were acknowledged or dropped, or the socket was closed. The callback is
+// called from an internal SRT thread and must not call any SRT function.
+typedef void srt_sendbuf_release_fn(void* opaque);
+SRT_API int srt_sendmsg_zc(SRTSOCKET u, const char* buf, int len, SRT_MSGCTRL *mctrl,
+                           srt_sendbuf_release_fn* release_fn, void* opaque);
+
 //
 // Receiving functions
 //
@@ -848,6 +886,24 @@ SRT_API int srt_recv    (SRTSOCKET u, char* buf, int len);
 SRT_API int srt_recvmsg (SRTSOCKET u, char* buf, int len);
 SRT_API int srt_recvmsg2(SRTSOCKET u, char *buf, int len, SRT_MSGCTRL *mctrl);
 
+// Zero-copy receiving: instead of copying the message, srt_recvmsg_zc lends
+// the payloads of its packets, which stay valid and unchanged until the loan
+// is returned with srt_recvmsg_release or the socket is closed.
+typedef struct SRT_RCVSEG
+{
+    const char* data;
+    int len;
+} SRT_RCVSEG;
+
+typedef struct SRT_RCVLOAN
+{
+    const SRT_RCVSEG* segs; // payloads of the packets of the message, in order
+    int nsegs;
+} SRT_RCVLOAN;
+
+SRT_API int srt_recvmsg_zc(SRTSOCKET u, SRT_RCVLOAN* loan, SRT_MSGCTRL *mctrl);
+SRT_API int srt_recvmsg_release(SRTSOCKET u, const SRT_RCVLOAN* loan);
+
 
 // Special send/receive functions for files only.
 #define SRT_DEFAULT_SENDFILE_BLOCK 364000
@@ -867,6 +923,7 @@ SRT_API       void  srt_clearlasterror(void);
 SRT_API int srt_bstats(SRTSOCKET u, SRT_TRACEBSTATS * perf, int clear);
 // Performance monitor with Byte counters and instantaneous stats instead of moving averages for Snd/Rcvbuffer sizes.
 SRT_API int srt_bistats(SRTSOCKET u, SRT_TRACEBSTATS * perf, int clear, int instantaneous);
+SRT_API int srt_getkekcachestats(int64_t* hits, int64_t* misses);
 
 // Socket Status (for problem tracking)
 SRT_API SRT_SOCKSTATUS srt_getsockstate(SRTSOCKET u);
@@ -907,6 +964,7 @@ SRT_API void srt_resetlogfa(const int* fara, size_t fara_size);
 // SRT_API void srt_setlogstream(std::ostream& stream);
 SRT_API void srt_setloghandler(void* opaque, SRT_LOG_HANDLER_FN* handler);
 SRT_API void srt_setlogflags(int flags);
+SRT_API int64_t srt_getlogoverflow(void);
 
 
 SRT_API int srt_getsndbuffer(SRTSOCKET sock, size_t* blocks, size_t* bytes);
@@ -943,6 +1001,7 @@ typedef enum SRT_GROUP_TYPE
     SRT_GTYPE_UNDEFINED,
     SRT_GTYPE_BROADCAST,
     SRT_GTYPE_BACKUP,
+    SRT_GTYPE_BALANCING,
     // ...
     SRT_GTYPE_E_END
 } SRT_GROUP_TYPE;
@@ -239,6 +239,15 @@ int srt_sendmsg2(SRTSOCKET u, const char * buf, int len, SRT_MSGCTRL *mctrl)
     return CUDT::sendmsg2(u, buf, len, (mignore));
 }
 
+int srt_sendmsg_zc(SRTSOCKET u, const char * buf, int len, SRT_MSGCTRL *mctrl,
+                   srt_sendbuf_release_fn* release_fn, void* opaque)
+{
+    if (mctrl)
+        return CUDT::sendmsgZeroCopy(u, buf, len, (*mctrl), release_fn, opaque);
+    SRT_MSGCTRL mignore = srt_msgctrl_default;
+    return CUDT::sendmsgZeroCopy(u, buf, len, (mignore), release_fn, opaque);
+}
+
 int srt_recvmsg2(SRTSOCKET u, char * buf, int len, SRT_MSGCTRL *mctrl)
 {
     if (mctrl)
@@ -247,6 +256,16 @@ int srt_recvmsg2(SRTSOCKET u, char * buf, int len, SRT_MSGCTRL *mctrl)
     return CUDT::recvmsg2(u, buf, len, (mignore));
 }
 
+int srt_recvmsg_zc(SRTSOCKET u, SRT_RCVLOAN* loan, SRT_MSGCTRL *mctrl)
+{
+    if (mctrl)
+        return CUDT::recvmsgZeroCopy(u, loan, (*mctrl));
+    SRT_MSGCTRL mignore = srt_msgctrl_default;
+    return CUDT::recvmsgZeroCopy(u, loan, (mignore));
+}
+
+int srt_recvmsg_release(SRTSOCKET u, const SRT_RCVLOAN* loan) { return CUDT::releaseRecvLoan(u, loan); }
+
 const char* srt_getlasterror_str() { return UDT::getlasterror().getErrorMessage(); }
 
 int srt_getlasterror(int* loc_errno)
@@ -270,6 +289,16 @@ void srt_clearlasterror()
 int srt_bstats(SRTSOCKET u, SRT_TRACEBSTATS * perf, int clear) { return CUDT::bstats(u, perf, 0!=  clear); }
 int srt_bistats(SRTSOCKET u, SRT_TRACEBSTATS * perf, int clear, int instantaneous) { return CUDT::bstats(u, perf, 0!=  clear, 0!= instantaneous); }
 
+int srt_getkekcachestats(int64_t* hits, int64_t* misses)
+{
+    if (!hits || !misses)
+        return CUDT::APIError(MJ_NOTSUP, MN_INVAL, 0);
+
+    *hits   = CKekCache::instance().hits();
+    *misses = CKekCache::instance().misses();
+    return 0;
+}
+
 SRT_SOCKSTATUS srt_getsockstate(SRTSOCKET u) { return SRT_SOCKSTATUS((int)CUDT::getsockstate(u)); }
 
 // event mechanism
@@ -376,6 +405,11 @@ void srt_setlogflags(int flags)
     UDT::setlogflags(flags);
 }
 
+int64_t srt_getlogoverflow()
+{
+    return UDT::getlogoverflow();
+}
+
 int srt_getsndbuffer(SRTSOCKET sock, size_t* blocks, size_t* bytes)
 {
     return CUDT::getsndbuffer(sock, blocks, bytes);
@@ -13,6 +13,7 @@
 
 #include "platform_sys.h"
 #include "packet.h"
+#include "atomic.h"
 
 namespace srt
 {
@@ -42,6 +43,11 @@ public:
         return m_count;
     }
 
+    Packets operator- (const Packets& other) const
+    {
+        return Packets(m_count - other.m_count);
+    }
+
 private:
     uint32_t m_count;
 };
@@ -94,19 +100,24 @@ public:
         return m_bytes + m_packets * hdr_size;
     }
 
+    BytesPackets operator- (const BytesPackets& other) const
+    {
+        return BytesPackets(m_bytes - other.m_bytes, m_packets - other.m_packets);
+    }
+
 protected:
     uint64_t m_bytes;
     uint32_t m_packets;
 };
 
 
-template <class METRIC_TYPE, class BASE_METRIC_TYPE = METRIC_TYPE>
+template <class METRIC_TYPE>
 struct Metric
 {
     METRIC_TYPE trace;
     METRIC_TYPE total;
 
-    void count(BASE_METRIC_TYPE val)
+    void count(METRIC_TYPE val)
     {
         trace += val;
         total += val;
@@ -130,19 +141,121 @@ struct Metric
     }
 };
 
-/// Sender-side statistics.
-struct Sender
+/// Value of a counter updated without a lock.
+template <class METRIC_TYPE>
+class AtomicCount;
+
+template <>
+class AtomicCount<Packets>
+{
+public:
+    void add(const Packets& val) { m_count.fetch_add_relaxed(val.count()); }
+    Packets load() const { return Packets(m_count.load()); }
+    void reset() { m_count.store(0); }
+
+private:
+    sync::atomic<uint32_t> m_count;
+};
+
+/// The bytes and the packets are two counters, so a writer counts between
+/// the increments of m_enter and m_leave, like in a seqlock that allows
+/// concurrent writers: the reader retries until it reads both counters
+/// with no writer in progress and none started meanwhile, so that the
+/// bytes and the packets are always of the same packets.
+template <>
+class AtomicCount<BytesPackets>
 {
-    Metric<BytesPackets> sent;
-    Metric<BytesPackets> sentUnique;
-    Metric<BytesPackets> sentRetrans; // The number of data packets retransmitted by the sender.
-    Metric<Packets> lost; // The number of packets reported lost (including repeated reports) to the sender in NAKs.
-    Metric<BytesPackets> dropped; // The number of data packets dropped by the sender.
+public:
+    void add(const BytesPackets& val)
+    {
+        ++m_enter;
+        m_packets.fetch_add_relaxed(val.count());
+        m_bytes.fetch_add_relaxed(val.bytes());
+        ++m_leave;
+    }
+
+    BytesPackets load() const
+    {
+        for (;;)
+        {
+            // m_leave first: if equal, no writer was in progress when m_enter was read.
+            const uint32_t leave = m_leave.load();
+            const uint32_t enter = m_enter.load();
+            if (enter != leave)
+                continue;
+
+            const BytesPackets val(m_bytes.load(), m_packets.load());
+            if (m_enter.load() == enter)
+                return val;
+        }
+    }
+
+    void reset()
+    {
+        m_packets.store(0);
+        m_bytes.store(0);
+    }
+
+private:
+    sync::atomic<uint64_t> m_bytes;
+    sync::atomic<uint32_t> m_packets;
+    sync::atomic<uint32_t> m_enter; // number of writers started
+    sync::atomic<uint32_t> m_leave; // number of writers finished
+};
 
-    Metric<Packets> sentFilterExtra; // The number of packets generate by the packet filter and sent by the sender.
+/// A metric counted by the sending, receiving and application threads with
+/// a relaxed atomic addition, without a lock. Only the total is counted;
+/// the trace is the difference from the total at the last trace reset,
+/// which the statistics reader keeps under its own lock, so reading
+/// the statistics doesn't modify the counters and no count is lost
+/// between the reading and the reset of the trace.
+template <class METRIC_TYPE>
+class AtomicMetric
+{
+public:
+    void count(const METRIC_TYPE& val) { m_total.add(val); }
+
+    METRIC_TYPE total() const { return m_total.load(); }
+
+    void reset()
+    {
+        m_total.reset();
+        m_traceBase = METRIC_TYPE();
+    }
+
+    void resetTrace() { m_traceBase = m_total.load(); }
+
+    /// Reads the trace and the total value from a single reading of the
+    /// counter, and starts a new trace interval if @a reset_trace.
+    void snapshot(Metric<METRIC_TYPE>& w_snap, bool reset_trace)
+    {
+        const METRIC_TYPE total = m_total.load();
+        w_snap.total = total;
+        w_snap.trace = total - m_traceBase;
+        if (reset_trace)
+            m_traceBase = total;
+    }
+
+private:
+    AtomicCount<METRIC_TYPE> m_total;
+    METRIC_TYPE m_traceBase;
+};
+
+/// Sender-side statistics. The counters are AtomicMetric in the socket,
+/// and Metric in a snapshot.
+template <template <class> class METRIC>
+struct SenderMetrics
+{
+    METRIC<BytesPackets> sent;
+    METRIC<BytesPackets> sentUnique;
+    METRIC<BytesPackets> sentRetrans; // The number of data packets retransmitted by the sender.
+    METRIC<Packets> lost; // The number of packets reported lost (including repeated reports) to the sender in NAKs.
+    METRIC<BytesPackets> dropped; // The number of data packets dropped by the sender.
+
+    METRIC<Packets> sentFilterExtra; // The number of packets generate by the packet filter and sent by the sender.
     
-    Metric<Packets> recvdAck; // The number of ACK packets received by the sender.
-    Metric<Packets> recvdNak; // The number of ACK packets received by the sender.
+    METRIC<Packets> recvdAck; // The number of ACK packets received by the sender.
+    METRIC<Packets> recvdNak; // The number of ACK packets received by the sender.
 
     void reset()
     {
@@ -167,25 +280,42 @@ struct Sender
         recvdNak.resetTrace();
         sentFilterExtra.resetTrace();
     }
+
+    void snapshot(SenderMetrics<Metric>& w_snap, bool reset_trace)
+    {
+        sent.snapshot(w_snap.sent, reset_trace);
+        sentUnique.snapshot(w_snap.sentUnique, reset_trace);
+        sentRetrans.snapshot(w_snap.sentRetrans, reset_trace);
+        lost.snapshot(w_snap.lost, reset_trace);
+        dropped.snapshot(w_snap.dropped, reset_trace);
+        recvdAck.snapshot(w_snap.recvdAck, reset_trace);
+        recvdNak.snapshot(w_snap.recvdNak, reset_trace);
+        sentFilterExtra.snapshot(w_snap.sentFilterExtra, reset_trace);
+    }
 };
 
-/// Receiver-side statistics.
-struct Receiver
+typedef SenderMetrics<AtomicMetric> Sender;
+typedef SenderMetrics<Metric> SenderSnapshot;
+
+/// Receiver-side statistics. The counters are AtomicMetric in the socket,
+/// and Metric in a snapshot.
+template <template <class> class METRIC>
+struct ReceiverMetrics
 {
-    Metric<BytesPackets> recvd;
-    Metric<BytesPackets> recvdUnique;
-    Metric<BytesPackets> recvdRetrans; // The number of retransmitted data packets received by the receiver.
-    Metric<BytesPackets> lost; // The number of packets detected by the receiver as lost.
-    Metric<BytesPackets> dropped; // The number of packets dropped by the receiver (as too-late to be delivered).
-    Metric<BytesPackets> recvdBelated; // The number of belated packets received (dropped as too late but eventually received).
-    Metric<BytesPackets> undecrypted; // The number of packets received by the receiver that failed to be decrypted.
+    METRIC<BytesPackets> recvd;
+    METRIC<BytesPackets> recvdUnique;
+    METRIC<BytesPackets> recvdRetrans; // The number of retransmitted data packets received by the receiver.
+    METRIC<BytesPackets> lost; // The number of packets detected by the receiver as lost.
+    METRIC<BytesPackets> dropped; // The number of packets dropped by the receiver (as too-late to be delivered).
+    METRIC<BytesPackets> recvdBelated; // The number of belated packets received (dropped as too late but eventually received).
+    METRIC<BytesPackets> undecrypted; // The number of packets received by the receiver that failed to be decrypted.
 
-    Metric<Packets> recvdFilterExtra; // The number of filter packets (e.g. FEC) received by the receiver.
-    Metric<Packets> suppliedByFilter; // The number of lost packets got from the packet filter at the receiver side (e.g. loss recovered by FEC).
-    Metric<Packets> lossFilter; // The number of lost DATA packets not recovered by the packet filter at the receiver side.
+    METRIC<Packets> recvdFilterExtra; // The number of filter packets (e.g. FEC) received by the receiver.
+    METRIC<Packets> suppliedByFilter; // The number of lost packets got from the packet filter at the receiver side (e.g. loss recovered by FEC).
+    METRIC<Packets> lossFilter; // The number of lost DATA packets not recovered by the packet filter at the receiver side.
 
-    Metric<Packets> sentAck; // The number of ACK packets sent by the receiver.
-    Metric<Packets> sentNak; // The number of NACK packets sent by the receiver.
+    METRIC<Packets> sentAck; // The number of ACK packets sent by the receiver.
+    METRIC<Packets> sentNak; // The number of NACK packets sent by the receiver.
 
     void reset()
     {
@@ -218,8 +348,27 @@ struct Receiver
         sentAck.resetTrace();
         sentNak.resetTrace();
     }
+
+    void snapshot(ReceiverMetrics<Metric>& w_snap, bool reset_trace)
+    {
+        recvd.snapshot(w_snap.recvd, reset_trace);
+        recvdUnique.snapshot(w_snap.recvdUnique, reset_trace);
+        recvdRetrans.snapshot(w_snap.recvdRetrans, reset_trace);
+        lost.snapshot(w_snap.lost, reset_trace);
+        dropped.snapshot(w_snap.dropped, reset_trace);
+        recvdBelated.snapshot(w_snap.recvdBelated, reset_trace);
+        undecrypted.snapshot(w_snap.undecrypted, reset_trace);
+        recvdFilterExtra.snapshot(w_snap.recvdFilterExtra, reset_trace);
+        suppliedByFilter.snapshot(w_snap.suppliedByFilter, reset_trace);
+        lossFilter.snapshot(w_snap.lossFilter, reset_trace);
+        sentAck.snapshot(w_snap.sentAck, reset_trace);
+        sentNak.snapshot(w_snap.sentNak, reset_trace);
+    }
 };
 
+typedef ReceiverMetrics<AtomicMetric> Receiver;
+typedef ReceiverMetrics<Metric> ReceiverSnapshot;
+
 } // namespace stats
 } // namespace srt
 
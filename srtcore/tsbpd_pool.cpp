@@ -0,0 +1,190 @@
+/*
+ * SRT - Secure, Reliable, Transport
+ * Copyright (c) 2021 Haivision Systems Inc.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ */
+#include "platform_sys.h"
+
+#include "tsbpd_pool.h"
+
+#include "core.h"
+#include "logging.h"
+#include "logger_defs.h"
+
+using namespace srt_logging;
+using namespace srt::sync;
+
+namespace srt
+{
+
+CTsbpdPool::CTsbpdPool()
+    : m_iSockets(0)
+{
+    for (int i = 0; i < MAX_THREADS; ++i)
+        setupCond(m_Workers[i].m_Cond, "TsbPdPool");
+}
+
+CTsbpdPool::~CTsbpdPool()
+{
+    stop();
+    for (int i = 0; i < MAX_THREADS; ++i)
+        releaseCond(m_Workers[i].m_Cond);
+}
+
+CTsbpdPool::Worker& CTsbpdPool::workerOf(const CUDT* u)
+{
+    return m_Workers[uint32_t(u->socketID()) % MAX_THREADS];
+}
+
+bool CTsbpdPool::add(CUDT* u)
+{
+    Worker& w = workerOf(u);
+    {
+        ScopedLock lk(m_StartLock);
+        if (!w.m_Thread.joinable())
+        {
+            HLOGC(tslog.Debug, log << "tsbpd pool: starting thread " << (&w - m_Workers));
+            w.m_bStop = false;
+            if (!StartThread(w.m_Thread, CTsbpdPool::worker, &w, "SRT:TsbPdPool"))
+                return false;
+        }
+    }
+
+    CTsbpdNode& n = u->m_TsbPdNode;
+    ScopedLock  lk(w.m_Lock);
+    n.m_pUDT = u;
+    if (!n.m_bRegistered)
+        ++m_iSockets;
+    n.m_bRegistered = true;
+    // Like the dedicated thread, check the socket once at the start.
+    schedule(w, &n, steady_clock::now());
+    w.m_Cond.notify_all();
+    return true;
+}
+
+void CTsbpdPool::wake(CUDT* u)
+{
+    Worker&     w = workerOf(u);
+    CTsbpdNode& n = u->m_TsbPdNode;
+    ScopedLock  lk(w.m_Lock);
+    if (!n.m_bRegistered)
+        return;
+
+    schedule(w, &n, steady_clock::now());
+    w.m_Cond.notify_all();
+}
+
+void CTsbpdPool::remove(CUDT* u)
+{
+    Worker&     w = workerOf(u);
+    CTsbpdNode& n = u->m_TsbPdNode;
+    UniqueLock  lk(w.m_Lock);
+    if (n.m_bRegistered)
+        --m_iSockets;
+    n.m_bRegistered = false;
+    w.m_Heap.remove(&n);
+
+    while (w.m_pActive == &n)
+        w.m_Cond.wait(lk);
+}
+
+void CTsbpdPool::stop()
+{
+    ScopedLock lk(m_StartLock);
+    for (int i = 0; i < MAX_THREADS; ++i)
+    {
+        Worker& w = m_Workers[i];
+        if (!w.m_Thread.joinable())
+            continue;
+
+        {
+            ScopedLock wlk(w.m_Lock);
+            w.m_bStop = true;
+            w.m_Cond.notify_all();
+        }
+        w.m_Thread.join();
+    }
+}
+
+void CTsbpdPool::resetAtFork()
+{
+    for (int i = 0; i < MAX_THREADS; ++i)
+    {
+        Worker& w = m_Workers[i];
+        resetThread(&w.m_Thread);
+        w.m_Heap.clear();
+        w.m_pActive = NULL;
+        w.m_bStop   = false;
+    }
+}
+
+void* CTsbpdPool::worker(void* param)
+{
+    Worker& w = *(Worker*)param;
+
+    THREAD_STATE_INIT("SRT:TsbPdPool");
+
+    UniqueLock lk(w.m_Lock);
+    while (!w.m_bStop)
+    {
+        INCREMENT_THREAD_ITERATIONS();
+
+        if (w.m_Heap.empty())
+        {
+            THREAD_PAUSED();
+            w.m_Cond.wait(lk);
+            THREAD_RESUMED();
+            continue;
+        }
+
+        CTsbpdNode* n = w.m_Heap.top();
+        if (n->m_tsNextCheck > steady_clock::now())
+        {
+            THREAD_PAUSED();
+            w.m_Cond.wait_until(lk, n->m_tsNextCheck);
+            THREAD_RESUMED();
+            continue;
+        }
+
+        w.m_Heap.remove(n);
+        w.m_pActive = n;
+        lk.unlock();
+
+        // This locks m_RecvLock of the socket, which may be locked
+        // by a thread calling wake(), so w.m_Lock must not be held.
+        const time_point next = n->m_pUDT->tsbpdSharedCheck();
+
+        lk.lock();
+        w.m_pActive = NULL;
+        // A zero time means waiting for a signal. If the socket was
+        // signalled during the check, it is already scheduled again.
+        if (n->m_bRegistered && !is_zero(next))
+            schedule(w, n, next);
+        w.m_Cond.notify_all();
+    }
+
+    THREAD_EXIT();
+    return NULL;
+}
+
+void CTsbpdPool::schedule(Worker& w, CTsbpdNode* n, const time_point& ts)
+{
+    if (n->m_iHeapLoc >= 0)
+    {
+        if (ts < n->m_tsNextCheck)
+        {
+            n->m_tsNextCheck = ts;
+            w.m_Heap.update(n);
+        }
+        return;
+    }
+
+    n->m_tsNextCheck = ts;
+    w.m_Heap.insert(n);
+}
+
+} // namespace srt
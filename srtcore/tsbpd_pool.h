@@ -0,0 +1,118 @@
+/*
+ * SRT - Secure, Reliable, Transport
+ * Copyright (c) 2021 Haivision Systems Inc.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ */
+
+#ifndef INC_SRT_TSBPD_POOL_H
+#define INC_SRT_TSBPD_POOL_H
+
+#include "sync.h"
+#include "heap.h"
+
+namespace srt
+{
+
+class CUDT;
+
+/// Scheduling data of a socket served by CTsbpdPool.
+struct CTsbpdNode
+{
+    CTsbpdNode()
+        : m_pUDT(NULL)
+        , m_iHeapLoc(-1)
+        , m_bRegistered(false)
+    {
+    }
+
+    CUDT*                          m_pUDT;        // The socket
+    sync::steady_clock::time_point m_tsNextCheck; // Time of the next TSBPD check
+    int                            m_iHeapLoc;    // Location on the heap, -1 if not scheduled
+    bool                           m_bRegistered; // Served by the pool
+};
+
+/// @brief Shared TimeStamp-Based Packet Delivery scheduler.
+///
+/// Does the work of the per-socket TSBPD thread (CUDT::tsbpd) for the
+/// sockets that have SRTO_TSBPDSHARED set, using a small pool of threads.
+/// A socket is always served by the same thread, picked by its socket ID.
+/// Every thread keeps its sockets on a heap ordered by the time of the
+/// next check, which is the play time of the first packet in the receiver
+/// buffer, or "now" when the socket is signalled.
+class CTsbpdPool
+{
+    typedef sync::steady_clock       steady_clock;
+    typedef steady_clock::time_point time_point;
+
+public:
+    static const int MAX_THREADS = 4;
+
+    CTsbpdPool();
+    ~CTsbpdPool();
+
+    /// Start serving a socket. Starts the thread serving it, if needed.
+    /// @param [in] u the socket
+    /// @return false if the thread could not be started.
+    bool add(CUDT* u);
+
+    /// Schedule an immediate TSBPD check of a socket. This is the
+    /// equivalent of signalling CUDT::m_RcvTsbPdCond. May be called
+    /// with CUDT::m_RecvLock locked.
+    /// @param [in] u the socket
+    void wake(CUDT* u);
+
+    /// Stop serving a socket. If the socket is being checked right now,
+    /// waits until the check is finished. Must not be called with
+    /// CUDT::m_RecvLock locked.
+    /// @param [in] u the socket
+    void remove(CUDT* u);
+
+    /// Stop all threads. Sockets must have been removed before.
+    void stop();
+
+    /// Forget the threads, which don't exist in the child process.
+    void resetAtFork();
+
+    /// @return The number of sockets served by the pool.
+    int sockets() const { return m_iSockets; }
+
+private:
+    struct Worker
+    {
+        Worker()
+            : m_pActive(NULL)
+            , m_bStop(false)
+        {
+        }
+
+        sync::Mutex     m_Lock;    // Protects the heap and the nodes of the sockets
+        sync::Condition m_Cond;    // Signalled when the heap changes or a check is finished
+        sync::CThread   m_Thread;
+        CIntrusiveHeap<CTsbpdNode, &CTsbpdNode::m_tsNextCheck> m_Heap;
+        CTsbpdNode*     m_pActive; // Node being checked
+        bool            m_bStop;
+    };
+
+    static void* worker(void* param);
+
+    Worker& workerOf(const CUDT* u);
+
+    // [[using locked(w.m_Lock)]]
+    static void schedule(Worker& w, CTsbpdNode* n, const time_point& ts);
+
+    sync::Mutex       m_StartLock; // Protects starting and stopping the threads
+    Worker            m_Workers[MAX_THREADS];
+    sync::atomic<int> m_iSockets;  // Number of the sockets served
+
+private:
+    CTsbpdPool(const CTsbpdPool&);
+    CTsbpdPool& operator=(const CTsbpdPool&);
+};
+
+} // namespace srt
+
+#endif
@@ -3,6 +3,7 @@
 #include <thread>
 #include <chrono>
 #include <vector>
+#include <functional>
 #include "gtest/gtest.h"
 #include "test_env.h"
 
@@ -11,6 +12,7 @@
 #include "common.h"
 #include "netinet_any.h"
 #include "socketconfig.h"
+#include "group.h"
 
 #include "apputil.hpp"
 
@@ -1593,6 +1595,245 @@ CheckLinksAgain:
     srt_close(ss);
 }
 
+// Sends a sequence of values over a group of two links and checks that the
+// receiver gets each of them once and in order. The checks specific to the
+// group type are done by check_receiver on the accepted group and by
+// check_sender on the sending group, before any of them is closed.
+static void testGroupTransfer(SRT_GROUP_TYPE type, int npackets, const std::string& passphrase,
+                              std::function<void(SRTSOCKET)> check_receiver,
+                              std::function<void(SRTSOCKET)> check_sender)
+{
+    using namespace std;
+    using namespace std::chrono;
+    using namespace srt;
+
+    TestInit srtinit;
+
+    MAKE_UNIQUE_SOCK(listener, "listener", srt_create_socket());
+    sockaddr_any bind_sa = srt::CreateAddr("127.0.0.1", 4200, AF_INET);
+    ASSERT_NE(srt_bind(listener, bind_sa.get(), bind_sa.size()), SRT_ERROR);
+    const int yes = 1;
+    ASSERT_NE(srt_setsockflag(listener, SRTO_GROUPCONNECT, &yes, sizeof yes), SRT_ERROR);
+    if (!passphrase.empty())
+    {
+        ASSERT_NE(srt_setsockflag(listener, SRTO_PASSPHRASE, passphrase.c_str(), int(passphrase.size())), SRT_ERROR);
+    }
+    ASSERT_NE(srt_listen(listener, 5), SRT_ERROR);
+
+    MAKE_UNIQUE_SOCK(ss, "group", srt_create_group(type));
+    if (!passphrase.empty())
+    {
+        ASSERT_NE(srt_setsockflag(ss, SRTO_PASSPHRASE, passphrase.c_str(), int(passphrase.size())), SRT_ERROR);
+    }
+
+    std::promise<void> sender_checked;
+    std::future<void> sender_checked_fut = sender_checked.get_future();
+    auto acthr = std::thread([&listener, &sender_checked_fut, &check_receiver, npackets]() {
+        sockaddr_any adr;
+        const SRTSOCKET accept_id = srt_accept(listener, adr.get(), &adr.len);
+        ASSERT_NE(accept_id & SRTGROUP_MASK, 0);
+
+        int32_t expected = 0;
+        for (int i = 0; i < npackets; ++i)
+        {
+            SRT_MSGCTRL mc = srt_msgctrl_default;
+            char data[1316];
+            const int ds = srt_recvmsg2(accept_id, data, sizeof data, (&mc));
+            ASSERT_EQ(ds, int(sizeof expected)) << srt_getlasterror_str();
+
+            int32_t value = -1;
+            memcpy(&value, data, sizeof value);
+            EXPECT_EQ(value, expected);
+            expected = value + 1;
+        }
+
+        SRT_TRACEBSTATS stats;
+        EXPECT_EQ(srt_bstats(accept_id, &stats, false), SRT_SUCCESS);
+        EXPECT_EQ(stats.pktRecvUniqueTotal, npackets);
+        EXPECT_EQ(stats.pktRcvDropTotal, 0);
+
+        check_receiver(accept_id);
+
+        sender_checked_fut.wait_for(std::chrono::seconds(10));
+        srt_close(accept_id);
+    });
+
+    sockaddr_any sa = srt::CreateAddr("127.0.0.1", 4200, AF_INET);
+    SRT_SOCKGROUPCONFIG cc[2];
+    cc[0] = srt_prepare_endpoint(NULL, sa.get(), sa.size());
+    cc[1] = srt_prepare_endpoint(NULL, sa.get(), sa.size());
+    ASSERT_GT(srt_connect_group(ss, cc, 2), 0);
+
+    // Send over both links.
+    SRT_SOCKGROUPDATA gdata[2];
+    size_t psize = 2;
+    for (int nwait = 0; nwait < 50; ++nwait)
+    {
+        psize = 2;
+        srt_group_data(ss, gdata, &psize);
+        if (psize == 2 && gdata[0].memberstate > SRT_GST_PENDING && gdata[1].memberstate > SRT_GST_PENDING)
+            break;
+        this_thread::sleep_for(milliseconds(100));
+    }
+    ASSERT_EQ(psize, 2U);
+
+    for (int32_t i = 0; i < npackets; ++i)
+    {
+        ASSERT_EQ(srt_send(ss, (const char*)&i, sizeof i), int(sizeof i)) << srt_getlasterror_str();
+        this_thread::sleep_for(milliseconds(1));
+    }
+
+    check_sender(ss);
+
+    sender_checked.set_value();
+    acthr.join();
+}
+
+// The members of a broadcast group store the packets in a buffer of the group,
+// so a packet received over both links is delivered once.
+static void testBroadcastTransfer(const std::string& passphrase)
+{
+    using namespace std;
+    using namespace std::chrono;
+
+    testGroupTransfer(SRT_GTYPE_BROADCAST, 200, passphrase,
+        [](SRTSOCKET accept_id) {
+            // The members don't keep the packets.
+            SRT_SOCKGROUPDATA gdata[2];
+            size_t gsize = 2;
+            ASSERT_NE(srt_group_data(accept_id, gdata, &gsize), SRT_ERROR);
+            for (size_t i = 0; i < gsize; ++i)
+            {
+                SRT_TRACEBSTATS stats;
+                EXPECT_EQ(srt_bstats(gdata[i].id, &stats, false), SRT_SUCCESS);
+                EXPECT_EQ(stats.pktRcvBuf, 0);
+            }
+        },
+        [](SRTSOCKET ss) {
+            // All members release the shared payloads once acknowledged.
+            SRT_SOCKGROUPDATA gdata[2];
+            size_t psize = 2;
+            EXPECT_NE(srt_group_data(ss, gdata, &psize), SRT_ERROR);
+            for (size_t i = 0; i < psize; ++i)
+            {
+                SRT_TRACEBSTATS stats;
+                for (int nwait = 0; nwait < 50; ++nwait)
+                {
+                    EXPECT_EQ(srt_bstats(gdata[i].id, &stats, false), SRT_SUCCESS);
+                    if (stats.pktSndBuf == 0)
+                        break;
+                    this_thread::sleep_for(milliseconds(100));
+                }
+                EXPECT_EQ(stats.pktSndBuf, 0);
+            }
+
+            // Each payload is freed once all the members dropped their references.
+            for (int nwait = 0; nwait < 50 && srt::CUDTGroup::SharedPayload::allocated() != 0; ++nwait)
+                this_thread::sleep_for(milliseconds(100));
+            EXPECT_EQ(srt::CUDTGroup::SharedPayload::allocated(), 0);
+        });
+}
+
+TEST(Bonding, BroadcastGroupRcvBuffer)
+{
+    testBroadcastTransfer("");
+}
+
+// The encrypted members can't refer to the shared payload and copy it.
+TEST(Bonding, BroadcastGroupEncrypted)
+{
+    testBroadcastTransfer("broadcast-passphrase");
+}
+
+// Sums up the balancing share statistics of the members of the group.
+static double balancingShare(SRTSOCKET group, bool sender)
+{
+    SRT_SOCKGROUPDATA gdata[2];
+    size_t gsize = 2;
+    EXPECT_NE(srt_group_data(group, gdata, &gsize), SRT_ERROR);
+    double share = 0;
+    for (size_t i = 0; i < gsize; ++i)
+    {
+        SRT_TRACEBSTATS stats;
+        EXPECT_EQ(srt_bstats(gdata[i].id, &stats, false), SRT_SUCCESS);
+        const double member_share = sender ? stats.groupSndShare : stats.groupRcvShare;
+        // Both links took a part of the messages.
+        if (sender)
+        {
+            EXPECT_GT(member_share, 0);
+        }
+        share += member_share;
+    }
+    return share;
+}
+
+// The messages are distributed over the members and delivered in order.
+TEST(Bonding, BalancingGroup)
+{
+    testGroupTransfer(SRT_GTYPE_BALANCING, 400, "",
+        [](SRTSOCKET accept_id) { EXPECT_NEAR(balancingShare(accept_id, false), 100.0, 0.01); },
+        [](SRTSOCKET ss) { EXPECT_NEAR(balancingShare(ss, true), 100.0, 0.01); });
+}
+
+// The links share the messages in proportion to their capacities.
+TEST(Bonding, BalancingWeights)
+{
+    using namespace srt::groups;
+
+    // Sends the messages over the members with the given capacities
+    // and returns how many each of them took.
+    struct Sim
+    {
+        static std::vector<int> run(const std::vector<int64_t>& capacities, int nmsg)
+        {
+            std::vector<SocketData> members(capacities.size());
+            std::vector<int> counts(capacities.size(), 0);
+            for (size_t i = 0; i < members.size(); ++i)
+                members[i].sndCredit = 0;
+
+            for (int n = 0; n < nmsg; ++n)
+            {
+                SendBalancingCtx ctx;
+                for (size_t i = 0; i < members.size(); ++i)
+                    ctx.addMember(&members[i], capacities[i], false);
+                ctx.weigh();
+                const size_t i = ctx.next();
+                ctx.charge(i);
+                ++counts[i];
+            }
+            return counts;
+        }
+    };
+
+    // Unequal links: 3:1.
+    std::vector<int> counts = Sim::run({3000, 1000}, 400);
+    EXPECT_EQ(counts[0], 300);
+    EXPECT_EQ(counts[1], 100);
+
+    // The link not measured yet gets the average capacity: 2000:1500:1000.
+    counts = Sim::run({2000, 0, 1000}, 900);
+    EXPECT_EQ(counts[0], 400);
+    EXPECT_EQ(counts[1], 300);
+    EXPECT_EQ(counts[2], 200);
+
+    // No link measured yet: all equal.
+    counts = Sim::run({0, 0}, 100);
+    EXPECT_EQ(counts[0], 50);
+    EXPECT_EQ(counts[1], 50);
+
+    // The congested link is tried only after the others.
+    SocketData fast, slow;
+    fast.sndCredit = 0;
+    slow.sndCredit = 0;
+    SendBalancingCtx ctx;
+    ctx.addMember(&fast, 3000, true);
+    ctx.addMember(&slow, 1000, false);
+    ctx.weigh();
+    EXPECT_EQ(ctx.totalWeight(), 4000);
+    EXPECT_EQ(ctx.next(), 1U);
+    EXPECT_EQ(ctx.next(), 0U);
+    EXPECT_EQ(ctx.next(), ctx.size());
+}
 
 TEST(Bonding, ApiConfig)
 {
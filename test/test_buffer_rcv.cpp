@@ -428,6 +428,43 @@ TEST_F(CRcvBufferReadMsg, MsgAcked)
     EXPECT_EQ(m_unit_queue->size(), m_unit_queue->capacity());
 }
 
+// Lend the packets of a message instead of copying them. The units
+// are not freed until the loan is released.
+TEST_F(CRcvBufferReadMsg, MsgLent)
+{
+    const size_t msg_pkts = 4;
+    addMessage(msg_pkts, 1, m_init_seqno, false);
+    addMessage(1, 2, CSeqNo::incseq(m_init_seqno, msg_pkts), false);
+    ackPackets(msg_pkts + 1);
+    EXPECT_EQ(m_unit_queue->takenUnits(), int(msg_pkts + 1));
+
+    SRT_RCVLOAN loan;
+    EXPECT_EQ(m_rcv_buffer->lendMessage((loan)), int(msg_pkts * m_payload_sz));
+    ASSERT_EQ(loan.nsegs, int(msg_pkts));
+    for (size_t i = 0; i < msg_pkts; ++i)
+    {
+        EXPECT_EQ(loan.segs[i].len, int(m_payload_sz));
+        EXPECT_TRUE(verifyPayload((char*) loan.segs[i].data, m_payload_sz, CSeqNo::incseq(m_init_seqno, int(i))));
+    }
+
+    // The next message is still there, the lent units are still taken.
+    EXPECT_TRUE(m_rcv_buffer->isRcvDataReady());
+    EXPECT_EQ(m_unit_queue->takenUnits(), int(msg_pkts + 1));
+    EXPECT_EQ(m_rcv_buffer->numLoans(), 1U);
+
+    EXPECT_TRUE(m_rcv_buffer->releaseLoan(loan));
+    EXPECT_FALSE(m_rcv_buffer->releaseLoan(loan));
+    EXPECT_EQ(m_unit_queue->takenUnits(), 1);
+
+    // A message not released until the buffer is destroyed.
+    SRT_RCVLOAN loan2;
+    EXPECT_EQ(m_rcv_buffer->lendMessage((loan2)), int(m_payload_sz));
+    EXPECT_EQ(loan2.nsegs, 1);
+    EXPECT_FALSE(m_rcv_buffer->isRcvDataReady());
+    m_rcv_buffer.reset();
+    EXPECT_EQ(m_unit_queue->takenUnits(), 0);
+}
+
 // Check reading the whole message (consisting of several packets) into
 // a buffer of an insufficient size.
 TEST_F(CRcvBufferReadMsg, SmallReadBuffer)
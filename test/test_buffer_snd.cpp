@@ -0,0 +1,239 @@
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "test_env.h"
+#include "buffer_snd.h"
+#include "common.h"
+
+using namespace std;
+using namespace srt;
+using namespace srt::sync;
+
+typedef steady_clock::time_point time_point;
+
+namespace
+{
+
+const int PAYLOAD = 1456;
+
+// Add a message of npkts packets, the first byte of each packet holding its index.
+void addMessage(CSndBuffer& buf, int32_t& seqno, int first_index, int npkts, int ttl = -1, int64_t srctime = 0)
+{
+    vector<char> data(npkts * PAYLOAD);
+    for (int i = 0; i < npkts; ++i)
+        data[i * PAYLOAD] = char(first_index + i);
+
+    SRT_MSGCTRL mctrl = srt_msgctrl_default;
+    mctrl.pktseq      = seqno;
+    mctrl.msgttl      = ttl;
+    mctrl.srctime     = srctime;
+    buf.addBuffer(&data[0], int(data.size()), (mctrl));
+    seqno = mctrl.pktseq;
+}
+
+} // namespace
+
+TEST(CSndBuffer, ReadAckWrap)
+{
+    srt::TestInit srtinit;
+    // Too small on purpose, so that the buffer grows.
+    CSndBuffer buf(AF_INET, 4, PAYLOAD, 0);
+    const int32_t init_seqno = 100;
+    int32_t       seqno      = init_seqno;
+
+    for (int i = 0; i < 10; ++i)
+        addMessage(buf, seqno, i, 1);
+    EXPECT_EQ(buf.getCurrBufSize(), 10);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        CPacket    pkt;
+        time_point origin;
+        int        seqnoinc = 0;
+        ASSERT_EQ(buf.readData((pkt), (origin), 0, (seqnoinc)), PAYLOAD);
+        EXPECT_EQ(pkt.seqno(), CSeqNo::incseq(init_seqno, i));
+        EXPECT_EQ(pkt.m_pcData[0], char(i));
+    }
+
+    buf.ackData(6);
+    EXPECT_EQ(buf.getCurrBufSize(), 4);
+
+    // Wrap around the end of the ring.
+    for (int i = 10; i < 16; ++i)
+        addMessage(buf, seqno, i, 1);
+    EXPECT_EQ(buf.getCurrBufSize(), 10);
+
+    // Retransmission of any packet, by the offset from the ACK point.
+    for (int off = 9; off >= 0; --off)
+    {
+        CPacket pkt;
+        pkt.set_seqno(CSeqNo::incseq(init_seqno, 6 + off));
+        time_point            origin;
+        CSndBuffer::DropRange drop;
+        ASSERT_EQ(buf.readData(off, (pkt), (origin), (drop)), PAYLOAD);
+        EXPECT_EQ(pkt.m_pcData[0], char(6 + off));
+        EXPECT_NE(buf.getPacketRexmitTime(off), time_point());
+        EXPECT_EQ(buf.getMsgNoAt(off), buf.getMsgNoAt(0) + off);
+    }
+
+    // Out of the buffer.
+    {
+        CPacket               pkt;
+        time_point            origin;
+        CSndBuffer::DropRange drop;
+        EXPECT_EQ(buf.readData(10, (pkt), (origin), (drop)), int(CSndBuffer::READ_NONE));
+    }
+
+    // The packets not sent yet are still sent after the ACK.
+    CPacket    pkt;
+    time_point origin;
+    int        seqnoinc = 0;
+    ASSERT_EQ(buf.readData((pkt), (origin), 0, (seqnoinc)), PAYLOAD);
+    EXPECT_EQ(pkt.m_pcData[0], char(10));
+
+    int     bytes = 0;
+    int32_t first_msgno = 0;
+    EXPECT_EQ(buf.dropLateData((bytes), (first_msgno), steady_clock::now() + seconds_from(1)), 10);
+    EXPECT_EQ(bytes, 10 * PAYLOAD);
+    EXPECT_EQ(buf.getCurrBufSize(), 0);
+    EXPECT_EQ(buf.readData((pkt), (origin), 0, (seqnoinc)), 0);
+}
+
+TEST(CSndBuffer, RexmitDropTTL)
+{
+    srt::TestInit srtinit;
+    CSndBuffer    buf(AF_INET, 8, PAYLOAD, 0);
+    const int32_t init_seqno = 1000;
+    int32_t       seqno      = init_seqno;
+
+    addMessage(buf, seqno, 0, 1);
+    addMessage(buf, seqno, 1, 3, 50);
+    addMessage(buf, seqno, 4, 1);
+
+    CPacket    pkt;
+    time_point origin;
+    int        seqnoinc = 0;
+    ASSERT_EQ(buf.readData((pkt), (origin), 0, (seqnoinc)), PAYLOAD);
+    ASSERT_EQ(buf.readData((pkt), (origin), 0, (seqnoinc)), PAYLOAD);
+    EXPECT_EQ(pkt.m_pcData[0], char(1));
+
+    std::this_thread::sleep_for(chrono::milliseconds(100));
+
+    // The whole expired message is to be dropped, including the packets not sent yet.
+    pkt.set_seqno(CSeqNo::incseq(init_seqno));
+    CSndBuffer::DropRange drop;
+    ASSERT_EQ(buf.readData(1, (pkt), (origin), (drop)), int(CSndBuffer::READ_DROP));
+    EXPECT_EQ(drop.seqno[CSndBuffer::DropRange::BEGIN], CSeqNo::incseq(init_seqno, 1));
+    EXPECT_EQ(drop.seqno[CSndBuffer::DropRange::END], CSeqNo::incseq(init_seqno, 3));
+    EXPECT_EQ(drop.msgno, buf.getMsgNoAt(1));
+
+    ASSERT_EQ(buf.readData((pkt), (origin), 0, (seqnoinc)), PAYLOAD);
+    EXPECT_EQ(pkt.m_pcData[0], char(4));
+    EXPECT_EQ(pkt.seqno(), CSeqNo::incseq(init_seqno, 4));
+    EXPECT_EQ(seqnoinc, 0);
+}
+
+/// Retransmission under heavy loss: requests for random packets
+/// anywhere in the flight window, after the ring has grown and wrapped.
+TEST(CSndBuffer, RexmitRandomOffset)
+{
+    srt::TestInit srtinit;
+    const int  inflight   = 200;
+    CSndBuffer buf(AF_INET, 32, PAYLOAD, 0);
+
+    const int32_t init_seqno = 1000;
+    int32_t       seqno      = init_seqno;
+    for (int i = 0; i < inflight; ++i)
+        addMessage(buf, seqno, i, 1);
+
+    // Move the start of the ring, so that the window wraps around its end.
+    const int acked = 100;
+    buf.ackData(acked);
+    for (int i = inflight; i < inflight + acked; ++i)
+        addMessage(buf, seqno, i, 1);
+    ASSERT_EQ(buf.getCurrBufSize(), inflight);
+
+    const int32_t first_seqno = CSeqNo::incseq(init_seqno, acked);
+    mt19937                       gen(7);
+    uniform_int_distribution<int> which(0, inflight - 1);
+    for (int i = 0; i < 1000; ++i)
+    {
+        const int offset = which(gen);
+
+        CPacket pkt;
+        pkt.set_seqno(CSeqNo::incseq(first_seqno, offset));
+        time_point            origin;
+        CSndBuffer::DropRange drop;
+        ASSERT_EQ(buf.readData(offset, (pkt), (origin), (drop)), PAYLOAD);
+        EXPECT_EQ(pkt.m_pcData[0], char(acked + offset));
+        EXPECT_EQ(buf.getMsgNoAt(offset), acked + offset + 1);
+    }
+}
+
+namespace
+{
+void countRelease(void* opaque)
+{
+    ++*static_cast<int*>(opaque);
+}
+}
+
+TEST(CSndBuffer, ZeroCopyRelease)
+{
+    srt::TestInit srtinit;
+    int released = 0;
+    {
+        CSndBuffer    buf(AF_INET, 8, PAYLOAD, 0);
+        int32_t       seqno = 0;
+        vector<char>  data(3 * PAYLOAD);
+        data[PAYLOAD] = 'x';
+
+        // Three messages of 3 packets, each referring to the same data.
+        for (int i = 0; i < 3; ++i)
+        {
+            SRT_MSGCTRL mctrl = srt_msgctrl_default;
+            mctrl.pktseq      = seqno;
+            buf.addBuffer(&data[0], int(data.size()), (mctrl), countRelease, &released);
+            seqno = mctrl.pktseq;
+        }
+
+        CPacket    pkt;
+        time_point origin;
+        int        seqnoinc = 0;
+        ASSERT_EQ(buf.readData((pkt), (origin), 0, (seqnoinc)), PAYLOAD);
+        ASSERT_EQ(buf.readData((pkt), (origin), 0, (seqnoinc)), PAYLOAD);
+        // Not copied.
+        EXPECT_EQ(pkt.m_pcData, &data[PAYLOAD]);
+
+        // Partially acknowledged messages are still in use.
+        buf.ackData(2);
+        buf.releaseAcked();
+        EXPECT_EQ(released, 0);
+
+        buf.ackData(1);
+        EXPECT_EQ(released, 0);
+        buf.releaseAcked();
+        EXPECT_EQ(released, 1);
+
+        int     bytes       = 0;
+        int32_t first_msgno = 0;
+        EXPECT_EQ(buf.dropLateData((bytes), (first_msgno), steady_clock::now() + seconds_from(1)), 6);
+        buf.releaseAcked();
+        EXPECT_EQ(released, 3);
+
+        // Copied as usual without a release function, in the same blocks.
+        addMessage(buf, seqno, 7, 1);
+        ASSERT_EQ(buf.readData((pkt), (origin), 0, (seqnoinc)), PAYLOAD);
+        EXPECT_EQ(pkt.m_pcData[0], char(7));
+        EXPECT_NE(pkt.m_pcData, &data[0]);
+
+        SRT_MSGCTRL mctrl = srt_msgctrl_default;
+        mctrl.pktseq      = seqno;
+        buf.addBuffer(&data[0], PAYLOAD, (mctrl), countRelease, &released);
+    }
+
+    // Released when the buffer is destroyed.
+    EXPECT_EQ(released, 4);
+}
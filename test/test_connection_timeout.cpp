@@ -14,6 +14,7 @@ typedef int SOCKET;
 #include"platform_sys.h"
 #include "srt.h"
 #include "netinet_any.h"
+#include "api.h"
 
 using namespace std;
 
@@ -273,3 +274,71 @@ TEST(TestConnectionAPI, Accept)
 }
 
 
+
+// Returns how many times the receiver worker checked the timers of the socket.
+static int64_t timerChecks(SRTSOCKET u)
+{
+    srt::CUDTUnited::SocketKeeper keeper(srt::CUDT::uglobal(), u);
+    return keeper.socket ? keeper.socket->core().timerChecks() : -1;
+}
+
+// The timers of a socket are checked when they have something to do,
+// not every SYN interval, and never in a loop when a deadline has passed
+// but its check decided there's nothing to do, as for the retransmission
+// timeout of the live mode sender when the receiver reports the losses.
+TEST(TestConnectionAPI, TimerChecks)
+{
+    using namespace std::chrono;
+
+    srt::TestInit srtinit;
+
+    const SRTSOCKET caller_sock = srt_create_socket();
+    const SRTSOCKET listener_sock = srt_create_socket();
+
+    // The receiver can store only 32 packets and doesn't deliver them
+    // before the test ends, so the sender keeps unacknowledged data.
+    const int fc = 32, rcvbuf = 1, latency = 10000;
+    ASSERT_NE(srt_setsockflag(listener_sock, SRTO_FC, &fc, sizeof fc), SRT_ERROR);
+    ASSERT_NE(srt_setsockflag(listener_sock, SRTO_RCVBUF, &rcvbuf, sizeof rcvbuf), SRT_ERROR);
+    ASSERT_NE(srt_setsockflag(listener_sock, SRTO_RCVLATENCY, &latency, sizeof latency), SRT_ERROR);
+
+    srt::sockaddr_any sa = srt::CreateAddr("127.0.0.1", 5556, AF_INET);
+
+    ASSERT_NE(srt_bind(listener_sock, sa.get(), sa.size()), -1);
+    ASSERT_NE(srt_listen(listener_sock, 1), -1);
+    ASSERT_NE(srt_connect(caller_sock, sa.get(), sa.size()), SRT_ERROR);
+
+    const SRTSOCKET accepted_sock = srt_accept(listener_sock, NULL, NULL);
+    ASSERT_NE(accepted_sock, SRT_INVALID_SOCK);
+
+    // Idle: the sockets are checked every 100ms, except for the keepalive.
+    std::this_thread::sleep_for(milliseconds(100));
+    int64_t caller_checks = timerChecks(caller_sock);
+    int64_t accepted_checks = timerChecks(accepted_sock);
+    std::this_thread::sleep_for(seconds(1));
+    EXPECT_LT(timerChecks(caller_sock) - caller_checks, 30);
+    EXPECT_LT(timerChecks(accepted_sock) - accepted_checks, 30);
+
+    // Stalled: the receiver buffer is full, so the ACKs don't come anymore.
+    char msg[1316] = {};
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(srt_sendmsg(caller_sock, msg, sizeof msg, -1, true), int(sizeof msg));
+    }
+    std::this_thread::sleep_for(milliseconds(200));
+
+    SRT_TRACEBSTATS stats;
+    ASSERT_EQ(srt_bstats(caller_sock, &stats, 0), SRT_SUCCESS);
+    EXPECT_GT(stats.pktSndBuf, 0);
+
+    caller_checks = timerChecks(caller_sock);
+    std::this_thread::sleep_for(seconds(1));
+    EXPECT_LT(timerChecks(caller_sock) - caller_checks, 200);
+
+    EXPECT_EQ(srt_getsockstate(caller_sock), SRTS_CONNECTED);
+    EXPECT_EQ(srt_getsockstate(accepted_sock), SRTS_CONNECTED);
+
+    srt_close(accepted_sock);
+    srt_close(caller_sock);
+    srt_close(listener_sock);
+}
@@ -2,6 +2,7 @@
 #include <numeric>
 
 #include "gtest/gtest.h"
+#include "test_env.h"
 
 #if defined(SRT_ENABLE_ENCRYPTION) && defined(ENABLE_AEAD_API_PREVIEW)
 #include "crypto.h"
@@ -108,3 +109,114 @@ namespace srt
 } // namespace srt
 
 #endif //SRT_ENABLE_ENCRYPTION && ENABLE_AEAD_API_PREVIEW
+
+#if defined(SRT_ENABLE_ENCRYPTION)
+#include "crypto.h"
+
+namespace srt
+{
+
+    TEST(CKekCache, LookupAndEviction)
+    {
+        CKekCache cache(2);
+        const unsigned char salt1[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+        const unsigned char salt2[8] = { 8, 7, 6, 5, 4, 3, 2, 1 };
+        const unsigned char salt3[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+        const char* pwd = "passphrase";
+        const size_t pwd_len = strlen(pwd);
+        unsigned char kek1[16], kek2[16], kek3[16], out[16];
+        memset(kek1, 0x11, sizeof kek1);
+        memset(kek2, 0x22, sizeof kek2);
+        memset(kek3, 0x33, sizeof kek3);
+
+        EXPECT_FALSE(cache.lookup(pwd, pwd_len, salt1, sizeof salt1, out, sizeof out));
+        cache.store(pwd, pwd_len, salt1, sizeof salt1, kek1, sizeof kek1);
+        cache.store(pwd, pwd_len, salt2, sizeof salt2, kek2, sizeof kek2);
+        EXPECT_EQ(cache.size(), 2U);
+
+        ASSERT_TRUE(cache.lookup(pwd, pwd_len, salt1, sizeof salt1, out, sizeof out));
+        EXPECT_EQ(memcmp(out, kek1, sizeof out), 0);
+
+        // Another passphrase, salt or key length is another KEK.
+        EXPECT_FALSE(cache.lookup("passphrasf", pwd_len, salt1, sizeof salt1, out, sizeof out));
+        EXPECT_FALSE(cache.lookup(pwd, pwd_len - 1, salt1, sizeof salt1, out, sizeof out));
+        EXPECT_FALSE(cache.lookup(pwd, pwd_len, salt3, sizeof salt3, out, sizeof out));
+        EXPECT_FALSE(cache.lookup(pwd, pwd_len, salt1, sizeof salt1, out, 24));
+
+        // salt2 is the least recently used one now.
+        cache.store(pwd, pwd_len, salt3, sizeof salt3, kek3, sizeof kek3);
+        EXPECT_EQ(cache.size(), 2U);
+        EXPECT_FALSE(cache.lookup(pwd, pwd_len, salt2, sizeof salt2, out, sizeof out));
+        ASSERT_TRUE(cache.lookup(pwd, pwd_len, salt3, sizeof salt3, out, sizeof out));
+        EXPECT_EQ(memcmp(out, kek3, sizeof out), 0);
+        EXPECT_TRUE(cache.lookup(pwd, pwd_len, salt1, sizeof salt1, out, sizeof out));
+
+        EXPECT_EQ(cache.hits(), 3);
+        EXPECT_EQ(cache.misses(), 6);
+
+        cache.clear();
+        EXPECT_EQ(cache.size(), 0U);
+        EXPECT_FALSE(cache.lookup(pwd, pwd_len, salt1, sizeof salt1, out, sizeof out));
+    }
+
+    // The shared cache must not keep the passphrases once SRT is cleaned up.
+    TEST(CKekCache, ClearedOnCleanup)
+    {
+        const unsigned char salt[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+        const char* pwd = "passphrase";
+        unsigned char kek[16];
+        memset(kek, 0x11, sizeof kek);
+
+        {
+            TestInit srtinit;
+            CKekCache::instance().store(pwd, strlen(pwd), salt, sizeof salt, kek, sizeof kek);
+            EXPECT_GT(CKekCache::instance().size(), 0U);
+        }
+        EXPECT_EQ(CKekCache::instance().size(), 0U);
+    }
+
+    // The KEK derived by the caller from the salt it has chosen is found in
+    // the cache by the listener, which derives it for the same salt both for
+    // receiving and for sending, here in the same process.
+    TEST(CKekCache, HitOnHandshake)
+    {
+        TestInit srtinit;
+        const std::string pass = "kek-cache-passphrase";
+
+        int64_t hits0 = -1, misses0 = -1;
+        ASSERT_EQ(srt_getkekcachestats(&hits0, &misses0), 0);
+        EXPECT_EQ(srt_getkekcachestats(NULL, &misses0), SRT_ERROR);
+
+        SRTSOCKET lsn = srt_create_socket();
+        ASSERT_NE(lsn, SRT_INVALID_SOCK);
+        ASSERT_EQ(srt_setsockflag(lsn, SRTO_PASSPHRASE, pass.c_str(), (int)pass.size()), SRT_SUCCESS);
+
+        sockaddr_in sa = sockaddr_in();
+        sa.sin_family = AF_INET;
+        inet_pton(AF_INET, "127.0.0.1", &sa.sin_addr);
+        ASSERT_EQ(srt_bind(lsn, (sockaddr*)&sa, sizeof sa), SRT_SUCCESS);
+        int sa_len = sizeof sa;
+        ASSERT_EQ(srt_getsockname(lsn, (sockaddr*)&sa, &sa_len), SRT_SUCCESS);
+        ASSERT_EQ(srt_listen(lsn, 1), SRT_SUCCESS);
+
+        SRTSOCKET clr = srt_create_socket();
+        ASSERT_NE(clr, SRT_INVALID_SOCK);
+        ASSERT_EQ(srt_setsockflag(clr, SRTO_PASSPHRASE, pass.c_str(), (int)pass.size()), SRT_SUCCESS);
+        ASSERT_NE(srt_connect(clr, (sockaddr*)&sa, sizeof sa), SRT_ERROR) << srt_getlasterror_str();
+
+        SRTSOCKET acp = srt_accept(lsn, NULL, NULL);
+        ASSERT_NE(acp, SRT_INVALID_SOCK);
+
+        int64_t hits = -1, misses = -1;
+        ASSERT_EQ(srt_getkekcachestats(&hits, &misses), 0);
+        EXPECT_GE(misses - misses0, 1);
+        EXPECT_GE(hits - hits0, 2);
+
+        srt_close(acp);
+        srt_close(clr);
+        srt_close(lsn);
+    }
+
+} // namespace srt
+
+#endif // SRT_ENABLE_ENCRYPTION
@@ -0,0 +1,115 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "test_env.h"
+#include "crypto_pool.h"
+
+using namespace std;
+using namespace srt;
+
+namespace
+{
+
+struct Jobs
+{
+    vector<atomic<int> > runs;
+    atomic<int>          concurrent;
+    atomic<int>          maxConcurrent;
+
+    explicit Jobs(int n)
+        : runs(n)
+        , concurrent(0)
+        , maxConcurrent(0)
+    {
+        for (int i = 0; i < n; ++i)
+            runs[i] = 0;
+    }
+
+    static void job(void* arg, int index)
+    {
+        Jobs* self = (Jobs*)arg;
+        const int now = ++self->concurrent;
+        int max = self->maxConcurrent;
+        while (now > max && !self->maxConcurrent.compare_exchange_weak(max, now))
+        {
+        }
+        this_thread::sleep_for(chrono::milliseconds(1));
+        ++self->runs[index];
+        --self->concurrent;
+    }
+};
+
+} // namespace
+
+// Every job runs exactly once and run() returns when all are finished.
+TEST(CCryptoPool, RunsAllJobs)
+{
+    srt::TestInit srtinit;
+
+    CCryptoPool pool;
+    pool.init(3);
+    EXPECT_EQ(pool.threads(), 3);
+
+    for (int round = 0; round < 20; ++round)
+    {
+        Jobs jobs(8);
+        pool.run(&Jobs::job, &jobs, 8);
+        for (int i = 0; i < 8; ++i)
+            ASSERT_EQ(jobs.runs[i].load(), 1) << "round " << round << " job " << i;
+        EXPECT_EQ(jobs.concurrent.load(), 0);
+    }
+
+    // The caller works together with the threads.
+    EXPECT_EQ(pool.jobsTotal(), 20 * 8);
+    EXPECT_GT(pool.jobsOffloadedTotal(), 0);
+    EXPECT_LT(pool.jobsOffloadedTotal(), 20 * 8);
+}
+
+// Without threads the jobs are done by the caller.
+TEST(CCryptoPool, NoThreads)
+{
+    srt::TestInit srtinit;
+
+    CCryptoPool pool;
+    Jobs jobs(4);
+    pool.run(&Jobs::job, &jobs, 4);
+    for (int i = 0; i < 4; ++i)
+        EXPECT_EQ(jobs.runs[i].load(), 1);
+    EXPECT_EQ(jobs.maxConcurrent.load(), 1);
+    EXPECT_EQ(pool.jobsOffloadedTotal(), 0);
+}
+
+// Several threads may run their jobs at the same time.
+TEST(CCryptoPool, ConcurrentCallers)
+{
+    srt::TestInit srtinit;
+
+    CCryptoPool pool;
+    pool.init(2);
+
+    const int NCALLERS = 4;
+    const int NJOBS = 6;
+    vector<Jobs*> jobs;
+    vector<thread> callers;
+    for (int c = 0; c < NCALLERS; ++c)
+        jobs.push_back(new Jobs(NJOBS));
+
+    for (int c = 0; c < NCALLERS; ++c)
+    {
+        callers.push_back(thread([&pool, &jobs, c] {
+            for (int round = 0; round < 10; ++round)
+                pool.run(&Jobs::job, jobs[c], NJOBS);
+        }));
+    }
+
+    for (size_t c = 0; c < callers.size(); ++c)
+        callers[c].join();
+
+    for (int c = 0; c < NCALLERS; ++c)
+    {
+        for (int i = 0; i < NJOBS; ++i)
+            EXPECT_EQ(jobs[c]->runs[i].load(), 10);
+        delete jobs[c];
+    }
+}
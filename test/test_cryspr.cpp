@@ -780,4 +780,76 @@ TEST_F(TestCRYSPRcrypto, DecryptAESctr_tv1_256)
 }
 #endif /* CRYSPR_HAS_AESCTR */
 
+/* HaiCrypt with precomputed AES-CTR keystream */
+
+static HaiCrypt_Handle ut_CreateTxCrypto()
+{
+    HaiCrypt_Cfg cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.flags = HAICRYPT_CFG_F_CRYPTO | HAICRYPT_CFG_F_TX;
+    cfg.xport = HAICRYPT_XPT_SRT;
+    cfg.cryspr = HaiCryptCryspr_Get_Instance();
+    cfg.key_len = 16;
+    cfg.data_max_len = HAICRYPT_DEF_DATA_MAX_LENGTH;
+    cfg.km_refresh_rate_pkt = HAICRYPT_DEF_KM_REFRESH_RATE;
+    cfg.km_pre_announce_pkt = HAICRYPT_DEF_KM_PRE_ANNOUNCE;
+    cfg.secret.typ = HAICRYPT_SECTYP_PASSPHRASE;
+    cfg.secret.len = 10;
+    memcpy(cfg.secret.str, "0123456789", cfg.secret.len);
+
+    HaiCrypt_Handle hc = NULL;
+    EXPECT_EQ(HaiCrypt_Create(&cfg, &hc), HAICRYPT_OK);
+    return hc;
+}
+
+static void ut_EncryptPacket(HaiCrypt_Handle hc, uint32_t seqno, size_t len, unsigned char* out)
+{
+    uint32_t hdr[4] = { seqno, uint32_t(HaiCrypt_Tx_GetKeyFlags(hc)) << 27, 0, 0 };
+    for (size_t i = 0; i < len; ++i)
+        out[i] = (unsigned char)(seqno + i);
+    ASSERT_EQ(HaiCrypt_Tx_Data(hc, (unsigned char*)hdr, out, len), 0);
+}
+
+TEST(HaiCrypt, PrecomputedKeystream)
+{
+    HaiCrypt_Handle hc = ut_CreateTxCrypto();
+    ASSERT_NE(hc, (HaiCrypt_Handle)NULL);
+
+    const size_t len = 1316;
+    const uint32_t seqno = 1000;
+    unsigned char expected[8][len];
+    unsigned char actual[len];
+
+    // Encrypted by the cipher.
+    for (uint32_t i = 0; i < 8; ++i)
+        ut_EncryptPacket(hc, seqno + i, len, expected[i]);
+
+    ASSERT_EQ(HaiCrypt_Tx_SetKeystreamCache(hc, 4), 0);
+    EXPECT_EQ(HaiCrypt_Tx_PrecomputeKeystream(hc, seqno, 4, len), 4);
+    // Already computed.
+    EXPECT_EQ(HaiCrypt_Tx_PrecomputeKeystream(hc, seqno + 2, 2, len), 0);
+
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        ut_EncryptPacket(hc, seqno + i, len, actual);
+        EXPECT_EQ(memcmp(actual, expected[i], len), 0) << "packet " << i;
+    }
+
+    // The last 4 packets didn't have their keystream computed.
+    unsigned hits = 0, misses = 0;
+    EXPECT_EQ(HaiCrypt_Tx_GetKeystreamStats(hc, &hits, &misses), 0);
+    EXPECT_EQ(hits, 4u);
+    EXPECT_EQ(misses, 4u);
+
+    // A shorter keystream isn't used for a longer packet.
+    ASSERT_EQ(HaiCrypt_Tx_SetKeystreamCache(hc, 4), 0);
+    EXPECT_EQ(HaiCrypt_Tx_PrecomputeKeystream(hc, seqno, 1, len / 2), 1);
+    ut_EncryptPacket(hc, seqno, len, actual);
+    EXPECT_EQ(memcmp(actual, expected[0], len), 0);
+    EXPECT_EQ(HaiCrypt_Tx_GetKeystreamStats(hc, &hits, &misses), 0);
+    EXPECT_EQ(misses, 5u);
+
+    EXPECT_EQ(HaiCrypt_Close(hc), 0);
+}
+
 #endif /* SRT_ENABLE_ENCRYPTION */
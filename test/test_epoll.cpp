@@ -3,6 +3,8 @@
 #include <future>
 #include <thread>
 #include <condition_variable>
+#include <atomic>
+#include <vector>
 #include "gtest/gtest.h"
 #include "test_env.h"
 #include "api.h"
@@ -546,6 +548,145 @@ TEST(CEPoll, ThreadedUpdate)
 }
 
 
+// Many threads wait each on its own EID, and an event is signalled on one
+// EID at a time. Only the thread waiting on that EID should wake up, so the
+// time to deliver an event doesn't depend on the number of other waiters.
+// Disabled by default, run with --gtest_also_run_disabled_tests.
+TEST(CEPoll, DISABLED_PerEidWakeupBenchmark)
+{
+    srt::TestInit srtinit;
+
+    const int nthreads = 32;
+    const int rounds   = 100;
+
+    CEPoll epoll;
+    vector<int> eids(nthreads);
+    vector<atomic<int>> received(nthreads);
+    atomic<bool> stop {false};
+
+    // The sockets are only identifiers to the EID, no real sockets are needed.
+    const SRTSOCKET sock_base = 1000;
+    const int epoll_in = SRT_EPOLL_IN | SRT_EPOLL_ET;
+    for (int i = 0; i < nthreads; ++i)
+    {
+        eids[i] = epoll.create();
+        ASSERT_GE(eids[i], 0);
+        ASSERT_EQ(epoll.update_usock(eids[i], sock_base + i, &epoll_in), 0);
+        received[i] = 0;
+    }
+
+    vector<thread> waiters;
+    for (int i = 0; i < nthreads; ++i)
+    {
+        waiters.push_back(thread([&, i]() {
+            SRT_EPOLL_EVENT fds[1];
+            while (!stop)
+            {
+                if (epoll.uwait(eids[i], fds, 1, -1) == 1 && !stop)
+                    ++received[i];
+            }
+        }));
+    }
+
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r)
+    {
+        for (int i = 0; i < nthreads; ++i)
+        {
+            set<int> eid = { eids[i] };
+            epoll.update_events(sock_base + i, eid, SRT_EPOLL_IN, false);
+            epoll.update_events(sock_base + i, eid, SRT_EPOLL_IN, true);
+            while (received[i] <= r)
+                this_thread::yield();
+        }
+    }
+    const int64_t elapsed_us =
+        chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+
+    cout << "CEPoll " << nthreads << " waiting EIDs: " << (double(elapsed_us) / (rounds * nthreads))
+         << " us per event delivery\n";
+
+    stop = true;
+    for (int i = 0; i < nthreads; ++i)
+    {
+        set<int> eid = { eids[i] };
+        epoll.update_events(sock_base + i, eid, SRT_EPOLL_IN, false);
+        epoll.update_events(sock_base + i, eid, SRT_EPOLL_IN, true);
+    }
+    for (size_t i = 0; i < waiters.size(); ++i)
+        waiters[i].join();
+
+    for (int i = 0; i < nthreads; ++i)
+    {
+        EXPECT_EQ(received[i], rounds);
+        EXPECT_EQ(epoll.release(eids[i]), 0);
+    }
+}
+
+// A waiting thread isn't woken up by the events of other EIDs, but it is
+// woken up by the events of its own EID and by the release of the EID.
+TEST(CEPoll, WakeupOnlyOwnEid)
+{
+    srt::TestInit srtinit;
+
+    CEPoll epoll;
+    const int eid_wait  = epoll.create();
+    const int eid_other = epoll.create();
+    ASSERT_EQ(epoll.setflags(eid_wait, SRT_EPOLL_ENABLE_EMPTY), 0);
+    const int epoll_in = SRT_EPOLL_IN;
+    ASSERT_EQ(epoll.update_usock(eid_other, 1000, &epoll_in), 0);
+
+    // Timed wait expires with no events and isn't notified even once
+    // while another EID gets them.
+    auto timed = async(launch::async, [&]() {
+        SRT_EPOLL_EVENT fds[1];
+        return epoll.uwait(eid_wait, fds, 1, 200);
+    });
+    this_thread::sleep_for(chrono::milliseconds(20));
+    set<int> other = { eid_other };
+    for (int i = 0; i < 10; ++i)
+    {
+        epoll.update_events(1000, other, SRT_EPOLL_IN, i % 2 == 0);
+        this_thread::sleep_for(chrono::milliseconds(5));
+    }
+    EXPECT_EQ(timed.get(), 0);
+    EXPECT_EQ(epoll.wakeups(eid_wait), 0);
+
+    // The socket's own event wakes it up.
+    ASSERT_EQ(epoll.update_usock(eid_wait, 1001, &epoll_in), 0);
+    const int64_t subscribed = epoll.wakeups(eid_wait);
+    auto own = async(launch::async, [&]() {
+        SRT_EPOLL_EVENT fds[1];
+        return epoll.uwait(eid_wait, fds, 1, 2000);
+    });
+    this_thread::sleep_for(chrono::milliseconds(50));
+    set<int> own_eids = { eid_wait };
+    epoll.update_events(1001, own_eids, SRT_EPOLL_IN, true);
+    EXPECT_EQ(own.get(), 1);
+    EXPECT_EQ(epoll.wakeups(eid_wait), subscribed + 1);
+    epoll.update_events(1001, own_eids, SRT_EPOLL_IN, false);
+
+    // Infinite wait is interrupted by the release.
+    auto infinite = async(launch::async, [&]() {
+        SRT_EPOLL_EVENT fds[1];
+        try
+        {
+            epoll.uwait(eid_wait, fds, 1, -1);
+        }
+        catch (CUDTException& e)
+        {
+            return e.getErrorCode();
+        }
+        return 0;
+    });
+    this_thread::sleep_for(chrono::milliseconds(50));
+    EXPECT_EQ(epoll.release(eid_wait), 0);
+    ASSERT_EQ(infinite.wait_for(chrono::seconds(2)), future_status::ready);
+    EXPECT_EQ(infinite.get(), int(CUDTException(MJ_NOTSUP, MN_EIDINVAL).getErrorCode()));
+    EXPECT_EQ(epoll.release(eid_other), 0);
+}
+
+
 class TestEPoll: public srt::Test
 {
 protected:
@@ -0,0 +1,315 @@
+#include <vector>
+#include <algorithm>
+#include <future>
+
+#include "gtest/gtest.h"
+#include "test_env.h"
+#include "packet.h"
+#include "fec_rs.h"
+#include "core.h"
+#include "packetfilter.h"
+#include "packetfilter_api.h"
+
+using namespace std;
+using namespace srt;
+
+class TestRSRebuilding: public srt::Test
+{
+protected:
+    unique_ptr<RSFilterBuiltin> sender;
+    unique_ptr<RSFilterBuiltin> receiver;
+    vector<SrtPacket> provided;
+    vector<unique_ptr<CPacket>> source;
+    vector<SrtPacket> parity;
+    int sockid = 54321;
+    int isn = 123456;
+    size_t plsize = 1316;
+
+    void setup() override
+    {
+        srand(7);
+    }
+
+    void teardown() override
+    {
+    }
+
+    void create(const string& conf)
+    {
+        SrtFilterInitializer init = {
+            sockid,
+            isn - 1,
+            isn - 1,
+            plsize,
+            CSrtConfig::DEF_BUFFER_SIZE
+        };
+
+        sender.reset(new RSFilterBuiltin(init, provided, conf));
+        receiver.reset(new RSFilterBuiltin(init, provided, conf));
+    }
+
+    // Send npkts packets through the sender filter, collecting
+    // the parity packets it produces.
+    void send(int npkts)
+    {
+        int32_t seq = CSeqNo::incseq(isn, int(source.size()));
+        for (int i = 0; i < npkts; ++i)
+        {
+            SrtPacket ctl(SRT_LIVE_MAX_PLSIZE);
+            while (sender->packControlPacket(ctl, CSeqNo::decseq(seq)))
+                parity.push_back(ctl);
+
+            source.emplace_back(new CPacket);
+            CPacket& p = *source.back();
+            p.allocate(SRT_LIVE_MAX_PLSIZE);
+
+            uint32_t* hdr = p.getHeader();
+            hdr[SRT_PH_SEQNO] = seq;
+            hdr[SRT_PH_MSGNO] = 1 | MSGNO_PACKET_BOUNDARY::wrap(PB_SOLO);
+            hdr[SRT_PH_ID] = sockid;
+            hdr[SRT_PH_TIMESTAMP] = 10 * int(source.size());
+
+            const size_t length = 100 + rand() % (plsize - 100);
+            p.setLength(length);
+            for (size_t b = 0; b < length; ++b)
+                p.data()[b] = char(rand());
+
+            sender->feedSource(p);
+            seq = CSeqNo::incseq(seq);
+        }
+
+        SrtPacket ctl(SRT_LIVE_MAX_PLSIZE);
+        while (sender->packControlPacket(ctl, CSeqNo::decseq(seq)))
+            parity.push_back(ctl);
+    }
+
+    bool receiveParity(const SrtPacket& ctl, RSFilterBuiltin::loss_seqs_t& w_loss)
+    {
+        CPacket pkt;
+        memcpy(pkt.getHeader(), ctl.hdr, SRT_PH_E_SIZE * sizeof(uint32_t));
+        pkt.m_pcData = const_cast<char*>(ctl.buffer);
+        pkt.setLength(ctl.length);
+        pkt.set_msgflags(SRT_MSGNO_CONTROL | MSGNO_PACKET_BOUNDARY::wrap(PB_SOLO));
+        const bool passthru = receiver->receive(pkt, w_loss);
+        pkt.m_pcData = NULL;
+        return passthru;
+    }
+
+    void expectRebuilt(const SrtPacket& rebuilt)
+    {
+        const int index = CSeqNo::seqoff(isn, rebuilt.hdr[SRT_PH_SEQNO]);
+        ASSERT_GE(index, 0);
+        ASSERT_LT(index, int(source.size()));
+        CPacket& orig = *source[index];
+
+        EXPECT_EQ(orig.getHeader()[SRT_PH_MSGNO] | MSGNO_REXMIT::wrap(true), rebuilt.hdr[SRT_PH_MSGNO]);
+        EXPECT_EQ(orig.getHeader()[SRT_PH_TIMESTAMP], rebuilt.hdr[SRT_PH_TIMESTAMP]);
+        EXPECT_EQ(uint32_t(sockid), rebuilt.hdr[SRT_PH_ID]);
+        ASSERT_EQ(orig.size(), rebuilt.size());
+        EXPECT_EQ(memcmp(orig.data(), rebuilt.data(), rebuilt.size()), 0);
+    }
+};
+
+// Up to m losses in any positions of a group, parity packets included.
+TEST_F(TestRSRebuilding, Rebuild)
+{
+    create("rsfec,k:10,m:3");
+    send(30);
+    ASSERT_EQ(parity.size(), 9U);
+
+    // Group 0: the first three, group 1: spread and one parity,
+    // group 2: the last two and the first parity.
+    const int lost[] = { 0, 1, 2, 12, 15, 28, 29 };
+    const int lost_parity[] = { 4, 6 };
+
+    RSFilterBuiltin::loss_seqs_t loss;
+    size_t nparity = 0;
+    for (size_t i = 0; i < source.size(); ++i)
+    {
+        if (find(lost, lost + Size(lost), int(i)) == lost + Size(lost))
+        {
+            EXPECT_TRUE(receiver->receive(*source[i], loss));
+        }
+
+        // The parity packets are sent after the last packet of the group
+        if (i % 10 == 9)
+        {
+            for (int p = 0; p < 3; ++p, ++nparity)
+            {
+                if (find(lost_parity, lost_parity + Size(lost_parity), int(nparity)) == lost_parity + Size(lost_parity))
+                {
+                    EXPECT_FALSE(receiveParity(parity[nparity], loss));
+                }
+            }
+        }
+    }
+
+    EXPECT_TRUE(loss.empty());
+    ASSERT_EQ(provided.size(), Size(lost));
+    for (size_t i = 0; i < provided.size(); ++i)
+        expectRebuilt(provided[i]);
+
+    EXPECT_EQ(receiver->stats().rcvRecovered, Size(lost));
+    EXPECT_EQ(receiver->stats().rcvParity, 7U);
+    EXPECT_EQ(receiver->stats().rcvUnrecoverable, 0U);
+    EXPECT_EQ(sender->stats().sndGroups, 3U);
+    EXPECT_EQ(sender->stats().sndParity, 9U);
+}
+
+// Parity packets coming before the data packets of their group.
+TEST_F(TestRSRebuilding, Reordered)
+{
+    create("rsfec,k:4,m:2");
+    send(4);
+    ASSERT_EQ(parity.size(), 2U);
+
+    RSFilterBuiltin::loss_seqs_t loss;
+    EXPECT_FALSE(receiveParity(parity[1], loss));
+    EXPECT_TRUE(receiver->receive(*source[3], loss));
+    EXPECT_FALSE(receiveParity(parity[0], loss));
+    EXPECT_TRUE(provided.empty());
+    EXPECT_TRUE(receiver->receive(*source[1], loss));
+
+    ASSERT_EQ(provided.size(), 2U);
+    expectRebuilt(provided[0]);
+    expectRebuilt(provided[1]);
+
+    // The original packet coming late is passed through,
+    // the receiver buffer drops it as a duplicate.
+    EXPECT_TRUE(receiver->receive(*source[0], loss));
+    EXPECT_EQ(provided.size(), 2U);
+}
+
+// More than m losses: reported when the group is dismissed.
+TEST_F(TestRSRebuilding, Unrecoverable)
+{
+    create("rsfec,k:5,m:2,arq:onreq");
+    send(15);
+
+    RSFilterBuiltin::loss_seqs_t loss;
+    for (size_t i = 0; i < 10; ++i)
+    {
+        if (i != 1 && i != 2 && i != 4)
+        {
+            EXPECT_TRUE(receiver->receive(*source[i], loss));
+        }
+        if (i == 4)
+        {
+            EXPECT_FALSE(receiveParity(parity[0], loss));
+            EXPECT_FALSE(receiveParity(parity[1], loss));
+        }
+    }
+    EXPECT_TRUE(provided.empty());
+    EXPECT_TRUE(loss.empty());
+
+    // A packet of the third group dismisses the first one.
+    EXPECT_TRUE(receiver->receive(*source[10], loss));
+    ASSERT_EQ(loss.size(), 2U);
+    EXPECT_EQ(loss[0].first, CSeqNo::incseq(isn, 1));
+    EXPECT_EQ(loss[0].second, CSeqNo::incseq(isn, 2));
+    EXPECT_EQ(loss[1].first, CSeqNo::incseq(isn, 4));
+    EXPECT_EQ(loss[1].second, CSeqNo::incseq(isn, 4));
+    EXPECT_EQ(receiver->stats().rcvUnrecoverable, 3U);
+
+    // Packets of dismissed groups are passed through.
+    loss.clear();
+    EXPECT_TRUE(receiver->receive(*source[1], loss));
+    EXPECT_TRUE(loss.empty());
+    EXPECT_TRUE(provided.empty());
+}
+
+TEST(TestRSFEC, Config)
+{
+    srt::TestInit srtinit;
+
+    SRTSOCKET s = srt_create_socket();
+
+    const char* wrong [] = {
+        "rsfec,k:0",           // too small group
+        "rsfec,k:10,m:0",      // no parity
+        "rsfec,k:200,m:100",   // exceeds GF(2^8)
+        "rsfec,k:10,arq:x",    // invalid arq
+        "rsfec,k:10,cols:10"   // unknown parameter
+    };
+    for (size_t i = 0; i < Size(wrong); ++i)
+        EXPECT_EQ(srt_setsockflag(s, SRTO_PACKETFILTER, wrong[i], (int)strlen(wrong[i])), -1) << wrong[i];
+
+    const char* right [] = { "rsfec", "rsfec,k:10", "rsfec,k:20,m:5,arq:never", "rsfec,k:250,m:5" };
+    for (size_t i = 0; i < Size(right); ++i)
+        EXPECT_NE(srt_setsockflag(s, SRTO_PACKETFILTER, right[i], (int)strlen(right[i])), -1) << right[i];
+
+    srt_close(s);
+}
+
+// The configuration is completed with the peer's and the default one,
+// and the parity packets are exchanged along with the data.
+TEST(TestRSFEC, Connection)
+{
+    srt::TestInit srtinit;
+
+    SRTSOCKET s = srt_create_socket();
+    SRTSOCKET l = srt_create_socket();
+
+    sockaddr_in sa;
+    memset(&sa, 0, sizeof sa);
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(5555);
+    ASSERT_EQ(inet_pton(AF_INET, "127.0.0.1", &sa.sin_addr), 1);
+
+    ASSERT_NE(srt_bind(l, (sockaddr*)& sa, sizeof(sa)), -1);
+
+    const char config1 [] = "rsfec,k:8";
+    const char config2 [] = "rsfec,m:3";
+    ASSERT_NE(srt_setsockflag(s, SRTO_PACKETFILTER, config1, (sizeof config1)-1), -1);
+    ASSERT_NE(srt_setsockflag(l, SRTO_PACKETFILTER, config2, (sizeof config2)-1), -1);
+
+    srt_listen(l, 1);
+
+    auto connect_res = std::async(std::launch::async, [&s, &sa]() {
+        return srt_connect(s, (sockaddr*)& sa, sizeof(sa));
+        });
+
+    SRTSOCKET la[] = { l };
+    SRTSOCKET a = srt_accept_bond(la, 1, 2000);
+    ASSERT_NE(a, SRT_ERROR);
+    ASSERT_EQ(connect_res.get(), SRT_SUCCESS);
+
+    char result_config1[200] = "";
+    int result_config1_size = 200;
+    char result_config2[200] = "";
+    int result_config2_size = 200;
+    EXPECT_NE(srt_getsockflag(s, SRTO_PACKETFILTER, result_config1, &result_config1_size), -1);
+    EXPECT_NE(srt_getsockflag(a, SRTO_PACKETFILTER, result_config2, &result_config2_size), -1);
+    EXPECT_EQ(string(result_config1), string(result_config2));
+
+    vector<string> params;
+    Split(string(result_config1), ',', back_inserter(params));
+    sort(params.begin(), params.end());
+    const char* expected [] = { "arq:onreq", "k:8", "m:3", "rsfec" };
+    EXPECT_EQ(params, vector<string>(expected, expected + Size(expected)));
+
+    const int npkts = 64;
+    char buf[1316];
+    for (int i = 0; i < npkts; ++i)
+    {
+        memset(buf, i, sizeof buf);
+        ASSERT_EQ(srt_sendmsg(s, buf, sizeof buf, -1, true), int(sizeof buf)) << srt_getlasterror_str();
+    }
+    for (int i = 0; i < npkts; ++i)
+    {
+        ASSERT_EQ(srt_recvmsg(a, buf, sizeof buf), int(sizeof buf)) << srt_getlasterror_str();
+        EXPECT_EQ(buf[0], char(i));
+    }
+
+    // The parity packets of the last group follow its last data packet.
+    SRT_TRACEBSTATS snd_stats, rcv_stats;
+    ASSERT_EQ(srt_bstats(s, &snd_stats, 0), 0);
+    ASSERT_EQ(srt_bstats(a, &rcv_stats, 0), 0);
+    EXPECT_EQ(snd_stats.pktSndFilterExtraTotal, npkts / 8 * 3);
+    EXPECT_EQ(rcv_stats.pktRcvFilterExtraTotal, npkts / 8 * 3);
+    EXPECT_EQ(rcv_stats.pktRcvFilterSupplyTotal, 0);
+
+    srt_close(a);
+    srt_close(s);
+    srt_close(l);
+}
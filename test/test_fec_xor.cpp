@@ -0,0 +1,188 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "fec_xor.h"
+
+using namespace std;
+using namespace srt;
+
+// Every kernel gives the same result as the plain loop, for any length
+// and alignment of the buffers.
+TEST(FECXor, KernelsMatchScalar)
+{
+    size_t                 count   = 0;
+    const fec::XorKernel*  kernels = fec::xorKernels((count));
+    ASSERT_GE(count, 1U);
+    EXPECT_STREQ(kernels[0].name, "scalar");
+    EXPECT_EQ(fec::xorBest().fn, kernels[count - 1].fn);
+
+    mt19937                       gen(7);
+    uniform_int_distribution<int> byte(0, 255);
+    vector<char>                  src(1500 + 64), dst(1500 + 64);
+    for (size_t i = 0; i < src.size(); ++i)
+    {
+        src[i] = char(byte(gen));
+        dst[i] = char(byte(gen));
+    }
+
+    const size_t lengths[] = {0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 1316, 1456};
+    for (size_t k = 0; k < count; ++k)
+    {
+        for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); ++l)
+        {
+            for (size_t off = 0; off < 4; ++off)
+            {
+                const size_t len = lengths[l];
+                vector<char> expected(dst), actual(dst);
+                for (size_t i = 0; i < len; ++i)
+                    expected[off + i] ^= src[3 + i];
+
+                kernels[k].fn(&actual[off], &src[3], len);
+                ASSERT_EQ(actual, expected) << kernels[k].name << " len=" << len << " off=" << off;
+            }
+        }
+    }
+}
+
+// Clipping of 1316-byte payloads into the row and column groups of
+// a 10x10 FEC matrix, as done by the sender and the receiver.
+// Disabled by default, run with --gtest_also_run_disabled_tests.
+TEST(FECXor, DISABLED_Benchmark)
+{
+    const size_t payload = 1316;
+    const size_t cols    = 10;
+    const size_t rows    = 10;
+    const int    rounds  = 2000;
+
+    vector<char> packets(cols * rows * payload);
+    mt19937      gen(7);
+    for (size_t i = 0; i < packets.size(); ++i)
+        packets[i] = char(gen());
+
+    size_t                count   = 0;
+    const fec::XorKernel* kernels = fec::xorKernels((count));
+    vector<char>          reference;
+    for (size_t k = 0; k < count; ++k)
+    {
+        vector<char> row_clips(rows * payload), col_clips(cols * payload);
+
+        const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (int r = 0; r < rounds; ++r)
+        {
+            for (size_t i = 0; i < cols * rows; ++i)
+            {
+                const char* pkt = &packets[i * payload];
+                kernels[k].fn(&row_clips[(i / cols) * payload], pkt, payload);
+                kernels[k].fn(&col_clips[(i % cols) * payload], pkt, payload);
+            }
+        }
+        const int64_t elapsed_ns =
+            chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+
+        const int64_t packets_clipped = int64_t(rounds) * cols * rows;
+        cout << "FEC XOR " << kernels[k].name << " " << cols << "x" << rows << " payload=" << payload << ": "
+             << (double(elapsed_ns) / packets_clipped) << " ns/packet, "
+             << (double(packets_clipped) * 2 * payload / elapsed_ns) << " GB/s\n";
+
+        row_clips.insert(row_clips.end(), col_clips.begin(), col_clips.end());
+        if (k == 0)
+            reference = row_clips;
+        else
+            EXPECT_EQ(row_clips, reference) << kernels[k].name;
+    }
+}
+
+TEST(FECXor, GaloisField)
+{
+    for (int a = 1; a < 256; ++a)
+    {
+        EXPECT_EQ(fec::gfMul((unsigned char)a, fec::gfInv((unsigned char)a)), 1) << a;
+        EXPECT_EQ(fec::gfMul((unsigned char)a, 1), a);
+        EXPECT_EQ(fec::gfMul((unsigned char)a, 0), 0);
+    }
+    // x * x^7 = x^8 = x^4 + x^3 + x^2 + 1 (0x11D)
+    EXPECT_EQ(fec::gfMul(0x02, 0x80), 0x1D);
+}
+
+// Every multiplying kernel gives the same result as the byte-wise
+// multiplication, for all constants and for any length.
+TEST(FECXor, MulKernelsMatchField)
+{
+    size_t                   count   = 0;
+    const fec::XorMulKernel* kernels = fec::xorMulKernels((count));
+    ASSERT_GE(count, 1U);
+    EXPECT_EQ(fec::xorMulBest().fn, kernels[count - 1].fn);
+
+    mt19937      gen(7);
+    vector<char> src(1316 + 3), dst(1316 + 3);
+    for (size_t i = 0; i < src.size(); ++i)
+    {
+        src[i] = char(gen());
+        dst[i] = char(gen());
+    }
+
+    const size_t lengths[] = {0, 1, 15, 16, 17, 31, 32, 33, 100, 1316};
+    for (size_t k = 0; k < count; ++k)
+    {
+        for (int c = 0; c < 256; ++c)
+        {
+            for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); ++l)
+            {
+                const size_t len = lengths[l];
+                vector<char> expected(dst), actual(dst);
+                for (size_t i = 0; i < len; ++i)
+                    expected[1 + i] ^= char(fec::gfMul((unsigned char)c, (unsigned char)src[3 + i]));
+
+                kernels[k].fn(&actual[1], &src[3], (unsigned char)c, len);
+                ASSERT_EQ(actual, expected) << kernels[k].name << " c=" << c << " len=" << len;
+            }
+        }
+    }
+}
+
+// Encoding of the parity of a group of 10 packets of 1316 bytes,
+// 2 parity packets, as done by the Reed-Solomon filter.
+// Disabled by default, run with --gtest_also_run_disabled_tests.
+TEST(FECXor, DISABLED_MulBenchmark)
+{
+    const size_t payload = 1316;
+    const size_t k       = 10;
+    const size_t m       = 2;
+    const int    rounds  = 2000;
+
+    vector<char> packets(k * payload);
+    mt19937      gen(7);
+    for (size_t i = 0; i < packets.size(); ++i)
+        packets[i] = char(gen());
+
+    size_t                   count   = 0;
+    const fec::XorMulKernel* kernels = fec::xorMulKernels((count));
+    vector<char>             reference;
+    for (size_t n = 0; n < count; ++n)
+    {
+        vector<char> parity(m * payload);
+
+        const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (int r = 0; r < rounds; ++r)
+        {
+            for (size_t j = 0; j < k; ++j)
+            {
+                for (size_t i = 0; i < m; ++i)
+                    kernels[n].fn(&parity[i * payload], &packets[j * payload], fec::gfInv((unsigned char)((k + i) ^ j)), payload);
+            }
+        }
+        const int64_t elapsed_ns =
+            chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+
+        const int64_t packets_encoded = int64_t(rounds) * k;
+        cout << "FEC GF(2^8) " << kernels[n].name << " k=" << k << " m=" << m << " payload=" << payload << ": "
+             << (double(elapsed_ns) / packets_encoded) << " ns/packet\n";
+
+        if (n == 0)
+            reference = parity;
+        else
+            EXPECT_EQ(parity, reference) << kernels[n].name;
+    }
+}
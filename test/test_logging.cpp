@@ -0,0 +1,248 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "logging.h"
+
+using namespace std;
+using namespace srt_logging;
+
+namespace
+{
+
+// Log lines collected from a logger of its own, so that the settings
+// of the library's loggers are not affected.
+class TestLog
+{
+public:
+    TestLog(int flags)
+        : config(fas(), LogLevel::debug)
+        , logger(SRT_LOGFA_GENERAL, config, "SRT.test")
+        , keep(true)
+        , lines(0)
+        , reports(0)
+        , dropped(0)
+    {
+        config.flags             = flags | SRT_LOGF_DISABLE_TIME | SRT_LOGF_DISABLE_THREADNAME | SRT_LOGF_DISABLE_EOL;
+        config.loghandler_fn     = &TestLog::handler;
+        config.loghandler_opaque = this;
+    }
+
+    ~TestLog()
+    {
+        // The records may refer to this logger.
+        LogQueue::instance().flush();
+    }
+
+    static LogConfig::fa_bitset_t fas()
+    {
+        LogConfig::fa_bitset_t fa;
+        fa.set(SRT_LOGFA_GENERAL);
+        return fa;
+    }
+
+    // Called with the config locked.
+    static void handler(void* opaque, int, const char*, int, const char*, const char* message)
+    {
+        TestLog* self = (TestLog*)opaque;
+        unsigned long n = 0;
+        if (strstr(message, "log records dropped") && sscanf(message, " D:SRT.test: %lu", &n) == 1)
+        {
+            ++self->reports;
+            self->dropped += n;
+            return;
+        }
+
+        ++self->lines;
+        if (self->keep)
+            self->messages.push_back(message);
+    }
+
+    LogConfig      config;
+    Logger         logger;
+    bool           keep;
+    size_t         lines;
+    size_t         reports; // Lines reporting the dropped records
+    uint64_t       dropped; // Records reported as dropped
+    vector<string> messages;
+};
+
+struct Point
+{
+    int value;
+};
+
+ostream& operator<<(ostream& os, const Point& p)
+{
+    return os << "<" << p.value << ">";
+}
+
+} // namespace
+
+TEST(Logging, BinaryArguments)
+{
+    TestLog tl(0);
+
+    const int64_t          big = -(int64_t(1) << 40);
+    srt::sync::atomic<int> counter(7);
+    const string           text  = "text";
+    const Point            other = {3};
+    char                   buf[] = "buf";
+
+    LOGB(tl.logger.Debug, "int={} uint={} big={} dbl={} chr={} bool={}",
+         log << -5 << 5u << big << 0.5 << 'x' << true);
+    LOGB(tl.logger.Debug, "str={} lit={} buf={} atomic={} other={}",
+         log << text << "lit" << buf << counter << other);
+    LOGB(tl.logger.Debug, "few={} {}", log << 1);
+    LOGB(tl.logger.Debug, "many={}", log << 1 << 2 << 3);
+    LOGB(tl.logger.Debug, "none", log);
+
+    ASSERT_EQ(tl.messages.size(), 5U);
+    EXPECT_EQ(tl.messages[0], " D:SRT.test: int=-5 uint=5 big=-1099511627776 dbl=0.5 chr=x bool=1");
+    EXPECT_EQ(tl.messages[1], " D:SRT.test: str=text lit=lit buf=buf atomic=7 other=<3>");
+    EXPECT_EQ(tl.messages[2], " D:SRT.test: few=1 {}");
+    EXPECT_EQ(tl.messages[3], " D:SRT.test: many=1 2 3");
+    EXPECT_EQ(tl.messages[4], " D:SRT.test: none");
+
+    // Text that doesn't fit in the record is cut.
+    const string long_text(200, 'a');
+    LOGB(tl.logger.Debug, "{}", log << long_text);
+    ASSERT_EQ(tl.messages.size(), 6U);
+    EXPECT_EQ(tl.messages[5], " D:SRT.test: " + string(LogRecord::TEXT_SIZE, 'a'));
+}
+
+// Records of several threads are written out in the order of their time.
+TEST(Logging, AsyncOrder)
+{
+    TestLog tl(SRT_LOGF_ASYNC);
+
+    const int      per_thread = 100;
+    vector<thread> threads;
+    for (int t = 0; t < 2; ++t)
+    {
+        threads.push_back(thread([&tl, t]() {
+            for (int i = 0; i < per_thread; ++i)
+            {
+                LOGB(tl.logger.Debug, "{} {}", log << t << i);
+                this_thread::sleep_for(chrono::microseconds(100));
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t)
+        threads[t].join();
+
+    LogQueue::instance().flush();
+
+    ASSERT_EQ(tl.messages.size(), size_t(2 * per_thread));
+    int next[2] = {0, 0};
+    for (size_t i = 0; i < tl.messages.size(); ++i)
+    {
+        int t = -1, n = -1;
+        ASSERT_EQ(sscanf(tl.messages[i].c_str(), " D:SRT.test: %d %d", &t, &n), 2) << tl.messages[i];
+        ASSERT_TRUE(t == 0 || t == 1);
+        EXPECT_EQ(n, next[t]++);
+    }
+}
+
+// When the ring of a thread is full, the records are dropped and counted,
+// and the next record of the thread is preceded by a report of the drop.
+TEST(Logging, AsyncOverflow)
+{
+    TestLog tl(SRT_LOGF_ASYNC);
+    tl.keep = false;
+
+    const uint64_t lost_before = LogQueue::instance().overflow();
+
+    // Writing a record takes much less than formatting it, so a burst
+    // of records fills the ring before the writing thread catches up.
+    const int written = 100000;
+    for (int i = 0; i < written; ++i)
+        LOGB(tl.logger.Debug, "{}", log << i);
+
+    LogQueue::instance().flush();
+
+    const uint64_t lost = LogQueue::instance().overflow() - lost_before;
+    EXPECT_GT(lost, 0U);
+    EXPECT_GT(tl.reports, 0U);
+    EXPECT_EQ(tl.dropped, lost);
+    EXPECT_EQ(tl.lines + lost, size_t(written));
+    EXPECT_EQ(srt_getlogoverflow(), int64_t(LogQueue::instance().overflow()));
+}
+
+namespace
+{
+int s_iFormatted = 0;
+
+string formatCounted(int64_t value)
+{
+    ++s_iFormatted;
+    ostringstream os;
+    os << "#" << value;
+    return os.str();
+}
+} // namespace
+
+// The deferred arguments are formatted by the writing thread.
+TEST(Logging, DeferredArguments)
+{
+    using namespace srt::sync;
+
+    TestLog tl(SRT_LOGF_ASYNC);
+
+    const steady_clock::time_point tp = steady_clock::now();
+    s_iFormatted = 0;
+    LOGB(tl.logger.Debug, "time={} value={}", log << tp << LogDeferred(&formatCounted, 5));
+    EXPECT_EQ(s_iFormatted, 0);
+
+    LogQueue::instance().flush();
+    EXPECT_EQ(s_iFormatted, 1);
+    ASSERT_EQ(tl.messages.size(), 1U);
+    EXPECT_EQ(tl.messages[0], " D:SRT.test: time=" + FormatTime(tp) + " value=#5");
+}
+
+// A data thread logging every packet, formatting the line itself under
+// the lock of the log config, versus passing the record to the writing
+// thread. Disabled by default, run with --gtest_also_run_disabled_tests.
+TEST(Logging, DISABLED_Benchmark)
+{
+    const int     lines = 200000;
+    const int32_t id    = 12345;
+
+    for (int variant = 0; variant < 2; ++variant)
+    {
+        TestLog tl(variant == 0 ? 0 : SRT_LOGF_ASYNC);
+        tl.keep = false;
+
+        const uint64_t lost_before = LogQueue::instance().overflow();
+        const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (int i = 0; i < lines; ++i)
+        {
+            if (variant == 0)
+            {
+                LOGC(tl.logger.Debug, log << "@" << id << ": packData: normal packet seq=" << i << " (ACK=" << (i - 10)
+                                          << " ACKDATA=" << (i - 10) << ")");
+            }
+            else
+            {
+                LOGB(tl.logger.Debug, "@{}: packData: normal packet seq={} (ACK={} ACKDATA={})",
+                     log << id << i << (i - 10) << (i - 10));
+            }
+        }
+        const chrono::steady_clock::time_point logged = chrono::steady_clock::now();
+        LogQueue::instance().flush();
+        const chrono::steady_clock::time_point flushed = chrono::steady_clock::now();
+
+        const uint64_t lost = LogQueue::instance().overflow() - lost_before;
+        cout << "Logging " << (variant == 0 ? "synchronous" : "asynchronous") << ": "
+             << (double(chrono::duration_cast<chrono::nanoseconds>(logged - start).count()) / lines)
+             << " ns/line in the logging thread, "
+             << chrono::duration_cast<chrono::milliseconds>(flushed - start).count() << " ms until written, "
+             << tl.lines << " written, " << lost << " lost, " << tl.reports << " drop reports\n";
+
+        EXPECT_EQ(tl.lines + lost, size_t(lines));
+    }
+}
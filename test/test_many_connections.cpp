@@ -1,9 +1,12 @@
 #define _CRT_RAND_S // For Windows, rand_s 
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <future>
 #include <random>
+#include <thread>
 #include <gtest/gtest.h>
 #include "test_env.h"
 
@@ -191,3 +194,211 @@ TEST_F(TestConnection, Multiple)
 
 
 
+
+// The receiving sockets deliver the packets with the shared TSBPD threads
+// instead of each running its own thread.
+TEST_F(TestConnection, SharedTsbpd)
+{
+    const sockaddr* psa = reinterpret_cast<const sockaddr*>(&m_sa);
+    const int NMSG = 10;
+
+    for (size_t i = 0; i < NSOCK; i++)
+    {
+        m_connections[i] = srt_create_socket();
+        ASSERT_NE(m_connections[i], SRT_INVALID_SOCK);
+
+        const bool yes = true;
+        const int rcvtimeo = 5000;
+        ASSERT_NE(srt_setsockflag(m_connections[i], SRTO_TSBPDSHARED, &yes, sizeof yes), SRT_ERROR);
+        ASSERT_NE(srt_setsockflag(m_connections[i], SRTO_RCVTIMEO, &rcvtimeo, sizeof rcvtimeo), SRT_ERROR);
+        ASSERT_NE(srt_connect(m_connections[i], psa, sizeof m_sa), SRT_ERROR) << srt_getlasterror_str();
+
+        bool shared = false;
+        int optlen = sizeof shared;
+        EXPECT_NE(srt_getsockflag(m_connections[i], SRTO_TSBPDSHARED, &shared, &optlen), SRT_ERROR);
+        EXPECT_TRUE(shared);
+    }
+
+    for (size_t i = 0; i < NSOCK; i++)
+    {
+        const SRTSOCKET acp = srt_accept(m_server_sock, NULL, NULL);
+        ASSERT_NE(acp, SRT_INVALID_SOCK) << srt_getlasterror_str();
+        m_accepted.push_back(acp);
+    }
+
+    for (int j = 0; j < NMSG; j++)
+    {
+        m_buf[0] = char(j);
+        for (size_t i = 0; i < NSOCK; i++)
+        {
+            EXPECT_EQ(srt_send(m_accepted[i], m_buf.data(), (int) m_buf.size()), (int) m_buf.size());
+        }
+    }
+
+    std::array<char, SRT_LIVE_DEF_PLSIZE> rbuf;
+    for (size_t i = 0; i < NSOCK; i++)
+    {
+        for (int j = 0; j < NMSG; j++)
+        {
+            m_buf[0] = char(j);
+            ASSERT_EQ(srt_recv(m_connections[i], rbuf.data(), (int) rbuf.size()), (int) rbuf.size())
+                << "conn #" << i << " msg #" << j << ": " << srt_getlasterror_str();
+            EXPECT_TRUE(rbuf == m_buf) << "conn #" << i << " msg #" << j;
+        }
+    }
+
+    // The receiving sockets are served by the pool, not their own threads.
+    EXPECT_GE(srt::CUDT::uglobal().tsbpdPool().sockets(), int(NSOCK));
+
+    for (size_t i = 0; i < NSOCK; i++)
+    {
+        EXPECT_EQ(srt_close(m_connections[i]), SRT_SUCCESS);
+        EXPECT_EQ(srt_close(m_accepted[i]), SRT_SUCCESS);
+    }
+    EXPECT_EQ(srt_close(m_server_sock), SRT_SUCCESS);
+}
+
+namespace
+{
+void countRelease(void* opaque)
+{
+    ++*static_cast<std::atomic<int>*>(opaque);
+}
+}
+
+// The payload is sent from the caller's buffers, which are released
+// once per message after the messages are acknowledged or the socket is closed.
+TEST_F(TestConnection, ZeroCopySend)
+{
+    const sockaddr* psa = reinterpret_cast<const sockaddr*>(&m_sa);
+    const int NMSG = 10;
+
+    for (size_t i = 0; i < NSOCK; i++)
+    {
+        m_connections[i] = srt_create_socket();
+        ASSERT_NE(m_connections[i], SRT_INVALID_SOCK);
+
+        const int rcvtimeo = 5000;
+        ASSERT_NE(srt_setsockflag(m_connections[i], SRTO_RCVTIMEO, &rcvtimeo, sizeof rcvtimeo), SRT_ERROR);
+        ASSERT_NE(srt_connect(m_connections[i], psa, sizeof m_sa), SRT_ERROR) << srt_getlasterror_str();
+    }
+
+    for (size_t i = 0; i < NSOCK; i++)
+    {
+        const SRTSOCKET acp = srt_accept(m_server_sock, NULL, NULL);
+        ASSERT_NE(acp, SRT_INVALID_SOCK) << srt_getlasterror_str();
+        m_accepted.push_back(acp);
+    }
+
+    // A release function is required.
+    EXPECT_EQ(srt_sendmsg_zc(m_accepted[0], m_buf.data(), (int) m_buf.size(), NULL, NULL, NULL), SRT_ERROR);
+    EXPECT_EQ(srt_getlasterror(NULL), SRT_EINVPARAM);
+
+    // The sockets may be closed by the fixture when the test fails,
+    // so the buffers and the counter must outlive the test function.
+    static std::vector< std::array<char, SRT_LIVE_DEF_PLSIZE> > payloads;
+    static std::atomic<int> released;
+    payloads.assign(NMSG, m_buf);
+    released = 0;
+    for (int j = 0; j < NMSG; j++)
+    {
+        payloads[j][0] = char(j);
+        for (size_t i = 0; i < NSOCK; i++)
+        {
+            EXPECT_EQ(srt_sendmsg_zc(m_accepted[i], payloads[j].data(), (int) payloads[j].size(), NULL, countRelease, &released),
+                      (int) payloads[j].size());
+        }
+    }
+
+    std::array<char, SRT_LIVE_DEF_PLSIZE> rbuf;
+    for (size_t i = 0; i < NSOCK; i++)
+    {
+        for (int j = 0; j < NMSG; j++)
+        {
+            ASSERT_EQ(srt_recv(m_connections[i], rbuf.data(), (int) rbuf.size()), (int) rbuf.size())
+                << "conn #" << i << " msg #" << j << ": " << srt_getlasterror_str();
+            EXPECT_TRUE(rbuf == payloads[j]) << "conn #" << i << " msg #" << j;
+        }
+    }
+
+    // The messages get released when the sender gets the ACK.
+    for (int n = 0; n < 500 && released < int(NSOCK) * NMSG; n++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(released, int(NSOCK) * NMSG);
+
+    // The messages not acknowledged yet are released by srt_close.
+    for (size_t i = 0; i < NSOCK; i++)
+    {
+        EXPECT_EQ(srt_sendmsg_zc(m_accepted[i], payloads[0].data(), (int) payloads[0].size(), NULL, countRelease, &released),
+                  (int) payloads[0].size());
+        EXPECT_EQ(srt_close(m_accepted[i]), SRT_SUCCESS);
+        EXPECT_EQ(released, int(NSOCK) * NMSG + int(i) + 1);
+    }
+
+    for (size_t i = 0; i < NSOCK; i++)
+        EXPECT_EQ(srt_close(m_connections[i]), SRT_SUCCESS);
+    EXPECT_EQ(srt_close(m_server_sock), SRT_SUCCESS);
+    EXPECT_EQ(released, int(NSOCK) * (NMSG + 1));
+}
+
+// The received messages are lent by the receiver buffer and
+// returned to it with srt_recvmsg_release.
+TEST_F(TestConnection, ZeroCopyRecv)
+{
+    const sockaddr* psa = reinterpret_cast<const sockaddr*>(&m_sa);
+    const int NMSG = 10;
+
+    for (size_t i = 0; i < NSOCK; i++)
+    {
+        m_connections[i] = srt_create_socket();
+        ASSERT_NE(m_connections[i], SRT_INVALID_SOCK);
+
+        const int rcvtimeo = 5000;
+        ASSERT_NE(srt_setsockflag(m_connections[i], SRTO_RCVTIMEO, &rcvtimeo, sizeof rcvtimeo), SRT_ERROR);
+        ASSERT_NE(srt_connect(m_connections[i], psa, sizeof m_sa), SRT_ERROR) << srt_getlasterror_str();
+    }
+
+    for (size_t i = 0; i < NSOCK; i++)
+    {
+        const SRTSOCKET acp = srt_accept(m_server_sock, NULL, NULL);
+        ASSERT_NE(acp, SRT_INVALID_SOCK) << srt_getlasterror_str();
+        m_accepted.push_back(acp);
+    }
+
+    for (int j = 0; j < NMSG; j++)
+    {
+        m_buf[0] = char(j);
+        for (size_t i = 0; i < NSOCK; i++)
+        {
+            EXPECT_EQ(srt_send(m_accepted[i], m_buf.data(), (int) m_buf.size()), (int) m_buf.size());
+        }
+    }
+
+    for (size_t i = 0; i < NSOCK; i++)
+    {
+        for (int j = 0; j < NMSG; j++)
+        {
+            m_buf[0] = char(j);
+            SRT_RCVLOAN loan;
+            ASSERT_EQ(srt_recvmsg_zc(m_connections[i], &loan, NULL), (int) m_buf.size())
+                << "conn #" << i << " msg #" << j << ": " << srt_getlasterror_str();
+            ASSERT_EQ(loan.nsegs, 1);
+            ASSERT_EQ(loan.segs[0].len, (int) m_buf.size());
+            EXPECT_TRUE(std::equal(m_buf.begin(), m_buf.end(), loan.segs[0].data)) << "conn #" << i << " msg #" << j;
+
+            // The last one is left to be released by closing the socket.
+            if (j == NMSG - 1)
+                continue;
+
+            EXPECT_EQ(srt_recvmsg_release(m_connections[i], &loan), 0);
+            EXPECT_EQ(srt_recvmsg_release(m_connections[i], &loan), SRT_ERROR);
+        }
+    }
+
+    for (size_t i = 0; i < NSOCK; i++)
+    {
+        EXPECT_EQ(srt_close(m_connections[i]), SRT_SUCCESS);
+        EXPECT_EQ(srt_close(m_accepted[i]), SRT_SUCCESS);
+    }
+    EXPECT_EQ(srt_close(m_server_sock), SRT_SUCCESS);
+}
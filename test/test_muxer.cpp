@@ -2,6 +2,7 @@
 #include "test_env.h"
 
 #include <thread>
+#include <cstring>
 #include "srt.h"
 
 class TestMuxer
@@ -194,3 +195,94 @@ TEST_F(TestMuxer, IPv4_and_IPv6)
     srt_close(accepted_sock);
     client.join();
 }
+
+#ifdef __linux__
+// Connections accepted through the shards of a listener keep working
+// independently of the listener, each through the shard it came in.
+TEST(Muxer, ListenShards)
+{
+    srt::TestInit srtinit;
+
+    const int NCONN  = 16;
+    const int shards = 4;
+
+    SRTSOCKET sock_lsn = srt_create_socket();
+    ASSERT_NE(sock_lsn, SRT_INVALID_SOCK);
+    ASSERT_EQ(srt_setsockflag(sock_lsn, SRTO_LISTENSHARDS, &shards, sizeof shards), SRT_SUCCESS);
+
+    sockaddr_in sa;
+    memset(&sa, 0, sizeof sa);
+    sa.sin_family = AF_INET;
+    inet_pton(AF_INET, "127.0.0.1", &sa.sin_addr);
+    int port = 5000;
+    for (; port <= 5555; ++port)
+    {
+        sa.sin_port = htons(port);
+        if (srt_bind(sock_lsn, (sockaddr*)&sa, sizeof sa) == 0)
+            break;
+    }
+    ASSERT_LE(port, 5555);
+    ASSERT_NE(srt_listen(sock_lsn, NCONN), SRT_ERROR);
+
+    int value = 0;
+    int optlen = sizeof value;
+    EXPECT_EQ(srt_getsockflag(sock_lsn, SRTO_LISTENSHARDS, &value, &optlen), SRT_SUCCESS);
+    EXPECT_EQ(value, shards);
+
+    // A socket with different settings can't use the same address.
+    SRTSOCKET sock_other = srt_create_socket();
+    EXPECT_EQ(srt_bind(sock_other, (sockaddr*)&sa, sizeof sa), SRT_ERROR);
+    srt_close(sock_other);
+
+    // Only a listener can spread its traffic among the shards.
+    SRTSOCKET sock_shcaller = srt_create_socket();
+    ASSERT_EQ(srt_setsockflag(sock_shcaller, SRTO_LISTENSHARDS, &shards, sizeof shards), SRT_SUCCESS);
+    EXPECT_EQ(srt_connect(sock_shcaller, (sockaddr*)&sa, sizeof sa), SRT_ERROR);
+    EXPECT_EQ(srt_getlasterror(NULL), SRT_EINVPARAM);
+    srt_close(sock_shcaller);
+
+    SRTSOCKET sock_clr[NCONN];
+    SRTSOCKET sock_acp[NCONN];
+    const int rcvtimeo = 3000;
+    for (int i = 0; i < NCONN; ++i)
+    {
+        sock_clr[i] = srt_create_socket();
+        ASSERT_NE(sock_clr[i], SRT_INVALID_SOCK);
+        ASSERT_EQ(srt_setsockflag(sock_clr[i], SRTO_RCVTIMEO, &rcvtimeo, sizeof rcvtimeo), SRT_SUCCESS);
+        ASSERT_NE(srt_connect(sock_clr[i], (sockaddr*)&sa, sizeof sa), SRT_ERROR) << srt_getlasterror_str();
+
+        sock_acp[i] = srt_accept(sock_lsn, NULL, NULL);
+        ASSERT_NE(sock_acp[i], SRT_INVALID_SOCK) << srt_getlasterror_str();
+        ASSERT_EQ(srt_setsockflag(sock_acp[i], SRTO_RCVTIMEO, &rcvtimeo, sizeof rcvtimeo), SRT_SUCCESS);
+    }
+
+    // The connections must survive the listener.
+    for (int round = 0; round < 2; ++round)
+    {
+        if (round == 1)
+            srt_close(sock_lsn);
+
+        for (int i = 0; i < NCONN; ++i)
+        {
+            char buf[16];
+            snprintf(buf, sizeof buf, "hello %d.%d", round, i);
+            const int len = int(strlen(buf)) + 1;
+            ASSERT_EQ(srt_sendmsg(sock_clr[i], buf, len, -1, true), len) << srt_getlasterror_str();
+
+            char rbuf[1500];
+            ASSERT_EQ(srt_recvmsg(sock_acp[i], rbuf, sizeof rbuf), len) << srt_getlasterror_str();
+            EXPECT_STREQ(rbuf, buf);
+
+            ASSERT_EQ(srt_sendmsg(sock_acp[i], rbuf, len, -1, true), len) << srt_getlasterror_str();
+            ASSERT_EQ(srt_recvmsg(sock_clr[i], rbuf, sizeof rbuf), len) << srt_getlasterror_str();
+            EXPECT_STREQ(rbuf, buf);
+        }
+    }
+
+    for (int i = 0; i < NCONN; ++i)
+    {
+        srt_close(sock_acp[i]);
+        srt_close(sock_clr[i]);
+    }
+}
+#endif
@@ -0,0 +1,161 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "test_env.h"
+#include "queue.h"
+
+using namespace std;
+using namespace srt;
+using namespace srt::sync;
+
+namespace
+{
+
+unique_ptr<CSNode[]> makeNodes(size_t count)
+{
+    unique_ptr<CSNode[]> nodes(new CSNode[count]);
+    for (size_t i = 0; i < count; ++i)
+    {
+        nodes[i].m_pUDT     = NULL;
+        nodes[i].m_iHeapLoc = -1;
+        nodes[i].m_pPrev    = NULL;
+        nodes[i].m_pNext    = NULL;
+    }
+    return nodes;
+}
+
+// Removes all nodes in the order of the schedule and returns their times.
+vector<steady_clock::time_point> drain(CSndSchedule& sched)
+{
+    vector<steady_clock::time_point> times;
+    while (CSNode* n = sched.top())
+    {
+        times.push_back(n->m_tsTimeStamp);
+        sched.remove(n);
+        EXPECT_EQ(n->m_iHeapLoc, -1);
+    }
+    EXPECT_EQ(sched.size(), 0);
+    return times;
+}
+
+}
+
+// The timing wheel must deliver the nodes in the same order as the heap,
+// including the ones in the past and the ones beyond the wheel range.
+TEST(SndSchedule, SameOrderAsHeap)
+{
+    const size_t count = 2000;
+    mt19937 gen(42);
+    // Up to 40s, so that some nodes get past the range of the wheel.
+    uniform_int_distribution<int64_t> delay(-100000, 40000000);
+    uniform_int_distribution<int> action(0, 9);
+
+    const steady_clock::time_point start = steady_clock::now();
+    unique_ptr<CSNode[]> heap_nodes  = makeNodes(count);
+    unique_ptr<CSNode[]> wheel_nodes = makeNodes(count);
+    CSndHeap        heap;
+    CSndTimingWheel wheel;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const steady_clock::time_point ts = start + microseconds_from(delay(gen));
+        heap_nodes[i].m_tsTimeStamp  = ts;
+        wheel_nodes[i].m_tsTimeStamp = ts;
+        heap.insert(&heap_nodes[i]);
+        wheel.insert(&wheel_nodes[i]);
+    }
+
+    // Mix taking the earliest with removing and advancing random nodes.
+    uniform_int_distribution<size_t> which(0, count - 1);
+    for (int step = 0; step < 1000; ++step)
+    {
+        const size_t i = which(gen);
+        const int    a = action(gen);
+        if (a == 0)
+        {
+            heap.remove(&heap_nodes[i]);
+            wheel.remove(&wheel_nodes[i]);
+        }
+        else if (a == 1 && heap_nodes[i].m_iHeapLoc >= 0)
+        {
+            const steady_clock::time_point ts = heap_nodes[i].m_tsTimeStamp - microseconds_from(delay(gen) / 100 + 1000);
+            heap.advance(&heap_nodes[i], ts);
+            wheel.advance(&wheel_nodes[i], ts);
+        }
+        else
+        {
+            CSNode* h = heap.top();
+            CSNode* w = wheel.top();
+            ASSERT_NE(h, nullptr);
+            ASSERT_NE(w, nullptr);
+            EXPECT_EQ(h->m_tsTimeStamp, w->m_tsTimeStamp);
+            heap.remove(h);
+            wheel.remove(w);
+
+            // Reschedule like a paced sender does.
+            const steady_clock::time_point ts = h->m_tsTimeStamp + microseconds_from(delay(gen) / 1000 + 200);
+            h->m_tsTimeStamp = ts;
+            w->m_tsTimeStamp = ts;
+            heap.insert(h);
+            wheel.insert(w);
+        }
+        ASSERT_EQ(heap.size(), wheel.size());
+    }
+
+    const vector<steady_clock::time_point> heap_order  = drain(heap);
+    const vector<steady_clock::time_point> wheel_order = drain(wheel);
+    EXPECT_EQ(heap_order, wheel_order);
+    EXPECT_TRUE(is_sorted(wheel_order.begin(), wheel_order.end()));
+}
+
+// Compares the cost of a sending cycle (take the earliest socket, schedule
+// its next packet) for the heap and the timing wheel. Disabled by default,
+// run with --gtest_also_run_disabled_tests.
+TEST(SndSchedule, DISABLED_Benchmark)
+{
+    const size_t sizes[] = {100, 1000, 10000};
+    const int    cycles  = 1000000;
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        const size_t count = sizes[s];
+        for (int kind = 0; kind < 2; ++kind)
+        {
+            unique_ptr<CSndSchedule> sched;
+            if (kind == 0)
+                sched.reset(new CSndHeap);
+            else
+                sched.reset(new CSndTimingWheel);
+
+            // Sockets sending at rates from about 1 to 10 Mbps (1316-byte packets).
+            mt19937 gen(7);
+            uniform_int_distribution<int> period(1000, 10000);
+            vector<int> periods(count);
+            unique_ptr<CSNode[]> nodes = makeNodes(count);
+            const steady_clock::time_point start = steady_clock::now();
+            for (size_t i = 0; i < count; ++i)
+            {
+                periods[i]             = period(gen);
+                nodes[i].m_tsTimeStamp = start + microseconds_from(periods[i] * i / count);
+                sched->insert(&nodes[i]);
+            }
+
+            const steady_clock::time_point bench_start = steady_clock::now();
+            for (int c = 0; c < cycles; ++c)
+            {
+                CSNode* n = sched->top();
+                sched->remove(n);
+                n->m_tsTimeStamp += microseconds_from(periods[n - nodes.get()]);
+                sched->insert(n);
+            }
+            const int64_t elapsed = count_microseconds(steady_clock::now() - bench_start);
+
+            cout << "SndSchedule " << (kind == 0 ? "heap " : "wheel") << " sockets=" << count << ": "
+                 << (elapsed * 1000 / cycles) << " ns/cycle\n";
+            EXPECT_EQ(sched->size(), int(count));
+        }
+    }
+}
@@ -0,0 +1,184 @@
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "test_env.h"
+#include "queue.h"
+
+using namespace std;
+using namespace srt;
+
+namespace
+{
+
+// Fake socket instances, only compared by the address.
+CUDT* fakeUDT(int32_t id)
+{
+    return reinterpret_cast<CUDT*>(static_cast<uintptr_t>(uint32_t(id)) * 16 + 16);
+}
+
+// The chained hash table that was used before, kept for comparison.
+class ChainedHash
+{
+public:
+    explicit ChainedHash(int size)
+        : m_vBucket(size, NULL)
+    {
+    }
+
+    ~ChainedHash()
+    {
+        for (size_t i = 0; i < m_vBucket.size(); ++i)
+        {
+            for (Bucket* b = m_vBucket[i]; b;)
+            {
+                Bucket* n = b->next;
+                delete b;
+                b = n;
+            }
+        }
+    }
+
+    CUDT* lookup(int32_t id) const
+    {
+        for (const Bucket* b = m_vBucket[id % m_vBucket.size()]; b; b = b->next)
+        {
+            if (b->id == id)
+                return b->u;
+        }
+        return NULL;
+    }
+
+    void insert(int32_t id, CUDT* u)
+    {
+        Bucket*& head = m_vBucket[id % m_vBucket.size()];
+        Bucket*  n    = new Bucket;
+        n->id         = id;
+        n->u          = u;
+        n->next       = head;
+        head          = n;
+    }
+
+private:
+    struct Bucket
+    {
+        int32_t id;
+        CUDT*   u;
+        Bucket* next;
+    };
+    vector<Bucket*> m_vBucket;
+};
+
+// Socket IDs are allocated downwards from a random starting value.
+vector<int32_t> socketIDs(size_t count, mt19937& gen)
+{
+    uniform_int_distribution<int32_t> start(1 << 20, (1 << 30) - 1);
+    vector<int32_t> ids(count);
+    int32_t id = start(gen);
+    for (size_t i = 0; i < count; ++i)
+        ids[i] = id--;
+    return ids;
+}
+
+}
+
+TEST(SocketHash, InsertLookupRemove)
+{
+    mt19937 gen(1);
+    CHash hash;
+    hash.init(16);
+    map<int32_t, CUDT*> expected;
+
+    // IDs from a sequence with gaps and random ones, so that both
+    // clusters and scattered keys are in the table.
+    vector<int32_t> ids = socketIDs(3000, gen);
+    uniform_int_distribution<int32_t> any(1, (1 << 30) - 1);
+    for (int i = 0; i < 2000; ++i)
+        ids.push_back(any(gen));
+
+    uniform_int_distribution<size_t> which(0, ids.size() - 1);
+    for (int step = 0; step < 50000; ++step)
+    {
+        const int32_t id = ids[which(gen)];
+        if (step % 3 == 0)
+        {
+            hash.remove(id);
+            expected.erase(id);
+        }
+        else
+        {
+            CUDT* u = fakeUDT(id + step);
+            hash.insert(id, u);
+            expected[id] = u;
+        }
+
+        if (step % 1000 == 0)
+        {
+            ASSERT_EQ(hash.size(), int(expected.size()));
+            for (size_t i = 0; i < ids.size(); ++i)
+            {
+                map<int32_t, CUDT*>::const_iterator e = expected.find(ids[i]);
+                EXPECT_EQ(hash.lookup(ids[i]), e == expected.end() ? NULL : e->second);
+            }
+        }
+    }
+
+    // The table grew and keeps the load below 3/4.
+    EXPECT_GT(hash.capacity(), 16);
+    EXPECT_LE(hash.size() * 4, hash.capacity() * 3);
+
+    for (map<int32_t, CUDT*>::const_iterator i = expected.begin(); i != expected.end(); ++i)
+        hash.remove(i->first);
+    EXPECT_EQ(hash.size(), 0);
+    for (size_t i = 0; i < ids.size(); ++i)
+        EXPECT_EQ(hash.lookup(ids[i]), (CUDT*)NULL);
+}
+
+// Compares the lookup cost of the open-addressing table with the chained
+// table with the same initial size, as the receive queue creates it.
+// Disabled by default, run with --gtest_also_run_disabled_tests.
+TEST(SocketHash, DISABLED_Benchmark)
+{
+    const size_t sizes[]  = {100, 1000, 10000, 50000};
+    const int    lookups  = 5000000;
+    const int    hashsize = 1024;
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        mt19937 gen(7);
+        const size_t          count = sizes[s];
+        const vector<int32_t> ids   = socketIDs(count, gen);
+
+        ChainedHash chained(hashsize);
+        CHash       open;
+        open.init(hashsize);
+        for (size_t i = 0; i < count; ++i)
+        {
+            chained.insert(ids[i], fakeUDT(ids[i]));
+            open.insert(ids[i], fakeUDT(ids[i]));
+        }
+
+        // Packets come for random sockets.
+        uniform_int_distribution<size_t> which(0, count - 1);
+        vector<int32_t> order(lookups);
+        for (int i = 0; i < lookups; ++i)
+            order[i] = ids[which(gen)];
+
+        uintptr_t found = 0;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (int i = 0; i < lookups; ++i)
+            found += reinterpret_cast<uintptr_t>(chained.lookup(order[i]));
+        const int64_t chained_ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < lookups; ++i)
+            found -= reinterpret_cast<uintptr_t>(open.lookup(order[i]));
+        const int64_t open_ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+
+        cout << "SocketHash sockets=" << count << ": chained " << (double(chained_ns) / lookups) << " ns/lookup, open "
+             << (double(open_ns) / lookups) << " ns/lookup\n";
+        EXPECT_EQ(found, uintptr_t(0));
+    }
+}
@@ -314,6 +314,8 @@ const OptionTestEntry g_test_matrix_options[] =
     //SRTO_BINDTODEVICE                                                                                                                                                R | W | G | S | D | I | M
     //{ SRTO_CONGESTION,      "SRTO_CONGESTION",  RestrictionType::PRE,               4,           "live",     "file",   "live",       "file",   {"liv", ""},          O | W | O | S | O | O | O },
     { SRTO_CONNTIMEO,        "SRTO_CONNTIMEO",  RestrictionType::PRE,     sizeof(int),                0,  INT32_MAX,     3000,          250,   {-1},                   O | W | G | S | D | O | M },
+    { SRTO_CRYPTOPRECOMP, "SRTO_CRYPTOPRECOMP", RestrictionType::PRE,     sizeof(int),                 0,      1024,   0,   64, {-1, 1025},                             R | W | G | S | D | O | M },
+    { SRTO_CRYPTOWORKERS, "SRTO_CRYPTOWORKERS", RestrictionType::PREBIND, sizeof(int),                 0,        16,   0,    2, {-1, 17},                               R | W | G | S | D | O | M },
     { SRTO_DRIFTTRACER,    "SRTO_DRIFTTRACER",  RestrictionType::POST,   sizeof(bool),            false,       true,     true,        false,     {},                   R | W | G | S | D | O | O },
     { SRTO_ENFORCEDENCRYPTION, "SRTO_ENFORCEDENCRYPTION", RestrictionType::PRE, sizeof(bool),     false,       true,     true,        false,     {},                   O | W | G | S | D | O | O },
     //SRTO_EVENT                                                                                                                                                       R | O | O | S | O | O | O
@@ -334,6 +336,9 @@ const OptionTestEntry g_test_matrix_options[] =
     //SRTO_KMSTATE
     { SRTO_LATENCY,             "SRTO_LATENCY", RestrictionType::PRE,     sizeof(int),                 0, INT32_MAX,      120,          200,  {-1},                    R | W | G | S | D | O | O },
     //SRTO_LINGER
+#ifdef __linux__
+    { SRTO_LISTENSHARDS,  "SRTO_LISTENSHARDS", RestrictionType::PREBIND,  sizeof(int),                 1,        32,   1,    4, {-1, 0, 33},                            R | W | G | S | D | O | M },
+#endif
     { SRTO_LOSSMAXTTL,       "SRTO_LOSSMAXTTL", RestrictionType::POST,    sizeof(int),                 0, INT32_MAX,        0,           10,   {},                     R | W | G | S | D | O | M },
     { SRTO_MAXBW,                 "SRTO_MAXBW", RestrictionType::POST, sizeof(int64_t),      int64_t(-1),  INT64_MAX, int64_t(-1), int64_t(200000),  {int64_t(-2)},    R | W | G | S | D | O | O },
 #ifdef ENABLE_MAXREXMITBW
@@ -368,12 +373,18 @@ const OptionTestEntry g_test_matrix_options[] =
     //SRTO_SNDKMSTATE
     //SRTO_SNDSYN
     { SRTO_SNDTIMEO,          "SRTO_SNDTIMEO", RestrictionType::POST,     sizeof(int),                -1, INT32_MAX, -1, 1400, {-2},                                   R | W | G | S | O | I | O },
+    { SRTO_SNDWORKERS,    "SRTO_SNDWORKERS",   RestrictionType::PREBIND,  sizeof(int),                 1,        16,   1,    4, {-1, 0, 17},                            R | W | G | S | D | O | M },
     //SRTO_STATE
     //SRTO_STREAMID
     { SRTO_TLPKTDROP,        "SRTO_TLPKTDROP",  RestrictionType::PRE,    sizeof(bool),             false,      true,     true, false, {},                              R | W | G | S | D | O | O },
     //SRTO_TRANSTYPE
     //SRTO_TSBPDMODE
+    { SRTO_TSBPDSHARED,    "SRTO_TSBPDSHARED",  RestrictionType::PRE,    sizeof(bool),             false,      true,    false, true, {},                              R | W | G | S | D | O | O },
+    { SRTO_UDP_GRO,            "SRTO_UDP_GRO", RestrictionType::PREBIND,  sizeof(bool),            false,      true,  false, true, {},                              R | W | G | S | D | O | M },
+    { SRTO_UDP_GSO,            "SRTO_UDP_GSO", RestrictionType::PREBIND,  sizeof(bool),            false,      true,  false, true, {},                              R | W | G | S | D | O | M },
+    { SRTO_UDP_RCVBATCH,  "SRTO_UDP_RCVBATCH", RestrictionType::PREBIND,  sizeof(int),                 1,        64,   1,   16, {-1, 0, 65},                            R | W | G | S | D | O | M },
     //SRTO_UDP_RCVBUF
+    { SRTO_UDP_SNDBATCH,  "SRTO_UDP_SNDBATCH", RestrictionType::PREBIND,  sizeof(int),                 1,        64,   1,   16, {-1, 0, 65},                            R | W | G | S | D | O | M },
     //SRTO_UDP_SNDBUF
     //SRTO_VERSION
 };
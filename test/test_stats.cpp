@@ -0,0 +1,213 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "stats.h"
+#include "sync.h"
+
+using namespace std;
+using namespace srt;
+
+// Every count lands in exactly one trace interval, even when the trace
+// is taken while the sending and receiving threads keep counting.
+TEST(Stats, TraceTakenUnderUpdates)
+{
+    const int per_thread = 200000;
+
+    stats::AtomicMetric<stats::BytesPackets> bytes;
+    stats::AtomicMetric<stats::Packets>      packets;
+    atomic<int>                              running(2);
+
+    vector<thread> writers;
+    for (int t = 0; t < 2; ++t)
+    {
+        writers.push_back(thread([&]() {
+            for (int i = 0; i < per_thread; ++i)
+            {
+                bytes.count(100);
+                packets.count(1);
+            }
+            --running;
+        }));
+    }
+
+    uint64_t traced_bytes = 0, traced_packets = 0, traced_count = 0;
+    for (;;)
+    {
+        // Evaluated before taking the snapshot, so that the last round
+        // sees everything counted.
+        const bool last = running == 0;
+
+        stats::Metric<stats::BytesPackets> bytes_snap;
+        stats::Metric<stats::Packets>      packets_snap;
+        bytes.snapshot(bytes_snap, true);
+        packets.snapshot(packets_snap, true);
+        traced_bytes += bytes_snap.trace.bytes();
+        traced_packets += bytes_snap.trace.count();
+        traced_count += packets_snap.trace.count();
+
+        // The trace can't exceed the total read at the same time.
+        ASSERT_LE(bytes_snap.trace.count(), bytes_snap.total.count());
+        ASSERT_EQ(packets_snap.total.count(), traced_count);
+
+        if (last)
+            break;
+    }
+    for (size_t t = 0; t < writers.size(); ++t)
+        writers[t].join();
+
+    EXPECT_EQ(bytes.total().count(), uint32_t(2 * per_thread));
+    EXPECT_EQ(bytes.total().bytes(), uint64_t(2 * per_thread * 100));
+    EXPECT_EQ(packets.total().count(), uint32_t(2 * per_thread));
+    EXPECT_EQ(traced_packets, uint64_t(2 * per_thread));
+    EXPECT_EQ(traced_bytes, uint64_t(2 * per_thread * 100));
+    EXPECT_EQ(traced_count, uint64_t(2 * per_thread));
+}
+
+// The bytes and the packets read together always belong to the same
+// packets, even while several threads keep counting.
+TEST(Stats, BytesPacketsConsistent)
+{
+    const int per_thread = 200000;
+
+    stats::AtomicMetric<stats::BytesPackets> bytes;
+    atomic<int>                              running(2);
+
+    vector<thread> writers;
+    for (int t = 0; t < 2; ++t)
+    {
+        writers.push_back(thread([&]() {
+            for (int i = 0; i < per_thread; ++i)
+                bytes.count(stats::BytesPackets(1316));
+            --running;
+        }));
+    }
+
+    while (running > 0)
+    {
+        const stats::BytesPackets total = bytes.total();
+        ASSERT_EQ(total.bytes(), uint64_t(total.count()) * 1316);
+    }
+    for (size_t t = 0; t < writers.size(); ++t)
+        writers[t].join();
+
+    EXPECT_EQ(bytes.total().count(), uint32_t(2 * per_thread));
+}
+
+namespace
+{
+
+// The counters as updated before, under the statistics lock.
+struct LockedCounters
+{
+    sync::Mutex             lock;
+    stats::SenderSnapshot   sndr;
+    stats::ReceiverSnapshot rcvr;
+};
+
+// The counters as in the socket now, the reader with its own lock.
+struct AtomicCounters
+{
+    sync::Mutex     lock;
+    stats::Sender   sndr;
+    stats::Receiver rcvr;
+};
+
+template <class Fn>
+double measure(int packets, Fn fn)
+{
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < packets; ++i)
+        fn();
+    return double(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count()) / packets;
+}
+
+} // namespace
+
+// The sending and the receiving threads count each packet while a monitoring
+// thread reads and clears the statistics in a loop, as srt_bstats does.
+// With the lock, the data path waits for the reader and for the other
+// direction; without it, it only pays for the atomic additions.
+// Disabled by default, run with --gtest_also_run_disabled_tests.
+TEST(Stats, DISABLED_Benchmark)
+{
+    const int packets = 1000000;
+
+    LockedCounters locked;
+    AtomicCounters lockfree;
+
+    for (int variant = 0; variant < 2; ++variant)
+    {
+        atomic<bool> stop(false);
+        uint64_t     polls = 0;
+        thread       monitor([&]() {
+            while (!stop)
+            {
+                if (variant == 0)
+                {
+                    sync::ScopedLock        lg(locked.lock);
+                    const stats::SenderSnapshot   sndr = locked.sndr;
+                    const stats::ReceiverSnapshot rcvr = locked.rcvr;
+                    (void)sndr;
+                    (void)rcvr;
+                    locked.sndr.resetTrace();
+                    locked.rcvr.resetTrace();
+                }
+                else
+                {
+                    sync::ScopedLock        lg(lockfree.lock);
+                    stats::SenderSnapshot   sndr;
+                    stats::ReceiverSnapshot rcvr;
+                    lockfree.sndr.snapshot(sndr, true);
+                    lockfree.rcvr.snapshot(rcvr, true);
+                }
+                ++polls;
+            }
+        });
+
+        double ns_sender = 0, ns_receiver = 0;
+        thread receiver([&]() {
+            ns_receiver = measure(packets, [&]() {
+                if (variant == 0)
+                {
+                    sync::ScopedLock lg(locked.lock);
+                    locked.rcvr.recvd.count(1316);
+                }
+                else
+                {
+                    lockfree.rcvr.recvd.count(1316);
+                }
+            });
+        });
+        ns_sender = measure(packets, [&]() {
+            if (variant == 0)
+            {
+                {
+                    sync::ScopedLock lg(locked.lock);
+                    locked.sndr.sent.count(1316);
+                    locked.sndr.sentUnique.count(1316);
+                }
+                sync::ScopedLock lg(locked.lock);
+                locked.sndr.recvdAck.count(1);
+            }
+            else
+            {
+                lockfree.sndr.sent.count(1316);
+                lockfree.sndr.sentUnique.count(1316);
+                lockfree.sndr.recvdAck.count(1);
+            }
+        });
+        receiver.join();
+        stop = true;
+        monitor.join();
+
+        cout << "Stats " << (variant == 0 ? "locked" : "lock-free") << ": sender " << ns_sender
+             << " ns/packet, receiver " << ns_receiver << " ns/packet, " << polls << " statistics reads\n";
+    }
+
+    EXPECT_EQ(locked.sndr.sent.total.count(), uint32_t(packets));
+    EXPECT_EQ(lockfree.sndr.sent.total().count(), uint32_t(packets));
+    EXPECT_EQ(lockfree.rcvr.recvd.total().bytes(), uint64_t(packets) * 1316);
+}
@@ -0,0 +1,723 @@
+/*
+ * SRT - Secure, Reliable, Transport
+ * Copyright (c) 2024 Haivision Systems Inc.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "test_env.h"
+
+#ifdef _WIN32
+#define INC_SRT_WIN_WINTIME // exclude gettimeofday from srt headers
+#endif
+
+#include "srt.h"
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+
+// Bind the socket to the first free port in the range, return the port or -1.
+int BindFreePort(SRTSOCKET sock, sockaddr_in& w_sa)
+{
+    w_sa = sockaddr_in();
+    w_sa.sin_family = AF_INET;
+    inet_pton(AF_INET, "127.0.0.1", &w_sa.sin_addr);
+
+    for (int port = 5000; port <= 5555; ++port)
+    {
+        w_sa.sin_port = htons(port);
+        if (srt_bind(sock, (sockaddr*)&w_sa, sizeof w_sa) == 0)
+            return port;
+    }
+    return -1;
+}
+
+}
+
+// Sockets accepted from a listener share its multiplexer, so
+// the packets they send can be collected in common batches.
+TEST(UDPBatch, SendManyConnections)
+{
+    srt::TestInit srtinit;
+
+    const int NCONN = 4;
+    const int NPKT = 1000;
+    const int batch = 16;
+
+    SRTSOCKET sock_lsn = srt_create_socket();
+    ASSERT_NE(sock_lsn, SRT_INVALID_SOCK);
+    ASSERT_EQ(srt_setsockflag(sock_lsn, SRTO_UDP_SNDBATCH, &batch, sizeof batch), SRT_SUCCESS);
+
+    sockaddr_in sa_lsn;
+    ASSERT_NE(BindFreePort(sock_lsn, (sa_lsn)), -1);
+    ASSERT_NE(srt_listen(sock_lsn, NCONN), SRT_ERROR);
+
+    // Setting the option after binding must fail
+    EXPECT_EQ(srt_setsockflag(sock_lsn, SRTO_UDP_SNDBATCH, &batch, sizeof batch), SRT_ERROR);
+
+    SRTSOCKET sock_clr[NCONN];
+    SRTSOCKET sock_acp[NCONN];
+    const int rcvtimeo = 3000;
+    for (int i = 0; i < NCONN; ++i)
+    {
+        sock_clr[i] = srt_create_socket();
+        ASSERT_NE(sock_clr[i], SRT_INVALID_SOCK);
+        ASSERT_EQ(srt_setsockflag(sock_clr[i], SRTO_RCVTIMEO, &rcvtimeo, sizeof rcvtimeo), SRT_SUCCESS);
+        ASSERT_NE(srt_connect(sock_clr[i], (sockaddr*)&sa_lsn, sizeof sa_lsn), SRT_ERROR) << srt_getlasterror_str();
+
+        sockaddr_in sa_acp;
+        int sa_len = sizeof sa_acp;
+        sock_acp[i] = srt_accept(sock_lsn, (sockaddr*)&sa_acp, &sa_len);
+        ASSERT_NE(sock_acp[i], SRT_INVALID_SOCK);
+
+        int acp_batch = 0;
+        int optlen = sizeof acp_batch;
+        EXPECT_EQ(srt_getsockflag(sock_acp[i], SRTO_UDP_SNDBATCH, &acp_batch, &optlen), SRT_SUCCESS);
+        EXPECT_EQ(acp_batch, batch);
+    }
+
+    array<char, 1316> buf;
+    for (int n = 0; n < NPKT; ++n)
+    {
+        for (int i = 0; i < NCONN; ++i)
+        {
+            buf.fill(char(n + i));
+            memcpy(buf.data(), &n, sizeof n);
+            ASSERT_EQ(srt_send(sock_acp[i], buf.data(), (int)buf.size()), (int)buf.size()) << srt_getlasterror_str();
+        }
+    }
+
+    for (int i = 0; i < NCONN; ++i)
+    {
+        for (int n = 0; n < NPKT; ++n)
+        {
+            array<char, 1316> rbuf;
+            ASSERT_EQ(srt_recv(sock_clr[i], rbuf.data(), (int)rbuf.size()), (int)rbuf.size())
+                << "conn " << i << " pkt " << n << ": " << srt_getlasterror_str();
+
+            int rn = -1;
+            memcpy(&rn, rbuf.data(), sizeof rn);
+            ASSERT_EQ(rn, n);
+            EXPECT_EQ(rbuf[rbuf.size() - 1], char(n + i));
+        }
+    }
+
+    SRT_TRACEBSTATS stats;
+    ASSERT_EQ(srt_bstats(sock_acp[0], &stats, 0), SRT_SUCCESS);
+    cerr << "Batched send calls: " << stats.sndBatchCallsTotal << " packets: " << stats.pktSndBatchTotal << endl;
+    EXPECT_GT(stats.sndBatchCallsTotal, 0);
+    EXPECT_GE(stats.pktSndBatchTotal, 2 * stats.sndBatchCallsTotal);
+    EXPECT_LE(stats.pktSndBatchTotal, batch * stats.sndBatchCallsTotal);
+
+    // The callers use the default setting and don't send data in batches.
+    ASSERT_EQ(srt_bstats(sock_clr[0], &stats, 0), SRT_SUCCESS);
+    EXPECT_EQ(stats.sndBatchCallsTotal, 0);
+    EXPECT_EQ(stats.pktSndBatchTotal, 0);
+
+    for (int i = 0; i < NCONN; ++i)
+    {
+        srt_close(sock_acp[i]);
+        srt_close(sock_clr[i]);
+    }
+    srt_close(sock_lsn);
+}
+
+// Packets from many connections arriving at the listener's multiplexer
+// are read in batches.
+TEST(UDPBatch, ReceiveManyConnections)
+{
+    srt::TestInit srtinit;
+
+    const int NCONN = 4;
+    const int NPKT = 1000;
+    const int batch = 16;
+    const int udp_rcvbuf = 4 * 1024 * 1024;
+    const int latency = 1000;
+
+    SRTSOCKET sock_lsn = srt_create_socket();
+    ASSERT_NE(sock_lsn, SRT_INVALID_SOCK);
+    ASSERT_EQ(srt_setsockflag(sock_lsn, SRTO_UDP_RCVBATCH, &batch, sizeof batch), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock_lsn, SRTO_UDP_SNDBATCH, &batch, sizeof batch), SRT_SUCCESS);
+    // All callers send to the same UDP socket at once, so give it enough buffer and
+    // time to recover from losses before the data are read.
+    ASSERT_EQ(srt_setsockflag(sock_lsn, SRTO_UDP_RCVBUF, &udp_rcvbuf, sizeof udp_rcvbuf), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock_lsn, SRTO_LATENCY, &latency, sizeof latency), SRT_SUCCESS);
+
+    sockaddr_in sa_lsn;
+    ASSERT_NE(BindFreePort(sock_lsn, (sa_lsn)), -1);
+    ASSERT_NE(srt_listen(sock_lsn, NCONN), SRT_ERROR);
+
+    SRTSOCKET sock_clr[NCONN];
+    SRTSOCKET sock_acp[NCONN];
+    const int rcvtimeo = 3000;
+    for (int i = 0; i < NCONN; ++i)
+    {
+        sock_clr[i] = srt_create_socket();
+        ASSERT_NE(sock_clr[i], SRT_INVALID_SOCK);
+        ASSERT_EQ(srt_setsockflag(sock_clr[i], SRTO_LATENCY, &latency, sizeof latency), SRT_SUCCESS);
+        ASSERT_NE(srt_connect(sock_clr[i], (sockaddr*)&sa_lsn, sizeof sa_lsn), SRT_ERROR) << srt_getlasterror_str();
+
+        sockaddr_in sa_acp;
+        int sa_len = sizeof sa_acp;
+        sock_acp[i] = srt_accept(sock_lsn, (sockaddr*)&sa_acp, &sa_len);
+        ASSERT_NE(sock_acp[i], SRT_INVALID_SOCK);
+        ASSERT_EQ(srt_setsockflag(sock_acp[i], SRTO_RCVTIMEO, &rcvtimeo, sizeof rcvtimeo), SRT_SUCCESS);
+    }
+
+    array<char, 1316> buf;
+    for (int n = 0; n < NPKT; ++n)
+    {
+        for (int i = 0; i < NCONN; ++i)
+        {
+            buf.fill(char(n + i));
+            memcpy(buf.data(), &n, sizeof n);
+            ASSERT_EQ(srt_send(sock_clr[i], buf.data(), (int)buf.size()), (int)buf.size()) << srt_getlasterror_str();
+        }
+
+        // Pace the callers a little so that the bursts don't overflow the
+        // listener's UDP buffer; packets from all callers still arrive together.
+        if (n % 10 == 9)
+            this_thread::sleep_for(chrono::milliseconds(2));
+    }
+
+    for (int i = 0; i < NCONN; ++i)
+    {
+        for (int n = 0; n < NPKT; ++n)
+        {
+            array<char, 1316> rbuf;
+            ASSERT_EQ(srt_recv(sock_acp[i], rbuf.data(), (int)rbuf.size()), (int)rbuf.size())
+                << "conn " << i << " pkt " << n << ": " << srt_getlasterror_str();
+
+            int rn = -1;
+            memcpy(&rn, rbuf.data(), sizeof rn);
+            ASSERT_EQ(rn, n);
+            EXPECT_EQ(rbuf[rbuf.size() - 1], char(n + i));
+        }
+    }
+
+    SRT_TRACEBSTATS stats;
+    ASSERT_EQ(srt_bstats(sock_acp[0], &stats, 0), SRT_SUCCESS);
+    cerr << "Batched receive calls: " << stats.rcvBatchCallsTotal << " packets: " << stats.pktRcvBatchTotal << endl;
+    EXPECT_GT(stats.rcvBatchCallsTotal, 0);
+    EXPECT_GE(stats.pktRcvBatchTotal, stats.rcvBatchCallsTotal);
+    EXPECT_LE(stats.pktRcvBatchTotal, batch * stats.rcvBatchCallsTotal);
+    // All data packets from all callers came through batched reads.
+    EXPECT_GE(stats.pktRcvBatchTotal, NCONN * NPKT);
+
+    ASSERT_EQ(srt_bstats(sock_clr[0], &stats, 0), SRT_SUCCESS);
+    EXPECT_EQ(stats.rcvBatchCallsTotal, 0);
+    EXPECT_EQ(stats.pktRcvBatchTotal, 0);
+
+    for (int i = 0; i < NCONN; ++i)
+    {
+        srt_close(sock_acp[i]);
+        srt_close(sock_clr[i]);
+    }
+    srt_close(sock_lsn);
+}
+
+// Transfer the data from the caller to the listener in file mode,
+// return the accepted socket or SRT_INVALID_SOCK.
+SRTSOCKET TransferFile(SRTSOCKET sock_lsn, SRTSOCKET sock_clr, size_t datasize)
+{
+    const int tt = SRTT_FILE;
+    EXPECT_EQ(srt_setsockflag(sock_lsn, SRTO_TRANSTYPE, &tt, sizeof tt), SRT_SUCCESS);
+    EXPECT_EQ(srt_setsockflag(sock_clr, SRTO_TRANSTYPE, &tt, sizeof tt), SRT_SUCCESS);
+
+    sockaddr_in sa_lsn;
+    EXPECT_NE(BindFreePort(sock_lsn, (sa_lsn)), -1);
+    EXPECT_NE(srt_listen(sock_lsn, 1), SRT_ERROR);
+
+    vector<char> data(datasize);
+    for (size_t i = 0; i < datasize; ++i)
+        data[i] = char(i % 251);
+
+    vector<char> received;
+    received.reserve(datasize);
+    SRTSOCKET sock_acp = SRT_INVALID_SOCK;
+    thread receiver([&] {
+        sockaddr_in sa_acp;
+        int sa_len = sizeof sa_acp;
+        sock_acp = srt_accept(sock_lsn, (sockaddr*)&sa_acp, &sa_len);
+        ASSERT_NE(sock_acp, SRT_INVALID_SOCK);
+
+        const int rcvtimeo = 5000;
+        ASSERT_EQ(srt_setsockflag(sock_acp, SRTO_RCVTIMEO, &rcvtimeo, sizeof rcvtimeo), SRT_SUCCESS);
+
+        vector<char> buf(64 * 1024);
+        while (received.size() < datasize)
+        {
+            const int n = srt_recv(sock_acp, buf.data(), (int)buf.size());
+            ASSERT_GT(n, 0) << srt_getlasterror_str();
+            received.insert(received.end(), buf.begin(), buf.begin() + n);
+        }
+    });
+
+    EXPECT_NE(srt_connect(sock_clr, (sockaddr*)&sa_lsn, sizeof sa_lsn), SRT_ERROR) << srt_getlasterror_str();
+
+    for (size_t pos = 0; pos < datasize;)
+    {
+        const int n = srt_send(sock_clr, data.data() + pos, (int)min<size_t>(datasize - pos, 64 * 1024));
+        if (n <= 0)
+        {
+            ADD_FAILURE() << srt_getlasterror_str();
+            break;
+        }
+        pos += n;
+    }
+
+    receiver.join();
+    EXPECT_TRUE(received == data);
+    return sock_acp;
+}
+
+// A file sender has many full packets ready at once, which are sent
+// with segmentation offload where the system supports it.
+TEST(UDPBatch, SegmentedFileTransfer)
+{
+    srt::TestInit srtinit;
+
+    const int  batch = 16;
+    const bool gso   = true;
+
+    SRTSOCKET sock_lsn = srt_create_socket();
+    SRTSOCKET sock_clr = srt_create_socket();
+    ASSERT_EQ(srt_setsockflag(sock_clr, SRTO_UDP_SNDBATCH, &batch, sizeof batch), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock_clr, SRTO_UDP_GSO, &gso, sizeof gso), SRT_SUCCESS);
+
+    const SRTSOCKET sock_acp = TransferFile(sock_lsn, sock_clr, 8 * 1024 * 1024);
+
+    SRT_TRACEBSTATS stats;
+    ASSERT_EQ(srt_bstats(sock_clr, &stats, 0), SRT_SUCCESS);
+    cerr << "Segmented send calls: " << stats.sndGSOCallsTotal << " packets: " << stats.pktSndGSOTotal
+         << ", batched send calls: " << stats.sndBatchCallsTotal << " packets: " << stats.pktSndBatchTotal << endl;
+    EXPECT_GE(stats.pktSndGSOTotal, 2 * stats.sndGSOCallsTotal);
+    EXPECT_LE(stats.pktSndGSOTotal, batch * stats.sndGSOCallsTotal);
+#ifdef SRT_ENABLE_GSO
+    EXPECT_GT(stats.sndGSOCallsTotal, 0);
+#else
+    EXPECT_EQ(stats.sndGSOCallsTotal, 0);
+#endif
+
+    srt_close(sock_acp);
+    srt_close(sock_clr);
+    srt_close(sock_lsn);
+}
+
+// With receive coalescing, the segmented packets arrive in one datagram
+// over the loopback device and are split back into the units.
+TEST(UDPBatch, CoalescedFileTransfer)
+{
+    srt::TestInit srtinit;
+
+    const int  batch = 16;
+    const bool on    = true;
+
+    SRTSOCKET sock_lsn = srt_create_socket();
+    SRTSOCKET sock_clr = srt_create_socket();
+    ASSERT_EQ(srt_setsockflag(sock_lsn, SRTO_UDP_GRO, &on, sizeof on), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock_clr, SRTO_UDP_SNDBATCH, &batch, sizeof batch), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock_clr, SRTO_UDP_GSO, &on, sizeof on), SRT_SUCCESS);
+
+    const SRTSOCKET sock_acp = TransferFile(sock_lsn, sock_clr, 8 * 1024 * 1024);
+
+    SRT_TRACEBSTATS stats;
+    ASSERT_EQ(srt_bstats(sock_acp, &stats, 0), SRT_SUCCESS);
+    cerr << "Coalesced reads: " << stats.rcvGROReadsTotal << " packets: " << stats.pktRcvGROTotal << endl;
+    EXPECT_GE(stats.pktRcvGROTotal, stats.rcvGROReadsTotal);
+    // The receive queue doesn't read in batches here.
+    EXPECT_EQ(stats.rcvBatchCallsTotal, 0);
+#if defined(SRT_ENABLE_GRO) && defined(SRT_ENABLE_GSO)
+    EXPECT_GT(stats.pktRcvGROTotal, stats.rcvGROReadsTotal);
+#elif !defined(SRT_ENABLE_GRO)
+    EXPECT_EQ(stats.rcvGROReadsTotal, 0);
+#endif
+
+    ASSERT_EQ(srt_bstats(sock_clr, &stats, 0), SRT_SUCCESS);
+    EXPECT_EQ(stats.rcvGROReadsTotal, 0);
+
+    srt_close(sock_acp);
+    srt_close(sock_clr);
+    srt_close(sock_lsn);
+}
+
+// Sockets of a multiplexer with several sending threads are spread among
+// them, and each connection still gets its packets in order.
+TEST(UDPBatch, SendWorkers)
+{
+    srt::TestInit srtinit;
+
+    const int NCONN = 8;
+    const int NPKT = 500;
+    const int workers = 4;
+    const int batch = 16;
+
+    SRTSOCKET sock_lsn = srt_create_socket();
+    ASSERT_NE(sock_lsn, SRT_INVALID_SOCK);
+    ASSERT_EQ(srt_setsockflag(sock_lsn, SRTO_SNDWORKERS, &workers, sizeof workers), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock_lsn, SRTO_UDP_SNDBATCH, &batch, sizeof batch), SRT_SUCCESS);
+
+    sockaddr_in sa_lsn;
+    ASSERT_NE(BindFreePort(sock_lsn, (sa_lsn)), -1);
+    ASSERT_NE(srt_listen(sock_lsn, NCONN), SRT_ERROR);
+
+    SRTSOCKET sock_clr[NCONN];
+    SRTSOCKET sock_acp[NCONN];
+    const int rcvtimeo = 3000;
+    for (int i = 0; i < NCONN; ++i)
+    {
+        sock_clr[i] = srt_create_socket();
+        ASSERT_NE(sock_clr[i], SRT_INVALID_SOCK);
+        ASSERT_EQ(srt_setsockflag(sock_clr[i], SRTO_RCVTIMEO, &rcvtimeo, sizeof rcvtimeo), SRT_SUCCESS);
+        ASSERT_NE(srt_connect(sock_clr[i], (sockaddr*)&sa_lsn, sizeof sa_lsn), SRT_ERROR) << srt_getlasterror_str();
+
+        sockaddr_in sa_acp;
+        int sa_len = sizeof sa_acp;
+        sock_acp[i] = srt_accept(sock_lsn, (sockaddr*)&sa_acp, &sa_len);
+        ASSERT_NE(sock_acp[i], SRT_INVALID_SOCK);
+
+        int acp_workers = 0;
+        int optlen = sizeof acp_workers;
+        EXPECT_EQ(srt_getsockflag(sock_acp[i], SRTO_SNDWORKERS, &acp_workers, &optlen), SRT_SUCCESS);
+        EXPECT_EQ(acp_workers, workers);
+    }
+
+    array<char, 1316> buf;
+    for (int n = 0; n < NPKT; ++n)
+    {
+        for (int i = 0; i < NCONN; ++i)
+        {
+            buf.fill(char(n + i));
+            memcpy(buf.data(), &n, sizeof n);
+            ASSERT_EQ(srt_send(sock_acp[i], buf.data(), (int)buf.size()), (int)buf.size()) << srt_getlasterror_str();
+        }
+    }
+
+    for (int i = 0; i < NCONN; ++i)
+    {
+        for (int n = 0; n < NPKT; ++n)
+        {
+            array<char, 1316> rbuf;
+            ASSERT_EQ(srt_recv(sock_clr[i], rbuf.data(), (int)rbuf.size()), (int)rbuf.size())
+                << "conn " << i << " pkt " << n << ": " << srt_getlasterror_str();
+
+            int rn = -1;
+            memcpy(&rn, rbuf.data(), sizeof rn);
+            ASSERT_EQ(rn, n);
+            EXPECT_EQ(rbuf[rbuf.size() - 1], char(n + i));
+        }
+    }
+
+    for (int i = 0; i < NCONN; ++i)
+    {
+        srt_close(sock_acp[i]);
+        srt_close(sock_clr[i]);
+    }
+    srt_close(sock_lsn);
+}
+
+#if SRT_ENABLE_ENCRYPTION
+// With the crypto threads the batched packets of every connection are
+// encrypted and decrypted in parallel, and still arrive in order.
+TEST(UDPBatch, CryptoWorkers)
+{
+    srt::TestInit srtinit;
+
+    const int NCONN = 6;
+    const int NPKT = 400;
+    const int workers = 2;
+    const int batch = 16;
+    const string pass = "crypto-workers-passphrase";
+
+    SRTSOCKET sock_lsn = srt_create_socket();
+    ASSERT_NE(sock_lsn, SRT_INVALID_SOCK);
+    ASSERT_EQ(srt_setsockflag(sock_lsn, SRTO_CRYPTOWORKERS, &workers, sizeof workers), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock_lsn, SRTO_UDP_SNDBATCH, &batch, sizeof batch), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock_lsn, SRTO_UDP_RCVBATCH, &batch, sizeof batch), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock_lsn, SRTO_PASSPHRASE, pass.c_str(), (int)pass.size()), SRT_SUCCESS);
+
+    sockaddr_in sa_lsn;
+    ASSERT_NE(BindFreePort(sock_lsn, (sa_lsn)), -1);
+    ASSERT_NE(srt_listen(sock_lsn, NCONN), SRT_ERROR);
+
+    SRTSOCKET sock_clr[NCONN];
+    SRTSOCKET sock_acp[NCONN];
+    const int rcvtimeo = 3000;
+    for (int i = 0; i < NCONN; ++i)
+    {
+        sock_clr[i] = srt_create_socket();
+        ASSERT_NE(sock_clr[i], SRT_INVALID_SOCK);
+        ASSERT_EQ(srt_setsockflag(sock_clr[i], SRTO_RCVTIMEO, &rcvtimeo, sizeof rcvtimeo), SRT_SUCCESS);
+        ASSERT_EQ(srt_setsockflag(sock_clr[i], SRTO_CRYPTOWORKERS, &workers, sizeof workers), SRT_SUCCESS);
+        ASSERT_EQ(srt_setsockflag(sock_clr[i], SRTO_UDP_RCVBATCH, &batch, sizeof batch), SRT_SUCCESS);
+        ASSERT_EQ(srt_setsockflag(sock_clr[i], SRTO_PASSPHRASE, pass.c_str(), (int)pass.size()), SRT_SUCCESS);
+        ASSERT_NE(srt_connect(sock_clr[i], (sockaddr*)&sa_lsn, sizeof sa_lsn), SRT_ERROR) << srt_getlasterror_str();
+
+        sockaddr_in sa_acp;
+        int sa_len = sizeof sa_acp;
+        sock_acp[i] = srt_accept(sock_lsn, (sockaddr*)&sa_acp, &sa_len);
+        ASSERT_NE(sock_acp[i], SRT_INVALID_SOCK);
+        ASSERT_EQ(srt_setsockflag(sock_acp[i], SRTO_RCVTIMEO, &rcvtimeo, sizeof rcvtimeo), SRT_SUCCESS);
+
+        int acp_workers = 0;
+        int optlen = sizeof acp_workers;
+        EXPECT_EQ(srt_getsockflag(sock_acp[i], SRTO_CRYPTOWORKERS, &acp_workers, &optlen), SRT_SUCCESS);
+        EXPECT_EQ(acp_workers, workers);
+    }
+
+    // Both ways, so that the listener's multiplexer decrypts packets of several
+    // sockets, in rounds, so that the UDP buffers don't overflow.
+    const int ROUND = 25;
+    array<char, 1316> buf;
+    for (int first = 0; first < NPKT; first += ROUND)
+    {
+        for (int n = first; n < first + ROUND; ++n)
+        {
+            for (int i = 0; i < NCONN; ++i)
+            {
+                buf.fill(char(n + i));
+                memcpy(buf.data(), &n, sizeof n);
+                ASSERT_EQ(srt_send(sock_acp[i], buf.data(), (int)buf.size()), (int)buf.size()) << srt_getlasterror_str();
+                ASSERT_EQ(srt_send(sock_clr[i], buf.data(), (int)buf.size()), (int)buf.size()) << srt_getlasterror_str();
+            }
+        }
+
+        for (int i = 0; i < NCONN; ++i)
+        {
+            for (int n = first; n < first + ROUND; ++n)
+            {
+                array<char, 1316> rbuf;
+                int rn = -1;
+                ASSERT_EQ(srt_recv(sock_clr[i], rbuf.data(), (int)rbuf.size()), (int)rbuf.size())
+                    << "conn " << i << " pkt " << n << ": " << srt_getlasterror_str();
+                memcpy(&rn, rbuf.data(), sizeof rn);
+                ASSERT_EQ(rn, n);
+                EXPECT_EQ(rbuf[rbuf.size() - 1], char(n + i));
+
+                ASSERT_EQ(srt_recv(sock_acp[i], rbuf.data(), (int)rbuf.size()), (int)rbuf.size())
+                    << "conn " << i << " pkt " << n << ": " << srt_getlasterror_str();
+                memcpy(&rn, rbuf.data(), sizeof rn);
+                ASSERT_EQ(rn, n);
+                EXPECT_EQ(rbuf[rbuf.size() - 1], char(n + i));
+            }
+        }
+    }
+
+    for (int i = 0; i < NCONN; ++i)
+    {
+        SRT_TRACEBSTATS stats;
+        ASSERT_EQ(srt_bstats(sock_acp[i], &stats, 0), SRT_SUCCESS);
+        EXPECT_EQ(stats.pktRcvUndecryptTotal, 0);
+        ASSERT_EQ(srt_bstats(sock_clr[i], &stats, 0), SRT_SUCCESS);
+        EXPECT_EQ(stats.pktRcvUndecryptTotal, 0);
+        EXPECT_GT(stats.cryptoJobsTotal, 0);
+    }
+
+    for (int i = 0; i < NCONN; ++i)
+    {
+        srt_close(sock_acp[i]);
+        srt_close(sock_clr[i]);
+    }
+    srt_close(sock_lsn);
+}
+
+// The crypto threads encrypt and decrypt across the key switches, which
+// happen between the batches of the sending and receiving threads.
+TEST(UDPBatch, CryptoWorkersKeySwitch)
+{
+    srt::TestInit srtinit;
+
+    const int NPKT = 600;
+    const int workers = 2;
+    const int batch = 16;
+    const int km_refresh = 128;
+    const int km_preannounce = 32;
+    const string pass = "crypto-keyswitch-passphrase";
+
+    SRTSOCKET sock_lsn = srt_create_socket();
+    ASSERT_NE(sock_lsn, SRT_INVALID_SOCK);
+    ASSERT_EQ(srt_setsockflag(sock_lsn, SRTO_CRYPTOWORKERS, &workers, sizeof workers), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock_lsn, SRTO_UDP_SNDBATCH, &batch, sizeof batch), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock_lsn, SRTO_UDP_RCVBATCH, &batch, sizeof batch), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock_lsn, SRTO_KMREFRESHRATE, &km_refresh, sizeof km_refresh), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock_lsn, SRTO_KMPREANNOUNCE, &km_preannounce, sizeof km_preannounce), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock_lsn, SRTO_PASSPHRASE, pass.c_str(), (int)pass.size()), SRT_SUCCESS);
+
+    sockaddr_in sa_lsn;
+    ASSERT_NE(BindFreePort(sock_lsn, (sa_lsn)), -1);
+    ASSERT_NE(srt_listen(sock_lsn, 1), SRT_ERROR);
+
+    SRTSOCKET sock_clr = srt_create_socket();
+    ASSERT_NE(sock_clr, SRT_INVALID_SOCK);
+    const int rcvtimeo = 3000;
+    ASSERT_EQ(srt_setsockflag(sock_clr, SRTO_RCVTIMEO, &rcvtimeo, sizeof rcvtimeo), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock_clr, SRTO_CRYPTOWORKERS, &workers, sizeof workers), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock_clr, SRTO_UDP_SNDBATCH, &batch, sizeof batch), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock_clr, SRTO_UDP_RCVBATCH, &batch, sizeof batch), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock_clr, SRTO_KMREFRESHRATE, &km_refresh, sizeof km_refresh), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock_clr, SRTO_KMPREANNOUNCE, &km_preannounce, sizeof km_preannounce), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock_clr, SRTO_PASSPHRASE, pass.c_str(), (int)pass.size()), SRT_SUCCESS);
+    ASSERT_NE(srt_connect(sock_clr, (sockaddr*)&sa_lsn, sizeof sa_lsn), SRT_ERROR) << srt_getlasterror_str();
+
+    SRTSOCKET sock_acp = srt_accept(sock_lsn, NULL, NULL);
+    ASSERT_NE(sock_acp, SRT_INVALID_SOCK);
+    ASSERT_EQ(srt_setsockflag(sock_acp, SRTO_RCVTIMEO, &rcvtimeo, sizeof rcvtimeo), SRT_SUCCESS);
+
+    // Both ways, each side switching its sending key several times.
+    const int ROUND = 40;
+    array<char, 1316> buf;
+    for (int first = 0; first < NPKT; first += ROUND)
+    {
+        for (int n = first; n < first + ROUND; ++n)
+        {
+            buf.fill(char(n));
+            memcpy(buf.data(), &n, sizeof n);
+            ASSERT_EQ(srt_send(sock_acp, buf.data(), (int)buf.size()), (int)buf.size()) << srt_getlasterror_str();
+            ASSERT_EQ(srt_send(sock_clr, buf.data(), (int)buf.size()), (int)buf.size()) << srt_getlasterror_str();
+        }
+
+        for (int n = first; n < first + ROUND; ++n)
+        {
+            array<char, 1316> rbuf;
+            int rn = -1;
+            ASSERT_EQ(srt_recv(sock_clr, rbuf.data(), (int)rbuf.size()), (int)rbuf.size())
+                << "pkt " << n << ": " << srt_getlasterror_str();
+            memcpy(&rn, rbuf.data(), sizeof rn);
+            ASSERT_EQ(rn, n);
+            EXPECT_EQ(rbuf[rbuf.size() - 1], char(n));
+
+            ASSERT_EQ(srt_recv(sock_acp, rbuf.data(), (int)rbuf.size()), (int)rbuf.size())
+                << "pkt " << n << ": " << srt_getlasterror_str();
+            memcpy(&rn, rbuf.data(), sizeof rn);
+            ASSERT_EQ(rn, n);
+            EXPECT_EQ(rbuf[rbuf.size() - 1], char(n));
+        }
+    }
+
+    SRT_TRACEBSTATS stats;
+    ASSERT_EQ(srt_bstats(sock_acp, &stats, 0), SRT_SUCCESS);
+    EXPECT_EQ(stats.pktRcvUndecryptTotal, 0);
+    EXPECT_GT(stats.cryptoJobsTotal, 0);
+    ASSERT_EQ(srt_bstats(sock_clr, &stats, 0), SRT_SUCCESS);
+    EXPECT_EQ(stats.pktRcvUndecryptTotal, 0);
+    EXPECT_GT(stats.cryptoJobsTotal, 0);
+
+    srt_close(sock_acp);
+    srt_close(sock_clr);
+    srt_close(sock_lsn);
+}
+
+// With the keystream precomputed between the packets, including across the
+// key refreshes, the payload still arrives intact.
+TEST(UDPBatch, CryptoPrecompute)
+{
+    srt::TestInit srtinit;
+
+    const int NPKT = 600;
+    const int precomp = 64;
+    const int km_refresh = 256;
+    const int km_preannounce = 64;
+    const string pass = "crypto-precomp-passphrase";
+
+    SRTSOCKET sock_lsn = srt_create_socket();
+    ASSERT_NE(sock_lsn, SRT_INVALID_SOCK);
+    ASSERT_EQ(srt_setsockflag(sock_lsn, SRTO_PASSPHRASE, pass.c_str(), (int)pass.size()), SRT_SUCCESS);
+
+    sockaddr_in sa_lsn;
+    ASSERT_NE(BindFreePort(sock_lsn, (sa_lsn)), -1);
+    ASSERT_NE(srt_listen(sock_lsn, 1), SRT_ERROR);
+
+    SRTSOCKET sock_clr = srt_create_socket();
+    ASSERT_NE(sock_clr, SRT_INVALID_SOCK);
+    ASSERT_EQ(srt_setsockflag(sock_clr, SRTO_CRYPTOPRECOMP, &precomp, sizeof precomp), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock_clr, SRTO_KMREFRESHRATE, &km_refresh, sizeof km_refresh), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock_clr, SRTO_KMPREANNOUNCE, &km_preannounce, sizeof km_preannounce), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock_clr, SRTO_PASSPHRASE, pass.c_str(), (int)pass.size()), SRT_SUCCESS);
+    ASSERT_NE(srt_connect(sock_clr, (sockaddr*)&sa_lsn, sizeof sa_lsn), SRT_ERROR) << srt_getlasterror_str();
+
+    SRTSOCKET sock_acp = srt_accept(sock_lsn, NULL, NULL);
+    ASSERT_NE(sock_acp, SRT_INVALID_SOCK);
+    const int rcvtimeo = 3000;
+    ASSERT_EQ(srt_setsockflag(sock_acp, SRTO_RCVTIMEO, &rcvtimeo, sizeof rcvtimeo), SRT_SUCCESS);
+
+    // Sent in rounds, so that the sending queue gets idle between them.
+    const int ROUND = 40;
+    array<char, 1316> buf;
+    for (int first = 0; first < NPKT; first += ROUND)
+    {
+        for (int n = first; n < first + ROUND; ++n)
+        {
+            buf.fill(char(n));
+            memcpy(buf.data(), &n, sizeof n);
+            ASSERT_EQ(srt_send(sock_clr, buf.data(), (int)buf.size()), (int)buf.size()) << srt_getlasterror_str();
+        }
+
+        for (int n = first; n < first + ROUND; ++n)
+        {
+            array<char, 1316> rbuf;
+            int rn = -1;
+            ASSERT_EQ(srt_recv(sock_acp, rbuf.data(), (int)rbuf.size()), (int)rbuf.size())
+                << "pkt " << n << ": " << srt_getlasterror_str();
+            memcpy(&rn, rbuf.data(), sizeof rn);
+            ASSERT_EQ(rn, n);
+            EXPECT_EQ(rbuf[rbuf.size() - 1], char(n));
+        }
+    }
+
+    SRT_TRACEBSTATS stats;
+    ASSERT_EQ(srt_bstats(sock_acp, &stats, 0), SRT_SUCCESS);
+    EXPECT_EQ(stats.pktRcvUndecryptTotal, 0);
+    ASSERT_EQ(srt_bstats(sock_clr, &stats, 0), SRT_SUCCESS);
+    // The packets sent before the first idle time are not counted.
+    EXPECT_GT(stats.pktSndKeystreamHitTotal, NPKT / 2);
+    EXPECT_GT(stats.pktSndKeystreamHitTotal, stats.pktSndKeystreamMissTotal);
+
+    srt_close(sock_acp);
+    srt_close(sock_clr);
+    srt_close(sock_lsn);
+}
+#endif
+
+// Sockets with a different batch size can't share the multiplexer.
+TEST(UDPBatch, MuxerMismatch)
+{
+    srt::TestInit srtinit;
+
+    const int batch = 8;
+    SRTSOCKET sock1 = srt_create_socket();
+    SRTSOCKET sock2 = srt_create_socket();
+    ASSERT_EQ(srt_setsockflag(sock1, SRTO_UDP_SNDBATCH, &batch, sizeof batch), SRT_SUCCESS);
+
+    sockaddr_in sa;
+    ASSERT_NE(BindFreePort(sock1, (sa)), -1);
+    EXPECT_EQ(srt_bind(sock2, (sockaddr*)&sa, sizeof sa), SRT_ERROR);
+
+    SRTSOCKET sock3 = srt_create_socket();
+    ASSERT_EQ(srt_setsockflag(sock3, SRTO_UDP_SNDBATCH, &batch, sizeof batch), SRT_SUCCESS);
+    EXPECT_EQ(srt_bind(sock3, (sockaddr*)&sa, sizeof sa), SRT_SUCCESS) << srt_getlasterror_str();
+
+    // The number of sending threads must match, too.
+    const int workers = 2;
+    SRTSOCKET sock4 = srt_create_socket();
+    ASSERT_EQ(srt_setsockflag(sock4, SRTO_UDP_SNDBATCH, &batch, sizeof batch), SRT_SUCCESS);
+    ASSERT_EQ(srt_setsockflag(sock4, SRTO_SNDWORKERS, &workers, sizeof workers), SRT_SUCCESS);
+    EXPECT_EQ(srt_bind(sock4, (sockaddr*)&sa, sizeof sa), SRT_ERROR);
+
+    srt_close(sock1);
+    srt_close(sock2);
+    srt_close(sock3);
+    srt_close(sock4);
+}
@@ -86,3 +86,105 @@ TEST(CUnitQueue, IncreaseAndFreeGrouped)
             << "Buffer capacity should not exceed two queues of 4 units";
     }
 }
+
+/// Units freed in any order must be handed out again
+/// without allocating more, the most recently freed first.
+TEST(CUnitQueue, FreeAnyOrder)
+{
+    srt::TestInit srtinit;
+    const int buffer_size_pkts = 16;
+    CUnitQueue unit_queue(buffer_size_pkts, 1500);
+
+    vector<CUnit*> taken_units;
+    for (int i = 0; i < buffer_size_pkts / 2; ++i)
+    {
+        CUnit* unit = unit_queue.getNextAvailUnit();
+        ASSERT_NE(unit, nullptr);
+        unit_queue.makeUnitTaken(unit);
+        taken_units.push_back(unit);
+    }
+    EXPECT_EQ(unit_queue.takenUnits(), buffer_size_pkts / 2);
+
+    // Free every other unit, then the rest.
+    for (size_t i = 0; i < taken_units.size(); i += 2)
+        unit_queue.makeUnitFree(taken_units[i]);
+    EXPECT_EQ(unit_queue.getNextAvailUnit(), taken_units[taken_units.size() - 2]);
+
+    for (size_t i = 1; i < taken_units.size(); i += 2)
+        unit_queue.makeUnitFree(taken_units[i]);
+    EXPECT_EQ(unit_queue.getNextAvailUnit(), taken_units.back());
+
+    EXPECT_EQ(unit_queue.takenUnits(), 0);
+    EXPECT_EQ(unit_queue.size(), buffer_size_pkts);
+    EXPECT_EQ(unit_queue.capacity(), buffer_size_pkts);
+
+    // Taking a unit that is not the first available one.
+    unit_queue.makeUnitTaken(taken_units[3]);
+    EXPECT_NE(unit_queue.getNextAvailUnit(), taken_units[3]);
+    EXPECT_EQ(unit_queue.takenUnits(), 1);
+    unit_queue.makeUnitFree(taken_units[3]);
+}
+
+/// After a burst the blocks of units that are all free are released,
+/// once the number of units in use has stayed low for a whole period.
+TEST(CUnitQueue, Shrink)
+{
+    using namespace srt::sync;
+    srt::TestInit srtinit;
+    const int buffer_size_pkts = 4;
+    CUnitQueue unit_queue(buffer_size_pkts, 1500);
+    const steady_clock::duration period = milliseconds_from(CUnitQueue::SHRINK_PERIOD_MS + 1);
+    steady_clock::time_point now = steady_clock::now();
+
+    vector<CUnit*> taken_units;
+    for (int i = 0; i < 4 * buffer_size_pkts; ++i)
+    {
+        CUnit* unit = unit_queue.getNextAvailUnit();
+        ASSERT_NE(unit, nullptr);
+        unit_queue.makeUnitTaken(unit);
+        taken_units.push_back(unit);
+    }
+    const int peak_capacity = unit_queue.capacity();
+    EXPECT_GT(peak_capacity, 4 * buffer_size_pkts);
+
+    // Keep the first unit taken, so its block can't be released.
+    for (size_t i = 1; i < taken_units.size(); ++i)
+        unit_queue.makeUnitFree(taken_units[i]);
+
+    // Too early.
+    EXPECT_EQ(unit_queue.shrink(now), 0);
+    EXPECT_EQ(unit_queue.capacity(), peak_capacity);
+
+    // All units were in use during this period.
+    now += period;
+    EXPECT_EQ(unit_queue.shrink(now), 0);
+    EXPECT_EQ(unit_queue.capacity(), peak_capacity);
+    EXPECT_EQ(unit_queue.shrinkCount(), 0);
+
+    now += period;
+    EXPECT_GT(unit_queue.shrink(now), 0);
+    EXPECT_EQ(unit_queue.shrinkCount(), 1);
+    EXPECT_EQ(unit_queue.takenUnits(), 1);
+    EXPECT_GE(unit_queue.capacity(), buffer_size_pkts);
+    EXPECT_LT(unit_queue.capacity(), peak_capacity);
+
+    // The remaining units are all usable.
+    vector<CUnit*> retaken;
+    while (unit_queue.size() > 0)
+    {
+        CUnit* unit = unit_queue.getNextAvailUnit();
+        ASSERT_NE(unit, nullptr);
+        unit_queue.makeUnitTaken(unit);
+        retaken.push_back(unit);
+    }
+    for (size_t i = 0; i < retaken.size(); ++i)
+        unit_queue.makeUnitFree(retaken[i]);
+    unit_queue.makeUnitFree(taken_units[0]);
+
+    // Never below the initial capacity.
+    now += period;
+    unit_queue.shrink(now);
+    now += period;
+    unit_queue.shrink(now);
+    EXPECT_GE(unit_queue.capacity(), buffer_size_pkts);
+}